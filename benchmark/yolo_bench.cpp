@@ -0,0 +1,1571 @@
+// Native benchmark tool for flutter_yolo_open_kit (Linux host)
+//
+// Build:
+//   cd linux && cmake -B build -DYOLO_BUILD_BENCHMARK=ON && cmake --build build
+//
+// Usage:
+//   yolo_bench preprocess [width height [iterations]]
+//   yolo_bench load <libflutter_yolo_open_kit.so> [iterations]
+//   yolo_bench pool [threads [iterations]]
+//   yolo_bench scan <image directory> [depth]
+//   yolo_bench delta <detection log> [keyframe interval]
+//   yolo_bench fold <model.onnx> <image file or directory>
+//   yolo_bench pipeline <model.onnx> <image directory> [depth]
+//   yolo_bench backends <model.onnx> <image file or directory> [iterations]
+//   yolo_bench group <image directory> <model.onnx> <model.onnx> [...]
+//   yolo_bench video <model.onnx> <video file> [interval seconds]
+//   yolo_bench plan <model.onnx> <image file or directory> [fps per stream [p99 ms [seconds per config]]]
+//   yolo_bench energy <model.onnx> <image file or directory> [iterations]
+//   yolo_bench mjpeg <model.onnx> <mjpeg file> [decode threads [scale]]
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "batch_scan.hpp"
+#include "delta_stream.hpp"
+#include "detection_log.hpp"
+#include "detector_group.hpp"
+#include "file_prefetcher.hpp"
+#include "frame_pipeline.hpp"
+#include "image_decoder.hpp"
+#include "mjpeg_ingest.hpp"
+#include "sampling_plan.hpp"
+#include "task_pool.hpp"
+#include "video_scan.hpp"
+#include "yolo_detector.hpp"
+
+#if YOLO_USE_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+using namespace std::chrono;
+
+namespace {
+
+constexpr int kInputSize = 640;
+
+// Average milliseconds per call over `iterations` runs (after one warm-up run)
+double timeMs(int iterations, const std::function<void()>& fn) {
+    fn();
+    auto start = steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        fn();
+    }
+    auto end = steady_clock::now();
+    return duration<double, std::milli>(end - start).count() / iterations;
+}
+
+// Package energy from Linux powercap (Intel RAPL; AMD RAPL is exposed under
+// the same intel-rapl names) and process CPU time from getrusage, read
+// around a measured run. Energy covers whole packages, so other load on the
+// host is included. Without readable counters (no RAPL, or energy_uj
+// restricted to root) only CPU time is reported.
+class EnergyMeter {
+public:
+    struct Reading {
+        double energy_j = 0.0;
+        double cpu_s = 0.0;
+    };
+
+    EnergyMeter() {
+        DIR* dir = opendir("/sys/class/powercap");
+        if (dir == nullptr) {
+            m_reason = "no /sys/class/powercap";
+            return;
+        }
+        while (dirent* entry = readdir(dir)) {
+            // Top-level package zones only ("intel-rapl:0"); subzones
+            // ("intel-rapl:0:0") are already counted in them
+            std::string name = entry->d_name;
+            if (name.compare(0, 11, "intel-rapl:") != 0 || name.find(':', 11) != std::string::npos) continue;
+            Domain domain;
+            domain.path = "/sys/class/powercap/" + name + "/energy_uj";
+            domain.range_uj = readCounter("/sys/class/powercap/" + name + "/max_energy_range_uj");
+            domain.last_uj = readCounter(domain.path);
+            if (domain.last_uj < 0) {
+                m_reason = "energy_uj not readable (root or a read permission on it is needed)";
+                continue;
+            }
+            m_domains.push_back(domain);
+        }
+        closedir(dir);
+        if (m_domains.empty() && m_reason.empty()) {
+            m_reason = "no RAPL package zones";
+        }
+    }
+
+    bool hasEnergy() const { return !m_domains.empty(); }
+
+    // Why energy is not available
+    const std::string& reason() const { return m_reason; }
+
+    // Cumulative energy and CPU time since construction. Counter wraparound
+    // is handled if readings are taken at least once per wrap period
+    // (minutes at full load).
+    Reading read() {
+        Reading reading;
+        for (Domain& domain : m_domains) {
+            int64_t uj = readCounter(domain.path);
+            if (uj < 0) continue;
+            int64_t delta = uj - domain.last_uj;
+            if (delta < 0 && domain.range_uj > 0) delta += domain.range_uj;
+            domain.total_uj += std::max<int64_t>(0, delta);
+            domain.last_uj = uj;
+            reading.energy_j += domain.total_uj / 1e6;
+        }
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            reading.cpu_s = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+                            usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+        }
+        return reading;
+    }
+
+private:
+    struct Domain {
+        std::string path;
+        int64_t range_uj = 0;
+        int64_t last_uj = 0;
+        int64_t total_uj = 0;
+    };
+
+    std::vector<Domain> m_domains;
+    std::string m_reason;
+
+    static int64_t readCounter(const std::string& path) {
+        FILE* f = fopen(path.c_str(), "r");
+        if (f == nullptr) return -1;
+        long long value = -1;
+        if (fscanf(f, "%lld", &value) != 1) value = -1;
+        fclose(f);
+        return value;
+    }
+};
+
+#if YOLO_USE_OPENCV
+// Previous OpenCV preprocessing: letterbox a BGR image and convert to CHW
+void legacyLetterbox(const cv::Mat& bgr, std::vector<float>& tensor) {
+    float scale = std::min(static_cast<float>(kInputSize) / bgr.cols,
+                           static_cast<float>(kInputSize) / bgr.rows);
+    int new_width = static_cast<int>(bgr.cols * scale);
+    int new_height = static_cast<int>(bgr.rows * scale);
+    int pad_x = (kInputSize - new_width) / 2;
+    int pad_y = (kInputSize - new_height) / 2;
+
+    cv::Mat resized;
+    cv::resize(bgr, resized, cv::Size(new_width, new_height), 0, 0, cv::INTER_LINEAR);
+    cv::Mat padded(kInputSize, kInputSize, CV_8UC3, cv::Scalar(114, 114, 114));
+    resized.copyTo(padded(cv::Rect(pad_x, pad_y, new_width, new_height)));
+
+    cv::Mat rgb;
+    cv::cvtColor(padded, rgb, cv::COLOR_BGR2RGB);
+    const int channel_size = kInputSize * kInputSize;
+    for (int y = 0; y < kInputSize; y++) {
+        for (int x = 0; x < kInputSize; x++) {
+            cv::Vec3b pixel = rgb.at<cv::Vec3b>(y, x);
+            int idx = y * kInputSize + x;
+            tensor[0 * channel_size + idx] = pixel[0] / 255.0f;
+            tensor[1 * channel_size + idx] = pixel[1] / 255.0f;
+            tensor[2 * channel_size + idx] = pixel[2] / 255.0f;
+        }
+    }
+}
+#endif
+
+// Per-frame preprocessing cost: OpenCV pipeline vs cached sampling plan
+int benchPreprocess(int width, int height, int iterations) {
+    std::vector<float> tensor(3 * kInputSize * kInputSize);
+    TensorFormat format;
+    format.rgb = true;
+    format.norm = 1.0f / 255.0f;
+
+    std::vector<uint8_t> bgra(static_cast<size_t>(width) * height * 4);
+    std::vector<uint8_t> nv21(static_cast<size_t>(width) * height * 3 / 2);
+    srand(42);
+    for (auto& v : bgra) v = static_cast<uint8_t>(rand());
+    for (auto& v : nv21) v = static_cast<uint8_t>(rand());
+
+    printf("Preprocess %dx%d -> %dx%d, %d iterations (ms/frame)\n\n",
+           width, height, kInputSize, kInputSize, iterations);
+    printf("%-28s %12s %12s %12s\n", "input", "opencv", "plan-rebuild", "plan-cached");
+
+    auto run = [&](const char* label, const FrameView& frame, const std::function<void()>& legacy) {
+        double cv_ms = legacy ? timeMs(iterations, legacy) : -1.0;
+        double rebuild_ms = timeMs(iterations, [&]() {
+            SamplingPlan plan;
+            plan.build(frame.geometry, kInputSize, kInputSize, true);
+            plan.sample(frame, format, tensor.data());
+        });
+        SamplingPlan plan;
+        plan.build(frame.geometry, kInputSize, kInputSize, true);
+        double cached_ms = timeMs(iterations, [&]() {
+            plan.sample(frame, format, tensor.data());
+        });
+        if (cv_ms < 0) {
+            printf("%-28s %12s %12.3f %12.3f\n", label, "n/a", rebuild_ms, cached_ms);
+        } else {
+            printf("%-28s %12.3f %12.3f %12.3f\n", label, cv_ms, rebuild_ms, cached_ms);
+        }
+    };
+
+    // BGRA (iOS camera)
+    {
+        FrameView frame;
+        frame.geometry.format = SourceFormat::BGRA;
+        frame.geometry.width = width;
+        frame.geometry.height = height;
+        frame.geometry.stride = width * 4;
+        frame.data = bgra.data();
+
+        std::function<void()> legacy;
+#if YOLO_USE_OPENCV
+        legacy = [&]() {
+            cv::Mat src(height, width, CV_8UC4, bgra.data());
+            cv::Mat bgr;
+            cv::cvtColor(src, bgr, cv::COLOR_BGRA2BGR);
+            legacyLetterbox(bgr, tensor);
+        };
+#endif
+        run("BGRA", frame, legacy);
+    }
+
+    // NV21 with rotation (Android camera)
+    for (int rotation : {0, 90}) {
+        FrameView frame;
+        frame.geometry.format = SourceFormat::YUV420;
+        frame.geometry.width = width;
+        frame.geometry.height = height;
+        frame.geometry.stride = width;
+        frame.geometry.uv_row_stride = width;
+        frame.geometry.uv_pixel_stride = 2;
+        frame.geometry.rotation = rotation;
+        frame.data = nv21.data();
+        frame.v = nv21.data() + static_cast<size_t>(width) * height;
+        frame.u = frame.v + 1;
+
+        std::function<void()> legacy;
+#if YOLO_USE_OPENCV
+        legacy = [&, rotation]() {
+            std::vector<uint8_t> copy(nv21);
+            cv::Mat yuv(height * 3 / 2, width, CV_8UC1, copy.data());
+            cv::Mat bgr;
+            cv::cvtColor(yuv, bgr, cv::COLOR_YUV2BGR_NV21);
+            if (rotation == 90) {
+                cv::rotate(bgr, bgr, cv::ROTATE_90_CLOCKWISE);
+            }
+            legacyLetterbox(bgr, tensor);
+        };
+#endif
+        std::string label = "NV21 rot=" + std::to_string(rotation);
+        run(label.c_str(), frame, legacy);
+    }
+
+    return 0;
+}
+
+// Shipped library size and cold dlopen time (each sample in a fresh process,
+// so dependent libraries such as OpenCV are loaded and relocated every time)
+int benchLoad(const char* library, int iterations) {
+    struct stat st;
+    if (stat(library, &st) != 0) {
+        fprintf(stderr, "Cannot stat %s\n", library);
+        return 1;
+    }
+
+    double total_ms = 0.0;
+    double min_ms = 1e9;
+    int samples = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        int fds[2];
+        if (pipe(fds) != 0) return 1;
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            auto start = steady_clock::now();
+            void* handle = dlopen(library, RTLD_NOW | RTLD_LOCAL);
+            double ms = duration<double, std::milli>(steady_clock::now() - start).count();
+            if (handle == nullptr) ms = -1.0;
+            ssize_t written = write(fds[1], &ms, sizeof(ms));
+            _exit(written == sizeof(ms) ? 0 : 1);
+        }
+
+        close(fds[1]);
+        double ms = -1.0;
+        ssize_t got = read(fds[0], &ms, sizeof(ms));
+        close(fds[0]);
+        waitpid(pid, nullptr, 0);
+
+        if (got != sizeof(ms) || ms < 0) {
+            fprintf(stderr, "dlopen failed: %s\n", library);
+            return 1;
+        }
+        total_ms += ms;
+        min_ms = std::min(min_ms, ms);
+        samples++;
+    }
+
+    printf("Library:      %s\n", library);
+    printf("File size:    %.1f KB\n", st.st_size / 1024.0);
+    printf("dlopen (avg): %.3f ms over %d runs\n", total_ms / samples, samples);
+    printf("dlopen (min): %.3f ms\n", min_ms);
+    return 0;
+}
+
+// Task pool vs serial vs cv::parallel_for_ on the same chunked workloads
+int benchPool(int threads, int iterations) {
+    setThreadBudget(threads);
+    TaskPool& pool = TaskPool::shared();
+#if YOLO_USE_OPENCV
+    cv::setNumThreads(threads);
+#endif
+
+    printf("Task pool, %d threads, %d iterations (ms/call)\n\n", pool.threadCount(), iterations);
+    printf("%-28s %12s %12s %12s\n", "workload", "serial", "task-pool", "cv-parallel");
+
+    auto row = [&](const char* label, int items, int grain, const std::function<void(int, int)>& body) {
+        double serial_ms = timeMs(iterations, [&]() { body(0, items); });
+        double pool_ms = timeMs(iterations, [&]() { pool.parallelFor(0, items, grain, body); });
+#if YOLO_USE_OPENCV
+        double cv_ms = timeMs(iterations, [&]() {
+            cv::parallel_for_(cv::Range(0, items), [&](const cv::Range& r) { body(r.start, r.end); },
+                              static_cast<double>(items) / grain);
+        });
+        printf("%-28s %12.4f %12.4f %12.4f\n", label, serial_ms, pool_ms, cv_ms);
+#else
+        printf("%-28s %12.4f %12.4f %12s\n", label, serial_ms, pool_ms, "n/a");
+#endif
+    };
+
+    // Fork-join overhead: one tiny chunk per item
+    std::atomic<int> sink{0};
+    row("fork-join (64 empty)", 64, 1, [&](int b, int e) { sink.fetch_add(e - b, std::memory_order_relaxed); });
+
+    // Compute-bound map over 1M floats
+    std::vector<float> data(1 << 20);
+    for (size_t i = 0; i < data.size(); i++) data[i] = static_cast<float>(i % 1000);
+    std::vector<float> out(data.size());
+    row("sqrt map 1M", static_cast<int>(data.size()), 16384, [&](int b, int e) {
+        for (int i = b; i < e; i++) out[i] = std::sqrt(data[i]) * 0.5f + 1.0f;
+    });
+
+    // Memory-bound copy of 32 MB
+    std::vector<uint8_t> src(32u << 20, 1);
+    std::vector<uint8_t> dst(src.size());
+    row("memcpy 32MB", 512, 16, [&](int b, int e) {
+        const size_t chunk = src.size() / 512;
+        memcpy(dst.data() + b * chunk, src.data() + b * chunk, (e - b) * chunk);
+    });
+
+    // The detector's own stage: 1280x720 BGRA -> 640x640 sampling
+    std::vector<uint8_t> bgra(1280u * 720u * 4u, 7);
+    FrameView frame;
+    frame.geometry.format = SourceFormat::BGRA;
+    frame.geometry.width = 1280;
+    frame.geometry.height = 720;
+    frame.geometry.stride = 1280 * 4;
+    frame.data = bgra.data();
+    SamplingPlan plan;
+    plan.build(frame.geometry, kInputSize, kInputSize, true);
+    std::vector<float> tensor(3 * kInputSize * kInputSize);
+    TensorFormat format;
+
+    setThreadBudget(1);
+    double sample_serial = timeMs(iterations, [&]() { plan.sample(frame, format, tensor.data()); });
+    setThreadBudget(threads);
+    double sample_pool = timeMs(iterations, [&]() { plan.sample(frame, format, tensor.data()); });
+    printf("%-28s %12.4f %12.4f %12s\n", "sample BGRA 720p", sample_serial, sample_pool, "n/a");
+    return 0;
+}
+
+// Drop a file from the page cache so every pass reads from storage
+void evictFromCache(const std::string& path) {
+#if defined(POSIX_FADV_DONTNEED)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+// Blocking read + decode per image vs prefetched (io_uring / pread pool)
+// contents decoded from memory; reports I/O wait per image
+int benchScan(const char* directory, int depth) {
+    std::vector<std::string> paths = listImageFiles(directory);
+    if (paths.empty()) {
+        fprintf(stderr, "No images in %s\n", directory);
+        return 1;
+    }
+    if (!imageDecoderAvailable()) {
+        fprintf(stderr, "Built without an image decoder\n");
+        return 1;
+    }
+
+    struct Pass {
+        double io_wait_ms = 0.0;
+        double decode_ms = 0.0;
+        double total_ms = 0.0;
+        uint64_t bytes = 0;
+        int decoded = 0;
+    };
+
+    auto decode = [](const uint8_t* data, size_t size, Pass& pass) {
+        auto start = steady_clock::now();
+        DecodedImage image;
+        if (decodeImageMemory(data, size, image)) pass.decoded++;
+        pass.decode_ms += duration<double, std::milli>(steady_clock::now() - start).count();
+    };
+
+    // Blocking: read each file on the decode thread, then decode it
+    for (const auto& path : paths) evictFromCache(path);
+    Pass blocking;
+    auto start = steady_clock::now();
+    std::vector<uint8_t> buffer;
+    for (const auto& path : paths) {
+        auto read_start = steady_clock::now();
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file == nullptr) continue;
+        fseek(file, 0, SEEK_END);
+        buffer.resize(static_cast<size_t>(ftell(file)));
+        fseek(file, 0, SEEK_SET);
+        size_t got = fread(buffer.data(), 1, buffer.size(), file);
+        fclose(file);
+        blocking.io_wait_ms += duration<double, std::milli>(steady_clock::now() - read_start).count();
+        blocking.bytes += got;
+        decode(buffer.data(), got, blocking);
+    }
+    blocking.total_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    // Prefetched: reads run ahead while the previous image decodes
+    for (const auto& path : paths) evictFromCache(path);
+    Pass prefetched;
+    PrefetchConfig config;
+    config.depth = depth;
+    start = steady_clock::now();
+    std::string backend;
+    {
+        FilePrefetcher prefetcher(paths, config);
+        backend = prefetcher.backend();
+        PrefetchedFile file;
+        while (prefetcher.next(file)) {
+            prefetched.io_wait_ms += file.io_wait_ms;
+            if (file.ok()) {
+                prefetched.bytes += file.size;
+                decode(file.data, file.size, prefetched);
+            }
+            prefetcher.release(file);
+        }
+    }
+    prefetched.total_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    const double n = static_cast<double>(paths.size());
+    printf("Scan %s: %zu images, prefetch depth %d (%s)\n\n", directory, paths.size(), config.depth,
+           backend.c_str());
+    printf("%-12s %14s %14s %14s %10s\n", "reader", "io wait/img", "decode/img", "total/img", "MB/s");
+    auto row = [&](const char* label, const Pass& pass) {
+        printf("%-12s %11.3f ms %11.3f ms %11.3f ms %10.1f\n", label, pass.io_wait_ms / n,
+               pass.decode_ms / n, pass.total_ms / n, pass.bytes / 1048576.0 / (pass.total_ms / 1000.0));
+    };
+    row("blocking", blocking);
+    row("prefetch", prefetched);
+    if (blocking.decoded != prefetched.decoded) {
+        fprintf(stderr, "Decoded %d vs %d images\n", blocking.decoded, prefetched.decoded);
+        return 1;
+    }
+    return 0;
+}
+
+// Replay a detection log through the delta stream encoder and decoder:
+// packet size against full-precision boxes and the log's own records,
+// encode / decode cost, and the worst reconstruction error
+int benchDelta(const char* log_path, int keyframe_interval) {
+    DetectionLogReader log;
+    if (!log.open(log_path)) {
+        fprintf(stderr, "Not a detection log: %s\n", log_path);
+        return 1;
+    }
+    const int64_t frames = log.frameCount();
+    if (frames == 0) {
+        fprintf(stderr, "Log has no frames\n");
+        return 1;
+    }
+
+    DeltaEncoder encoder(keyframe_interval);
+    DeltaDecoder decoder;
+    std::vector<detection_log::Box> boxes;
+    std::vector<uint8_t> packet;
+    double decode_ms = 0.0;
+    double max_error = 0.0;
+    uint64_t encoded_bytes = 0;
+    uint64_t total_boxes = 0;
+
+    for (int64_t i = 0; i < frames; i++) {
+        int64_t ts = 0;
+        int width = 0;
+        int height = 0;
+        int count = log.readFrame(i, ts, width, height, nullptr, 0);
+        boxes.resize(std::max(count, 0));
+        log.readFrame(i, ts, width, height, boxes.data(), count);
+
+        encoder.encode(ts, width, height, boxes.data(), count, packet);
+        encoded_bytes += packet.size();
+        total_boxes += boxes.size();
+
+        auto start = steady_clock::now();
+        int decoded = decoder.decode(packet.data(), packet.size());
+        decode_ms += duration<double, std::milli>(steady_clock::now() - start).count();
+        if (decoded != count) {
+            fprintf(stderr, "Frame %lld: decoded %d of %d boxes\n", static_cast<long long>(i), decoded, count);
+            return 1;
+        }
+
+        // Decoded order differs (kept boxes first); compare against the
+        // closest decoded box of the same class
+        for (const auto& box : boxes) {
+            double best = 1e30;
+            for (const auto& d : decoder.boxes()) {
+                if (d.class_id != box.class_id) continue;
+                double err = std::max({std::fabs(d.x1 - box.x1), std::fabs(d.y1 - box.y1),
+                                       std::fabs(d.x2 - box.x2), std::fabs(d.y2 - box.y2)});
+                best = std::min(best, err);
+            }
+            max_error = std::max(max_error, best);
+        }
+    }
+
+    struct stat st;
+    const double log_bytes = stat(log_path, &st) == 0 ? static_cast<double>(st.st_size) : 0.0;
+    const double n = static_cast<double>(frames);
+    printf("Delta stream %s: %lld frames, %.1f boxes/frame, keyframe every %d\n\n",
+           log_path, static_cast<long long>(frames), total_boxes / n, keyframe_interval);
+    printf("%s\n\n", encoder.statsJson().c_str());
+    printf("%-16s %12s\n", "format", "bytes/frame");
+    printf("%-16s %12.1f\n", "full precision", (16.0 * frames + sizeof(detection_log::Box) * total_boxes) / n);
+    printf("%-16s %12.1f\n", "detection log", log_bytes / n);
+    printf("%-16s %12.1f\n", "delta stream", encoded_bytes / n);
+    printf("\ndecode %.3f us/frame, max error %.2f px\n", decode_ms * 1000.0 / n, max_error);
+    return 0;
+}
+
+// Regression check for input normalization folding: the same images through
+// the model as exported and with its first convolution rewritten, comparing
+// detections and per-image latency
+int benchFold(const char* model_path, const char* images) {
+    struct stat st;
+    std::vector<std::string> paths;
+    if (stat(images, &st) == 0 && S_ISDIR(st.st_mode)) {
+        paths = listImageFiles(images);
+    } else {
+        paths.push_back(images);
+    }
+
+    YoloDetector reference;
+    YoloDetector folded;
+    folded.setFoldInputNormalization(true);
+    if (!reference.init(model_path) || !folded.init(model_path)) {
+        fprintf(stderr, "Failed to load %s\n", model_path);
+        return 1;
+    }
+    if (!folded.inputFolded()) {
+        fprintf(stderr, "Input normalization of %s cannot be folded (see debug log)\n", model_path);
+        return 1;
+    }
+
+    struct Pass {
+        std::vector<Detection> detections;
+        std::vector<float> embeddings;
+        double ms = 0.0;
+    };
+    auto run = [](YoloDetector& detector, const std::string& path, Pass& pass) {
+        int width = 0;
+        int height = 0;
+        auto start = steady_clock::now();
+        DetectStatus status = detector.detectBoxes(YoloDetector::fileSource(path.c_str()), 0.25f, 0.45f,
+                                                   false, pass.detections, pass.embeddings, width, height);
+        pass.ms += duration<double, std::milli>(steady_clock::now() - start).count();
+        return status == DetectStatus::Ok;
+    };
+
+    Pass ref;
+    Pass fold;
+    int images_run = 0;
+    int count_mismatches = 0;
+    int unmatched = 0;
+    double max_coord_error = 0.0;
+    double max_score_error = 0.0;
+    for (const auto& path : paths) {
+        if (!run(reference, path, ref) || !run(folded, path, fold)) {
+            fprintf(stderr, "Skipping %s\n", path.c_str());
+            continue;
+        }
+        images_run++;
+        if (ref.detections.size() != fold.detections.size()) count_mismatches++;
+
+        // Both lists are sorted by confidence; pair each reference box with
+        // the closest folded box of the same class
+        for (const auto& r : ref.detections) {
+            double best = 1e30;
+            const Detection* match = nullptr;
+            for (const auto& f : fold.detections) {
+                if (f.class_id != r.class_id) continue;
+                double err = std::max({std::fabs(f.x1 - r.x1), std::fabs(f.y1 - r.y1),
+                                       std::fabs(f.x2 - r.x2), std::fabs(f.y2 - r.y2)});
+                if (err < best) {
+                    best = err;
+                    match = &f;
+                }
+            }
+            if (match == nullptr) {
+                unmatched++;
+                continue;
+            }
+            max_coord_error = std::max(max_coord_error, best);
+            max_score_error = std::max(max_score_error,
+                                       static_cast<double>(std::fabs(match->confidence - r.confidence)));
+        }
+    }
+    if (images_run == 0) {
+        fprintf(stderr, "No images could be run\n");
+        return 1;
+    }
+
+    printf("Fold %s: %d images\n\n", model_path, images_run);
+    printf("%-12s %14s\n", "model", "detect/img");
+    printf("%-12s %11.3f ms\n", "as exported", ref.ms / images_run);
+    printf("%-12s %11.3f ms\n", "folded", fold.ms / images_run);
+    printf("\ncount mismatches %d, unmatched boxes %d, max coord error %.3f px, max score error %.5f\n",
+           count_mismatches, unmatched, max_coord_error, max_score_error);
+    return count_mismatches == 0 && unmatched == 0 ? 0 : 1;
+}
+
+// Sequential detect calls against the staged FramePipeline (decode, sampling
+// and inference of successive images overlapped) over the same images
+int benchPipeline(const char* model_path, const char* image_dir, int depth) {
+    std::vector<std::string> paths = listImageFiles(image_dir);
+    if (paths.empty()) {
+        fprintf(stderr, "No images in %s\n", image_dir);
+        return 1;
+    }
+
+    YoloDetector detector;
+    if (!detector.init(model_path)) {
+        fprintf(stderr, "Failed to load %s\n", model_path);
+        return 1;
+    }
+
+    // Warm-up
+    std::vector<Detection> detections;
+    std::vector<float> embeddings;
+    int width = 0;
+    int height = 0;
+    detector.detectBoxes(YoloDetector::fileSource(paths[0].c_str()), 0.25f, 0.45f, false,
+                         detections, embeddings, width, height);
+
+    std::vector<size_t> sequential_counts;
+    auto start = steady_clock::now();
+    for (const auto& path : paths) {
+        DetectStatus status = detector.detectBoxes(YoloDetector::fileSource(path.c_str()), 0.25f, 0.45f, false,
+                                                   detections, embeddings, width, height);
+        sequential_counts.push_back(status == DetectStatus::Ok ? detections.size() : 0);
+    }
+    const double sequential_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    std::vector<size_t> pipeline_counts;
+    CallbackSink sink([&](const FrameResult& result) {
+        pipeline_counts.push_back(result.status == DetectStatus::Ok ? result.detections.size() : 0);
+    });
+    PipelineConfig config;
+    config.depth = depth;
+    std::string stats;
+    start = steady_clock::now();
+    {
+        FramePipeline pipeline(detector, sink, config);
+        for (const auto& path : paths) {
+            pipeline.push(YoloDetector::fileSource(path.c_str()));
+        }
+        pipeline.finish();
+        stats = pipeline.statsJson();
+    }
+    const double pipeline_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    const double n = static_cast<double>(paths.size());
+    printf("Pipeline %s: %zu images, depth %d\n\n", model_path, paths.size(), depth);
+    printf("%-12s %12s %12s\n", "mode", "ms/img", "img/s");
+    printf("%-12s %12.3f %12.1f\n", "sequential", sequential_ms / n, n * 1000.0 / sequential_ms);
+    printf("%-12s %12.3f %12.1f\n", "pipeline", pipeline_ms / n, n * 1000.0 / pipeline_ms);
+    printf("\n%s\n", stats.c_str());
+
+    const bool same = pipeline_counts == sequential_counts;
+    printf("\ndetection counts %s\n", same ? "match" : "DIFFER");
+    return same ? 0 : 1;
+}
+
+// The same model and images through every compiled-in inference backend:
+// load time, detect latency and agreement with ONNX Runtime
+int benchBackends(const char* model_path, const char* images, int iterations) {
+    struct stat st;
+    std::vector<std::string> paths;
+    if (stat(images, &st) == 0 && S_ISDIR(st.st_mode)) {
+        paths = listImageFiles(images);
+    } else {
+        paths.push_back(images);
+    }
+    if (paths.empty()) {
+        fprintf(stderr, "No images in %s\n", images);
+        return 1;
+    }
+
+    struct Result {
+        const char* name = "";
+        double load_ms = 0.0;
+        double detect_ms = 0.0;
+        int images = 0;
+        std::vector<std::vector<Detection>> detections;     // per image, last iteration
+    };
+    std::vector<Result> results;
+
+    for (BackendType type : {BackendType::OnnxRuntime, BackendType::OpenCvDnn}) {
+        YoloDetector detector;
+        if (!detector.setBackend(type)) {
+            continue;
+        }
+        Result result;
+        auto start = steady_clock::now();
+        if (!detector.init(model_path)) {
+            fprintf(stderr, "Backend %d could not load %s\n", static_cast<int>(type), model_path);
+            continue;
+        }
+        result.load_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+        result.name = detector.backendName();
+        result.detections.resize(paths.size());
+
+        std::vector<float> embeddings;
+        int width = 0;
+        int height = 0;
+        detector.detectBoxes(YoloDetector::fileSource(paths[0].c_str()), 0.25f, 0.45f, false,
+                             result.detections[0], embeddings, width, height);
+        for (int it = 0; it < iterations; it++) {
+            for (size_t i = 0; i < paths.size(); i++) {
+                start = steady_clock::now();
+                DetectStatus status = detector.detectBoxes(YoloDetector::fileSource(paths[i].c_str()),
+                                                           0.25f, 0.45f, false, result.detections[i],
+                                                           embeddings, width, height);
+                if (status != DetectStatus::Ok) continue;
+                result.detect_ms += duration<double, std::milli>(steady_clock::now() - start).count();
+                result.images++;
+            }
+        }
+        results.push_back(std::move(result));
+    }
+    if (results.empty()) {
+        fprintf(stderr, "No backend could load %s\n", model_path);
+        return 1;
+    }
+
+    printf("Backends %s: %zu images x %d\n\n", model_path, paths.size(), iterations);
+    printf("%-12s %10s %12s %16s %14s\n", "backend", "load ms", "detect/img", "count mismatches", "max error px");
+    const Result& reference = results[0];
+    for (const Result& r : results) {
+        int count_mismatches = 0;
+        double max_error = 0.0;
+        for (size_t i = 0; i < paths.size(); i++) {
+            const auto& ref = reference.detections[i];
+            const auto& got = r.detections[i];
+            if (ref.size() != got.size()) count_mismatches++;
+            for (const auto& a : ref) {
+                double best = 1e30;
+                for (const auto& b : got) {
+                    if (b.class_id != a.class_id) continue;
+                    double err = std::max({std::fabs(a.x1 - b.x1), std::fabs(a.y1 - b.y1),
+                                           std::fabs(a.x2 - b.x2), std::fabs(a.y2 - b.y2)});
+                    best = std::min(best, err);
+                }
+                if (best < 1e30) max_error = std::max(max_error, best);
+            }
+        }
+        printf("%-12s %10.1f %9.3f ms %16d %14.3f\n", r.name, r.load_ms,
+               r.images > 0 ? r.detect_ms / r.images : 0.0, count_mismatches, max_error);
+    }
+    return 0;
+}
+
+// Every model run separately on each image against a DetectorGroup, which
+// decodes each image once and samples it once per distinct input signature
+int benchGroup(const char* image_dir, const std::vector<std::string>& model_paths) {
+    std::vector<std::string> paths = listImageFiles(image_dir);
+    if (paths.empty()) {
+        fprintf(stderr, "No images in %s\n", image_dir);
+        return 1;
+    }
+
+    DetectorGroup group;
+    for (const auto& model_path : model_paths) {
+        if (group.add(model_path, model_path) < 0) {
+            fprintf(stderr, "Failed to load %s\n", model_path.c_str());
+            return 1;
+        }
+    }
+
+    // Warm-up
+    std::vector<Detection> detections;
+    std::vector<float> embeddings;
+    std::vector<GroupResult> results;
+    int width = 0;
+    int height = 0;
+    for (size_t m = 0; m < group.size(); m++) {
+        group.detector(m).detectBoxes(YoloDetector::fileSource(paths[0].c_str()), 0.25f, 0.45f, false,
+                                      detections, embeddings, width, height);
+    }
+    group.detect(YoloDetector::fileSource(paths[0].c_str()), 0.25f, 0.45f, results, width, height);
+
+    std::vector<size_t> separate_counts;
+    auto start = steady_clock::now();
+    for (const auto& path : paths) {
+        for (size_t m = 0; m < group.size(); m++) {
+            DetectStatus status = group.detector(m).detectBoxes(YoloDetector::fileSource(path.c_str()), 0.25f, 0.45f,
+                                                                false, detections, embeddings, width, height);
+            separate_counts.push_back(status == DetectStatus::Ok ? detections.size() : 0);
+        }
+    }
+    const double separate_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    std::vector<size_t> group_counts;
+    start = steady_clock::now();
+    for (const auto& path : paths) {
+        DetectStatus status = group.detect(YoloDetector::fileSource(path.c_str()), 0.25f, 0.45f,
+                                           results, width, height);
+        for (size_t m = 0; m < group.size(); m++) {
+            const bool ok = status == DetectStatus::Ok && results[m].status == DetectStatus::Ok;
+            group_counts.push_back(ok ? results[m].detections.size() : 0);
+        }
+    }
+    const double group_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+
+    const double n = static_cast<double>(paths.size());
+    printf("Group of %zu models: %zu images\n\n", group.size(), paths.size());
+    printf("%-12s %12s %12s\n", "mode", "ms/img", "img/s");
+    printf("%-12s %12.3f %12.1f\n", "separate", separate_ms / n, n * 1000.0 / separate_ms);
+    printf("%-12s %12.3f %12.1f\n", "group", group_ms / n, n * 1000.0 / group_ms);
+    printf("\n%s\n", group.statsJson().c_str());
+
+    int mismatches = 0;
+    for (size_t i = 0; i < separate_counts.size(); i++) {
+        if (separate_counts[i] != group_counts[i]) mismatches++;
+    }
+    printf("\ndetection count mismatches %d of %zu\n", mismatches, separate_counts.size());
+    return 0;
+}
+
+// Reading and converting every frame of a video against sparse scans that
+// only convert sampled frames (grab-only skipping, then with keyframe seeks)
+int benchVideo(const char* model_path, const char* video_path, double interval_s) {
+    if (!videoScanAvailable()) {
+        fprintf(stderr, "Built without OpenCV videoio\n");
+        return 1;
+    }
+    YoloDetector detector;
+    if (!detector.init(model_path)) {
+        fprintf(stderr, "Failed to load %s\n", model_path);
+        return 1;
+    }
+
+    printf("Video %s, one frame every %.2f s\n\n", video_path, interval_s);
+    printf("%-12s %10s %8s %8s %12s %12s %12s %10s\n",
+           "mode", "wall ms", "sampled", "seeks", "decode ms", "convert ms", "detect ms", "x realtime");
+
+#if YOLO_USE_OPENCV
+    {
+        cv::VideoCapture capture(video_path);
+        if (!capture.isOpened()) {
+            fprintf(stderr, "Could not open %s\n", video_path);
+            return 1;
+        }
+        double fps = capture.get(cv::CAP_PROP_FPS);
+        if (!(fps > 0.0)) fps = 30.0;
+        const int64_t step = std::max<int64_t>(1, std::llround(interval_s * fps));
+
+        cv::Mat image;
+        std::vector<Detection> detections;
+        std::vector<float> embeddings;
+        int width = 0;
+        int height = 0;
+        int64_t frames = 0;
+        int sampled = 0;
+        double read_ms = 0.0;
+        double detect_ms = 0.0;
+        auto start = steady_clock::now();
+        while (true) {
+            auto t0 = steady_clock::now();
+            if (!capture.read(image)) break;
+            read_ms += duration<double, std::milli>(steady_clock::now() - t0).count();
+            if (frames++ % step != 0) continue;
+
+            FrameView frame;
+            frame.geometry.format = SourceFormat::BGR;
+            frame.geometry.width = image.cols;
+            frame.geometry.height = image.rows;
+            frame.geometry.stride = static_cast<int>(image.step);
+            frame.data = image.data;
+            t0 = steady_clock::now();
+            detector.detectBoxes(YoloDetector::viewSource(frame), 0.25f, 0.45f, false,
+                                 detections, embeddings, width, height);
+            detect_ms += duration<double, std::milli>(steady_clock::now() - t0).count();
+            sampled++;
+        }
+        const double wall_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+        printf("%-12s %10.1f %8d %8d %12.1f %12s %12.1f %10.2f\n", "read-all", wall_ms, sampled, 0,
+               read_ms, "(in decode)", detect_ms, wall_ms > 0.0 ? frames / fps * 1000.0 / wall_ms : 0.0);
+    }
+#endif
+
+    for (int keyframe_interval : {0, VideoScanOptions().keyframe_interval}) {
+        VideoScanOptions options;
+        options.interval_s = interval_s;
+        options.keyframe_interval = keyframe_interval;
+        std::string json = runVideoScan(video_path, options, [&](const FrameView& frame, const FrameTiming& timing) {
+            return detector.detectJson(YoloDetector::viewSource(frame), 0.25f, 0.45f, timing);
+        });
+        if (json.compare(0, 9, "{\"error\":") == 0) {
+            fprintf(stderr, "%s\n", json.c_str());
+            return 1;
+        }
+        auto field = [&](const char* key) {
+            std::string needle = std::string("\"") + key + "\":";
+            size_t pos = json.find(needle);
+            return pos == std::string::npos ? 0.0 : atof(json.c_str() + pos + needle.size());
+        };
+        printf("%-12s %10.1f %8d %8d %12.1f %12.1f %12.1f %10.2f\n",
+               keyframe_interval > 0 ? "grab+seek" : "grab", field("wall_ms"),
+               static_cast<int>(field("sampled")), static_cast<int>(field("seeks")), field("decode_ms"),
+               field("convert_ms"), field("detect_ms"), field("realtime_factor"));
+    }
+    return 0;
+}
+
+// Resident set size of this process in MB
+double residentMb() {
+    long pages = 0;
+    long resident = 0;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (f == nullptr) return 0.0;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+    fclose(f);
+    return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+// Resident set size after returning freed heap memory to the system, so
+// memory kept by the allocator from earlier work is not counted
+double trimmedResidentMb() {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+    return residentMb();
+}
+
+// Copy of a packed 3-byte image scaled to width x height (nearest neighbour)
+DecodedImage scaledFrame(const DecodedImage& image, int width, int height) {
+    auto pixels = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(width) * height * 3);
+    for (int y = 0; y < height; y++) {
+        const uint8_t* src_row = image.data + static_cast<size_t>(y * image.height / height) * image.stride;
+        uint8_t* dst_row = pixels->data() + static_cast<size_t>(y) * width * 3;
+        for (int x = 0; x < width; x++) {
+            memcpy(dst_row + x * 3, src_row + (x * image.width / width) * 3, 3);
+        }
+    }
+    DecodedImage frame;
+    frame.format = image.format;
+    frame.width = width;
+    frame.height = height;
+    frame.stride = width * 3;
+    frame.data = pixels->data();
+    frame.storage = pixels;
+    return frame;
+}
+
+// Capacity planner: sweeps camera resolution, replicas x intra-op threads
+// (how the cores are split between concurrent sessions) and batch size on
+// this host. Each configuration runs saturated for a fixed time with every
+// replica sampling, inferring and decoding on its own thread; frame latency
+// is the time of the batch the frame was in. A configuration sustains
+// throughput * kPlanUtilization / target_fps streams if its p99 latency
+// meets the SLO. Saturated latency is an upper bound for the planned load.
+// Memory is the resident size a configuration adds to the process as it was
+// before its replicas loaded.
+int benchPlan(const char* model_path, const char* images, double target_fps, double slo_ms, double seconds) {
+    constexpr double kPlanUtilization = 0.8;    // headroom for bursts and other work on the host
+    const int kResolutions[][2] = {{640, 480}, {1280, 720}, {1920, 1080}};
+    const int kBatches[] = {1, 2, 4};
+
+    struct stat st;
+    std::vector<std::string> paths;
+    if (stat(images, &st) == 0 && S_ISDIR(st.st_mode)) {
+        paths = listImageFiles(images);
+    } else {
+        paths.push_back(images);
+    }
+    std::vector<DecodedImage> sources;
+    for (const auto& path : paths) {
+        DecodedImage image;
+        if (decodeImageFile(path.c_str(), image) && image.stride >= image.width * 3 &&
+            (image.format == SourceFormat::BGR || image.format == SourceFormat::RGB)) {
+            sources.push_back(image);
+        }
+        if (sources.size() >= 8) break;
+    }
+    if (sources.empty()) {
+        fprintf(stderr, "No decodable images in %s\n", images);
+        return 1;
+    }
+
+    // Plan for the whole host, not the default pool budget
+    const int original_budget = threadBudget();
+    const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> replica_counts;
+    for (int replicas = 1; replicas <= cores; replicas *= 2) {
+        replica_counts.push_back(replicas);
+    }
+
+    struct Config {
+        int width;
+        int height;
+        int replicas;
+        int threads;
+        int batch;
+        double fps;
+        double p50_ms;
+        double p99_ms;
+        double rss_mb;          // resident memory the configuration adds
+        double cpu_ms;          // CPU time per frame
+        double mj;              // package energy per frame
+        int streams;
+    };
+    std::vector<Config> configs;
+
+    printf("Capacity plan %s: target %.1f fps per stream, p99 <= %.1f ms, %d cores, %.1f s per config\n\n",
+           model_path, target_fps, slo_ms, cores, seconds);
+    EnergyMeter meter;
+    if (!meter.hasEnergy()) {
+        printf("Package energy n/a: %s\n\n", meter.reason().c_str());
+    }
+    printf("%-10s %8s %8s %6s %10s %9s %9s %9s %9s %9s %8s\n", "frame", "replicas", "threads", "batch", "fps",
+           "p50 ms", "p99 ms", "mem MB", "cpu ms/f", "mJ/f", "streams");
+
+    for (int replicas : replica_counts) {
+        const int threads = std::max(1, cores / replicas);
+        setThreadBudget(threads);
+        const double baseline_mb = trimmedResidentMb();
+        std::vector<std::unique_ptr<YoloDetector>> detectors;
+        for (int r = 0; r < replicas; r++) {
+            auto detector = std::make_unique<YoloDetector>();
+            detector->setIntraOpThreads(threads);
+            if (!detector->init(model_path)) {
+                fprintf(stderr, "Failed to load %s\n", model_path);
+                setThreadBudget(original_budget);
+                return 1;
+            }
+            detectors.push_back(std::move(detector));
+        }
+        const YoloDetector& model = *detectors.front();
+        const int input_width = model.inputWidth();
+        const int input_height = model.inputHeight();
+        const size_t plane = static_cast<size_t>(3) * input_width * input_height;
+
+        // Batch size outermost: the inference arena only grows, so each
+        // configuration's memory includes the arena for its own batch size
+        // and none left over from a larger one
+        for (int batch : kBatches) {
+            const int64_t shape[4] = {batch, 3, input_height, input_width};
+            bool supported = true;
+
+            for (const auto& resolution : kResolutions) {
+                std::vector<DecodedImage> frames;
+                for (const auto& source : sources) {
+                    frames.push_back(scaledFrame(source, resolution[0], resolution[1]));
+                }
+                SamplingPlan plan;
+                plan.build(frames[0].view().geometry, input_width, input_height, model.letterboxInput());
+
+                // One pass per replica: warm-up, and a check that the model
+                // accepts this batch size
+                std::vector<std::vector<float>> tensors(replicas, std::vector<float>(plane * batch));
+                for (int r = 0; r < replicas && supported; r++) {
+                    for (int b = 0; b < batch; b++) {
+                        plan.sample(frames[b % frames.size()].view(), model.inputFormat(), tensors[r].data() + plane * b);
+                    }
+                    TensorRun run;
+                    supported = detectors[r]->runTensor(tensors[r].data(), shape, 4, run) == DetectStatus::Ok;
+                }
+                if (!supported) {
+                    printf("%4dx%-5d %8d %8d %6d %10s\n", resolution[0], resolution[1], replicas, threads, batch,
+                           "unsupported (fixed batch dimension)");
+                    break;
+                }
+
+                std::vector<std::vector<double>> latencies(replicas);
+                std::vector<int64_t> frame_counts(replicas, 0);
+                std::vector<std::thread> workers;
+                const EnergyMeter::Reading energy_before = meter.read();
+                const auto start = steady_clock::now();
+                const auto deadline = start + duration_cast<steady_clock::duration>(duration<double>(seconds));
+                for (int r = 0; r < replicas; r++) {
+                    workers.emplace_back([&, r]() {
+                        YoloDetector& detector = *detectors[r];
+                        std::unique_ptr<OutputDecoder> decoder = detector.createDecoder();
+                        CandidateFilter filter;
+                        std::vector<OutputTensor> views;
+                        std::vector<HeadBox> candidates;
+                        TensorRun run;
+                        size_t next = r;
+                        while (steady_clock::now() < deadline) {
+                            const auto t0 = steady_clock::now();
+                            for (int b = 0; b < batch; b++) {
+                                plan.sample(frames[next++ % frames.size()].view(), detector.inputFormat(),
+                                            tensors[r].data() + plane * b);
+                            }
+                            if (detector.runTensor(tensors[r].data(), shape, 4, run) != DetectStatus::Ok) break;
+
+                            // Decode each image of the batch from its slice of the outputs
+                            for (int b = 0; b < batch; b++) {
+                                views.clear();
+                                for (size_t o = 0; o < detector.detectionOutputCount() && o < run.outputs.size(); o++) {
+                                    OutputTensor view = run.outputs[o];
+                                    view.count /= batch;
+                                    view.data += view.count * b;
+                                    if (!view.shape.empty()) view.shape[0] = 1;
+                                    views.push_back(std::move(view));
+                                }
+                                candidates.clear();
+                                decoder->decode(views, filter, candidates);
+                                detector.finishCandidates(candidates,
+                                                          detector.tensorMapping(resolution[0], resolution[1],
+                                                                                 plan.scale(), plan.padX(), plan.padY()),
+                                                          resolution[0], resolution[1], 0.45f,
+                                                          decoder->suppressed(), false);
+                            }
+                            const double ms = duration<double, std::milli>(steady_clock::now() - t0).count();
+                            latencies[r].insert(latencies[r].end(), batch, ms);
+                            frame_counts[r] += batch;
+                        }
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                const double wall_s = duration<double>(steady_clock::now() - start).count();
+                const EnergyMeter::Reading energy_after = meter.read();
+
+                std::vector<double> all;
+                int64_t total_frames = 0;
+                for (int r = 0; r < replicas; r++) {
+                    all.insert(all.end(), latencies[r].begin(), latencies[r].end());
+                    total_frames += frame_counts[r];
+                }
+                if (all.empty()) continue;
+                std::sort(all.begin(), all.end());
+
+                Config config;
+                config.width = resolution[0];
+                config.height = resolution[1];
+                config.replicas = replicas;
+                config.threads = threads;
+                config.batch = batch;
+                config.fps = total_frames / wall_s;
+                config.p50_ms = all[all.size() / 2];
+                config.p99_ms = all[std::min(all.size() - 1, static_cast<size_t>(all.size() * 0.99))];
+                config.rss_mb = std::max(0.0, trimmedResidentMb() - baseline_mb);
+                config.cpu_ms = (energy_after.cpu_s - energy_before.cpu_s) * 1000.0 / total_frames;
+                config.mj = (energy_after.energy_j - energy_before.energy_j) * 1000.0 / total_frames;
+                config.streams = config.p99_ms <= slo_ms
+                                 ? static_cast<int>(config.fps * kPlanUtilization / target_fps)
+                                 : 0;
+                configs.push_back(config);
+                char energy[32] = "n/a";
+                if (meter.hasEnergy()) snprintf(energy, sizeof(energy), "%.1f", config.mj);
+                printf("%4dx%-5d %8d %8d %6d %10.1f %9.1f %9.1f %9.0f %9.2f %9s %8d\n", config.width, config.height,
+                       config.replicas, config.threads, config.batch, config.fps, config.p50_ms, config.p99_ms,
+                       config.rss_mb, config.cpu_ms, energy, config.streams);
+            }
+            // Larger batches fail the same way
+            if (!supported) break;
+        }
+    }
+
+    setThreadBudget(original_budget);
+
+    // Most streams per resolution; ties go to the smaller memory footprint
+    printf("\nRecommended (%.0f%% utilization):\n", kPlanUtilization * 100.0);
+    for (const auto& resolution : kResolutions) {
+        const Config* best = nullptr;
+        for (const Config& config : configs) {
+            if (config.width != resolution[0] || config.height != resolution[1]) continue;
+            if (best == nullptr || config.streams > best->streams ||
+                (config.streams == best->streams && config.rss_mb < best->rss_mb)) {
+                best = &config;
+            }
+        }
+        if (best == nullptr || best->streams == 0) {
+            printf("  %dx%d: no configuration meets %.1f fps with p99 <= %.1f ms\n",
+                   resolution[0], resolution[1], target_fps, slo_ms);
+            continue;
+        }
+        printf("  %dx%d: %d replicas x %d threads, batch %d -> %d streams (%.1f fps total, p99 %.1f ms, %.0f MB)\n",
+               resolution[0], resolution[1], best->replicas, best->threads, best->batch, best->streams,
+               best->fps, best->p99_ms, best->rss_mb);
+    }
+    return 0;
+}
+
+// Energy and CPU time per frame of each stage (image decode, preprocessing,
+// inference, output decoding), each run in isolation over the same images,
+// for thread profiles from one thread (efficiency) to every hardware thread
+// (latency)
+int benchEnergy(const char* model_path, const char* images, int iterations) {
+    struct stat st;
+    std::vector<std::string> paths;
+    if (stat(images, &st) == 0 && S_ISDIR(st.st_mode)) {
+        paths = listImageFiles(images);
+    } else {
+        paths.push_back(images);
+    }
+    if (paths.size() > 16) paths.resize(16);
+    if (paths.empty()) {
+        fprintf(stderr, "No images in %s\n", images);
+        return 1;
+    }
+
+    EnergyMeter meter;
+    printf("Energy %s: %zu images x %d\n", model_path, paths.size(), iterations);
+    if (!meter.hasEnergy()) {
+        printf("Package energy n/a: %s; reporting CPU time only\n", meter.reason().c_str());
+    }
+    printf("\n%-8s %-12s %10s %14s %12s\n", "threads", "stage", "ms/frame", "cpu ms/frame", "mJ/frame");
+
+    const int original_budget = threadBudget();
+    const int hardware = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::vector<int> profiles = {1, std::max(1, hardware / 2), hardware};
+    profiles.erase(std::unique(profiles.begin(), profiles.end()), profiles.end());
+
+    const size_t n = paths.size();
+    for (int threads : profiles) {
+        setThreadBudget(threads);
+        YoloDetector detector;
+        detector.setIntraOpThreads(threads);
+        if (!detector.init(model_path)) {
+            fprintf(stderr, "Failed to load %s\n", model_path);
+            setThreadBudget(original_budget);
+            return 1;
+        }
+        const int input_width = detector.inputWidth();
+        const int input_height = detector.inputHeight();
+        const int64_t shape[4] = {1, 3, input_height, input_width};
+        std::unique_ptr<OutputDecoder> decoder = detector.createDecoder();
+        StreamContext stream("energy");
+
+        std::vector<DecodedImage> decoded(n);
+        std::vector<std::vector<float>> tensors(n, std::vector<float>(static_cast<size_t>(3) * input_width * input_height));
+        std::vector<float> scales(n, 1.0f);
+        std::vector<int> pad_x(n, 0);
+        std::vector<int> pad_y(n, 0);
+        std::vector<TensorRun> runs(n);
+        CandidateFilter filter;
+        std::vector<OutputTensor> views;
+        std::vector<HeadBox> candidates;
+
+        const std::pair<const char*, std::function<bool(size_t)>> stages[] = {
+            {"decode", [&](size_t i) { return decodeImageFile(paths[i].c_str(), decoded[i]); }},
+            {"preprocess", [&](size_t i) {
+                stream.sample(decoded[i].view(), input_width, input_height, detector.letterboxInput(),
+                              detector.inputFormat(), tensors[i].data(), scales[i], pad_x[i], pad_y[i]);
+                return true;
+            }},
+            {"inference", [&](size_t i) {
+                return detector.runTensor(tensors[i].data(), shape, 4, runs[i]) == DetectStatus::Ok;
+            }},
+            {"postprocess", [&](size_t i) {
+                views.assign(runs[i].outputs.begin(),
+                             runs[i].outputs.begin() + std::min(runs[i].outputs.size(), detector.detectionOutputCount()));
+                candidates.clear();
+                decoder->decode(views, filter, candidates);
+                detector.finishCandidates(candidates,
+                                          detector.tensorMapping(decoded[i].width, decoded[i].height,
+                                                                 scales[i], pad_x[i], pad_y[i]),
+                                          decoded[i].width, decoded[i].height, 0.45f, decoder->suppressed(), true);
+                return true;
+            }},
+        };
+
+        // Warm-up pass, which also checks every image makes it through
+        for (const auto& stage : stages) {
+            for (size_t i = 0; i < n; i++) {
+                if (!stage.second(i)) {
+                    fprintf(stderr, "%s failed for %s\n", stage.first, paths[i].c_str());
+                    setThreadBudget(original_budget);
+                    return 1;
+                }
+            }
+        }
+
+        double total_ms = 0.0;
+        double total_cpu_ms = 0.0;
+        double total_mj = 0.0;
+        const double frames = static_cast<double>(n) * iterations;
+        for (const auto& stage : stages) {
+            const EnergyMeter::Reading before = meter.read();
+            const auto start = steady_clock::now();
+            for (int it = 0; it < iterations; it++) {
+                for (size_t i = 0; i < n; i++) {
+                    stage.second(i);
+                }
+            }
+            const double ms = duration<double, std::milli>(steady_clock::now() - start).count() / frames;
+            const EnergyMeter::Reading after = meter.read();
+            const double cpu_ms = (after.cpu_s - before.cpu_s) * 1000.0 / frames;
+            const double mj = (after.energy_j - before.energy_j) * 1000.0 / frames;
+            total_ms += ms;
+            total_cpu_ms += cpu_ms;
+            total_mj += mj;
+            if (meter.hasEnergy()) {
+                printf("%-8d %-12s %10.3f %14.3f %12.2f\n", threads, stage.first, ms, cpu_ms, mj);
+            } else {
+                printf("%-8d %-12s %10.3f %14.3f %12s\n", threads, stage.first, ms, cpu_ms, "n/a");
+            }
+        }
+        if (meter.hasEnergy()) {
+            printf("%-8d %-12s %10.3f %14.3f %12.2f\n\n", threads, "total", total_ms, total_cpu_ms, total_mj);
+        } else {
+            printf("%-8d %-12s %10.3f %14.3f %12s\n\n", threads, "total", total_ms, total_cpu_ms, "n/a");
+        }
+    }
+    setThreadBudget(original_budget);
+    return 0;
+}
+
+// MJPEG stream ingest: byte-by-byte marker search with sequential full-size
+// decodes (what a Dart-side parser does) against MjpegIngest, with and
+// without detection. The sequential pass parses the file from memory (its
+// read is not timed); MjpegIngest reads it on its own thread.
+int benchMjpeg(const char* model_path, const char* mjpeg_path, int threads, int scale) {
+    YoloDetector detector;
+    if (!detector.init(model_path)) {
+        fprintf(stderr, "Failed to load %s\n", model_path);
+        return 1;
+    }
+
+    std::vector<Detection> detections;
+    std::vector<float> embeddings;
+    auto detectImage = [&](const DecodedImage& image) {
+        int width = 0;
+        int height = 0;
+        detector.detectBoxes(YoloDetector::viewSource(image.view()), 0.25f, 0.45f, false,
+                             detections, embeddings, width, height);
+    };
+
+    printf("MJPEG %s\n\n", mjpeg_path);
+    printf("%-22s %8s %8s %10s %10s %12s %10s\n",
+           "mode", "detect", "frames", "wall ms", "fps", "decode ms/f", "wait ms");
+
+    for (bool detect : {false, true}) {
+        FILE* f = fopen(mjpeg_path, "rb");
+        if (f == nullptr) {
+            fprintf(stderr, "Could not open %s\n", mjpeg_path);
+            return 1;
+        }
+        std::vector<uint8_t> stream;
+        uint8_t chunk[65536];
+        size_t n = 0;
+        while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+            stream.insert(stream.end(), chunk, chunk + n);
+        }
+        fclose(f);
+
+        int frames = 0;
+        double decode_ms = 0.0;
+        auto start = steady_clock::now();
+        size_t begin = std::string::npos;
+        for (size_t i = 0; i + 1 < stream.size(); i++) {
+            if (stream[i] != 0xFF) continue;
+            if (stream[i + 1] == 0xD8 && begin == std::string::npos) {
+                begin = i;
+            } else if (stream[i + 1] == 0xD9 && begin != std::string::npos) {
+                DecodedImage image;
+                auto t0 = steady_clock::now();
+                const bool ok = decodeImageMemory(stream.data() + begin, i + 2 - begin, image);
+                decode_ms += duration<double, std::milli>(steady_clock::now() - t0).count();
+                if (ok) {
+                    if (detect) detectImage(image);
+                    frames++;
+                }
+                begin = std::string::npos;
+            }
+        }
+        const double wall_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+        printf("%-22s %8s %8d %10.1f %10.1f %12.2f %10s\n", "sequential", detect ? "yes" : "no", frames,
+               wall_ms, wall_ms > 0.0 ? frames * 1000.0 / wall_ms : 0.0, frames > 0 ? decode_ms / frames : 0.0,
+               "-");
+
+        for (int decode_threads : {1, threads}) {
+            MjpegIngestOptions options;
+            options.decode_threads = decode_threads;
+            options.decode_scale = scale;
+            options.min_width = detector.inputWidth();
+            options.min_height = detector.inputHeight();
+
+            frames = 0;
+            int used_scale = 1;
+            start = steady_clock::now();
+            std::string stats;
+            {
+                MjpegIngest ingest{std::string(mjpeg_path), options};
+                MjpegFrame frame;
+                while (ingest.next(frame)) {
+                    if (detect) detectImage(frame.image);
+                    used_scale = frame.scale;
+                    frames++;
+                }
+                stats = ingest.statsJson();
+            }
+            const double total_ms = duration<double, std::milli>(steady_clock::now() - start).count();
+            auto field = [&](const char* key) {
+                std::string needle = std::string("\"") + key + "\":";
+                size_t pos = stats.find(needle);
+                return pos == std::string::npos ? 0.0 : atof(stats.c_str() + pos + needle.size());
+            };
+            char mode[32];
+            snprintf(mode, sizeof(mode), "ingest %dt 1/%d", decode_threads, used_scale);
+            printf("%-22s %8s %8d %10.1f %10.1f %12.2f %10.1f\n", mode, detect ? "yes" : "no", frames, total_ms,
+                   total_ms > 0.0 ? frames * 1000.0 / total_ms : 0.0, field("mean_decode_ms"),
+                   field("consumer_wait_ms"));
+            if (decode_threads == threads) break;
+        }
+    }
+    printf("\nsequential: byte-by-byte SOI/EOI search, full-size decode, one frame at a time\n");
+    printf("wait ms: time the consumer waited for a decoded frame (0 = decode keeps up)\n");
+    return 0;
+}
+
+void printUsage() {
+    printf("Usage:\n");
+    printf("  yolo_bench preprocess [width height [iterations]]\n");
+    printf("  yolo_bench load <libflutter_yolo_open_kit.so> [iterations]\n");
+    printf("  yolo_bench pool [threads [iterations]]\n");
+    printf("  yolo_bench scan <image directory> [depth]\n");
+    printf("  yolo_bench delta <detection log> [keyframe interval]\n");
+    printf("  yolo_bench fold <model.onnx> <image file or directory>\n");
+    printf("  yolo_bench pipeline <model.onnx> <image directory> [depth]\n");
+    printf("  yolo_bench backends <model.onnx> <image file or directory> [iterations]\n");
+    printf("  yolo_bench group <image directory> <model.onnx> <model.onnx> [...]\n");
+    printf("  yolo_bench video <model.onnx> <video file> [interval seconds]\n");
+    printf("  yolo_bench plan <model.onnx> <image file or directory> [fps per stream [p99 ms [seconds per config]]]\n");
+    printf("  yolo_bench energy <model.onnx> <image file or directory> [iterations]\n");
+    printf("  yolo_bench mjpeg <model.onnx> <mjpeg file> [decode threads [scale]]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+
+    if (command == "preprocess") {
+        int width = argc > 3 ? atoi(argv[2]) : 1280;
+        int height = argc > 3 ? atoi(argv[3]) : 720;
+        int iterations = argc > 4 ? atoi(argv[4]) : 200;
+        return benchPreprocess(width, height, iterations);
+    }
+
+    if (command == "load" && argc > 2) {
+        int iterations = argc > 3 ? atoi(argv[3]) : 20;
+        return benchLoad(argv[2], iterations);
+    }
+
+    if (command == "pool") {
+        int threads = argc > 2 ? atoi(argv[2]) : threadBudget();
+        int iterations = argc > 3 ? atoi(argv[3]) : 100;
+        return benchPool(threads, iterations);
+    }
+
+    if (command == "scan" && argc > 2) {
+        int depth = argc > 3 ? atoi(argv[3]) : PrefetchConfig().depth;
+        return benchScan(argv[2], depth);
+    }
+
+    if (command == "delta" && argc > 2) {
+        int keyframe_interval = argc > 3 ? atoi(argv[3]) : 30;
+        return benchDelta(argv[2], keyframe_interval);
+    }
+
+    if (command == "fold" && argc > 3) {
+        return benchFold(argv[2], argv[3]);
+    }
+
+    if (command == "pipeline" && argc > 3) {
+        int depth = argc > 4 ? atoi(argv[4]) : PipelineConfig().depth;
+        return benchPipeline(argv[2], argv[3], depth);
+    }
+
+    if (command == "backends" && argc > 3) {
+        int iterations = argc > 4 ? atoi(argv[4]) : 3;
+        return benchBackends(argv[2], argv[3], std::max(1, iterations));
+    }
+
+    if (command == "group" && argc > 3) {
+        return benchGroup(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+    }
+
+    if (command == "video" && argc > 3) {
+        double interval_s = argc > 4 ? atof(argv[4]) : 1.0;
+        return benchVideo(argv[2], argv[3], interval_s);
+    }
+
+    if (command == "plan" && argc > 3) {
+        double target_fps = argc > 4 ? atof(argv[4]) : 10.0;
+        double slo_ms = argc > 5 ? atof(argv[5]) : 200.0;
+        double seconds = argc > 6 ? atof(argv[6]) : 3.0;
+        return benchPlan(argv[2], argv[3], std::max(0.1, target_fps), slo_ms, std::max(0.5, seconds));
+    }
+
+    if (command == "energy" && argc > 3) {
+        int iterations = argc > 4 ? atoi(argv[4]) : 5;
+        return benchEnergy(argv[2], argv[3], std::max(1, iterations));
+    }
+
+    if (command == "mjpeg" && argc > 3) {
+        int threads = argc > 4 ? atoi(argv[4]) : threadBudget();
+        int scale = argc > 5 ? atoi(argv[5]) : 0;
+        return benchMjpeg(argv[2], argv[3], std::max(1, threads), scale);
+    }
+
+    printUsage();
+    return 1;
+}
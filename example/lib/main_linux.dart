@@ -1,7 +1,6 @@
 import 'dart:async';
 import 'dart:io';
 import 'dart:isolate';
-import 'dart:typed_data';
 import 'dart:ui' as ui;
 
 import 'package:flutter/material.dart';
@@ -690,7 +689,13 @@ class DetectionPainter extends CustomPainter {
   bool shouldRepaint(covariant CustomPainter oldDelegate) => true;
 }
 
-/// FFmpeg pipe-based frame extractor for efficient sequential playback
+/// FFmpeg pipe-based frame source for efficient sequential playback.
+///
+/// ffmpeg writes MJPEG into a FIFO that the plugin reads natively: frames
+/// are split from the byte stream, decoded several at a time at reduced
+/// scale and detected in order, so no JPEG bytes pass through Dart. Use it
+/// from the detection isolate; [nextResult] blocks until the next frame has
+/// been detected.
 class FFmpegPipeExtractor {
   final String videoPath;
   final int width;
@@ -698,20 +703,11 @@ class FFmpegPipeExtractor {
   final double fps;
 
   Process? _process;
-  StreamSubscription<List<int>>? _subscription;
-  bool _isRunning = false;
+  MjpegIngest? _ingest;
+  String? _fifoPath;
+  double _startPosition = 0;
   double _currentPosition = 0;
 
-  // Buffer for accumulating bytes
-  final List<int> _buffer = [];
-  final _frameCompleter = <Completer<Uint8List?>>[];
-
-  // JPEG markers
-  static const int _jpegStart1 = 0xFF;
-  static const int _jpegStart2 = 0xD8;
-  static const int _jpegEnd1 = 0xFF;
-  static const int _jpegEnd2 = 0xD9;
-
   FFmpegPipeExtractor({
     required this.videoPath,
     required this.width,
@@ -719,19 +715,35 @@ class FFmpegPipeExtractor {
     this.fps = 5.0,
   });
 
-  bool get isRunning => _isRunning;
+  bool get isRunning => _ingest != null;
   double get currentPosition => _currentPosition;
 
+  /// Frames read / delivered / dropped and delivered fps of the native ingest
+  Map<String, dynamic> get stats => _ingest?.stats ?? {};
+
   /// Start extracting frames from the given position
   Future<void> start(double startSeconds) async {
     await stop();
 
+    _startPosition = startSeconds;
     _currentPosition = startSeconds;
-    _buffer.clear();
+
+    final tempDir = await getTemporaryDirectory();
+    final fifoPath =
+        '${tempDir.path}/yolo_mjpeg_${pid}_${DateTime.now().microsecondsSinceEpoch}';
+    final mkfifo = await Process.run('mkfifo', [fifoPath]);
+    if (mkfifo.exitCode != 0) {
+      debugPrint('FFmpeg: mkfifo failed: ${mkfifo.stderr}');
+      return;
+    }
+    _fifoPath = fifoPath;
 
     debugPrint('FFmpeg: Starting from $startSeconds for $videoPath');
 
-    // Start ffmpeg outputting JPEG frames to stdout
+    // The native reader opens the FIFO without waiting for ffmpeg
+    _ingest = FlutterYoloOpenKit.instance.openMjpeg(fifoPath);
+
+    // Start ffmpeg writing JPEG frames into the FIFO
     _process = await Process.start('ffmpeg', [
       '-ss', startSeconds.toStringAsFixed(2),
       '-i', videoPath,
@@ -739,11 +751,10 @@ class FFmpegPipeExtractor {
       '-f', 'image2pipe',
       '-vcodec', 'mjpeg',
       '-q:v', '5',
-      '-',
+      '-y',
+      fifoPath,
     ]);
 
-    _isRunning = true;
-
     // Log stderr for debugging
     _process!.stderr.transform(const SystemEncoding().decoder).listen((data) {
       // Only print errors, not progress
@@ -751,114 +762,24 @@ class FFmpegPipeExtractor {
         debugPrint('FFmpeg stderr: $data');
       }
     });
-
-    // Start listening to stdout and parse JPEG frames
-    _subscription = _process!.stdout.listen(
-      (chunk) {
-        _buffer.addAll(chunk);
-
-        // Prevent buffer from growing too large (max 500KB)
-        // If too large, discard old data to keep only recent frames
-        if (_buffer.length > 500000) {
-          debugPrint('FFmpeg: Buffer too large (${_buffer.length}), trimming...');
-          // Find the last JPEG start marker and keep from there
-          for (int i = _buffer.length - 2; i >= 0; i--) {
-            if (_buffer[i] == _jpegStart1 && _buffer[i + 1] == _jpegStart2) {
-              _buffer.removeRange(0, i);
-              break;
-            }
-          }
-        }
-
-        _tryExtractFrame();
-      },
-      onDone: () {
-        debugPrint('FFmpeg: Stream ended');
-        _isRunning = false;
-        // Complete any pending requests with null
-        for (final completer in _frameCompleter) {
-          if (!completer.isCompleted) {
-            completer.complete(null);
-          }
-        }
-        _frameCompleter.clear();
-      },
-      onError: (e) {
-        debugPrint('FFmpeg pipe error: $e');
-        _isRunning = false;
-      },
-    );
-
-    // Wait a bit for ffmpeg to start producing frames
-    await Future.delayed(const Duration(milliseconds: 500));
   }
 
-  void _tryExtractFrame() {
-    if (_frameCompleter.isEmpty) {
-      return;
-    }
+  /// Detect on the next frame; null once the stream has ended
+  MjpegFrameResult? nextResult({double confThreshold = 0.25}) {
+    final ingest = _ingest;
+    if (ingest == null) return null;
 
-    // Look for JPEG frame in buffer
-    int startIdx = -1;
-    int endIdx = -1;
-
-    for (int i = 0; i < _buffer.length - 1; i++) {
-      if (_buffer[i] == _jpegStart1 && _buffer[i + 1] == _jpegStart2) {
-        if (startIdx == -1) startIdx = i;
-      }
-      if (startIdx != -1 && _buffer[i] == _jpegEnd1 && _buffer[i + 1] == _jpegEnd2) {
-        endIdx = i + 2;
-        break;
-      }
-    }
-
-    if (startIdx != -1 && endIdx != -1) {
-      // Extract the JPEG frame
-      final frameBytes = Uint8List.fromList(_buffer.sublist(startIdx, endIdx));
-      _buffer.removeRange(0, endIdx);
-      _currentPosition += 1.0 / fps;
-
-      // Complete the first waiting completer
-      if (_frameCompleter.isNotEmpty) {
-        final completer = _frameCompleter.removeAt(0);
-        if (!completer.isCompleted) {
-          completer.complete(frameBytes);
-        }
-      }
-    }
-  }
-
-  /// Read the next frame as JPEG bytes
-  Future<Uint8List?> nextFrame() async {
-    if (_process == null || !_isRunning) return null;
-
-    final completer = Completer<Uint8List?>();
-    _frameCompleter.add(completer);
-
-    // Try to extract from existing buffer first
-    _tryExtractFrame();
-
-    // Wait with longer timeout (YOLO can take 500ms+)
-    try {
-      return await completer.future.timeout(
-        const Duration(seconds: 5),
-        onTimeout: () {
-          debugPrint('Frame read timeout');
-          return null;
-        },
-      );
-    } catch (e) {
-      debugPrint('Frame read error: $e');
+    final frame = ingest.detectNext(confThreshold: confThreshold);
+    if (frame == null) {
+      debugPrint('FFmpeg: Stream ended ${ingest.stats}');
       return null;
     }
+    _currentPosition = _startPosition + frame.frameIndex / fps;
+    return frame;
   }
 
   /// Stop the ffmpeg process
   Future<void> stop() async {
-    _isRunning = false;
-    await _subscription?.cancel();
-    _subscription = null;
-
     if (_process != null) {
       _process!.kill(ProcessSignal.sigterm);
       await _process!.exitCode.timeout(
@@ -871,13 +792,13 @@ class FFmpegPipeExtractor {
       _process = null;
     }
 
-    _buffer.clear();
-    for (final completer in _frameCompleter) {
-      if (!completer.isCompleted) {
-        completer.complete(null);
-      }
+    _ingest?.close();
+    _ingest = null;
+
+    if (_fifoPath != null) {
+      File(_fifoPath!).delete().ignore();
+      _fifoPath = null;
     }
-    _frameCompleter.clear();
   }
 
   void dispose() {
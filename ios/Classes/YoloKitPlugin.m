@@ -2,10 +2,81 @@
 
 // Declare extern functions to prevent dead code stripping
 extern int yolo_init(const char* model_path);
+extern int yolo_init_numa(const char* model_path);
+extern char* yolo_get_numa_info(void);
 extern char* yolo_detect_path(const char* image_path, float conf_threshold, float iou_threshold);
 extern char* yolo_detect_buffer(const uint8_t* image_data, int width, int height, int stride,
                                  float conf_threshold, float iou_threshold);
+extern char* yolo_detect_buffer_ex(const uint8_t* image_data, int width, int height, int stride,
+                                    float conf_threshold, float iou_threshold, const void* options);
+extern char* yolo_detect_frame(const void* desc, float conf_threshold, float iou_threshold,
+                               const void* options);
+extern int yolo_detect_presence(const void* input, const int32_t* class_ids, int class_count,
+                                float conf_threshold, const void* options);
+extern int yolo_detect_count(const void* input, const int32_t* class_ids, int class_count,
+                             float conf_threshold, float iou_threshold, int32_t* counts, int counts_len,
+                             const void* options);
+extern void yolo_set_embedding_output(const char* output_name, int pooled_size);
+extern int yolo_get_embedding_dim(void);
+extern void yolo_set_fold_input(int enabled);
+extern int yolo_is_input_folded(void);
+extern int yolo_set_backend(int backend);
+extern const char* yolo_get_backend_name(void);
+extern int yolo_detect_boxes(const void* input, float conf_threshold, float iou_threshold, void* boxes,
+                             int max_boxes, float* embeddings, int embedding_capacity,
+                             int32_t* image_width, int32_t* image_height, const void* options);
+extern int64_t yolo_latest_sequence(void* stream);
+extern int yolo_latest_poll(void* stream, int64_t last_sequence, void* info, void* boxes, int max_boxes);
+extern int yolo_run_tensor(const float* input, const int64_t* shape, int rank, void* outputs, int max_outputs,
+                           void** result, const void* options);
+extern void yolo_tensor_release(void* result);
+extern int yolo_get_input_size(int32_t* width, int32_t* height);
+extern char* yolo_detect_paths(const char* paths_json, float conf_threshold, float iou_threshold,
+                               const void* options);
+extern char* yolo_detect_directory(const char* directory, float conf_threshold, float iou_threshold,
+                                   const void* options);
+extern void yolo_set_batch_dedup(int max_distance);
+extern char* yolo_detect_video(const char* video_path, double interval_seconds, int keyframe_interval,
+                               float conf_threshold, float iou_threshold, const void* options);
+extern void* yolo_mjpeg_open_fd(int fd, int decode_threads, int decode_scale, int drop_late);
+extern void* yolo_mjpeg_open(const char* path, int decode_threads, int decode_scale, int drop_late);
+extern char* yolo_mjpeg_detect_next(void* ingest, float conf_threshold, float iou_threshold, const void* options);
+extern char* yolo_mjpeg_get_stats(const void* ingest);
+extern void yolo_mjpeg_close(void* ingest);
+extern int64_t yolo_now_ns(void);
+extern char* yolo_get_metrics(void);
+extern void yolo_set_scheduler_limits(int max_realtime, int max_interactive, int max_background,
+                                      int preempt_background);
+extern int yolo_cancel_background(void);
+extern char* yolo_get_scheduler_stats(void);
+extern void* yolo_log_writer_open(const char* path, const char* stream_name, const char* class_names_json);
+extern int yolo_log_write_frame(void* writer, int64_t timestamp_ns, int width, int height,
+                                const void* boxes, int count);
+extern int yolo_log_attach(void* writer);
+extern void yolo_log_writer_close(void* writer);
+extern void* yolo_log_reader_open(const char* path);
+extern int yolo_log_reader_read_frame(const void* reader, int64_t index, int64_t* timestamp_ns,
+                                      int* width, int* height, void* boxes, int max_boxes);
+extern void yolo_log_reader_close(void* reader);
+extern int64_t yolo_log_to_jsonl(const char* log_path, const char* jsonl_path);
+extern void* yolo_stream_create(const char* name);
+extern char* yolo_stream_get_metrics(const void* stream);
+extern void yolo_stream_reset_metrics(void* stream);
+extern void yolo_stream_log_attach(void* stream, void* writer);
+extern void yolo_stream_destroy(void* stream);
+extern void* yolo_delta_encoder_create(int keyframe_interval, float match_iou);
+extern int yolo_delta_encode(void* encoder, int64_t timestamp_ns, int width, int height, const void* boxes,
+                             int count, uint8_t* out, int out_capacity);
+extern void yolo_delta_request_keyframe(void* encoder);
+extern char* yolo_delta_encoder_stats(const void* encoder);
+extern void yolo_delta_encoder_destroy(void* encoder);
+extern void* yolo_delta_decoder_create(void);
+extern int yolo_delta_decode(void* decoder, const uint8_t* packet, int size, int64_t* timestamp_ns,
+                             int* width, int* height, void* boxes, int max_boxes);
+extern int yolo_delta_decoder_boxes(const void* decoder, void* boxes, int max_boxes);
+extern void yolo_delta_decoder_destroy(void* decoder);
 extern void yolo_set_classes(const char* class_names_json);
+extern char* yolo_get_classes(void);
 extern void yolo_release(void);
 extern void free_string(char* str);
 extern const char* yolo_get_version(void);
@@ -28,9 +99,58 @@ extern int yolo_is_initialized(void);
     // Force reference all symbols to prevent linker from stripping them
     if (version == NULL) {
         yolo_init("/nonexistent");
+        yolo_init_numa("/nonexistent");
+        free_string(yolo_get_numa_info());
         yolo_detect_path("/nonexistent", 0.0f, 0.0f);
         yolo_detect_buffer(NULL, 0, 0, 0, 0.0f, 0.0f);
+        yolo_detect_buffer_ex(NULL, 0, 0, 0, 0.0f, 0.0f, NULL);
+        free_string(yolo_detect_frame(NULL, 0.0f, 0.0f, NULL));
+        yolo_detect_presence(NULL, NULL, 0, 0.0f, NULL);
+        yolo_detect_count(NULL, NULL, 0, 0.0f, 0.0f, NULL, 0, NULL);
+        yolo_set_embedding_output(NULL, 1);
+        yolo_get_embedding_dim();
+        yolo_set_fold_input(0);
+        yolo_is_input_folded();
+        yolo_set_backend(0);
+        yolo_get_backend_name();
+        yolo_detect_boxes(NULL, 0.0f, 0.0f, NULL, 0, NULL, 0, NULL, NULL, NULL);
+        yolo_latest_sequence(NULL);
+        yolo_latest_poll(NULL, 0, NULL, NULL, 0);
+        yolo_run_tensor(NULL, NULL, 0, NULL, 0, NULL, NULL);
+        yolo_tensor_release(NULL);
+        yolo_get_input_size(NULL, NULL);
+        free_string(yolo_detect_paths(NULL, 0.0f, 0.0f, NULL));
+        free_string(yolo_detect_directory(NULL, 0.0f, 0.0f, NULL));
+        yolo_set_batch_dedup(-1);
+        free_string(yolo_detect_video(NULL, 0.0, 0, 0.0f, 0.0f, NULL));
+        yolo_mjpeg_close(yolo_mjpeg_open_fd(-1, 0, 1, 0));
+        yolo_mjpeg_close(yolo_mjpeg_open(NULL, 0, 1, 0));
+        free_string(yolo_mjpeg_detect_next(NULL, 0.0f, 0.0f, NULL));
+        free_string(yolo_mjpeg_get_stats(NULL));
+        yolo_now_ns();
+        free_string(yolo_get_metrics());
+        yolo_set_scheduler_limits(-1, -1, -1, -1);
+        yolo_cancel_background();
+        free_string(yolo_get_scheduler_stats());
+        yolo_log_write_frame(yolo_log_writer_open(NULL, NULL, NULL), 0, 0, 0, NULL, 0);
+        yolo_log_attach(NULL);
+        yolo_log_writer_close(NULL);
+        yolo_log_reader_read_frame(yolo_log_reader_open(NULL), 0, NULL, NULL, NULL, NULL, 0);
+        yolo_log_reader_close(NULL);
+        yolo_log_to_jsonl(NULL, NULL);
+        yolo_stream_destroy(yolo_stream_create(NULL));
+        free_string(yolo_stream_get_metrics(NULL));
+        yolo_stream_reset_metrics(NULL);
+        yolo_stream_log_attach(NULL, NULL);
+        yolo_delta_encode(yolo_delta_encoder_create(0, 0.0f), 0, 0, 0, NULL, 0, NULL, 0);
+        yolo_delta_request_keyframe(NULL);
+        free_string(yolo_delta_encoder_stats(NULL));
+        yolo_delta_encoder_destroy(NULL);
+        yolo_delta_decode(yolo_delta_decoder_create(), NULL, 0, NULL, NULL, NULL, NULL, 0);
+        yolo_delta_decoder_boxes(NULL, NULL, 0);
+        yolo_delta_decoder_destroy(NULL);
         yolo_set_classes("[]");
+        free_string(yolo_get_classes());
         yolo_release();
         free_string(NULL);
         yolo_is_initialized();
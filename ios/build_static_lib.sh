@@ -24,6 +24,30 @@ OPENCV_HEADERS="$SCRIPT_DIR/Frameworks/opencv2.framework/Headers"
 SOURCES=(
     "$SRC_DIR/yolo_detector.cpp"
     "$SRC_DIR/ffi_bridge.cpp"
+    "$SRC_DIR/sampling_plan.cpp"
+    "$SRC_DIR/image_decoder.cpp"
+    "$SRC_DIR/frame_metrics.cpp"
+    "$SRC_DIR/detection_log.cpp"
+    "$SRC_DIR/request_scheduler.cpp"
+    "$SRC_DIR/task_pool.cpp"
+    "$SRC_DIR/numa_topology.cpp"
+    "$SRC_DIR/numa_replicas.cpp"
+    "$SRC_DIR/file_prefetcher.cpp"
+    "$SRC_DIR/batch_scan.cpp"
+    "$SRC_DIR/image_hash.cpp"
+    "$SRC_DIR/head_decoder.cpp"
+    "$SRC_DIR/roi_align.cpp"
+    "$SRC_DIR/delta_stream.cpp"
+    "$SRC_DIR/onnx_rewrite.cpp"
+    "$SRC_DIR/stream_context.cpp"
+    "$SRC_DIR/output_decoder.cpp"
+    "$SRC_DIR/frame_pipeline.cpp"
+    "$SRC_DIR/inference_backend.cpp"
+    "$SRC_DIR/detector_group.cpp"
+    "$SRC_DIR/video_scan.cpp"
+    "$SRC_DIR/latest_result.cpp"
+    "$SRC_DIR/mjpeg_ingest.cpp"
+    "$SRC_DIR/json_escape.cpp"
 )
 
 # Output library name
@@ -1,6 +1,7 @@
 import 'dart:convert';
 import 'dart:ffi';
 import 'dart:io';
+import 'dart:typed_data';
 
 import 'package:ffi/ffi.dart';
 
@@ -56,6 +57,86 @@ class YoloDetection {
   }
 }
 
+/// Scheduling class of a detect call.
+///
+/// Higher classes run first when calls overlap. A queued realtime frame is
+/// superseded by a newer one (`FRAME_SHED`), a full queue rejects new calls
+/// (`QUEUE_FULL`), and a running background call is aborted when realtime or
+/// interactive work arrives (`CANCELLED`).
+enum DetectPriority {
+  /// Camera frames: only the newest queued frame is kept
+  realtime,
+
+  /// User-triggered calls (default)
+  interactive,
+
+  /// Batch and gallery scans
+  background,
+}
+
+/// Engine that runs the model; see [FlutterYoloOpenKit.setInferenceBackend]
+enum InferenceBackend {
+  /// ONNX Runtime (default), with NNAPI / Core ML acceleration on mobile
+  onnxRuntime,
+
+  /// OpenCV DNN on the CPU, loading the same `.onnx` file. It sizes
+  /// OpenCV's process-wide thread pool and cannot preempt a running
+  /// background call.
+  opencvDnn,
+}
+
+/// Pixel layout of a frame passed to [FlutterYoloOpenKit.detectFromFrame]
+/// or [DetectInput.frame]. Every layout is sampled in place straight into the
+/// model input, with no intermediate RGB frame.
+enum PixelFormat {
+  /// planes: Y, interleaved UV
+  nv12,
+
+  /// planes: Y, interleaved VU
+  nv21,
+
+  /// planes: Y, U, V
+  i420,
+
+  /// One packed plane, 3 bytes per pixel
+  rgb,
+
+  /// One packed plane, 3 bytes per pixel
+  bgr,
+
+  /// One packed plane, 4 bytes per pixel (alpha ignored)
+  rgba,
+
+  /// One packed plane, 4 bytes per pixel (alpha ignored)
+  bgra,
+
+  /// One plane, 1 byte per pixel
+  gray,
+
+  /// One packed 4:2:2 plane, Y0 U Y1 V per pixel pair
+  yuyv,
+}
+
+/// Fill a native frame descriptor; [strides] default to tightly packed rows
+void _fillFrameDesc(
+  Pointer<YoloFrameDesc> desc,
+  PixelFormat format,
+  List<Pointer<Uint8>> planes,
+  int width,
+  int height,
+  List<int> strides,
+  int rotation,
+) {
+  desc.ref.format = format.index;
+  desc.ref.width = width;
+  desc.ref.height = height;
+  desc.ref.rotation = rotation;
+  for (var i = 0; i < 3; i++) {
+    desc.ref.planes[i] = i < planes.length ? planes[i] : nullptr;
+    desc.ref.strides[i] = i < strides.length ? strides[i] : 0;
+  }
+}
+
 /// Result from YOLO detection
 class YoloResult {
   final List<YoloDetection> detections;
@@ -66,6 +147,18 @@ class YoloResult {
   final String? error;
   final String? errorCode;
 
+  /// Caller frame id passed to detect (-1 if none)
+  final int frameId;
+
+  /// Time spent waiting for the detector (ms)
+  final double queueWaitMs;
+
+  /// Time spent processing inside the detector (ms)
+  final double processingMs;
+
+  /// Capture (or native call entry) to result ready (ms)
+  final double frameAgeMs;
+
   YoloResult({
     required this.detections,
     required this.count,
@@ -74,6 +167,10 @@ class YoloResult {
     required this.imageHeight,
     this.error,
     this.errorCode,
+    this.frameId = -1,
+    this.queueWaitMs = 0,
+    this.processingMs = 0,
+    this.frameAgeMs = 0,
   });
 
   factory YoloResult.fromJson(Map<String, dynamic> json) {
@@ -99,6 +196,10 @@ class YoloResult {
       inferenceTimeMs: json['inference_time_ms'] as int,
       imageWidth: json['image_width'] as int,
       imageHeight: json['image_height'] as int,
+      frameId: (json['frame_id'] as int?) ?? -1,
+      queueWaitMs: (json['queue_wait_ms'] as num?)?.toDouble() ?? 0,
+      processingMs: (json['processing_ms'] as num?)?.toDouble() ?? 0,
+      frameAgeMs: (json['frame_age_ms'] as num?)?.toDouble() ?? 0,
     );
   }
 
@@ -113,12 +214,682 @@ class YoloResult {
   }
 }
 
+/// One file of a batch scan
+class BatchScanItem {
+  final String path;
+
+  /// Time the scan waited for this file's contents (ms)
+  final double ioWaitMs;
+
+  /// Detection result, or an error if the file could not be read or decoded
+  final YoloResult result;
+
+  /// Index of the near-duplicate image whose detections were reused, or
+  /// null if the model ran on this file
+  final int? reusedFrom;
+
+  /// dHash distance to [reusedFrom] in bits
+  final int? hashDistance;
+
+  /// Times the file was preempted by higher priority work and run again
+  final int preempted;
+
+  BatchScanItem({
+    required this.path,
+    required this.ioWaitMs,
+    required this.result,
+    this.reusedFrom,
+    this.hashDistance,
+    this.preempted = 0,
+  });
+
+  bool get reused => reusedFrom != null;
+}
+
+/// Result of [FlutterYoloOpenKit.detectFromPaths] /
+/// [FlutterYoloOpenKit.detectDirectory]
+class BatchScanResult {
+  final List<BatchScanItem> items;
+
+  /// File reader used: `io_uring` or `pread`
+  final String backend;
+  final int bytesRead;
+
+  /// Total time spent waiting for file contents (ms)
+  final double ioWaitMs;
+
+  /// Files whose detections were reused from a near-duplicate
+  final int skipped;
+
+  /// [skipped] / number of files
+  final double skipRate;
+
+  /// Runs repeated because higher priority work preempted them
+  final int preempted;
+
+  /// Whether [FlutterYoloOpenKit.cancelBackground] stopped the scan; files
+  /// not processed are listed with error code `CANCELLED`
+  final bool cancelled;
+  final String? error;
+  final String? errorCode;
+
+  BatchScanResult({
+    required this.items,
+    this.backend = '',
+    this.bytesRead = 0,
+    this.ioWaitMs = 0,
+    this.skipped = 0,
+    this.skipRate = 0,
+    this.preempted = 0,
+    this.cancelled = false,
+    this.error,
+    this.errorCode,
+  });
+
+  factory BatchScanResult.fromJson(Map<String, dynamic> json) {
+    if (json.containsKey('error')) {
+      return BatchScanResult(
+        items: [],
+        error: json['error'] as String?,
+        errorCode: json['code'] as String?,
+      );
+    }
+    final items = (json['results'] as List).map((r) {
+      final item = r as Map<String, dynamic>;
+      return BatchScanItem(
+        path: item['path'] as String,
+        ioWaitMs: (item['io_wait_ms'] as num?)?.toDouble() ?? 0,
+        result: YoloResult.fromJson(item),
+        reusedFrom: item['reused_from'] as int?,
+        hashDistance: item['hash_distance'] as int?,
+        preempted: (item['preempted'] as int?) ?? 0,
+      );
+    }).toList();
+    return BatchScanResult(
+      items: items,
+      backend: json['backend'] as String,
+      bytesRead: json['bytes_read'] as int,
+      ioWaitMs: (json['io_wait_ms'] as num).toDouble(),
+      skipped: (json['skipped'] as int?) ?? 0,
+      skipRate: (json['skip_rate'] as num?)?.toDouble() ?? 0,
+      preempted: (json['preempted'] as int?) ?? 0,
+      cancelled: (json['cancelled'] as bool?) ?? false,
+    );
+  }
+
+  bool get hasError => error != null;
+}
+
+/// One sampled frame of a video scan
+class VideoScanItem {
+  /// Frame index in the video
+  final int frameIndex;
+
+  /// Media time of the frame (seconds)
+  final double timeSeconds;
+  final YoloResult result;
+
+  VideoScanItem({
+    required this.frameIndex,
+    required this.timeSeconds,
+    required this.result,
+  });
+}
+
+/// Result of [FlutterYoloOpenKit.detectVideo]
+class VideoScanResult {
+  final List<VideoScanItem> items;
+  final double fps;
+
+  /// Frames in the video as reported by the container (0 if unknown)
+  final int frameCount;
+
+  /// Frames decoded but never converted or detected
+  final int skipped;
+
+  /// Seeks to a keyframe instead of decoding the gap
+  final int seeks;
+
+  /// Time spent decoding (grab and seek), converting sampled frames and
+  /// detecting (ms)
+  final double decodeMs;
+  final double convertMs;
+  final double detectMs;
+  final double wallMs;
+
+  /// Media seconds covered per wall-clock second
+  final double realtimeFactor;
+  final String? error;
+  final String? errorCode;
+
+  VideoScanResult({
+    required this.items,
+    this.fps = 0,
+    this.frameCount = 0,
+    this.skipped = 0,
+    this.seeks = 0,
+    this.decodeMs = 0,
+    this.convertMs = 0,
+    this.detectMs = 0,
+    this.wallMs = 0,
+    this.realtimeFactor = 0,
+    this.error,
+    this.errorCode,
+  });
+
+  factory VideoScanResult.fromJson(Map<String, dynamic> json) {
+    if (json.containsKey('error')) {
+      return VideoScanResult(
+        items: [],
+        error: json['error'] as String?,
+        errorCode: json['code'] as String?,
+      );
+    }
+    final items = (json['results'] as List).map((r) {
+      final item = r as Map<String, dynamic>;
+      return VideoScanItem(
+        frameIndex: item['frame_index'] as int,
+        timeSeconds: (item['time_s'] as num).toDouble(),
+        result: YoloResult.fromJson(item),
+      );
+    }).toList();
+    return VideoScanResult(
+      items: items,
+      fps: (json['fps'] as num).toDouble(),
+      frameCount: json['frame_count'] as int,
+      skipped: json['skipped'] as int,
+      seeks: json['seeks'] as int,
+      decodeMs: (json['decode_ms'] as num).toDouble(),
+      convertMs: (json['convert_ms'] as num).toDouble(),
+      detectMs: (json['detect_ms'] as num).toDouble(),
+      wallMs: (json['wall_ms'] as num).toDouble(),
+      realtimeFactor: (json['realtime_factor'] as num).toDouble(),
+    );
+  }
+
+  bool get hasError => error != null;
+}
+
+/// Image source for [FlutterYoloOpenKit.detectPresence] and
+/// [FlutterYoloOpenKit.detectCount], matching the detectFrom* entry points
+class DetectInput {
+  final int _kind;
+  final String? _path;
+  final Uint8List? _bytes;
+  final Pointer<Uint8> _data;
+  final Pointer<Uint8> _uData;
+  final Pointer<Uint8> _vData;
+  final int _width;
+  final int _height;
+  final int _stride;
+  final int _uvRowStride;
+  final int _uvPixelStride;
+  final int _rotation;
+  final PixelFormat? _format;
+  final List<Pointer<Uint8>> _planes;
+  final List<int> _strides;
+
+  DetectInput._(
+    this._kind, {
+    String? path,
+    Uint8List? bytes,
+    Pointer<Uint8>? data,
+    Pointer<Uint8>? uData,
+    Pointer<Uint8>? vData,
+    int width = 0,
+    int height = 0,
+    int stride = 0,
+    int uvRowStride = 0,
+    int uvPixelStride = 0,
+    int rotation = 0,
+    PixelFormat? format,
+    List<Pointer<Uint8>> planes = const [],
+    List<int> strides = const [],
+  }) : _path = path,
+       _bytes = bytes,
+       _data = data ?? nullptr,
+       _uData = uData ?? nullptr,
+       _vData = vData ?? nullptr,
+       _width = width,
+       _height = height,
+       _stride = stride,
+       _uvRowStride = uvRowStride,
+       _uvPixelStride = uvPixelStride,
+       _rotation = rotation,
+       _format = format,
+       _planes = planes,
+       _strides = strides;
+
+  /// Image file (JPEG/PNG/BMP)
+  factory DetectInput.path(String imagePath) =>
+      DetectInput._(YoloInputKind.YOLO_INPUT_PATH, path: imagePath);
+
+  /// Encoded image bytes (JPEG/PNG/BMP)
+  factory DetectInput.encoded(Uint8List bytes) =>
+      DetectInput._(YoloInputKind.YOLO_INPUT_ENCODED, bytes: bytes);
+
+  /// BGRA buffer, as for [FlutterYoloOpenKit.detectFromBuffer]
+  factory DetectInput.bgra(
+    Pointer<Uint8> imageData,
+    int width,
+    int height,
+    int stride,
+  ) => DetectInput._(
+    YoloInputKind.YOLO_INPUT_BGRA,
+    data: imageData,
+    width: width,
+    height: height,
+    stride: stride,
+  );
+
+  /// YUV420 planes, as for [FlutterYoloOpenKit.detectFromYUV]
+  factory DetectInput.yuv(
+    Pointer<Uint8> yData,
+    Pointer<Uint8> uData,
+    Pointer<Uint8> vData,
+    int width,
+    int height,
+    int yRowStride,
+    int uvRowStride,
+    int uvPixelStride, {
+    int rotation = 0,
+  }) => DetectInput._(
+    YoloInputKind.YOLO_INPUT_YUV420,
+    data: yData,
+    uData: uData,
+    vData: vData,
+    width: width,
+    height: height,
+    stride: yRowStride,
+    uvRowStride: uvRowStride,
+    uvPixelStride: uvPixelStride,
+    rotation: rotation,
+  );
+
+  /// Frame in any [PixelFormat], as for [FlutterYoloOpenKit.detectFromFrame]
+  factory DetectInput.frame(
+    PixelFormat format,
+    List<Pointer<Uint8>> planes,
+    int width,
+    int height, {
+    List<int> strides = const [],
+    int rotation = 0,
+  }) => DetectInput._(
+    YoloInputKind.YOLO_INPUT_FRAME,
+    format: format,
+    planes: planes,
+    width: width,
+    height: height,
+    strides: strides,
+    rotation: rotation,
+  );
+
+  /// Run [call] with a native copy of this input
+  T _withNative<T>(T Function(Pointer<YoloInput>) call) {
+    final input = calloc<YoloInput>();
+    Pointer<Utf8> pathPtr = nullptr;
+    Pointer<Uint8> bytesPtr = nullptr;
+    Pointer<YoloFrameDesc> framePtr = nullptr;
+    try {
+      input.ref.kind = _kind;
+      input.ref.data = _data;
+      if (_path != null) {
+        pathPtr = _path.toNativeUtf8();
+        input.ref.path = pathPtr.cast();
+      }
+      if (_bytes != null) {
+        bytesPtr = malloc<Uint8>(_bytes.length);
+        bytesPtr.asTypedList(_bytes.length).setAll(0, _bytes);
+        input.ref.data = bytesPtr;
+        input.ref.size = _bytes.length;
+      }
+      input.ref.u_data = _uData;
+      input.ref.v_data = _vData;
+      input.ref.width = _width;
+      input.ref.height = _height;
+      input.ref.stride = _stride;
+      input.ref.uv_row_stride = _uvRowStride;
+      input.ref.uv_pixel_stride = _uvPixelStride;
+      input.ref.rotation = _rotation;
+      if (_format != null) {
+        framePtr = calloc<YoloFrameDesc>();
+        _fillFrameDesc(
+          framePtr,
+          _format,
+          _planes,
+          _width,
+          _height,
+          _strides,
+          _rotation,
+        );
+        input.ref.frame = framePtr;
+      }
+      return call(input);
+    } finally {
+      if (pathPtr != nullptr) malloc.free(pathPtr);
+      if (bytesPtr != nullptr) malloc.free(bytesPtr);
+      if (framePtr != nullptr) calloc.free(framePtr);
+      calloc.free(input);
+    }
+  }
+}
+
+/// Result of [FlutterYoloOpenKit.detectPresence]
+class PresenceResult {
+  final bool present;
+
+  /// Same codes as [YoloResult.errorCode] (e.g. `IMAGE_LOAD_FAILED`)
+  final String? errorCode;
+
+  PresenceResult({required this.present, this.errorCode});
+
+  bool get hasError => errorCode != null;
+}
+
+/// Result of [FlutterYoloOpenKit.detectCount]
+class CountResult {
+  /// Detections per class id after NMS
+  final List<int> counts;
+  final int total;
+
+  /// Same codes as [YoloResult.errorCode] (e.g. `IMAGE_LOAD_FAILED`)
+  final String? errorCode;
+
+  CountResult({required this.counts, required this.total, this.errorCode});
+
+  /// Count for one class id (0 if out of range)
+  int operator [](int classId) =>
+      classId >= 0 && classId < counts.length ? counts[classId] : 0;
+
+  bool get hasError => errorCode != null;
+}
+
+/// Result of [FlutterYoloOpenKit.detectBoxes]
+class BoxResult {
+  /// Detections by descending confidence
+  final List<YoloDetection> detections;
+
+  /// One L2-normalized appearance embedding per detection (same order), or
+  /// empty if not requested or the model has no embedding output
+  final List<Float32List> embeddings;
+  final int imageWidth;
+  final int imageHeight;
+
+  /// Same codes as [YoloResult.errorCode] (e.g. `IMAGE_LOAD_FAILED`)
+  final String? errorCode;
+
+  BoxResult({
+    required this.detections,
+    this.embeddings = const [],
+    this.imageWidth = 0,
+    this.imageHeight = 0,
+    this.errorCode,
+  });
+
+  bool get hasError => errorCode != null;
+}
+
+/// Newest frame returned by [LatestResultPoller.poll]
+class LatestFrame {
+  /// Increases with every published frame
+  final int sequence;
+
+  /// Frame id given to the detect call, or -1
+  final int frameId;
+
+  /// Capture timestamp given to the detect call (0 if none)
+  final int captureTimestampNs;
+
+  /// When the result was ready ([FlutterYoloOpenKit.nowNs] clock)
+  final int endTimestampNs;
+  final int imageWidth;
+  final int imageHeight;
+
+  /// Detections by descending confidence (at most the poller's maxBoxes)
+  final List<YoloDetection> detections;
+
+  LatestFrame({
+    required this.sequence,
+    required this.frameId,
+    required this.captureTimestampNs,
+    required this.endTimestampNs,
+    required this.imageWidth,
+    required this.imageHeight,
+    required this.detections,
+  });
+}
+
+/// Polls the newest detection result without waiting for detection, e.g.
+/// once per repaint while detection runs on another isolate. Buffers are
+/// allocated once; [poll] is a lock-free copy that returns null when
+/// nothing newer has been published. Use one poller per polling thread.
+class LatestResultPoller {
+  final FlutterYoloOpenKit _kit;
+  final DetectionStream? _stream;
+  final int maxBoxes;
+  Pointer<YoloLatestInfo> _info;
+  Pointer<YoloBox> _boxes;
+  int _sequence = 0;
+
+  LatestResultPoller._(this._kit, this._stream, this.maxBoxes)
+    : _info = calloc<YoloLatestInfo>(),
+      _boxes = calloc<YoloBox>(maxBoxes);
+
+  /// Sequence of the last frame returned by [poll] (0 = none yet)
+  int get sequence => _sequence;
+
+  /// Whether a frame newer than the last [poll] result has been published
+  bool get hasUpdate =>
+      _info != nullptr &&
+      _kit._bindings.yolo_latest_sequence(_streamPtr) != _sequence;
+
+  Pointer<YoloStream> get _streamPtr => _stream?._stream ?? nullptr;
+
+  /// The newest frame, or null if it was already returned
+  LatestFrame? poll() {
+    if (_info == nullptr) return null;
+    final status = _kit._bindings.yolo_latest_poll(
+      _streamPtr,
+      _sequence,
+      _info,
+      _boxes,
+      maxBoxes,
+    );
+    if (status <= 0) return null;
+
+    final info = _info.ref;
+    _sequence = info.sequence;
+    final names = _kit.classNames;
+    final n = info.count < maxBoxes ? info.count : maxBoxes;
+    return LatestFrame(
+      sequence: info.sequence,
+      frameId: info.frame_id,
+      captureTimestampNs: info.capture_ts_ns,
+      endTimestampNs: info.end_ts_ns,
+      imageWidth: info.width,
+      imageHeight: info.height,
+      detections: List<YoloDetection>.generate(n, (i) {
+        final box = (_boxes + i).ref;
+        return YoloDetection(
+          classId: box.class_id,
+          className: box.class_id < names.length
+              ? names[box.class_id]
+              : 'class_${box.class_id}',
+          confidence: box.confidence,
+          x1: box.x1,
+          y1: box.y1,
+          x2: box.x2,
+          y2: box.y2,
+        );
+      }),
+    );
+  }
+
+  /// Free the buffers
+  void close() {
+    if (_info != nullptr) {
+      calloc.free(_boxes);
+      calloc.free(_info);
+      _boxes = nullptr;
+      _info = nullptr;
+    }
+  }
+}
+
+/// One frame detected by [MjpegIngest.detectNext]
+class MjpegFrameResult {
+  /// Position in the stream (dropped frames leave gaps)
+  final int frameIndex;
+
+  /// Scale the frame was decoded at (1 where the decoder cannot scale);
+  /// detections and image size refer to the decoded frame
+  final int decodeScale;
+  final YoloResult result;
+
+  MjpegFrameResult({
+    required this.frameIndex,
+    required this.decodeScale,
+    required this.result,
+  });
+}
+
+/// Native MJPEG byte-stream ingest (see [FlutterYoloOpenKit.openMjpeg]).
+/// Frames are split and decoded on native threads; [detectNext] blocks
+/// until the next frame is decoded, so call it from a background isolate.
+class MjpegIngest {
+  final FlutterYoloOpenKit _kit;
+  Pointer<YoloMjpegIngest> _ingest;
+
+  MjpegIngest._(this._kit, this._ingest);
+
+  /// Detect on the next frame in stream order; null at the end of the
+  /// stream (or once closed)
+  MjpegFrameResult? detectNext({
+    double confThreshold = 0.25,
+    double iouThreshold = 0.45,
+    DetectPriority priority = DetectPriority.interactive,
+    DetectionStream? stream,
+  }) {
+    if (_ingest == nullptr) return null;
+    final options = _kit._allocOptions(null, null, priority, stream);
+    try {
+      final ptr = _kit._bindings.yolo_mjpeg_detect_next(
+        _ingest,
+        confThreshold,
+        iouThreshold,
+        options,
+      );
+      if (ptr == nullptr) return null;
+      try {
+        final json =
+            jsonDecode(ptr.cast<Utf8>().toDartString())
+                as Map<String, dynamic>;
+        return MjpegFrameResult(
+          frameIndex: json['frame_index'] as int? ?? -1,
+          decodeScale: json['decode_scale'] as int? ?? 1,
+          result: YoloResult.fromJson(json),
+        );
+      } finally {
+        _kit._bindings.free_string(ptr);
+      }
+    } finally {
+      _kit._freeOptions(options);
+    }
+  }
+
+  /// Frames split / delivered / dropped / corrupt, bytes read, decode time,
+  /// `source_fps` and `delivered_fps`, and `error` if the source could not
+  /// be opened or read
+  Map<String, dynamic> get stats {
+    if (_ingest == nullptr) return {};
+    final ptr = _kit._bindings.yolo_mjpeg_get_stats(_ingest);
+    try {
+      return jsonDecode(ptr.cast<Utf8>().toDartString())
+          as Map<String, dynamic>;
+    } finally {
+      _kit._bindings.free_string(ptr);
+    }
+  }
+
+  /// Stop reading and release; no [detectNext] call may be running
+  void close() {
+    if (_ingest != nullptr) {
+      _kit._bindings.yolo_mjpeg_close(_ingest);
+      _ingest = nullptr;
+    }
+  }
+}
+
+/// One model output of [FlutterYoloOpenKit.runTensor]
+class TensorOutput {
+  final String name;
+  final List<int> shape;
+
+  /// View of native memory owned by the [TensorRunResult], valid until
+  /// [TensorRunResult.release]; null if the output is not float32
+  final Float32List? data;
+
+  TensorOutput({required this.name, required this.shape, this.data});
+}
+
+/// Outputs of [FlutterYoloOpenKit.runTensor], read in place from the
+/// inference engine's buffers. Call [release] when done.
+class TensorRunResult {
+  final FlutterYoloOpenKitBindings? _bindings;
+  Pointer<YoloTensorResult> _result;
+
+  /// Detection outputs in model order, then the embedding output if set
+  final List<TensorOutput> outputs;
+
+  /// Same codes as [YoloResult.errorCode] (e.g. `INVALID_ARGUMENT`)
+  final String? errorCode;
+
+  TensorRunResult._(
+    this._bindings,
+    this._result, {
+    this.outputs = const [],
+    this.errorCode,
+  });
+
+  bool get hasError => errorCode != null;
+
+  /// Output by name, or null
+  TensorOutput? operator [](String name) {
+    for (final output in outputs) {
+      if (output.name == name) return output;
+    }
+    return null;
+  }
+
+  /// Free the native outputs; [TensorOutput.data] views become invalid
+  void release() {
+    if (_result != nullptr) {
+      _bindings!.yolo_tensor_release(_result);
+      _result = nullptr;
+    }
+  }
+}
+
+/// Error code string for a negative YoloStatus
+String _statusCode(int status) => switch (status) {
+  YoloStatus.YOLO_ERR_NOT_INITIALIZED => 'NOT_INITIALIZED',
+  YoloStatus.YOLO_ERR_INVALID_ARGUMENT => 'INVALID_ARGUMENT',
+  YoloStatus.YOLO_ERR_IMAGE_LOAD_FAILED => 'IMAGE_LOAD_FAILED',
+  YoloStatus.YOLO_ERR_DECODER_UNAVAILABLE => 'DECODER_UNAVAILABLE',
+  YoloStatus.YOLO_ERR_QUEUE_FULL => 'QUEUE_FULL',
+  YoloStatus.YOLO_ERR_FRAME_SHED => 'FRAME_SHED',
+  _ => 'CANCELLED',
+};
+
 /// Flutter YOLO Open Kit - YOLO object detection plugin
 class FlutterYoloOpenKit {
   static FlutterYoloOpenKit? _instance;
   late final FlutterYoloOpenKitBindings _bindings;
   bool _initialized = false;
 
+  /// Class names cached by [classNames]; cleared when they may change
+  List<String>? _classNames;
+
   FlutterYoloOpenKit._() {
     _bindings = FlutterYoloOpenKitBindings(_dylib);
   }
@@ -134,6 +905,7 @@ class FlutterYoloOpenKit {
   /// [modelPath] - Path to ONNX model file (YOLOv8/v11)
   /// Returns true on success
   bool init(String modelPath) {
+    _classNames = null;
     final pathPtr = modelPath.toNativeUtf8();
     try {
       final result = _bindings.yolo_init(pathPtr.cast());
@@ -144,24 +916,77 @@ class FlutterYoloOpenKit {
     }
   }
 
+  /// Initialize in server mode: one detector per NUMA node, loaded with
+  /// node-local memory and pinned to that node's cores. Detect calls go to the
+  /// least-loaded replica. On single-node machines this behaves like [init].
+  /// Returns the number of replicas (0 on failure).
+  int initNuma(String modelPath) {
+    _classNames = null;
+    final pathPtr = modelPath.toNativeUtf8();
+    try {
+      final replicas = _bindings.yolo_init_numa(pathPtr.cast());
+      _initialized = replicas > 0;
+      return replicas;
+    } finally {
+      malloc.free(pathPtr);
+    }
+  }
+
+  /// Replica placement and load in server mode: node, cpus, in_flight,
+  /// served and scheduler stats per replica
+  Map<String, dynamic> get numaInfo {
+    final ptr = _bindings.yolo_get_numa_info();
+    try {
+      return jsonDecode(ptr.cast<Utf8>().toDartString())
+          as Map<String, dynamic>;
+    } finally {
+      _bindings.free_string(ptr);
+    }
+  }
+
+  /// Threads the library may use: ONNX Runtime intra-op threads (applied at
+  /// the next [init]) and the internal task pool used by preprocessing.
+  /// 0 restores the default, min(4, hardware threads).
+  void setThreadBudget(int threads) {
+    _bindings.yolo_set_thread_budget(threads);
+  }
+
+  /// Current thread budget
+  int get threadBudget => _bindings.yolo_get_thread_budget();
+
   /// Run detection on image file
   ///
   /// [imagePath] - Path to image file
   /// [confThreshold] - Confidence threshold (0-1), default 0.25
   /// [iouThreshold] - IoU threshold for NMS (0-1), default 0.45
+  /// [captureTimestampNs] - Capture time from [nowNs], for frame age tracking
+  /// [frameId] - Frame id echoed back in the result
+  /// [priority] - Scheduling class, see [DetectPriority]
+  /// [stream] - Camera the frame belongs to, see [DetectionStream]
   YoloResult detectFromPath(
     String imagePath, {
     double confThreshold = 0.25,
     double iouThreshold = 0.45,
+    int? captureTimestampNs,
+    int? frameId,
+    DetectPriority priority = DetectPriority.interactive,
+    DetectionStream? stream,
   }) {
     final pathPtr = imagePath.toNativeUtf8();
+    final options = _allocOptions(
+      captureTimestampNs,
+      frameId,
+      priority,
+      stream,
+    );
     Pointer<Char>? resultPtr;
 
     try {
-      resultPtr = _bindings.yolo_detect_path(
+      resultPtr = _bindings.yolo_detect_path_ex(
         pathPtr.cast(),
         confThreshold,
         iouThreshold,
+        options,
       );
 
       if (resultPtr == nullptr) {
@@ -181,6 +1006,7 @@ class FlutterYoloOpenKit {
       return YoloResult.fromJson(json);
     } finally {
       malloc.free(pathPtr);
+      _freeOptions(options);
       if (resultPtr != null && resultPtr != nullptr) {
         _bindings.free_string(resultPtr);
       }
@@ -195,6 +1021,9 @@ class FlutterYoloOpenKit {
   /// [stride] - Bytes per row
   /// [confThreshold] - Confidence threshold (0-1), default 0.25
   /// [iouThreshold] - IoU threshold for NMS (0-1), default 0.45
+  /// [captureTimestampNs] - Capture time from [nowNs], for frame age tracking
+  /// [frameId] - Frame id echoed back in the result
+  /// [priority] - Scheduling class, see [DetectPriority]
   YoloResult detectFromBuffer(
     Pointer<Uint8> imageData,
     int width,
@@ -202,17 +1031,28 @@ class FlutterYoloOpenKit {
     int stride, {
     double confThreshold = 0.25,
     double iouThreshold = 0.45,
+    int? captureTimestampNs,
+    int? frameId,
+    DetectPriority priority = DetectPriority.interactive,
+    DetectionStream? stream,
   }) {
+    final options = _allocOptions(
+      captureTimestampNs,
+      frameId,
+      priority,
+      stream,
+    );
     Pointer<Char>? resultPtr;
 
     try {
-      resultPtr = _bindings.yolo_detect_buffer(
+      resultPtr = _bindings.yolo_detect_buffer_ex(
         imageData,
         width,
         height,
         stride,
         confThreshold,
         iouThreshold,
+        options,
       );
 
       if (resultPtr == nullptr) {
@@ -231,6 +1071,7 @@ class FlutterYoloOpenKit {
       final json = jsonDecode(jsonStr) as Map<String, dynamic>;
       return YoloResult.fromJson(json);
     } finally {
+      _freeOptions(options);
       if (resultPtr != null && resultPtr != nullptr) {
         _bindings.free_string(resultPtr);
       }
@@ -250,6 +1091,9 @@ class FlutterYoloOpenKit {
   /// [rotation] - Rotation in degrees (0, 90, 180, 270), default 0
   /// [confThreshold] - Confidence threshold (0-1), default 0.25
   /// [iouThreshold] - IoU threshold for NMS (0-1), default 0.45
+  /// [captureTimestampNs] - Capture time from [nowNs], for frame age tracking
+  /// [frameId] - Frame id echoed back in the result
+  /// [priority] - Scheduling class, see [DetectPriority]
   YoloResult detectFromYUV(
     Pointer<Uint8> yData,
     Pointer<Uint8> uData,
@@ -262,11 +1106,21 @@ class FlutterYoloOpenKit {
     int rotation = 0,
     double confThreshold = 0.25,
     double iouThreshold = 0.45,
+    int? captureTimestampNs,
+    int? frameId,
+    DetectPriority priority = DetectPriority.interactive,
+    DetectionStream? stream,
   }) {
+    final options = _allocOptions(
+      captureTimestampNs,
+      frameId,
+      priority,
+      stream,
+    );
     Pointer<Char>? resultPtr;
 
     try {
-      resultPtr = _bindings.yolo_detect_yuv(
+      resultPtr = _bindings.yolo_detect_yuv_ex(
         yData,
         uData,
         vData,
@@ -278,6 +1132,7 @@ class FlutterYoloOpenKit {
         rotation,
         confThreshold,
         iouThreshold,
+        options,
       );
 
       if (resultPtr == nullptr) {
@@ -296,27 +1151,696 @@ class FlutterYoloOpenKit {
       final json = jsonDecode(jsonStr) as Map<String, dynamic>;
       return YoloResult.fromJson(json);
     } finally {
+      _freeOptions(options);
       if (resultPtr != null && resultPtr != nullptr) {
         _bindings.free_string(resultPtr);
       }
     }
   }
 
-  /// Set custom class names for the model
+  /// Run detection on a frame in any [PixelFormat] (NV12, NV21, I420, RGB,
+  /// BGR, RGBA, BGRA, GRAY, YUYV)
   ///
-  /// [classNames] - List of class names
-  void setClassNames(List<String> classNames) {
-    final jsonStr = jsonEncode(classNames);
-    final ptr = jsonStr.toNativeUtf8();
-    try {
-      _bindings.yolo_set_classes(ptr.cast());
-    } finally {
-      malloc.free(ptr);
-    }
-  }
-
+  /// [planes] - Plane pointers in the order listed for [format]
+  /// [width] - Image width
+  /// [height] - Image height
+  /// [strides] - Bytes per row of each plane; missing or 0 = tightly packed
+  /// [rotation] - Rotation in degrees (0, 90, 180, 270), default 0
+  /// [confThreshold] - Confidence threshold (0-1), default 0.25
+  /// [iouThreshold] - IoU threshold for NMS (0-1), default 0.45
+  /// [captureTimestampNs] - Capture time from [nowNs], for frame age tracking
+  /// [frameId] - Frame id echoed back in the result
+  /// [priority] - Scheduling class, see [DetectPriority]
+  YoloResult detectFromFrame(
+    PixelFormat format,
+    List<Pointer<Uint8>> planes,
+    int width,
+    int height, {
+    List<int> strides = const [],
+    int rotation = 0,
+    double confThreshold = 0.25,
+    double iouThreshold = 0.45,
+    int? captureTimestampNs,
+    int? frameId,
+    DetectPriority priority = DetectPriority.interactive,
+    DetectionStream? stream,
+  }) {
+    final options = _allocOptions(
+      captureTimestampNs,
+      frameId,
+      priority,
+      stream,
+    );
+    final desc = calloc<YoloFrameDesc>();
+    Pointer<Char>? resultPtr;
+
+    try {
+      _fillFrameDesc(desc, format, planes, width, height, strides, rotation);
+      resultPtr = _bindings.yolo_detect_frame(
+        desc,
+        confThreshold,
+        iouThreshold,
+        options,
+      );
+
+      if (resultPtr == nullptr) {
+        return YoloResult(
+          detections: [],
+          count: 0,
+          inferenceTimeMs: 0,
+          imageWidth: width,
+          imageHeight: height,
+          error: 'Detection failed',
+          errorCode: 'NULL_RESULT',
+        );
+      }
+
+      final jsonStr = resultPtr.cast<Utf8>().toDartString();
+      final json = jsonDecode(jsonStr) as Map<String, dynamic>;
+      return YoloResult.fromJson(json);
+    } finally {
+      calloc.free(desc);
+      _freeOptions(options);
+      if (resultPtr != null && resultPtr != nullptr) {
+        _bindings.free_string(resultPtr);
+      }
+    }
+  }
+
+  /// Whether [input] contains a detection of one of [classIds] (all classes
+  /// if null) scoring at least [confThreshold].
+  ///
+  /// Cheaper than a full detect: decoding stops at the first hit, and no
+  /// NMS, class names or JSON are produced.
+  PresenceResult detectPresence(
+    DetectInput input, {
+    List<int>? classIds,
+    double confThreshold = 0.25,
+    int? captureTimestampNs,
+    int? frameId,
+    DetectPriority priority = DetectPriority.interactive,
+    DetectionStream? stream,
+  }) {
+    final options = _allocOptions(
+      captureTimestampNs,
+      frameId,
+      priority,
+      stream,
+    );
+    final classPtr = _allocClassIds(classIds);
+    try {
+      final status = input._withNative(
+        (native) => _bindings.yolo_detect_presence(
+          native,
+          classPtr,
+          classIds?.length ?? 0,
+          confThreshold,
+          options,
+        ),
+      );
+      if (status < 0) {
+        return PresenceResult(present: false, errorCode: _statusCode(status));
+      }
+      return PresenceResult(present: status == 1);
+    } finally {
+      if (classPtr != nullptr) calloc.free(classPtr);
+      _freeOptions(options);
+    }
+  }
+
+  /// Detections per class in [input] after NMS, restricted to [classIds]
+  /// (all classes if null), without building boxes or JSON.
+  CountResult detectCount(
+    DetectInput input, {
+    List<int>? classIds,
+    double confThreshold = 0.25,
+    double iouThreshold = 0.45,
+    int? captureTimestampNs,
+    int? frameId,
+    DetectPriority priority = DetectPriority.interactive,
+    DetectionStream? stream,
+  }) {
+    final options = _allocOptions(
+      captureTimestampNs,
+      frameId,
+      priority,
+      stream,
+    );
+    final classPtr = _allocClassIds(classIds);
+    const maxClasses = 1024;
+    final counts = calloc<Int32>(maxClasses);
+    try {
+      final total = input._withNative(
+        (native) => _bindings.yolo_detect_count(
+          native,
+          classPtr,
+          classIds?.length ?? 0,
+          confThreshold,
+          iouThreshold,
+          counts,
+          maxClasses,
+          options,
+        ),
+      );
+      if (total < 0) {
+        return CountResult(counts: [], total: 0, errorCode: _statusCode(total));
+      }
+      var used = maxClasses;
+      while (used > 0 && counts[used - 1] == 0) {
+        used--;
+      }
+      return CountResult(
+        counts: List<int>.generate(used, (i) => counts[i]),
+        total: total,
+      );
+    } finally {
+      calloc.free(counts);
+      if (classPtr != nullptr) calloc.free(classPtr);
+      _freeOptions(options);
+    }
+  }
+
+  Pointer<Int32> _allocClassIds(List<int>? classIds) {
+    if (classIds == null || classIds.isEmpty) {
+      return nullptr;
+    }
+    final ptr = calloc<Int32>(classIds.length);
+    ptr.asTypedList(classIds.length).setAll(0, classIds);
+    return ptr;
+  }
+
+  /// Run the model on an already preprocessed input tensor [shape]
+  /// `[N, 3, H, W]`, skipping preprocessing and decoding, for pipelines that
+  /// letterbox upstream or decode the raw head outputs themselves. The tensor
+  /// must be laid out as the model expects (YOLOv8 / PP-YOLOE: RGB in [0, 1],
+  /// or raw BGR 0-255 if [inputFolded]; YOLOX: BGR 0-255); see [inputSize].
+  /// Outputs are views of native memory until [TensorRunResult.release].
+  TensorRunResult runTensor(
+    Float32List input,
+    List<int> shape, {
+    int maxOutputs = 8,
+    int? captureTimestampNs,
+    int? frameId,
+    DetectPriority priority = DetectPriority.interactive,
+  }) {
+    final options = _allocOptions(captureTimestampNs, frameId, priority);
+    final tensor = calloc<Float>(input.length);
+    final dims = calloc<Int64>(shape.length);
+    final views = calloc<YoloTensorView>(maxOutputs);
+    final result = calloc<Pointer<YoloTensorResult>>();
+    try {
+      tensor.asTypedList(input.length).setAll(0, input);
+      dims.asTypedList(shape.length).setAll(0, shape);
+      final count = _bindings.yolo_run_tensor(
+        tensor,
+        dims,
+        shape.length,
+        views,
+        maxOutputs,
+        result,
+        options,
+      );
+      if (count < 0) {
+        return TensorRunResult._(null, nullptr, errorCode: _statusCode(count));
+      }
+
+      final n = count < maxOutputs ? count : maxOutputs;
+      final outputs = List<TensorOutput>.generate(n, (i) {
+        final view = (views + i).ref;
+        return TensorOutput(
+          name: view.name.cast<Utf8>().toDartString(),
+          shape: List<int>.generate(view.rank, (d) => view.shape[d]),
+          data: view.data != nullptr
+              ? view.data.asTypedList(view.element_count)
+              : null,
+        );
+      });
+      return TensorRunResult._(_bindings, result.value, outputs: outputs);
+    } finally {
+      calloc.free(result);
+      calloc.free(views);
+      calloc.free(dims);
+      calloc.free(tensor);
+      _freeOptions(options);
+    }
+  }
+
+  /// Model input width and height, or null before [init]
+  (int, int)? get inputSize {
+    final size = calloc<Int32>(2);
+    try {
+      if (_bindings.yolo_get_input_size(size, size + 1) == 0) return null;
+      return (size[0], size[1]);
+    } finally {
+      calloc.free(size);
+    }
+  }
+
+  /// Pool a per-detection appearance embedding from the model output
+  /// [outputName], a neck feature map [1, C, H, W] exported as an extra
+  /// output, for re-identification without a second embedding model.
+  /// [pooledSize] bins per side (1 = average pooling, C floats). Applies from
+  /// the next [init] / [initNuma]; null disables.
+  void setEmbeddingOutput(String? outputName, {int pooledSize = 1}) {
+    final namePtr = outputName?.toNativeUtf8() ?? nullptr;
+    try {
+      _bindings.yolo_set_embedding_output(namePtr.cast(), pooledSize);
+    } finally {
+      if (namePtr != nullptr) malloc.free(namePtr);
+    }
+  }
+
+  /// Floats per embedding (0 if the loaded model has no embedding output)
+  int get embeddingDim => _bindings.yolo_get_embedding_dim();
+
+  /// Fold the RGB channel order and /255 scaling of YOLOv8 / PP-YOLOE models
+  /// into the first convolution at load, so frames are fed as raw BGR and
+  /// preprocessing skips the per-pixel multiply. Applies from the next
+  /// [init] / [initNuma]; check [inputFolded] afterwards, since models whose
+  /// input does not feed a single plain Conv load unchanged.
+  void setFoldInputNormalization(bool enabled) =>
+      _bindings.yolo_set_fold_input(enabled ? 1 : 0);
+
+  /// Whether the loaded model was rewritten by [setFoldInputNormalization]
+  bool get inputFolded => _bindings.yolo_is_input_folded() != 0;
+
+  /// Inference backend for the next [init] / [initNuma]. Returns false (and
+  /// keeps the current choice) if it was not compiled into the native
+  /// library, e.g. OpenCV DNN in a build without OpenCV.
+  bool setInferenceBackend(InferenceBackend backend) {
+    final value = switch (backend) {
+      InferenceBackend.onnxRuntime => YoloBackend.YOLO_BACKEND_ONNXRUNTIME,
+      InferenceBackend.opencvDnn => YoloBackend.YOLO_BACKEND_OPENCV_DNN,
+    };
+    return _bindings.yolo_set_backend(value) != 0;
+  }
+
+  /// Backend of the loaded model (`onnxruntime`, `opencv-dnn`), empty
+  /// before [init]
+  String get backendName =>
+      _bindings.yolo_get_backend_name().cast<Utf8>().toDartString();
+
+  /// Detections as a binary result (no JSON), with an appearance embedding
+  /// per detection when [withEmbeddings] is set (see [setEmbeddingOutput]).
+  /// At most [maxBoxes] detections are returned.
+  BoxResult detectBoxes(
+    DetectInput input, {
+    double confThreshold = 0.25,
+    double iouThreshold = 0.45,
+    bool withEmbeddings = false,
+    int maxBoxes = 300,
+    int? captureTimestampNs,
+    int? frameId,
+    DetectPriority priority = DetectPriority.interactive,
+    DetectionStream? stream,
+  }) {
+    final options = _allocOptions(
+      captureTimestampNs,
+      frameId,
+      priority,
+      stream,
+    );
+    final dim = withEmbeddings ? embeddingDim : 0;
+    final boxes = calloc<YoloBox>(maxBoxes);
+    final embeddings = dim > 0 ? calloc<Float>(maxBoxes * dim) : nullptr;
+    final size = calloc<Int32>(2);
+    try {
+      final count = input._withNative(
+        (native) => _bindings.yolo_detect_boxes(
+          native,
+          confThreshold,
+          iouThreshold,
+          boxes,
+          maxBoxes,
+          embeddings,
+          maxBoxes * dim,
+          size,
+          size + 1,
+          options,
+        ),
+      );
+      if (count < 0) {
+        return BoxResult(detections: [], errorCode: _statusCode(count));
+      }
+
+      final names = classNames;
+      final n = count < maxBoxes ? count : maxBoxes;
+      final detections = List<YoloDetection>.generate(n, (i) {
+        final box = (boxes + i).ref;
+        return YoloDetection(
+          classId: box.class_id,
+          className: box.class_id < names.length
+              ? names[box.class_id]
+              : 'class_${box.class_id}',
+          confidence: box.confidence,
+          x1: box.x1,
+          y1: box.y1,
+          x2: box.x2,
+          y2: box.y2,
+        );
+      });
+      final pooled = dim > 0
+          ? List<Float32List>.generate(
+              n,
+              (i) => Float32List.fromList(
+                (embeddings + i * dim).asTypedList(dim),
+              ),
+            )
+          : const <Float32List>[];
+      return BoxResult(
+        detections: detections,
+        embeddings: pooled,
+        imageWidth: size[0],
+        imageHeight: size[1],
+      );
+    } finally {
+      calloc.free(size);
+      if (embeddings != nullptr) calloc.free(embeddings);
+      calloc.free(boxes);
+      _freeOptions(options);
+    }
+  }
+
+  /// Read an MJPEG byte stream (concatenated JPEGs, e.g. ffmpeg
+  /// `-f mjpeg` into a FIFO) from [path] and detect frame by frame with
+  /// [MjpegIngest.detectNext]. [decodeThreads] JPEGs are decoded in parallel
+  /// (0 = thread budget) at 1/[decodeScale] size (1, 2, 4 or 8; 0 = the
+  /// largest that keeps frames at least the model input size, or full size
+  /// before [init]). With [dropLate], frames are dropped when detection
+  /// falls behind instead of pausing the source. Open and read errors are
+  /// reported in [MjpegIngest.stats].
+  MjpegIngest? openMjpeg(
+    String path, {
+    int decodeThreads = 0,
+    int decodeScale = 0,
+    bool dropLate = false,
+  }) {
+    final pathPtr = path.toNativeUtf8();
+    try {
+      final ingest = _bindings.yolo_mjpeg_open(
+        pathPtr.cast(),
+        decodeThreads,
+        decodeScale,
+        dropLate ? 1 : 0,
+      );
+      return ingest == nullptr ? null : MjpegIngest._(this, ingest);
+    } finally {
+      malloc.free(pathPtr);
+    }
+  }
+
+  /// [openMjpeg] on an open file descriptor (pipe, socket), which stays
+  /// owned by the caller and must outlive [MjpegIngest.close]
+  MjpegIngest? openMjpegFd(
+    int fd, {
+    int decodeThreads = 0,
+    int decodeScale = 0,
+    bool dropLate = false,
+  }) {
+    final ingest = _bindings.yolo_mjpeg_open_fd(
+      fd,
+      decodeThreads,
+      decodeScale,
+      dropLate ? 1 : 0,
+    );
+    return ingest == nullptr ? null : MjpegIngest._(this, ingest);
+  }
+
+  /// Poller for the newest result of any detect call (or only of [stream]'s
+  /// calls), for a UI that repaints faster than detection runs
+  LatestResultPoller latestResults({
+    DetectionStream? stream,
+    int maxBoxes = 300,
+  }) => LatestResultPoller._(this, stream, maxBoxes);
+
+  /// Current class names (model defaults or [setClassNames])
+  List<String> get classNames {
+    final cached = _classNames;
+    if (cached != null) return cached;
+    final ptr = _bindings.yolo_get_classes();
+    try {
+      final names = (jsonDecode(ptr.cast<Utf8>().toDartString()) as List)
+          .cast<String>();
+      return _classNames = names;
+    } finally {
+      _bindings.free_string(ptr);
+    }
+  }
+
+  /// Detect on a list of image files in order.
+  ///
+  /// File contents are read ahead (io_uring on Linux, pread threads
+  /// elsewhere) into a bounded buffer pool and decoded from memory, so slow
+  /// storage such as network mounts overlaps with inference. Runs at
+  /// [DetectPriority.background] unless [priority] says otherwise; each
+  /// result's `frameId` is the file's index. A file preempted by higher
+  /// priority work is run again once that work has drained;
+  /// [cancelBackground] stops a background scan, and the files it did not
+  /// process are listed with error code `CANCELLED`.
+  BatchScanResult detectFromPaths(
+    List<String> imagePaths, {
+    double confThreshold = 0.25,
+    double iouThreshold = 0.45,
+    DetectPriority priority = DetectPriority.background,
+  }) {
+    final pathsPtr = jsonEncode(imagePaths).toNativeUtf8();
+    try {
+      return _batchScan(
+        (options) => _bindings.yolo_detect_paths(
+          pathsPtr.cast(),
+          confThreshold,
+          iouThreshold,
+          options,
+        ),
+        priority,
+      );
+    } finally {
+      malloc.free(pathsPtr);
+    }
+  }
+
+  /// Detect on every .jpg/.jpeg/.png/.bmp file in [directory] (not
+  /// recursive), sorted by name. See [detectFromPaths].
+  BatchScanResult detectDirectory(
+    String directory, {
+    double confThreshold = 0.25,
+    double iouThreshold = 0.45,
+    DetectPriority priority = DetectPriority.background,
+  }) {
+    final dirPtr = directory.toNativeUtf8();
+    try {
+      return _batchScan(
+        (options) => _bindings.yolo_detect_directory(
+          dirPtr.cast(),
+          confThreshold,
+          iouThreshold,
+          options,
+        ),
+        priority,
+      );
+    } finally {
+      malloc.free(dirPtr);
+    }
+  }
+
+  /// Reuse detections for near-duplicate images in batch scans.
+  ///
+  /// Each file is hashed (dHash) from a reduced decode; when a recent image
+  /// with the same dimensions is at most [maxDistance] bits away, its
+  /// detections are reused instead of running the model. 0 reuses only
+  /// identical hashes, 8-12 (of 128 bits) catches typical burst shots; -1 disables (default).
+  void setBatchDedup(int maxDistance) {
+    _bindings.yolo_set_batch_dedup(maxDistance);
+  }
+
+  /// Detect on one frame every [intervalSeconds] of a video file (<= 0 =
+  /// every frame), e.g. one detection per second over archived footage.
+  ///
+  /// Frames between samples are decoded without color conversion, or skipped
+  /// by seeking when the gap is longer than [keyframeInterval] frames (the
+  /// assumed GOP length; 0 never seeks). Needs OpenCV with videoio (error
+  /// code `DECODER_UNAVAILABLE` otherwise). Runs at
+  /// [DetectPriority.background] unless [priority] says otherwise.
+  VideoScanResult detectVideo(
+    String videoPath, {
+    double intervalSeconds = 1.0,
+    int keyframeInterval = 250,
+    double confThreshold = 0.25,
+    double iouThreshold = 0.45,
+    DetectPriority priority = DetectPriority.background,
+  }) {
+    final pathPtr = videoPath.toNativeUtf8();
+    final options = calloc<YoloDetectOptions>();
+    options.ref.frame_id = -1;
+    options.ref.priority = _priorityValue(priority);
+    Pointer<Char>? resultPtr;
+    try {
+      resultPtr = _bindings.yolo_detect_video(
+        pathPtr.cast(),
+        intervalSeconds,
+        keyframeInterval,
+        confThreshold,
+        iouThreshold,
+        options,
+      );
+      if (resultPtr == nullptr) {
+        return VideoScanResult(
+          items: [],
+          error: 'Detection failed',
+          errorCode: 'NULL_RESULT',
+        );
+      }
+      final json =
+          jsonDecode(resultPtr.cast<Utf8>().toDartString())
+              as Map<String, dynamic>;
+      return VideoScanResult.fromJson(json);
+    } finally {
+      malloc.free(pathPtr);
+      calloc.free(options);
+      if (resultPtr != null && resultPtr != nullptr) {
+        _bindings.free_string(resultPtr);
+      }
+    }
+  }
+
+  BatchScanResult _batchScan(
+    Pointer<Char> Function(Pointer<YoloDetectOptions>) scan,
+    DetectPriority priority,
+  ) {
+    final options = calloc<YoloDetectOptions>();
+    options.ref.frame_id = -1;
+    options.ref.priority = _priorityValue(priority);
+    Pointer<Char>? resultPtr;
+    try {
+      resultPtr = scan(options);
+      if (resultPtr == nullptr) {
+        return BatchScanResult(
+          items: [],
+          error: 'Detection failed',
+          errorCode: 'NULL_RESULT',
+        );
+      }
+      final json =
+          jsonDecode(resultPtr.cast<Utf8>().toDartString())
+              as Map<String, dynamic>;
+      return BatchScanResult.fromJson(json);
+    } finally {
+      calloc.free(options);
+      if (resultPtr != null && resultPtr != nullptr) {
+        _bindings.free_string(resultPtr);
+      }
+    }
+  }
+
+  /// Current time on the native monotonic clock (ns).
+  ///
+  /// Stamp camera frames with this on arrival and pass it as
+  /// `captureTimestampNs` so results report the full frame age, including
+  /// isolate hops and queueing.
+  int get nowNs => _bindings.yolo_now_ns();
+
+  /// Latency metrics: frame count, queue wait, processing time and a frame
+  /// age histogram
+  Map<String, dynamic> get metrics {
+    final ptr = _bindings.yolo_get_metrics();
+    try {
+      return jsonDecode(ptr.cast<Utf8>().toDartString())
+          as Map<String, dynamic>;
+    } finally {
+      _bindings.free_string(ptr);
+    }
+  }
+
+  /// Reset latency metrics
+  void resetMetrics() {
+    _bindings.yolo_reset_metrics();
+  }
+
+  /// Scheduler statistics per priority class: queued, admitted, rejected,
+  /// shed, cancelled and preempted calls. `preemption_supported` is false on
+  /// backends that cannot abort a running inference (OpenCV DNN). After
+  /// [initNuma] the counts cover all replicas; see [numaInfo] for each.
+  Map<String, dynamic> get schedulerStats {
+    final ptr = _bindings.yolo_get_scheduler_stats();
+    try {
+      return jsonDecode(ptr.cast<Utf8>().toDartString())
+          as Map<String, dynamic>;
+    } finally {
+      _bindings.free_string(ptr);
+    }
+  }
+
+  /// Set how many calls may wait per priority class (0 = never queue), and
+  /// whether a running background call is aborted for higher priority work.
+  /// Omitted values keep their current setting.
+  void setSchedulerLimits({
+    int? maxRealtime,
+    int? maxInteractive,
+    int? maxBackground,
+    bool? preemptBackground,
+  }) {
+    _bindings.yolo_set_scheduler_limits(
+      maxRealtime ?? -1,
+      maxInteractive ?? -1,
+      maxBackground ?? -1,
+      preemptBackground == null ? -1 : (preemptBackground ? 1 : 0),
+    );
+  }
+
+  /// Cancel queued background calls and abort a running one (not on OpenCV
+  /// DNN, where it completes). Cancelled calls return a result with error
+  /// code `CANCELLED`. Returns the number of calls affected.
+  int cancelBackground() => _bindings.yolo_cancel_background();
+
+  Pointer<YoloDetectOptions> _allocOptions(
+    int? captureTimestampNs,
+    int? frameId,
+    DetectPriority priority, [
+    DetectionStream? stream,
+  ]) {
+    if (captureTimestampNs == null &&
+        frameId == null &&
+        priority == DetectPriority.interactive &&
+        stream == null) {
+      return nullptr;
+    }
+    final options = calloc<YoloDetectOptions>();
+    options.ref.capture_ts_ns = captureTimestampNs ?? 0;
+    options.ref.frame_id = frameId ?? -1;
+    options.ref.priority = _priorityValue(priority);
+    options.ref.stream = stream?._stream ?? nullptr;
+    return options;
+  }
+
+  int _priorityValue(DetectPriority priority) => switch (priority) {
+    DetectPriority.realtime => YoloPriority.YOLO_PRIORITY_REALTIME,
+    DetectPriority.interactive => YoloPriority.YOLO_PRIORITY_INTERACTIVE,
+    DetectPriority.background => YoloPriority.YOLO_PRIORITY_BACKGROUND,
+  };
+
+  void _freeOptions(Pointer<YoloDetectOptions> options) {
+    if (options != nullptr) {
+      calloc.free(options);
+    }
+  }
+
+  /// Set custom class names for the model
+  ///
+  /// [classNames] - List of class names
+  void setClassNames(List<String> classNames) {
+    _classNames = null;
+    final jsonStr = jsonEncode(classNames);
+    final ptr = jsonStr.toNativeUtf8();
+    try {
+      _bindings.yolo_set_classes(ptr.cast());
+    } finally {
+      malloc.free(ptr);
+    }
+  }
+
   /// Release detector resources
   void release() {
+    _classNames = null;
     _bindings.yolo_release();
     _initialized = false;
   }
@@ -333,6 +1857,453 @@ class FlutterYoloOpenKit {
   }
 }
 
+/// Native copy of [detections] as log boxes (nullptr if empty)
+Pointer<YoloLogBox> _allocLogBoxes(List<YoloDetection> detections) {
+  if (detections.isEmpty) return nullptr;
+  final boxes = calloc<YoloLogBox>(detections.length);
+  for (var i = 0; i < detections.length; i++) {
+    final d = detections[i];
+    final box = (boxes + i).ref;
+    box.class_id = d.classId;
+    box.confidence = d.confidence;
+    box.x1 = d.x1;
+    box.y1 = d.y1;
+    box.x2 = d.x2;
+    box.y2 = d.y2;
+  }
+  return boxes;
+}
+
+/// Detections decoded from log boxes
+List<YoloDetection> _logBoxDetections(
+  Pointer<YoloLogBox> boxes,
+  int count,
+  List<String> classNames,
+) {
+  final detections = <YoloDetection>[];
+  for (var i = 0; i < count; i++) {
+    final box = (boxes + i).ref;
+    detections.add(
+      YoloDetection(
+        classId: box.class_id,
+        className: box.class_id < classNames.length
+            ? classNames[box.class_id]
+            : 'unknown',
+        confidence: box.confidence,
+        x1: box.x1,
+        y1: box.y1,
+        x2: box.x2,
+        y2: box.y2,
+      ),
+    );
+  }
+  return detections;
+}
+
+/// Per-camera context for serving several cameras from one loaded model.
+///
+/// Pass it as `stream:` to the detect calls of that camera's frames: the
+/// stream keeps the sampling plan for its frame geometry (cameras with
+/// different resolutions don't rebuild a shared one every frame), its own
+/// latency [metrics] and optionally its own detection log. The model and
+/// the scheduler stay shared; streams survive [FlutterYoloOpenKit.init].
+class DetectionStream {
+  final FlutterYoloOpenKitBindings _bindings;
+  Pointer<YoloStream> _stream;
+
+  DetectionStream._(this._bindings, this._stream);
+
+  factory DetectionStream(String name) {
+    final bindings = FlutterYoloOpenKitBindings(_dylib);
+    final namePtr = name.toNativeUtf8();
+    try {
+      return DetectionStream._(
+        bindings,
+        bindings.yolo_stream_create(namePtr.cast()),
+      );
+    } finally {
+      malloc.free(namePtr);
+    }
+  }
+
+  /// Name, last frame size, `plan_builds` and this stream's frame metrics
+  /// (same fields as [FlutterYoloOpenKit.metrics]) under `metrics`
+  Map<String, dynamic> get metrics {
+    if (_stream == nullptr) return {};
+    final ptr = _bindings.yolo_stream_get_metrics(_stream);
+    try {
+      return jsonDecode(ptr.cast<Utf8>().toDartString())
+          as Map<String, dynamic>;
+    } finally {
+      _bindings.free_string(ptr);
+    }
+  }
+
+  void resetMetrics() {
+    if (_stream != nullptr) _bindings.yolo_stream_reset_metrics(_stream);
+  }
+
+  /// Record this stream's frames into [log] instead of the detector-wide
+  /// log (null to stop). Detach before closing the log.
+  void attachLog(DetectionLogWriter? log) {
+    if (_stream == nullptr) return;
+    _bindings.yolo_stream_log_attach(_stream, log?._writer ?? nullptr);
+  }
+
+  /// Release the stream; no detect call may be using it
+  void close() {
+    if (_stream != nullptr) {
+      _bindings.yolo_stream_destroy(_stream);
+      _stream = nullptr;
+    }
+  }
+}
+
+/// One frame read back from a detection log
+class DetectionLogFrame {
+  final int timestampNs;
+  final int imageWidth;
+  final int imageHeight;
+  final List<YoloDetection> detections;
+
+  DetectionLogFrame({
+    required this.timestampNs,
+    required this.imageWidth,
+    required this.imageHeight,
+    required this.detections,
+  });
+}
+
+/// Append-only binary detection log.
+///
+/// Stores about 10 bytes per detection (quantized scores and box corners)
+/// instead of JSON, for recording every frame of long-running streams.
+class DetectionLogWriter {
+  final FlutterYoloOpenKitBindings _bindings;
+  Pointer<YoloLogWriter> _writer;
+
+  DetectionLogWriter._(this._bindings, this._writer);
+
+  /// Create a log, or append to an existing one with the same stream name
+  /// and class table. [classNames] defaults to the detector's classes.
+  /// Returns null if the file cannot be opened or has a different header.
+  static DetectionLogWriter? open(
+    String path, {
+    String streamName = '',
+    List<String>? classNames,
+  }) {
+    final bindings = FlutterYoloOpenKitBindings(_dylib);
+    final pathPtr = path.toNativeUtf8();
+    final namePtr = streamName.toNativeUtf8();
+    final classesPtr =
+        classNames != null ? jsonEncode(classNames).toNativeUtf8() : nullptr;
+    try {
+      final writer = bindings.yolo_log_writer_open(
+        pathPtr.cast(),
+        namePtr.cast(),
+        classesPtr.cast(),
+      );
+      return writer == nullptr ? null : DetectionLogWriter._(bindings, writer);
+    } finally {
+      malloc.free(pathPtr);
+      malloc.free(namePtr);
+      if (classesPtr != nullptr) malloc.free(classesPtr);
+    }
+  }
+
+  /// Append a result (e.g. from a detector running elsewhere). Returns false,
+  /// writing nothing, if a class id is outside the log's id range or there
+  /// are more than 65535 detections.
+  bool write(YoloResult result, {required int timestampNs}) {
+    if (_writer == nullptr) return false;
+    final count = result.detections.length;
+    final boxes = _allocLogBoxes(result.detections);
+    try {
+      return _bindings.yolo_log_write_frame(
+            _writer,
+            timestampNs,
+            result.imageWidth,
+            result.imageHeight,
+            boxes,
+            count,
+          ) ==
+          1;
+    } finally {
+      if (boxes != nullptr) calloc.free(boxes);
+    }
+  }
+
+  /// Record every detect call of the detector into this log, without
+  /// round-tripping results through Dart
+  bool attach() => _writer != nullptr && _bindings.yolo_log_attach(_writer) == 1;
+
+  /// Stop recording detect calls
+  void detach() {
+    _bindings.yolo_log_attach(nullptr);
+  }
+
+  void flush() {
+    if (_writer != nullptr) _bindings.yolo_log_writer_flush(_writer);
+  }
+
+  /// Close the log (detaches it first if attached)
+  void close() {
+    if (_writer != nullptr) {
+      _bindings.yolo_log_writer_close(_writer);
+      _writer = nullptr;
+    }
+  }
+}
+
+/// Memory-mapped reader for logs written by [DetectionLogWriter]
+class DetectionLogReader {
+  final FlutterYoloOpenKitBindings _bindings;
+  Pointer<YoloLogReader> _reader;
+
+  /// Stream name from the log header
+  final String streamName;
+
+  /// Class table from the log header
+  final List<String> classNames;
+
+  DetectionLogReader._(
+    this._bindings,
+    this._reader,
+    this.streamName,
+    this.classNames,
+  );
+
+  /// Open a log. Returns null if the file is not a valid log.
+  static DetectionLogReader? open(String path) {
+    final bindings = FlutterYoloOpenKitBindings(_dylib);
+    final pathPtr = path.toNativeUtf8();
+    try {
+      final reader = bindings.yolo_log_reader_open(pathPtr.cast());
+      if (reader == nullptr) return null;
+      final infoPtr = bindings.yolo_log_reader_info(reader);
+      try {
+        final info =
+            jsonDecode(infoPtr.cast<Utf8>().toDartString())
+                as Map<String, dynamic>;
+        return DetectionLogReader._(
+          bindings,
+          reader,
+          info['stream'] as String,
+          (info['classes'] as List).cast<String>(),
+        );
+      } finally {
+        bindings.free_string(infoPtr);
+      }
+    } finally {
+      malloc.free(pathPtr);
+    }
+  }
+
+  /// Convert a log to JSON lines. Returns frames written, or -1 on failure.
+  static int toJsonl(String logPath, String jsonlPath) {
+    final bindings = FlutterYoloOpenKitBindings(_dylib);
+    final logPtr = logPath.toNativeUtf8();
+    final outPtr = jsonlPath.toNativeUtf8();
+    try {
+      return bindings.yolo_log_to_jsonl(logPtr.cast(), outPtr.cast());
+    } finally {
+      malloc.free(logPtr);
+      malloc.free(outPtr);
+    }
+  }
+
+  int get frameCount =>
+      _reader == nullptr ? 0 : _bindings.yolo_log_reader_frame_count(_reader);
+
+  /// Decode frame [index], or null if out of range
+  DetectionLogFrame? frame(int index) {
+    if (_reader == nullptr) return null;
+    final ts = calloc<Int64>();
+    final width = calloc<Int>();
+    final height = calloc<Int>();
+    Pointer<YoloLogBox> boxes = nullptr;
+    try {
+      final count = _bindings.yolo_log_reader_read_frame(
+        _reader, index, ts, width, height, nullptr, 0);
+      if (count < 0) return null;
+      if (count > 0) {
+        boxes = calloc<YoloLogBox>(count);
+        _bindings.yolo_log_reader_read_frame(
+          _reader, index, ts, width, height, boxes, count);
+      }
+      return DetectionLogFrame(
+        timestampNs: ts.value,
+        imageWidth: width.value,
+        imageHeight: height.value,
+        detections: _logBoxDetections(boxes, count, classNames),
+      );
+    } finally {
+      calloc.free(ts);
+      calloc.free(width);
+      calloc.free(height);
+      if (boxes != nullptr) calloc.free(boxes);
+    }
+  }
+
+  void close() {
+    if (_reader != nullptr) {
+      _bindings.yolo_log_reader_close(_reader);
+      _reader = nullptr;
+    }
+  }
+}
+
+/// Encodes results as a compact delta stream for forwarding over a narrow
+/// link: keyframes carry every box, other packets only the boxes that
+/// appeared, disappeared or moved (as small quantized offsets against the
+/// previous packet). Decode with [DetectionDeltaDecoder].
+class DetectionDeltaEncoder {
+  final FlutterYoloOpenKitBindings _bindings;
+  Pointer<YoloDeltaEncoder> _encoder;
+  Pointer<Uint8> _buffer = nullptr;
+  int _capacity = 0;
+
+  DetectionDeltaEncoder._(this._bindings, this._encoder);
+
+  /// [keyframeInterval] - Packets between keyframes (0 = first packet only)
+  /// [matchIou] - Minimum IoU for a box to be sent as a move of a previous one
+  factory DetectionDeltaEncoder({
+    int keyframeInterval = 30,
+    double matchIou = 0.3,
+  }) {
+    final bindings = FlutterYoloOpenKitBindings(_dylib);
+    return DetectionDeltaEncoder._(
+      bindings,
+      bindings.yolo_delta_encoder_create(keyframeInterval, matchIou),
+    );
+  }
+
+  /// Encode a result into the next packet
+  Uint8List encode(YoloResult result, {required int timestampNs}) {
+    if (_encoder == nullptr) return Uint8List(0);
+    final count = result.detections.length;
+    final boxes = _allocLogBoxes(result.detections);
+    try {
+      var size = -1;
+      while (size < 0) {
+        size = _bindings.yolo_delta_encode(
+          _encoder,
+          timestampNs,
+          result.imageWidth,
+          result.imageHeight,
+          boxes,
+          count,
+          _buffer,
+          _capacity,
+        );
+        if (size < 0) {
+          if (_buffer != nullptr) malloc.free(_buffer);
+          _capacity = -size;
+          _buffer = malloc<Uint8>(_capacity);
+        }
+      }
+      return Uint8List.fromList(_buffer.asTypedList(size));
+    } finally {
+      if (boxes != nullptr) calloc.free(boxes);
+    }
+  }
+
+  /// Make the next packet a keyframe, e.g. when the receiver lost sync
+  void requestKeyframe() {
+    if (_encoder != nullptr) _bindings.yolo_delta_request_keyframe(_encoder);
+  }
+
+  /// Packets, keyframes, encoded vs full-precision bytes
+  /// (`compression_ratio`) and encode time (`encode_us_per_packet`)
+  Map<String, dynamic> get stats {
+    if (_encoder == nullptr) return {};
+    final ptr = _bindings.yolo_delta_encoder_stats(_encoder);
+    try {
+      return jsonDecode(ptr.cast<Utf8>().toDartString())
+          as Map<String, dynamic>;
+    } finally {
+      _bindings.free_string(ptr);
+    }
+  }
+
+  void close() {
+    if (_encoder != nullptr) {
+      _bindings.yolo_delta_encoder_destroy(_encoder);
+      _encoder = nullptr;
+    }
+    if (_buffer != nullptr) {
+      malloc.free(_buffer);
+      _buffer = nullptr;
+      _capacity = 0;
+    }
+  }
+}
+
+/// Rebuilds frames from packets of a [DetectionDeltaEncoder]
+class DetectionDeltaDecoder {
+  final FlutterYoloOpenKitBindings _bindings;
+  Pointer<YoloDeltaDecoder> _decoder;
+
+  /// Names for decoded class ids (the stream carries ids only)
+  final List<String> classNames;
+
+  /// Whether the last packet was rejected because an earlier one was lost;
+  /// ask the sender for a keyframe ([DetectionDeltaEncoder.requestKeyframe])
+  bool outOfSync = false;
+
+  DetectionDeltaDecoder._(this._bindings, this._decoder, this.classNames);
+
+  factory DetectionDeltaDecoder({List<String> classNames = const []}) {
+    final bindings = FlutterYoloOpenKitBindings(_dylib);
+    return DetectionDeltaDecoder._(
+      bindings,
+      bindings.yolo_delta_decoder_create(),
+      classNames,
+    );
+  }
+
+  /// Apply one packet. Returns the reconstructed frame, or null if the
+  /// packet is malformed or out of sync ([outOfSync]).
+  DetectionLogFrame? decode(Uint8List packet) {
+    if (_decoder == nullptr) return null;
+    final data = malloc<Uint8>(packet.isEmpty ? 1 : packet.length);
+    final ts = calloc<Int64>();
+    final width = calloc<Int>();
+    final height = calloc<Int>();
+    Pointer<YoloLogBox> boxes = nullptr;
+    try {
+      data.asTypedList(packet.length).setAll(0, packet);
+      final count = _bindings.yolo_delta_decode(
+        _decoder, data, packet.length, ts, width, height, nullptr, 0);
+      outOfSync = count == YoloDeltaStatus.YOLO_DELTA_OUT_OF_SYNC;
+      if (count < 0) return null;
+      if (count > 0) {
+        boxes = calloc<YoloLogBox>(count);
+        _bindings.yolo_delta_decoder_boxes(_decoder, boxes, count);
+      }
+      return DetectionLogFrame(
+        timestampNs: ts.value,
+        imageWidth: width.value,
+        imageHeight: height.value,
+        detections: _logBoxDetections(boxes, count, classNames),
+      );
+    } finally {
+      malloc.free(data);
+      calloc.free(ts);
+      calloc.free(width);
+      calloc.free(height);
+      if (boxes != nullptr) calloc.free(boxes);
+    }
+  }
+
+  void close() {
+    if (_decoder != nullptr) {
+      _bindings.yolo_delta_decoder_destroy(_decoder);
+      _decoder = nullptr;
+    }
+  }
+}
+
 const String _libName = 'flutter_yolo_open_kit';
 
 /// The dynamic library in which the symbols for [FlutterYoloOpenKitBindings] can be found.
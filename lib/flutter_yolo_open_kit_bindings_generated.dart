@@ -39,6 +39,58 @@ class FlutterYoloOpenKitBindings {
   late final _yolo_init =
       _yolo_initPtr.asFunction<int Function(ffi.Pointer<ffi.Char>)>();
 
+  /// Server mode for multi-socket machines: one detector per NUMA node, each
+  /// loaded with node-local memory and pinned to that node's cores. Detect calls
+  /// go to the least-loaded replica. Falls back to a single detector when the
+  /// machine has one node. Returns the number of replicas, 0 on failure.
+  int yolo_init_numa(ffi.Pointer<ffi.Char> model_path) {
+    return _yolo_init_numa(model_path);
+  }
+
+  late final _yolo_init_numaPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.Pointer<ffi.Char>)>>(
+        'yolo_init_numa',
+      );
+  late final _yolo_init_numa =
+      _yolo_init_numaPtr.asFunction<int Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Replica nodes, CPUs, load and scheduler stats as JSON (caller must free
+  /// with free_string)
+  ffi.Pointer<ffi.Char> yolo_get_numa_info() {
+    return _yolo_get_numa_info();
+  }
+
+  late final _yolo_get_numa_infoPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+        'yolo_get_numa_info',
+      );
+  late final _yolo_get_numa_info =
+      _yolo_get_numa_infoPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  /// Threads the library may use: ONNX Runtime intra-op threads (from the next
+  /// yolo_init) and the internal task pool used by preprocessing (as soon as
+  /// running preprocessing passes finish; detect calls may overlap it).
+  /// 0 restores the default, min(4, hardware threads).
+  void yolo_set_thread_budget(int threads) {
+    return _yolo_set_thread_budget(threads);
+  }
+
+  late final _yolo_set_thread_budgetPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Int)>>(
+        'yolo_set_thread_budget',
+      );
+  late final _yolo_set_thread_budget =
+      _yolo_set_thread_budgetPtr.asFunction<void Function(int)>();
+
+  int yolo_get_thread_budget() {
+    return _yolo_get_thread_budget();
+  }
+
+  late final _yolo_get_thread_budgetPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function()>>('yolo_get_thread_budget');
+  late final _yolo_get_thread_budget =
+      _yolo_get_thread_budgetPtr.asFunction<int Function()>();
+
   /// Run detection on image file path
   /// Returns JSON string with detection results (caller must free with free_string)
   ffi.Pointer<ffi.Char> yolo_detect_path(
@@ -179,59 +231,1889 @@ class FlutterYoloOpenKitBindings {
             )
           >();
 
-  /// Set custom class names (JSON array string)
-  void yolo_set_classes(ffi.Pointer<ffi.Char> class_names_json) {
-    return _yolo_set_classes(class_names_json);
+  /// Monotonic clock used for capture timestamps, in nanoseconds
+  int yolo_now_ns() {
+    return _yolo_now_ns();
   }
 
-  late final _yolo_set_classesPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char>)>>(
-        'yolo_set_classes',
+  late final _yolo_now_nsPtr =
+      _lookup<ffi.NativeFunction<ffi.Int64 Function()>>('yolo_now_ns');
+  late final _yolo_now_ns = _yolo_now_nsPtr.asFunction<int Function()>();
+
+  /// Same as yolo_detect_path / yolo_detect_buffer / yolo_detect_yuv, plus
+  /// options (may be NULL). The result additionally reports frame_id,
+  /// queue_wait_ms, processing_ms and frame_age_ms (capture to result).
+  ffi.Pointer<ffi.Char> yolo_detect_path_ex(
+    ffi.Pointer<ffi.Char> image_path,
+    double conf_threshold,
+    double iou_threshold,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_detect_path_ex(
+      image_path,
+      conf_threshold,
+      iou_threshold,
+      options,
+    );
+  }
+
+  late final _yolo_detect_path_exPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<ffi.Char> Function(
+        ffi.Pointer<ffi.Char>,
+        ffi.Float,
+        ffi.Float,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_detect_path_ex');
+  late final _yolo_detect_path_ex =
+      _yolo_detect_path_exPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>,
+              double,
+              double,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  ffi.Pointer<ffi.Char> yolo_detect_buffer_ex(
+    ffi.Pointer<ffi.Uint8> image_data,
+    int width,
+    int height,
+    int stride,
+    double conf_threshold,
+    double iou_threshold,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_detect_buffer_ex(
+      image_data,
+      width,
+      height,
+      stride,
+      conf_threshold,
+      iou_threshold,
+      options,
+    );
+  }
+
+  late final _yolo_detect_buffer_exPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<ffi.Char> Function(
+        ffi.Pointer<ffi.Uint8>,
+        ffi.Int,
+        ffi.Int,
+        ffi.Int,
+        ffi.Float,
+        ffi.Float,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_detect_buffer_ex');
+  late final _yolo_detect_buffer_ex =
+      _yolo_detect_buffer_exPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Uint8>,
+              int,
+              int,
+              int,
+              double,
+              double,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  ffi.Pointer<ffi.Char> yolo_detect_yuv_ex(
+    ffi.Pointer<ffi.Uint8> y_data,
+    ffi.Pointer<ffi.Uint8> u_data,
+    ffi.Pointer<ffi.Uint8> v_data,
+    int width,
+    int height,
+    int y_row_stride,
+    int uv_row_stride,
+    int uv_pixel_stride,
+    int rotation,
+    double conf_threshold,
+    double iou_threshold,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_detect_yuv_ex(
+      y_data,
+      u_data,
+      v_data,
+      width,
+      height,
+      y_row_stride,
+      uv_row_stride,
+      uv_pixel_stride,
+      rotation,
+      conf_threshold,
+      iou_threshold,
+      options,
+    );
+  }
+
+  late final _yolo_detect_yuv_exPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<ffi.Char> Function(
+        ffi.Pointer<ffi.Uint8>,
+        ffi.Pointer<ffi.Uint8>,
+        ffi.Pointer<ffi.Uint8>,
+        ffi.Int,
+        ffi.Int,
+        ffi.Int,
+        ffi.Int,
+        ffi.Int,
+        ffi.Int,
+        ffi.Float,
+        ffi.Float,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_detect_yuv_ex');
+  late final _yolo_detect_yuv_ex =
+      _yolo_detect_yuv_exPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Pointer<ffi.Uint8>,
+              ffi.Pointer<ffi.Uint8>,
+              int,
+              int,
+              int,
+              int,
+              int,
+              int,
+              double,
+              double,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  /// Run detection on a frame described by desc. options may be NULL.
+  /// Returns JSON string with detection results (caller must free with free_string)
+  ffi.Pointer<ffi.Char> yolo_detect_frame(
+    ffi.Pointer<YoloFrameDesc> desc,
+    double conf_threshold,
+    double iou_threshold,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_detect_frame(desc, conf_threshold, iou_threshold, options);
+  }
+
+  late final _yolo_detect_framePtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<ffi.Char> Function(
+        ffi.Pointer<YoloFrameDesc>,
+        ffi.Float,
+        ffi.Float,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_detect_frame');
+  late final _yolo_detect_frame =
+      _yolo_detect_framePtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<YoloFrameDesc>,
+              double,
+              double,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  /// Whether the image contains a detection of one of class_ids (NULL or
+  /// class_count 0 = any class) scoring at least conf_threshold. Decoding stops
+  /// at the first hit; no NMS and no JSON. options may be NULL.
+  /// Returns 1 if present, 0 if not, or a negative YoloStatus.
+  int yolo_detect_presence(
+    ffi.Pointer<YoloInput> input,
+    ffi.Pointer<ffi.Int32> class_ids,
+    int class_count,
+    double conf_threshold,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_detect_presence(input, class_ids, class_count, conf_threshold, options);
+  }
+
+  late final _yolo_detect_presencePtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Int Function(
+        ffi.Pointer<YoloInput>,
+        ffi.Pointer<ffi.Int32>,
+        ffi.Int,
+        ffi.Float,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_detect_presence');
+  late final _yolo_detect_presence =
+      _yolo_detect_presencePtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<YoloInput>,
+              ffi.Pointer<ffi.Int32>,
+              int,
+              double,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  /// Per-class detection counts after NMS, without building detection JSON.
+  /// counts[class_id] receives each class's count for the first counts_len
+  /// classes (counts may be NULL for the total only); class_ids filters as in
+  /// yolo_detect_presence. options may be NULL.
+  /// Returns the total count, or a negative YoloStatus.
+  int yolo_detect_count(
+    ffi.Pointer<YoloInput> input,
+    ffi.Pointer<ffi.Int32> class_ids,
+    int class_count,
+    double conf_threshold,
+    double iou_threshold,
+    ffi.Pointer<ffi.Int32> counts,
+    int counts_len,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_detect_count(
+      input,
+      class_ids,
+      class_count,
+      conf_threshold,
+      iou_threshold,
+      counts,
+      counts_len,
+      options,
+    );
+  }
+
+  late final _yolo_detect_countPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Int Function(
+        ffi.Pointer<YoloInput>,
+        ffi.Pointer<ffi.Int32>,
+        ffi.Int,
+        ffi.Float,
+        ffi.Float,
+        ffi.Pointer<ffi.Int32>,
+        ffi.Int,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_detect_count');
+  late final _yolo_detect_count =
+      _yolo_detect_countPtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<YoloInput>,
+              ffi.Pointer<ffi.Int32>,
+              int,
+              double,
+              double,
+              ffi.Pointer<ffi.Int32>,
+              int,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  /// Per-detection appearance embeddings for re-identification, pooled in the
+  /// same pass from a neck feature map the model exposes as an extra
+  /// [1, C, H, W] output named output_name. pooled_size is the RoIAlign bins per
+  /// side: 1 = average pooling (C floats), 2 = 4 * C floats. Embeddings are
+  /// L2-normalized. Applies from the next yolo_init / yolo_init_numa; NULL or ""
+  /// disables.
+  void yolo_set_embedding_output(
+    ffi.Pointer<ffi.Char> output_name,
+    int pooled_size,
+  ) {
+    return _yolo_set_embedding_output(output_name, pooled_size);
+  }
+
+  late final _yolo_set_embedding_outputPtr = _lookup<
+    ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char>, ffi.Int)>
+  >('yolo_set_embedding_output');
+  late final _yolo_set_embedding_output =
+      _yolo_set_embedding_outputPtr
+          .asFunction<void Function(ffi.Pointer<ffi.Char>, int)>();
+
+  /// Floats per embedding (0 if the loaded model has no embedding output)
+  int yolo_get_embedding_dim() {
+    return _yolo_get_embedding_dim();
+  }
+
+  late final _yolo_get_embedding_dimPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function()>>('yolo_get_embedding_dim');
+  late final _yolo_get_embedding_dim =
+      _yolo_get_embedding_dimPtr.asFunction<int Function()>();
+
+  /// Fold the RGB channel order and /255 scaling of YOLOv8 / PP-YOLOE models
+  /// into the first convolution's weights at load, so frames are fed as raw BGR
+  /// 0-255 and preprocessing skips the per-pixel multiply. Results are the same
+  /// up to float rounding. Applies from the next yolo_init / yolo_init_numa;
+  /// models whose input does not feed a single plain Conv load unchanged.
+  void yolo_set_fold_input(int enabled) {
+    return _yolo_set_fold_input(enabled);
+  }
+
+  late final _yolo_set_fold_inputPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Int)>>(
+        'yolo_set_fold_input',
       );
-  late final _yolo_set_classes =
-      _yolo_set_classesPtr.asFunction<void Function(ffi.Pointer<ffi.Char>)>();
+  late final _yolo_set_fold_input =
+      _yolo_set_fold_inputPtr.asFunction<void Function(int)>();
 
-  /// Release detector resources
-  void yolo_release() {
-    return _yolo_release();
+  /// 1 if the loaded model was rewritten by yolo_set_fold_input
+  int yolo_is_input_folded() {
+    return _yolo_is_input_folded();
   }
 
-  late final _yolo_releasePtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function()>>('yolo_release');
-  late final _yolo_release = _yolo_releasePtr.asFunction<void Function()>();
+  late final _yolo_is_input_foldedPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function()>>(
+        'yolo_is_input_folded',
+      );
+  late final _yolo_is_input_folded =
+      _yolo_is_input_foldedPtr.asFunction<int Function()>();
 
-  /// Free allocated string
-  void free_string(ffi.Pointer<ffi.Char> str) {
-    return _free_string(str);
+  /// Inference backend (YoloBackend) for the next yolo_init / yolo_init_numa.
+  /// OpenCV DNN sizes OpenCV's process-wide thread pool (cv::setNumThreads) and
+  /// cannot preempt a running background call.
+  /// Returns 1, or 0 if that backend was not compiled in (setting unchanged).
+  int yolo_set_backend(int backend) {
+    return _yolo_set_backend(backend);
   }
 
-  late final _free_stringPtr =
-      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char>)>>(
-        'free_string',
+  late final _yolo_set_backendPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.Int)>>(
+        'yolo_set_backend',
       );
-  late final _free_string =
-      _free_stringPtr.asFunction<void Function(ffi.Pointer<ffi.Char>)>();
+  late final _yolo_set_backend =
+      _yolo_set_backendPtr.asFunction<int Function(int)>();
 
-  /// Get version info
-  ffi.Pointer<ffi.Char> yolo_get_version() {
-    return _yolo_get_version();
+  /// Name of the loaded model's backend ("onnxruntime", "opencv-dnn"), "" before
+  /// init. Static string, do not free.
+  ffi.Pointer<ffi.Char> yolo_get_backend_name() {
+    return _yolo_get_backend_name();
   }
 
-  late final _yolo_get_versionPtr =
+  late final _yolo_get_backend_namePtr =
       _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
-        'yolo_get_version',
+        'yolo_get_backend_name',
       );
-  late final _yolo_get_version =
-      _yolo_get_versionPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+  late final _yolo_get_backend_name =
+      _yolo_get_backend_namePtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
 
-  /// Check if detector is initialized
-  /// Returns 1 if initialized, 0 otherwise
-  int yolo_is_initialized() {
-    return _yolo_is_initialized();
+  /// Binary detection result: up to max_boxes boxes by descending confidence
+  /// and, if embeddings is not NULL, yolo_get_embedding_dim() floats per written
+  /// box (as many as fit in embedding_capacity floats). image_width /
+  /// image_height (may be NULL) receive the frame size boxes refer to.
+  /// options may be NULL. Returns the number of detections (may exceed
+  /// max_boxes), or a negative YoloStatus.
+  int yolo_detect_boxes(
+    ffi.Pointer<YoloInput> input,
+    double conf_threshold,
+    double iou_threshold,
+    ffi.Pointer<YoloBox> boxes,
+    int max_boxes,
+    ffi.Pointer<ffi.Float> embeddings,
+    int embedding_capacity,
+    ffi.Pointer<ffi.Int32> image_width,
+    ffi.Pointer<ffi.Int32> image_height,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_detect_boxes(
+      input,
+      conf_threshold,
+      iou_threshold,
+      boxes,
+      max_boxes,
+      embeddings,
+      embedding_capacity,
+      image_width,
+      image_height,
+      options,
+    );
   }
 
-  late final _yolo_is_initializedPtr =
-      _lookup<ffi.NativeFunction<ffi.Int Function()>>('yolo_is_initialized');
-  late final _yolo_is_initialized =
-      _yolo_is_initializedPtr.asFunction<int Function()>();
-}
+  late final _yolo_detect_boxesPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Int Function(
+        ffi.Pointer<YoloInput>,
+        ffi.Float,
+        ffi.Float,
+        ffi.Pointer<YoloBox>,
+        ffi.Int,
+        ffi.Pointer<ffi.Float>,
+        ffi.Int,
+        ffi.Pointer<ffi.Int32>,
+        ffi.Pointer<ffi.Int32>,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_detect_boxes');
+  late final _yolo_detect_boxes =
+      _yolo_detect_boxesPtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<YoloInput>,
+              double,
+              double,
+              ffi.Pointer<YoloBox>,
+              int,
+              ffi.Pointer<ffi.Float>,
+              int,
+              ffi.Pointer<ffi.Int32>,
+              ffi.Pointer<ffi.Int32>,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  /// Sequence of the newest published frame (0 = none yet)
+  int yolo_latest_sequence(
+    ffi.Pointer<YoloStream> stream,
+  ) {
+    return _yolo_latest_sequence(stream);
+  }
+
+  late final _yolo_latest_sequencePtr =
+      _lookup<ffi.NativeFunction<ffi.Int64 Function(ffi.Pointer<YoloStream>)>>(
+        'yolo_latest_sequence',
+      );
+  late final _yolo_latest_sequence =
+      _yolo_latest_sequencePtr.asFunction<int Function(ffi.Pointer<YoloStream>)>();
+
+  /// Copy the newest frame into info and up to max_boxes boxes if its sequence
+  /// differs from last_sequence. Returns 1 if a frame was copied, 0 if there is
+  /// nothing newer (or another thread is polling the same slot), or a negative
+  /// YoloStatus.
+  int yolo_latest_poll(
+    ffi.Pointer<YoloStream> stream,
+    int last_sequence,
+    ffi.Pointer<YoloLatestInfo> info,
+    ffi.Pointer<YoloBox> boxes,
+    int max_boxes,
+  ) {
+    return _yolo_latest_poll(stream, last_sequence, info, boxes, max_boxes);
+  }
+
+  late final _yolo_latest_pollPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Int Function(
+        ffi.Pointer<YoloStream>,
+        ffi.Int64,
+        ffi.Pointer<YoloLatestInfo>,
+        ffi.Pointer<YoloBox>,
+        ffi.Int,
+      )
+    >
+  >('yolo_latest_poll');
+  late final _yolo_latest_poll =
+      _yolo_latest_pollPtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<YoloStream>,
+              int,
+              ffi.Pointer<YoloLatestInfo>,
+              ffi.Pointer<YoloBox>,
+              int,
+            )
+          >();
+
+  /// Run the model on a prepared input tensor (float32, shape [N, 3, H, W],
+  /// rank 4) with no preprocessing or decoding. The tensor is laid out as the
+  /// model expects: YOLOv8 / PP-YOLOE RGB in [0, 1] (raw BGR 0-255 when
+  /// yolo_is_input_folded), YOLOX BGR 0-255; input is not copied and only needs
+  /// to stay valid for the call. PP-YOLOE's scale_factor input is fed as 1.
+  /// outputs receives views of the first max_outputs outputs (detection outputs,
+  /// then the embedding output if set) pointing into *result, which stays valid
+  /// until yolo_tensor_release, even across yolo_release. options may be NULL.
+  /// Returns the number of outputs, or a negative YoloStatus (*result is NULL).
+  int yolo_run_tensor(
+    ffi.Pointer<ffi.Float> input,
+    ffi.Pointer<ffi.Int64> shape,
+    int rank,
+    ffi.Pointer<YoloTensorView> outputs,
+    int max_outputs,
+    ffi.Pointer<ffi.Pointer<YoloTensorResult>> result,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_run_tensor(
+      input,
+      shape,
+      rank,
+      outputs,
+      max_outputs,
+      result,
+      options,
+    );
+  }
+
+  late final _yolo_run_tensorPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Int Function(
+        ffi.Pointer<ffi.Float>,
+        ffi.Pointer<ffi.Int64>,
+        ffi.Int,
+        ffi.Pointer<YoloTensorView>,
+        ffi.Int,
+        ffi.Pointer<ffi.Pointer<YoloTensorResult>>,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_run_tensor');
+  late final _yolo_run_tensor =
+      _yolo_run_tensorPtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<ffi.Float>,
+              ffi.Pointer<ffi.Int64>,
+              int,
+              ffi.Pointer<YoloTensorView>,
+              int,
+              ffi.Pointer<ffi.Pointer<YoloTensorResult>>,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  void yolo_tensor_release(
+    ffi.Pointer<YoloTensorResult> result,
+  ) {
+    return _yolo_tensor_release(result);
+  }
+
+  late final _yolo_tensor_releasePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<YoloTensorResult>)>>(
+        'yolo_tensor_release',
+      );
+  late final _yolo_tensor_release =
+      _yolo_tensor_releasePtr.asFunction<void Function(ffi.Pointer<YoloTensorResult>)>();
+
+  /// Model input width and height. Returns 0 if no model is loaded.
+  int yolo_get_input_size(
+    ffi.Pointer<ffi.Int32> width,
+    ffi.Pointer<ffi.Int32> height,
+  ) {
+    return _yolo_get_input_size(width, height);
+  }
+
+  late final _yolo_get_input_sizePtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Int Function(
+        ffi.Pointer<ffi.Int32>,
+        ffi.Pointer<ffi.Int32>,
+      )
+    >
+  >('yolo_get_input_size');
+  late final _yolo_get_input_size =
+      _yolo_get_input_sizePtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<ffi.Int32>,
+              ffi.Pointer<ffi.Int32>,
+            )
+          >();
+
+  /// Batch detection over image files (JSON array of paths, or the .jpg/.jpeg/
+  /// .png/.bmp files in a directory, sorted by name). File contents are read
+  /// ahead with io_uring where available (a few pread threads otherwise) into a
+  /// bounded buffer pool and decoded from memory. options may be NULL, in which
+  /// case calls run at background priority; frame_id is the file index. A file
+  /// preempted by higher priority work is run again once that work has drained;
+  /// yolo_cancel_background stops a background scan.
+  /// Returns {"backend","count","bytes_read","io_wait_ms","skipped","skip_rate",
+  /// "preempted","cancelled","results":[...]} where each result is a detection
+  /// result plus "path" and its "io_wait_ms" ("preempted" if it was retried).
+  /// After a cancel, the files not processed are listed with code CANCELLED
+  /// (caller must free with free_string).
+  ffi.Pointer<ffi.Char> yolo_detect_paths(
+    ffi.Pointer<ffi.Char> paths_json,
+    double conf_threshold,
+    double iou_threshold,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_detect_paths(paths_json, conf_threshold, iou_threshold, options);
+  }
+
+  late final _yolo_detect_pathsPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<ffi.Char> Function(
+        ffi.Pointer<ffi.Char>,
+        ffi.Float,
+        ffi.Float,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_detect_paths');
+  late final _yolo_detect_paths =
+      _yolo_detect_pathsPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>,
+              double,
+              double,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  ffi.Pointer<ffi.Char> yolo_detect_directory(
+    ffi.Pointer<ffi.Char> directory,
+    double conf_threshold,
+    double iou_threshold,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_detect_directory(directory, conf_threshold, iou_threshold, options);
+  }
+
+  late final _yolo_detect_directoryPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<ffi.Char> Function(
+        ffi.Pointer<ffi.Char>,
+        ffi.Float,
+        ffi.Float,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_detect_directory');
+  late final _yolo_detect_directory =
+      _yolo_detect_directoryPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>,
+              double,
+              double,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  /// Near-duplicate skipping for batch scans: each file is hashed (dHash) from a
+  /// reduced decode, and when a recent image with the same dimensions is at most
+  /// max_distance bits away its detections are reused instead of running the
+  /// model. Reused results carry "reused_from" and "hash_distance"; the scan
+  /// reports "skipped" and "skip_rate". -1 disables (default); 0 reuses only
+  /// identical hashes, 8-12 (of 128 bits) catches typical burst shots.
+  void yolo_set_batch_dedup(int max_distance) {
+    return _yolo_set_batch_dedup(max_distance);
+  }
+
+  late final _yolo_set_batch_dedupPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Int)>>(
+        'yolo_set_batch_dedup',
+      );
+  late final _yolo_set_batch_dedup =
+      _yolo_set_batch_dedupPtr.asFunction<void Function(int)>();
+
+  /// Sparse detection over a video file: one frame every interval_seconds of
+  /// media time (<= 0 = every frame). Frames between samples are decoded
+  /// without color conversion (grab without retrieve), or skipped by seeking
+  /// when the gap exceeds keyframe_interval frames (the assumed GOP length;
+  /// 0 = never seek, negative = default 250). Only sampled frames are converted
+  /// and detected. options may be NULL, in which case calls run at background
+  /// priority; frame_id is the frame index in the video.
+  /// Returns {"fps","frame_count","duration_s","sampled","skipped","seeks",
+  /// "decode_ms","convert_ms","detect_ms","wall_ms","media_s",
+  /// "realtime_factor","results":[...]} where each result is a detection result
+  /// plus "frame_index" and "time_s", or an error with code VIDEO_OPEN_FAILED /
+  /// DECODER_UNAVAILABLE (built without OpenCV videoio) (caller must free with
+  /// free_string).
+  ffi.Pointer<ffi.Char> yolo_detect_video(
+    ffi.Pointer<ffi.Char> video_path,
+    double interval_seconds,
+    int keyframe_interval,
+    double conf_threshold,
+    double iou_threshold,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_detect_video(
+      video_path,
+      interval_seconds,
+      keyframe_interval,
+      conf_threshold,
+      iou_threshold,
+      options,
+    );
+  }
+
+  late final _yolo_detect_videoPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<ffi.Char> Function(
+        ffi.Pointer<ffi.Char>,
+        ffi.Double,
+        ffi.Int,
+        ffi.Float,
+        ffi.Float,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_detect_video');
+  late final _yolo_detect_video =
+      _yolo_detect_videoPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<ffi.Char>,
+              double,
+              int,
+              double,
+              double,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  /// decode_threads: parallel decoders (<= 0 = thread budget). decode_scale: 1,
+  /// 2, 4 or 8, or 0 for the largest that keeps frames at least the model input
+  /// size (full size before yolo_init). drop_late: 1 to drop the oldest
+  /// undelivered frame when detection falls behind (live sources), 0 to pause
+  /// reading instead.
+  /// yolo_mjpeg_open_fd reads fd, which the caller keeps and closes after
+  /// yolo_mjpeg_close; yolo_mjpeg_open opens path (a FIFO may have no writer
+  /// yet). Returns NULL on invalid arguments; open / read errors are reported
+  /// by yolo_mjpeg_get_stats.
+  ffi.Pointer<YoloMjpegIngest> yolo_mjpeg_open_fd(
+    int fd,
+    int decode_threads,
+    int decode_scale,
+    int drop_late,
+  ) {
+    return _yolo_mjpeg_open_fd(fd, decode_threads, decode_scale, drop_late);
+  }
+
+  late final _yolo_mjpeg_open_fdPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<YoloMjpegIngest> Function(
+        ffi.Int,
+        ffi.Int,
+        ffi.Int,
+        ffi.Int,
+      )
+    >
+  >('yolo_mjpeg_open_fd');
+  late final _yolo_mjpeg_open_fd =
+      _yolo_mjpeg_open_fdPtr
+          .asFunction<
+            ffi.Pointer<YoloMjpegIngest> Function(
+              int,
+              int,
+              int,
+              int,
+            )
+          >();
+
+  ffi.Pointer<YoloMjpegIngest> yolo_mjpeg_open(
+    ffi.Pointer<ffi.Char> path,
+    int decode_threads,
+    int decode_scale,
+    int drop_late,
+  ) {
+    return _yolo_mjpeg_open(path, decode_threads, decode_scale, drop_late);
+  }
+
+  late final _yolo_mjpeg_openPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<YoloMjpegIngest> Function(
+        ffi.Pointer<ffi.Char>,
+        ffi.Int,
+        ffi.Int,
+        ffi.Int,
+      )
+    >
+  >('yolo_mjpeg_open');
+  late final _yolo_mjpeg_open =
+      _yolo_mjpeg_openPtr
+          .asFunction<
+            ffi.Pointer<YoloMjpegIngest> Function(
+              ffi.Pointer<ffi.Char>,
+              int,
+              int,
+              int,
+            )
+          >();
+
+  /// Detect on the next frame in stream order, blocking until it is decoded.
+  /// Returns a detection result plus "frame_index" (position in the stream) and
+  /// "decode_scale" (as applied: 1 where the decoder cannot scale); boxes and
+  /// image size refer to the decoded frame. frame_id defaults to the frame index
+  /// and capture_ts_ns to when the frame was read.
+  /// Returns NULL at the end of the stream (caller must free with free_string).
+  ffi.Pointer<ffi.Char> yolo_mjpeg_detect_next(
+    ffi.Pointer<YoloMjpegIngest> ingest,
+    double conf_threshold,
+    double iou_threshold,
+    ffi.Pointer<YoloDetectOptions> options,
+  ) {
+    return _yolo_mjpeg_detect_next(
+      ingest,
+      conf_threshold,
+      iou_threshold,
+      options,
+    );
+  }
+
+  late final _yolo_mjpeg_detect_nextPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<ffi.Char> Function(
+        ffi.Pointer<YoloMjpegIngest>,
+        ffi.Float,
+        ffi.Float,
+        ffi.Pointer<YoloDetectOptions>,
+      )
+    >
+  >('yolo_mjpeg_detect_next');
+  late final _yolo_mjpeg_detect_next =
+      _yolo_mjpeg_detect_nextPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<YoloMjpegIngest>,
+              double,
+              double,
+              ffi.Pointer<YoloDetectOptions>,
+            )
+          >();
+
+  /// {"frames","delivered","dropped","corrupt","oversize","skipped_bytes",
+  /// "bytes_read","decode_threads","decode_scale","scan","decode_ms",
+  /// "mean_decode_ms","consumer_wait_ms","reader_stall_ms","elapsed_s",
+  /// "source_fps","delivered_fps","eof","error"} (caller must free with
+  /// free_string)
+  ffi.Pointer<ffi.Char> yolo_mjpeg_get_stats(
+    ffi.Pointer<YoloMjpegIngest> ingest,
+  ) {
+    return _yolo_mjpeg_get_stats(ingest);
+  }
+
+  late final _yolo_mjpeg_get_statsPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function(ffi.Pointer<YoloMjpegIngest>)>>(
+        'yolo_mjpeg_get_stats',
+      );
+  late final _yolo_mjpeg_get_stats =
+      _yolo_mjpeg_get_statsPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<YoloMjpegIngest>,
+            )
+          >();
+
+  /// Stop reading and release; no yolo_mjpeg_detect_next call may be running
+  void yolo_mjpeg_close(
+    ffi.Pointer<YoloMjpegIngest> ingest,
+  ) {
+    return _yolo_mjpeg_close(ingest);
+  }
+
+  late final _yolo_mjpeg_closePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<YoloMjpegIngest>)>>(
+        'yolo_mjpeg_close',
+      );
+  late final _yolo_mjpeg_close =
+      _yolo_mjpeg_closePtr.asFunction<void Function(ffi.Pointer<YoloMjpegIngest>)>();
+
+  /// Get latency metrics as JSON: queue wait, processing time and a frame age
+  /// histogram (caller must free with free_string)
+  ffi.Pointer<ffi.Char> yolo_get_metrics() {
+    return _yolo_get_metrics();
+  }
+
+  late final _yolo_get_metricsPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+        'yolo_get_metrics',
+      );
+  late final _yolo_get_metrics =
+      _yolo_get_metricsPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  /// Reset latency metrics
+  void yolo_reset_metrics() {
+    return _yolo_reset_metrics();
+  }
+
+  late final _yolo_reset_metricsPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function()>>('yolo_reset_metrics');
+  late final _yolo_reset_metrics =
+      _yolo_reset_metricsPtr.asFunction<void Function()>();
+
+  /// Queue limits per class (queued, not running, calls; 0 = never queue) and
+  /// whether background calls are preempted. Negative values keep the current limit.
+  void yolo_set_scheduler_limits(
+    int max_realtime,
+    int max_interactive,
+    int max_background,
+    int preempt_background,
+  ) {
+    return _yolo_set_scheduler_limits(
+      max_realtime,
+      max_interactive,
+      max_background,
+      preempt_background,
+    );
+  }
+
+  late final _yolo_set_scheduler_limitsPtr =
+      _lookup<
+        ffi.NativeFunction<ffi.Void Function(ffi.Int, ffi.Int, ffi.Int, ffi.Int)>
+      >('yolo_set_scheduler_limits');
+  late final _yolo_set_scheduler_limits =
+      _yolo_set_scheduler_limitsPtr
+          .asFunction<void Function(int, int, int, int)>();
+
+  /// Cancel queued background calls and abort a running one (not on OpenCV DNN,
+  /// which cannot abort a run). Returns the number of calls affected.
+  int yolo_cancel_background() {
+    return _yolo_cancel_background();
+  }
+
+  late final _yolo_cancel_backgroundPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function()>>('yolo_cancel_background');
+  late final _yolo_cancel_background =
+      _yolo_cancel_backgroundPtr.asFunction<int Function()>();
+
+  /// Per-class admitted / rejected / shed / cancelled / preempted counts as JSON,
+  /// with "preemption_supported" (false on OpenCV DNN, where background calls
+  /// are never preempted). After yolo_init_numa the counts cover all replicas;
+  /// yolo_get_numa_info has them per replica (caller must free with free_string)
+  ffi.Pointer<ffi.Char> yolo_get_scheduler_stats() {
+    return _yolo_get_scheduler_stats();
+  }
+
+  late final _yolo_get_scheduler_statsPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+        'yolo_get_scheduler_stats',
+      );
+  late final _yolo_get_scheduler_stats =
+      _yolo_get_scheduler_statsPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  /// Create a log, or append to an existing one with the same stream name and
+  /// class table. class_names_json: JSON array, or NULL for the detector's classes.
+  /// Names are stored cut to 255 bytes. Returns NULL on failure.
+  ffi.Pointer<YoloLogWriter> yolo_log_writer_open(
+    ffi.Pointer<ffi.Char> path,
+    ffi.Pointer<ffi.Char> stream_name,
+    ffi.Pointer<ffi.Char> class_names_json,
+  ) {
+    return _yolo_log_writer_open(path, stream_name, class_names_json);
+  }
+
+  late final _yolo_log_writer_openPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<YoloLogWriter> Function(
+            ffi.Pointer<ffi.Char>,
+            ffi.Pointer<ffi.Char>,
+            ffi.Pointer<ffi.Char>,
+          )
+        >
+      >('yolo_log_writer_open');
+  late final _yolo_log_writer_open =
+      _yolo_log_writer_openPtr
+          .asFunction<
+            ffi.Pointer<YoloLogWriter> Function(
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>,
+              ffi.Pointer<ffi.Char>,
+            )
+          >();
+
+  /// Append one frame. Returns 1 on success, 0 on failure (including more than
+  /// 65535 boxes, or a class id outside the log's range: 0-255 for up to 255
+  /// classes, else 0-65535).
+  int yolo_log_write_frame(
+    ffi.Pointer<YoloLogWriter> writer,
+    int timestamp_ns,
+    int width,
+    int height,
+    ffi.Pointer<YoloLogBox> boxes,
+    int count,
+  ) {
+    return _yolo_log_write_frame(
+      writer,
+      timestamp_ns,
+      width,
+      height,
+      boxes,
+      count,
+    );
+  }
+
+  late final _yolo_log_write_framePtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Int Function(
+            ffi.Pointer<YoloLogWriter>,
+            ffi.Int64,
+            ffi.Int,
+            ffi.Int,
+            ffi.Pointer<YoloLogBox>,
+            ffi.Int,
+          )
+        >
+      >('yolo_log_write_frame');
+  late final _yolo_log_write_frame =
+      _yolo_log_write_framePtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<YoloLogWriter>,
+              int,
+              int,
+              int,
+              ffi.Pointer<YoloLogBox>,
+              int,
+            )
+          >();
+
+  void yolo_log_writer_flush(ffi.Pointer<YoloLogWriter> writer) {
+    return _yolo_log_writer_flush(writer);
+  }
+
+  late final _yolo_log_writer_flushPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<YoloLogWriter>)>>(
+        'yolo_log_writer_flush',
+      );
+  late final _yolo_log_writer_flush =
+      _yolo_log_writer_flushPtr
+          .asFunction<void Function(ffi.Pointer<YoloLogWriter>)>();
+
+  /// Close the log (detaches it from the detector first)
+  void yolo_log_writer_close(ffi.Pointer<YoloLogWriter> writer) {
+    return _yolo_log_writer_close(writer);
+  }
+
+  late final _yolo_log_writer_closePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<YoloLogWriter>)>>(
+        'yolo_log_writer_close',
+      );
+  late final _yolo_log_writer_close =
+      _yolo_log_writer_closePtr
+          .asFunction<void Function(ffi.Pointer<YoloLogWriter>)>();
+
+  /// Log every detect call of the detector into this writer (NULL detaches).
+  /// Frames are stamped with the capture timestamp when given, else the start time.
+  /// Returns 1 on success, 0 if the detector is not initialized.
+  int yolo_log_attach(ffi.Pointer<YoloLogWriter> writer) {
+    return _yolo_log_attach(writer);
+  }
+
+  late final _yolo_log_attachPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function(ffi.Pointer<YoloLogWriter>)>>(
+        'yolo_log_attach',
+      );
+  late final _yolo_log_attach =
+      _yolo_log_attachPtr.asFunction<int Function(ffi.Pointer<YoloLogWriter>)>();
+
+  /// Open a log for reading. Returns NULL if the file is not a valid log.
+  ffi.Pointer<YoloLogReader> yolo_log_reader_open(ffi.Pointer<ffi.Char> path) {
+    return _yolo_log_reader_open(path);
+  }
+
+  late final _yolo_log_reader_openPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<YoloLogReader> Function(ffi.Pointer<ffi.Char>)
+        >
+      >('yolo_log_reader_open');
+  late final _yolo_log_reader_open =
+      _yolo_log_reader_openPtr
+          .asFunction<
+            ffi.Pointer<YoloLogReader> Function(ffi.Pointer<ffi.Char>)
+          >();
+
+  int yolo_log_reader_frame_count(ffi.Pointer<YoloLogReader> reader) {
+    return _yolo_log_reader_frame_count(reader);
+  }
+
+  late final _yolo_log_reader_frame_countPtr =
+      _lookup<ffi.NativeFunction<ffi.Int64 Function(ffi.Pointer<YoloLogReader>)>>(
+        'yolo_log_reader_frame_count',
+      );
+  late final _yolo_log_reader_frame_count =
+      _yolo_log_reader_frame_countPtr
+          .asFunction<int Function(ffi.Pointer<YoloLogReader>)>();
+
+  /// Decode a frame into up to max_boxes boxes (boxes may be NULL to query the count).
+  /// Returns the frame's detection count, or -1 if index is out of range.
+  int yolo_log_reader_read_frame(
+    ffi.Pointer<YoloLogReader> reader,
+    int index,
+    ffi.Pointer<ffi.Int64> timestamp_ns,
+    ffi.Pointer<ffi.Int> width,
+    ffi.Pointer<ffi.Int> height,
+    ffi.Pointer<YoloLogBox> boxes,
+    int max_boxes,
+  ) {
+    return _yolo_log_reader_read_frame(
+      reader,
+      index,
+      timestamp_ns,
+      width,
+      height,
+      boxes,
+      max_boxes,
+    );
+  }
+
+  late final _yolo_log_reader_read_framePtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Int Function(
+            ffi.Pointer<YoloLogReader>,
+            ffi.Int64,
+            ffi.Pointer<ffi.Int64>,
+            ffi.Pointer<ffi.Int>,
+            ffi.Pointer<ffi.Int>,
+            ffi.Pointer<YoloLogBox>,
+            ffi.Int,
+          )
+        >
+      >('yolo_log_reader_read_frame');
+  late final _yolo_log_reader_read_frame =
+      _yolo_log_reader_read_framePtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<YoloLogReader>,
+              int,
+              ffi.Pointer<ffi.Int64>,
+              ffi.Pointer<ffi.Int>,
+              ffi.Pointer<ffi.Int>,
+              ffi.Pointer<YoloLogBox>,
+              int,
+            )
+          >();
+
+  /// Stream name and class table as JSON (caller must free with free_string)
+  ffi.Pointer<ffi.Char> yolo_log_reader_info(ffi.Pointer<YoloLogReader> reader) {
+    return _yolo_log_reader_info(reader);
+  }
+
+  late final _yolo_log_reader_infoPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ffi.Char> Function(ffi.Pointer<YoloLogReader>)
+        >
+      >('yolo_log_reader_info');
+  late final _yolo_log_reader_info =
+      _yolo_log_reader_infoPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(ffi.Pointer<YoloLogReader>)
+          >();
+
+  void yolo_log_reader_close(ffi.Pointer<YoloLogReader> reader) {
+    return _yolo_log_reader_close(reader);
+  }
+
+  late final _yolo_log_reader_closePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<YoloLogReader>)>>(
+        'yolo_log_reader_close',
+      );
+  late final _yolo_log_reader_close =
+      _yolo_log_reader_closePtr
+          .asFunction<void Function(ffi.Pointer<YoloLogReader>)>();
+
+  /// Convert a log to JSON lines (one object per frame).
+  /// Returns the number of frames written, or -1 on failure.
+  int yolo_log_to_jsonl(
+    ffi.Pointer<ffi.Char> log_path,
+    ffi.Pointer<ffi.Char> jsonl_path,
+  ) {
+    return _yolo_log_to_jsonl(log_path, jsonl_path);
+  }
+
+  late final _yolo_log_to_jsonlPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Int64 Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)
+        >
+      >('yolo_log_to_jsonl');
+  late final _yolo_log_to_jsonl =
+      _yolo_log_to_jsonlPtr
+          .asFunction<
+            int Function(ffi.Pointer<ffi.Char>, ffi.Pointer<ffi.Char>)
+          >();
+
+  /// Per-camera stream contexts for serving several cameras from one loaded
+  /// model. A stream carries the state that depends on its camera: the sampling
+  /// plan for its frame geometry, its own frame metrics and detection log. Pass
+  /// it in YoloDetectOptions.stream; the model session, scheduler and global
+  /// metrics stay shared. Streams survive yolo_init / yolo_release. Frames of
+  /// one stream should be submitted in order.
+  ffi.Pointer<YoloStream> yolo_stream_create(
+    ffi.Pointer<ffi.Char> name,
+  ) {
+    return _yolo_stream_create(name);
+  }
+
+  late final _yolo_stream_createPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<YoloStream> Function(ffi.Pointer<ffi.Char>)>>(
+        'yolo_stream_create',
+      );
+  late final _yolo_stream_create =
+      _yolo_stream_createPtr
+          .asFunction<
+            ffi.Pointer<YoloStream> Function(
+              ffi.Pointer<ffi.Char>,
+            )
+          >();
+
+  /// Name, last frame size, sampling plan rebuilds and the stream's frame
+  /// metrics (same fields as yolo_get_metrics) as JSON (caller must free with
+  /// free_string)
+  ffi.Pointer<ffi.Char> yolo_stream_get_metrics(
+    ffi.Pointer<YoloStream> stream,
+  ) {
+    return _yolo_stream_get_metrics(stream);
+  }
+
+  late final _yolo_stream_get_metricsPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function(ffi.Pointer<YoloStream>)>>(
+        'yolo_stream_get_metrics',
+      );
+  late final _yolo_stream_get_metrics =
+      _yolo_stream_get_metricsPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<YoloStream>,
+            )
+          >();
+
+  void yolo_stream_reset_metrics(
+    ffi.Pointer<YoloStream> stream,
+  ) {
+    return _yolo_stream_reset_metrics(stream);
+  }
+
+  late final _yolo_stream_reset_metricsPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<YoloStream>)>>(
+        'yolo_stream_reset_metrics',
+      );
+  late final _yolo_stream_reset_metrics =
+      _yolo_stream_reset_metricsPtr.asFunction<void Function(ffi.Pointer<YoloStream>)>();
+
+  /// Log this stream's frames to writer instead of the log attached with
+  /// yolo_log_attach (NULL to detach). The writer must outlive the attachment.
+  void yolo_stream_log_attach(
+    ffi.Pointer<YoloStream> stream,
+    ffi.Pointer<YoloLogWriter> writer,
+  ) {
+    return _yolo_stream_log_attach(stream, writer);
+  }
+
+  late final _yolo_stream_log_attachPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Void Function(
+        ffi.Pointer<YoloStream>,
+        ffi.Pointer<YoloLogWriter>,
+      )
+    >
+  >('yolo_stream_log_attach');
+  late final _yolo_stream_log_attach =
+      _yolo_stream_log_attachPtr
+          .asFunction<
+            void Function(
+              ffi.Pointer<YoloStream>,
+              ffi.Pointer<YoloLogWriter>,
+            )
+          >();
+
+  /// No call using the stream may be in flight
+  void yolo_stream_destroy(
+    ffi.Pointer<YoloStream> stream,
+  ) {
+    return _yolo_stream_destroy(stream);
+  }
+
+  late final _yolo_stream_destroyPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<YoloStream>)>>(
+        'yolo_stream_destroy',
+      );
+  late final _yolo_stream_destroy =
+      _yolo_stream_destroyPtr.asFunction<void Function(ffi.Pointer<YoloStream>)>();
+
+  /// keyframe_interval: packets between keyframes (0 = first packet only).
+  /// match_iou: minimum IoU for a box to be sent as a change of a previous one
+  /// (e.g. 0.3).
+  ffi.Pointer<YoloDeltaEncoder> yolo_delta_encoder_create(
+    int keyframe_interval,
+    double match_iou,
+  ) {
+    return _yolo_delta_encoder_create(keyframe_interval, match_iou);
+  }
+
+  late final _yolo_delta_encoder_createPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<YoloDeltaEncoder> Function(ffi.Int, ffi.Float)>>(
+        'yolo_delta_encoder_create',
+      );
+  late final _yolo_delta_encoder_create =
+      _yolo_delta_encoder_createPtr
+          .asFunction<
+            ffi.Pointer<YoloDeltaEncoder> Function(
+              int,
+              double,
+            )
+          >();
+
+  /// Encode one frame's boxes (pixel coordinates) into out. Returns the packet
+  /// size, or minus the required capacity if out_capacity is too small (the
+  /// frame is then not encoded).
+  int yolo_delta_encode(
+    ffi.Pointer<YoloDeltaEncoder> encoder,
+    int timestamp_ns,
+    int width,
+    int height,
+    ffi.Pointer<YoloLogBox> boxes,
+    int count,
+    ffi.Pointer<ffi.Uint8> out,
+    int out_capacity,
+  ) {
+    return _yolo_delta_encode(
+      encoder,
+      timestamp_ns,
+      width,
+      height,
+      boxes,
+      count,
+      out,
+      out_capacity,
+    );
+  }
+
+  late final _yolo_delta_encodePtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Int Function(
+        ffi.Pointer<YoloDeltaEncoder>,
+        ffi.Int64,
+        ffi.Int,
+        ffi.Int,
+        ffi.Pointer<YoloLogBox>,
+        ffi.Int,
+        ffi.Pointer<ffi.Uint8>,
+        ffi.Int,
+      )
+    >
+  >('yolo_delta_encode');
+  late final _yolo_delta_encode =
+      _yolo_delta_encodePtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<YoloDeltaEncoder>,
+              int,
+              int,
+              int,
+              ffi.Pointer<YoloLogBox>,
+              int,
+              ffi.Pointer<ffi.Uint8>,
+              int,
+            )
+          >();
+
+  /// Make the next packet a keyframe (e.g. the receiver reported OUT_OF_SYNC)
+  void yolo_delta_request_keyframe(
+    ffi.Pointer<YoloDeltaEncoder> encoder,
+  ) {
+    return _yolo_delta_request_keyframe(encoder);
+  }
+
+  late final _yolo_delta_request_keyframePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<YoloDeltaEncoder>)>>(
+        'yolo_delta_request_keyframe',
+      );
+  late final _yolo_delta_request_keyframe =
+      _yolo_delta_request_keyframePtr.asFunction<void Function(ffi.Pointer<YoloDeltaEncoder>)>();
+
+  /// Packets, keyframes, boxes, encoded_bytes, raw_bytes (full-precision boxes),
+  /// compression_ratio, bytes_per_packet, encode_ms and encode_us_per_packet as
+  /// JSON (caller must free with free_string)
+  ffi.Pointer<ffi.Char> yolo_delta_encoder_stats(
+    ffi.Pointer<YoloDeltaEncoder> encoder,
+  ) {
+    return _yolo_delta_encoder_stats(encoder);
+  }
+
+  late final _yolo_delta_encoder_statsPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Pointer<ffi.Char> Function(
+        ffi.Pointer<YoloDeltaEncoder>,
+      )
+    >
+  >('yolo_delta_encoder_stats');
+  late final _yolo_delta_encoder_stats =
+      _yolo_delta_encoder_statsPtr
+          .asFunction<
+            ffi.Pointer<ffi.Char> Function(
+              ffi.Pointer<YoloDeltaEncoder>,
+            )
+          >();
+
+  void yolo_delta_encoder_destroy(
+    ffi.Pointer<YoloDeltaEncoder> encoder,
+  ) {
+    return _yolo_delta_encoder_destroy(encoder);
+  }
+
+  late final _yolo_delta_encoder_destroyPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<YoloDeltaEncoder>)>>(
+        'yolo_delta_encoder_destroy',
+      );
+  late final _yolo_delta_encoder_destroy =
+      _yolo_delta_encoder_destroyPtr.asFunction<void Function(ffi.Pointer<YoloDeltaEncoder>)>();
+
+  ffi.Pointer<YoloDeltaDecoder> yolo_delta_decoder_create() {
+    return _yolo_delta_decoder_create();
+  }
+
+  late final _yolo_delta_decoder_createPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<YoloDeltaDecoder> Function()>>(
+        'yolo_delta_decoder_create',
+      );
+  late final _yolo_delta_decoder_create =
+      _yolo_delta_decoder_createPtr.asFunction<ffi.Pointer<YoloDeltaDecoder> Function()>();
+
+  /// Apply one packet and write the reconstructed frame into up to max_boxes
+  /// boxes (boxes may be NULL). Returns the frame's detection count, or a
+  /// negative YoloDeltaStatus (the decoder keeps its previous frame).
+  int yolo_delta_decode(
+    ffi.Pointer<YoloDeltaDecoder> decoder,
+    ffi.Pointer<ffi.Uint8> packet,
+    int size,
+    ffi.Pointer<ffi.Int64> timestamp_ns,
+    ffi.Pointer<ffi.Int> width,
+    ffi.Pointer<ffi.Int> height,
+    ffi.Pointer<YoloLogBox> boxes,
+    int max_boxes,
+  ) {
+    return _yolo_delta_decode(
+      decoder,
+      packet,
+      size,
+      timestamp_ns,
+      width,
+      height,
+      boxes,
+      max_boxes,
+    );
+  }
+
+  late final _yolo_delta_decodePtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Int Function(
+        ffi.Pointer<YoloDeltaDecoder>,
+        ffi.Pointer<ffi.Uint8>,
+        ffi.Int,
+        ffi.Pointer<ffi.Int64>,
+        ffi.Pointer<ffi.Int>,
+        ffi.Pointer<ffi.Int>,
+        ffi.Pointer<YoloLogBox>,
+        ffi.Int,
+      )
+    >
+  >('yolo_delta_decode');
+  late final _yolo_delta_decode =
+      _yolo_delta_decodePtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<YoloDeltaDecoder>,
+              ffi.Pointer<ffi.Uint8>,
+              int,
+              ffi.Pointer<ffi.Int64>,
+              ffi.Pointer<ffi.Int>,
+              ffi.Pointer<ffi.Int>,
+              ffi.Pointer<YoloLogBox>,
+              int,
+            )
+          >();
+
+  /// Boxes of the last decoded frame, as written by yolo_delta_decode.
+  /// Returns the frame's detection count.
+  int yolo_delta_decoder_boxes(
+    ffi.Pointer<YoloDeltaDecoder> decoder,
+    ffi.Pointer<YoloLogBox> boxes,
+    int max_boxes,
+  ) {
+    return _yolo_delta_decoder_boxes(decoder, boxes, max_boxes);
+  }
+
+  late final _yolo_delta_decoder_boxesPtr = _lookup<
+    ffi.NativeFunction<
+      ffi.Int Function(
+        ffi.Pointer<YoloDeltaDecoder>,
+        ffi.Pointer<YoloLogBox>,
+        ffi.Int,
+      )
+    >
+  >('yolo_delta_decoder_boxes');
+  late final _yolo_delta_decoder_boxes =
+      _yolo_delta_decoder_boxesPtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<YoloDeltaDecoder>,
+              ffi.Pointer<YoloLogBox>,
+              int,
+            )
+          >();
+
+  void yolo_delta_decoder_destroy(
+    ffi.Pointer<YoloDeltaDecoder> decoder,
+  ) {
+    return _yolo_delta_decoder_destroy(decoder);
+  }
+
+  late final _yolo_delta_decoder_destroyPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<YoloDeltaDecoder>)>>(
+        'yolo_delta_decoder_destroy',
+      );
+  late final _yolo_delta_decoder_destroy =
+      _yolo_delta_decoder_destroyPtr.asFunction<void Function(ffi.Pointer<YoloDeltaDecoder>)>();
+
+  /// Set custom class names (JSON array string)
+  void yolo_set_classes(ffi.Pointer<ffi.Char> class_names_json) {
+    return _yolo_set_classes(class_names_json);
+  }
+
+  late final _yolo_set_classesPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char>)>>(
+        'yolo_set_classes',
+      );
+  late final _yolo_set_classes =
+      _yolo_set_classesPtr.asFunction<void Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Current class names as a JSON array (caller must free with free_string)
+  ffi.Pointer<ffi.Char> yolo_get_classes() {
+    return _yolo_get_classes();
+  }
+
+  late final _yolo_get_classesPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+        'yolo_get_classes',
+      );
+  late final _yolo_get_classes =
+      _yolo_get_classesPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  /// Release detector resources
+  void yolo_release() {
+    return _yolo_release();
+  }
+
+  late final _yolo_releasePtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function()>>('yolo_release');
+  late final _yolo_release = _yolo_releasePtr.asFunction<void Function()>();
+
+  /// Free allocated string
+  void free_string(ffi.Pointer<ffi.Char> str) {
+    return _free_string(str);
+  }
+
+  late final _free_stringPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ffi.Char>)>>(
+        'free_string',
+      );
+  late final _free_string =
+      _free_stringPtr.asFunction<void Function(ffi.Pointer<ffi.Char>)>();
+
+  /// Get version info
+  ffi.Pointer<ffi.Char> yolo_get_version() {
+    return _yolo_get_version();
+  }
+
+  late final _yolo_get_versionPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ffi.Char> Function()>>(
+        'yolo_get_version',
+      );
+  late final _yolo_get_version =
+      _yolo_get_versionPtr.asFunction<ffi.Pointer<ffi.Char> Function()>();
+
+  /// Check if detector is initialized
+  /// Returns 1 if initialized, 0 otherwise
+  int yolo_is_initialized() {
+    return _yolo_is_initialized();
+  }
+
+  late final _yolo_is_initializedPtr =
+      _lookup<ffi.NativeFunction<ffi.Int Function()>>('yolo_is_initialized');
+  late final _yolo_is_initialized =
+      _yolo_is_initializedPtr.asFunction<int Function()>();
+}
+
+/// Optional per-call metadata for the *_ex detect entry points
+/// Scheduling class of a detect call. Higher classes run first; queued
+/// realtime frames are superseded by newer ones (FRAME_SHED), full queues
+/// reject new calls (QUEUE_FULL), and a running background call is aborted
+/// when realtime or interactive work arrives (CANCELLED).
+abstract class YoloPriority {
+  /// default: user-triggered calls
+  static const int YOLO_PRIORITY_INTERACTIVE = 0;
+
+  /// camera frames
+  static const int YOLO_PRIORITY_REALTIME = 1;
+
+  /// batch / gallery scans
+  static const int YOLO_PRIORITY_BACKGROUND = 2;
+}
+
+/// Per-camera context (see yolo_stream_create)
+final class YoloStream extends ffi.Opaque {}
+
+final class YoloDetectOptions extends ffi.Struct {
+  /// Capture time on the yolo_now_ns() clock (0 = unknown)
+  @ffi.Int64()
+  external int capture_ts_ns;
+
+  /// Caller frame id echoed back in the result (-1 = none)
+  @ffi.Int64()
+  external int frame_id;
+
+  /// YoloPriority value
+  @ffi.Int32()
+  external int priority;
+
+  /// Camera the frame belongs to (NULL = the detector's own state)
+  external ffi.Pointer<YoloStream> stream;
+}
+
+/// Pixel layouts accepted by yolo_detect_frame. Every layout is sampled in
+/// place straight into the model input (no intermediate RGB frame).
+abstract class YoloPixelFormat {
+  /// planes[0] Y, planes[1] interleaved UV
+  static const int YOLO_PIXEL_NV12 = 0;
+
+  /// planes[0] Y, planes[1] interleaved VU
+  static const int YOLO_PIXEL_NV21 = 1;
+
+  /// planes[0] Y, planes[1] U, planes[2] V
+  static const int YOLO_PIXEL_I420 = 2;
+
+  /// planes[0] packed, 3 bytes per pixel
+  static const int YOLO_PIXEL_RGB = 3;
+
+  /// planes[0] packed, 3 bytes per pixel
+  static const int YOLO_PIXEL_BGR = 4;
+
+  /// planes[0] packed, 4 bytes per pixel (alpha ignored)
+  static const int YOLO_PIXEL_RGBA = 5;
+
+  /// planes[0] packed, 4 bytes per pixel (alpha ignored)
+  static const int YOLO_PIXEL_BGRA = 6;
+
+  /// planes[0] 1 byte per pixel
+  static const int YOLO_PIXEL_GRAY = 7;
+
+  /// planes[0] packed 4:2:2, Y0 U Y1 V per pixel pair
+  static const int YOLO_PIXEL_YUYV = 8;
+}
+
+/// A frame in one of the YoloPixelFormat layouts. strides[i] is the row
+/// stride of planes[i] in bytes (0 = tightly packed); chroma planes are
+/// subsampled 2x2. Unused planes are ignored.
+final class YoloFrameDesc extends ffi.Struct {
+  /// YoloPixelFormat value
+  @ffi.Int32()
+  external int format;
+
+  @ffi.Int32()
+  external int width;
+
+  @ffi.Int32()
+  external int height;
+
+  /// 0, 90, 180, 270 degrees clockwise
+  @ffi.Int32()
+  external int rotation;
+
+  @ffi.Array.multi([3])
+  external ffi.Array<ffi.Pointer<ffi.Uint8>> planes;
+
+  @ffi.Array.multi([3])
+  external ffi.Array<ffi.Int32> strides;
+}
+
+/// Input of the presence / count calls: the same sources as yolo_detect_path,
+/// yolo_detect_buffer and yolo_detect_yuv, plus encoded bytes in memory.
+/// Unused fields are ignored.
+abstract class YoloInputKind {
+  /// path
+  static const int YOLO_INPUT_PATH = 0;
+
+  /// data + size: JPEG/PNG/BMP bytes
+  static const int YOLO_INPUT_ENCODED = 1;
+
+  /// data, width, height, stride
+  static const int YOLO_INPUT_BGRA = 2;
+
+  /// data (Y), u_data, v_data, width, height, strides, rotation
+  static const int YOLO_INPUT_YUV420 = 3;
+
+  /// frame
+  static const int YOLO_INPUT_FRAME = 4;
+}
+
+final class YoloInput extends ffi.Struct {
+  /// YoloInputKind value
+  @ffi.Int32()
+  external int kind;
+
+  external ffi.Pointer<ffi.Char> path;
+
+  external ffi.Pointer<ffi.Uint8> data;
+
+  @ffi.Int64()
+  external int size;
+
+  external ffi.Pointer<ffi.Uint8> u_data;
+
+  external ffi.Pointer<ffi.Uint8> v_data;
+
+  @ffi.Int32()
+  external int width;
+
+  @ffi.Int32()
+  external int height;
+
+  /// BGRA row stride or Y row stride
+  @ffi.Int32()
+  external int stride;
+
+  @ffi.Int32()
+  external int uv_row_stride;
+
+  @ffi.Int32()
+  external int uv_pixel_stride;
+
+  /// 0, 90, 180, 270 degrees clockwise
+  @ffi.Int32()
+  external int rotation;
+
+  external ffi.Pointer<YoloFrameDesc> frame;
+}
+
+/// Engine that runs the model
+abstract class YoloBackend {
+  /// default; NNAPI / Core ML on mobile
+  static const int YOLO_BACKEND_ONNXRUNTIME = 0;
+
+  /// OpenCV DNN on the CPU, same .onnx file
+  static const int YOLO_BACKEND_OPENCV_DNN = 1;
+}
+
+/// One detection of a binary result (pixel coordinates)
+final class YoloBox extends ffi.Struct {
+  @ffi.Int32()
+  external int class_id;
+
+  @ffi.Float()
+  external double confidence;
+
+  @ffi.Float()
+  external double x1;
+
+  @ffi.Float()
+  external double y1;
+
+  @ffi.Float()
+  external double x2;
+
+  @ffi.Float()
+  external double y2;
+}
+
+/// Summary of the frame returned by yolo_latest_poll
+final class YoloLatestInfo extends ffi.Struct {
+  /// increases with every published frame
+  @ffi.Int64()
+  external int sequence;
+
+  /// YoloDetectOptions.frame_id, or -1
+  @ffi.Int64()
+  external int frame_id;
+
+  /// 0 if the caller gave none
+  @ffi.Int64()
+  external int capture_ts_ns;
+
+  /// result ready (yolo_now_ns clock)
+  @ffi.Int64()
+  external int end_ts_ns;
+
+  /// frame size the boxes refer to
+  @ffi.Int32()
+  external int width;
+
+  @ffi.Int32()
+  external int height;
+
+  /// detections in the frame (may exceed max_boxes)
+  @ffi.Int32()
+  external int count;
+}
+
+/// Opaque outputs of yolo_run_tensor
+final class YoloTensorResult extends ffi.Opaque {}
+
+/// One model output, read in place
+final class YoloTensorView extends ffi.Struct {
+  external ffi.Pointer<ffi.Char> name;
+
+  /// NULL if the output is not float32
+  external ffi.Pointer<ffi.Float> data;
+
+  @ffi.Int64()
+  external int element_count;
+
+  @ffi.Int32()
+  external int rank;
+
+  @ffi.Array.multi([8])
+  external ffi.Array<ffi.Int64> shape;
+}
+
+/// Failure codes of the presence / count calls (always negative)
+abstract class YoloStatus {
+  static const int YOLO_ERR_NOT_INITIALIZED = -1;
+  static const int YOLO_ERR_INVALID_ARGUMENT = -2;
+  static const int YOLO_ERR_IMAGE_LOAD_FAILED = -3;
+  static const int YOLO_ERR_DECODER_UNAVAILABLE = -4;
+  static const int YOLO_ERR_QUEUE_FULL = -5;
+  static const int YOLO_ERR_FRAME_SHED = -6;
+  static const int YOLO_ERR_CANCELLED = -7;
+  static const int YOLO_ERR_PREEMPTED = -8;
+}
+
+final class YoloMjpegIngest extends ffi.Opaque {}
+
+final class YoloLogWriter extends ffi.Opaque {}
+
+final class YoloLogReader extends ffi.Opaque {}
+
+/// Delta-encoded result stream for forwarding detections over a narrow link.
+/// Packets are keyframes (every box) or deltas against the previous packet:
+/// boxes still present (matched by class and IoU) carry only their changed
+/// corners / score as small offsets, plus the added boxes. Coordinates are
+/// quantized to 1/4096 of the frame size, scores to 1/255. Keyframes are sent
+/// every keyframe_interval packets, on a frame size change and on request.
+/// Encoders and decoders are not thread-safe; use one per stream.
+final class YoloDeltaEncoder extends ffi.Opaque {}
+
+final class YoloDeltaDecoder extends ffi.Opaque {}
+
+/// Failure codes of yolo_delta_decode (always negative)
+abstract class YoloDeltaStatus {
+  /// truncated or invalid packet
+  static const int YOLO_DELTA_MALFORMED = -1;
+
+  /// a packet was lost; wait for a keyframe
+  static const int YOLO_DELTA_OUT_OF_SYNC = -2;
+}
+
+/// One detection as written to / read from a log (pixel coordinates)
+final class YoloLogBox extends ffi.Struct {
+  @ffi.Int32()
+  external int class_id;
+
+  @ffi.Float()
+  external double confidence;
+
+  @ffi.Float()
+  external double x1;
+
+  @ffi.Float()
+  external double y1;
+
+  @ffi.Float()
+  external double x2;
+
+  @ffi.Float()
+  external double y2;
+}
+
+const int YOLO_TENSOR_MAX_DIMS = 8;
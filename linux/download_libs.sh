@@ -71,10 +71,30 @@ else
     echo "ONNX Runtime already exists"
 fi
 
+# stb_image (image decoder for builds with -DYOLO_USE_OPENCV=OFF), pinned
+# like ONNX Runtime: stb_image.h v2.28
+STB_COMMIT="5736b15f7ea0ffb08dd38af21067c314d6a3aae9"
+STB_IMAGE_URL="https://raw.githubusercontent.com/nothings/stb/${STB_COMMIT}/stb_image.h"
+if [ ! -f "$INCLUDE_DIR/stb_image.h" ]; then
+    echo "Downloading stb_image.h..."
+    mkdir -p "$INCLUDE_DIR"
+    download_file "$STB_IMAGE_URL" "$INCLUDE_DIR/stb_image.h"
+    # An error page saved under the header's name would otherwise pass
+    # the CMake check and fail at compile time
+    if ! grep -q "stb_image - v" "$INCLUDE_DIR/stb_image.h" 2>/dev/null; then
+        echo "Error: Failed to download stb_image.h"
+        rm -f "$INCLUDE_DIR/stb_image.h"
+        exit 1
+    fi
+else
+    echo "stb_image.h already exists"
+fi
+
 echo ""
 echo "========================================"
 echo "Linux dependencies ready!"
 echo ""
 echo "Make sure OpenCV is installed:"
 echo "  sudo apt install libopencv-dev"
+echo "(or configure with -DYOLO_USE_OPENCV=OFF to build without it)"
 echo "========================================"
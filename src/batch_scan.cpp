@@ -0,0 +1,170 @@
+#include "batch_scan.hpp"
+#include "image_hash.hpp"
+#include "json_escape.hpp"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+bool hasImageExtension(const std::string& name) {
+    size_t dot = name.rfind('.');
+    if (dot == std::string::npos) return false;
+    std::string ext = name.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext == "jpg" || ext == "jpeg" || ext == "png" || ext == "bmp";
+}
+
+// A processed image kept for near-duplicate matching
+struct HashedResult {
+    size_t index;
+    int width;
+    int height;
+    ImageHash hash;
+    std::string fields;     // result JSON without the enclosing braces
+};
+
+// Replace the "frame_id" value in result fields with the reusing file's index
+std::string withFrameId(const std::string& fields, size_t frame_id) {
+    const char* key = "\"frame_id\":";
+    size_t pos = fields.find(key);
+    if (pos == std::string::npos) return fields;
+    pos += strlen(key);
+    size_t end = std::min(fields.find_first_of(",}", pos), fields.size());
+    return fields.substr(0, pos) + std::to_string(frame_id) + fields.substr(end);
+}
+
+}  // namespace
+
+std::vector<std::string> listImageFiles(const std::string& directory) {
+    std::vector<std::string> paths;
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) return paths;
+
+    std::string prefix = directory;
+    if (!prefix.empty() && prefix.back() != '/') prefix += '/';
+
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.empty() || name[0] == '.' || !hasImageExtension(name)) continue;
+        paths.push_back(prefix + name);
+    }
+    closedir(dir);
+
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+std::string runBatchScan(const std::vector<std::string>& paths,
+                         const BatchScanOptions& options,
+                         const EncodedDetectFn& detect) {
+    FilePrefetcher prefetcher(paths, options.prefetch);
+    const bool dedup = options.dedup_distance >= 0 && options.dedup_window > 0;
+    std::deque<HashedResult> recent;
+
+    std::ostringstream results;
+    PrefetchedFile file;
+    size_t count = 0;
+    size_t skipped = 0;
+    size_t preempted = 0;
+    bool cancelled = false;
+    size_t next_index = 0;
+    while (!cancelled && prefetcher.next(file)) {
+        FrameTiming timing;
+        timing.frame_id = static_cast<int64_t>(file.index);
+
+        // Hash from a reduced decode and look for a recent near-duplicate
+        bool hashed = false;
+        HashedResult current{file.index, 0, 0, ImageHash(), std::string()};
+        const HashedResult* match = nullptr;
+        int distance = 0;
+        if (dedup && file.ok() && probeImageSize(file.data, file.size, current.width, current.height)) {
+            DecodedImage preview;
+            if (decodeImagePreview(file.data, file.size, preview)) {
+                current.hash = differenceHash(preview);
+                hashed = true;
+                for (auto it = recent.rbegin(); it != recent.rend(); ++it) {
+                    if (it->width != current.width || it->height != current.height) continue;
+                    int d = hammingDistance(it->hash, current.hash);
+                    if (d <= options.dedup_distance && (match == nullptr || d < distance)) {
+                        match = &*it;
+                        distance = d;
+                    }
+                }
+            }
+        }
+
+        char* result = nullptr;
+        DetectStatus status = DetectStatus::Ok;
+        int attempts = 0;
+        if (file.ok() && match == nullptr) {
+            for (;;) {
+                status = detect(file.data, file.size, timing, result);
+                if (status != DetectStatus::Preempted) break;
+                // The retry waits in the scheduler until higher priority work drains
+                free(result);
+                result = nullptr;
+                attempts++;
+            }
+        }
+        prefetcher.release(file);
+        preempted += attempts;
+        cancelled = status == DetectStatus::Cancelled;
+        next_index = file.index + 1;
+
+        if (count++ > 0) results << ",";
+        results << "{\"path\":";
+        writeJsonString(results, file.path);
+        results << ",\"io_wait_ms\":" << std::fixed << std::setprecision(2) << file.io_wait_ms << ",";
+        if (attempts > 0) {
+            results << "\"preempted\":" << attempts << ",";
+        }
+        if (match != nullptr) {
+            skipped++;
+            results << "\"reused_from\":" << match->index << ",\"hash_distance\":" << distance << ","
+                    << withFrameId(match->fields, file.index) << "}";
+        } else if (result != nullptr && result[0] == '{') {
+            results << (result + 1);
+            if (hashed && status == DetectStatus::Ok) {
+                std::string fields(result + 1);
+                fields.pop_back();
+                current.fields = std::move(fields);
+                recent.push_back(std::move(current));
+                if (recent.size() > options.dedup_window) recent.pop_front();
+            }
+        } else if (!file.ok()) {
+            results << "\"error\":\"Could not read file: " << strerror(file.error)
+                    << "\",\"code\":\"IMAGE_LOAD_FAILED\"}";
+        } else {
+            results << "\"error\":\"Detection failed\",\"code\":\"NULL_RESULT\"}";
+        }
+        free(result);
+    }
+
+    // Files after a cancel are reported, not read
+    for (size_t i = next_index; cancelled && i < paths.size(); i++) {
+        if (count++ > 0) results << ",";
+        results << "{\"path\":";
+        writeJsonString(results, paths[i]);
+        results << ",\"error\":\"Scan cancelled before this file\",\"code\":\"CANCELLED\"}";
+    }
+
+    std::ostringstream oss;
+    oss << "{\"backend\":\"" << prefetcher.backend() << "\""
+        << ",\"count\":" << count
+        << ",\"bytes_read\":" << prefetcher.bytesRead()
+        << ",\"io_wait_ms\":" << std::fixed << std::setprecision(2) << prefetcher.totalIoWaitMs()
+        << ",\"skipped\":" << skipped
+        << ",\"skip_rate\":" << std::setprecision(4) << (count > 0 ? static_cast<double>(skipped) / count : 0.0)
+        << ",\"preempted\":" << preempted
+        << ",\"cancelled\":" << (cancelled ? "true" : "false")
+        << ",\"results\":[" << results.str() << "]}";
+    return oss.str();
+}
@@ -0,0 +1,54 @@
+#ifndef BATCH_SCAN_HPP
+#define BATCH_SCAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "file_prefetcher.hpp"
+#include "frame_metrics.hpp"
+#include "yolo_detector.hpp"
+
+// Image files (.jpg, .jpeg, .png, .bmp) directly inside a directory, sorted
+// by name. Empty if the directory cannot be read.
+std::vector<std::string> listImageFiles(const std::string& directory);
+
+struct BatchScanOptions {
+    PrefetchConfig prefetch;
+
+    // Reuse the result of a recent image with the same dimensions whose dHash
+    // is at most this many bits away (-1 = never reuse)
+    int dedup_distance = -1;
+
+    // Processed images kept for comparison (bursts are consecutive)
+    size_t dedup_window = 64;
+};
+
+// Runs one encoded image: sets result to a malloc'd JSON result (detection or
+// error) and returns its status
+using EncodedDetectFn = std::function<DetectStatus(const uint8_t* data, size_t size, const FrameTiming& timing,
+                                                   char*& result)>;
+
+// Detect on every file in order. File contents are prefetched into a bounded
+// buffer pool and decoded from memory, so decoding never blocks on storage.
+// With dedup enabled each file is first hashed from a reduced decode, and
+// near-duplicates of a recent image skip inference entirely.
+//
+// A file preempted by higher priority work (DetectStatus::Preempted) is run
+// again; the retry queues behind that work, so it runs once it has drained.
+// A cancelled file (DetectStatus::Cancelled) ends the scan.
+//
+// Returns {"backend","count","bytes_read","io_wait_ms","skipped","skip_rate",
+// "preempted","cancelled","results":[...]}; each result is the usual
+// detection JSON plus "path" and the "io_wait_ms" spent waiting for that
+// file. frame_id is the file's index in `paths`. Reused results add
+// "reused_from" (index of the image whose detections were copied) and
+// "hash_distance"; retried ones "preempted" (times they were). After a
+// cancel, the files not processed are listed with code CANCELLED.
+std::string runBatchScan(const std::vector<std::string>& paths,
+                         const BatchScanOptions& options,
+                         const EncodedDetectFn& detect);
+
+#endif // BATCH_SCAN_HPP
@@ -0,0 +1,355 @@
+#include "delta_stream.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+using delta_stream::QuantizedBox;
+using detection_log::Box;
+
+namespace {
+
+// Per-frame fields of a full-precision result (timestamp, width, height),
+// the baseline the compression ratio is reported against
+constexpr size_t kRawFrameBytes = 8 + 4 + 4;
+constexpr size_t kRawBoxBytes = sizeof(Box);
+
+// Mask bit of the score in a kept box's changed-field mask
+constexpr uint8_t kScoreChanged = 1 << 4;
+
+void putVarint(std::vector<uint8_t>& buf, uint64_t value) {
+    while (value >= 0x80) {
+        buf.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buf.push_back(static_cast<uint8_t>(value));
+}
+
+void putSigned(std::vector<uint8_t>& buf, int64_t value) {
+    putVarint(buf, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+// All supported targets are little-endian, so fields are copied as-is
+template <typename T>
+void put(std::vector<uint8_t>& buf, T value) {
+    size_t at = buf.size();
+    buf.resize(at + sizeof(T));
+    memcpy(buf.data() + at, &value, sizeof(T));
+}
+
+// Bounds-checked cursor over a packet; any overrun clears ok
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok = true;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p >= end) break;
+            uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    int64_t signedVarint() {
+        uint64_t v = varint();
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    template <typename T>
+    T fixed() {
+        T value{};
+        if (end - p < static_cast<ptrdiff_t>(sizeof(T))) {
+            ok = false;
+            p = end;
+            return value;
+        }
+        memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+};
+
+uint16_t quantizeCoord(float v, int extent) {
+    if (extent <= 0) return 0;
+    float n = std::min(std::max(v / static_cast<float>(extent), 0.0f), 1.0f);
+    return static_cast<uint16_t>(std::lround(n * delta_stream::kCoordSteps));
+}
+
+uint8_t quantizeScore(float v) {
+    v = std::min(std::max(v, 0.0f), 1.0f);
+    return static_cast<uint8_t>(std::lround(v * 255.0f));
+}
+
+QuantizedBox quantize(const Box& box, int width, int height) {
+    QuantizedBox q;
+    q.class_id = std::max(box.class_id, 0);
+    q.score = quantizeScore(box.confidence);
+    q.coord[0] = quantizeCoord(box.x1, width);
+    q.coord[1] = quantizeCoord(box.y1, height);
+    q.coord[2] = quantizeCoord(box.x2, width);
+    q.coord[3] = quantizeCoord(box.y2, height);
+    return q;
+}
+
+float iou(const QuantizedBox& a, const QuantizedBox& b) {
+    int iw = std::min(a.coord[2], b.coord[2]) - std::max(a.coord[0], b.coord[0]);
+    int ih = std::min(a.coord[3], b.coord[3]) - std::max(a.coord[1], b.coord[1]);
+    if (iw <= 0 || ih <= 0) return 0.0f;
+    float inter = static_cast<float>(iw) * ih;
+    float area_a = static_cast<float>(a.coord[2] - a.coord[0]) * (a.coord[3] - a.coord[1]);
+    float area_b = static_cast<float>(b.coord[2] - b.coord[0]) * (b.coord[3] - b.coord[1]);
+    return inter / (area_a + area_b - inter);
+}
+
+void putBox(std::vector<uint8_t>& buf, const QuantizedBox& box) {
+    putVarint(buf, static_cast<uint64_t>(box.class_id));
+    buf.push_back(box.score);
+    for (uint16_t c : box.coord) put<uint16_t>(buf, c);
+}
+
+bool readBox(Cursor& in, QuantizedBox& box) {
+    uint64_t class_id = in.varint();
+    box.class_id = static_cast<int>(std::min<uint64_t>(class_id, 65535));
+    box.score = in.fixed<uint8_t>();
+    for (uint16_t& c : box.coord) {
+        c = in.fixed<uint16_t>();
+        if (c > delta_stream::kCoordSteps) in.ok = false;
+    }
+    return in.ok;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// Encoder
+
+DeltaEncoder::DeltaEncoder(int keyframe_interval, float match_iou)
+    : m_keyframe_interval(std::max(keyframe_interval, 0)),
+      m_match_iou(match_iou) {}
+
+size_t DeltaEncoder::maxPacketSize(int count) const {
+    // Header and counts, the kept bitmap, then at most 16 bytes per box
+    // (a kept box: mask + four 2-byte corner offsets + 2-byte score offset;
+    // an added box: class varint + score + four corners)
+    const size_t boxes = static_cast<size_t>(std::max(count, 0));
+    return 1 + 5 + 12 + 2 * 10 + (m_previous.size() + 7) / 8 + 16 * boxes;
+}
+
+void DeltaEncoder::encode(int64_t timestamp_ns, int width, int height,
+                          const Box* boxes, int count,
+                          std::vector<uint8_t>& packet) {
+    auto start = std::chrono::steady_clock::now();
+    if (boxes == nullptr) count = 0;
+    count = std::max(count, 0);
+
+    width = std::min(std::max(width, 0), 65535);
+    height = std::min(std::max(height, 0), 65535);
+
+    m_current.resize(count);
+    for (int i = 0; i < count; i++) {
+        m_current[i] = quantize(boxes[i], width, height);
+    }
+
+    const bool keyframe = m_force_keyframe ||
+                          width != m_width || height != m_height ||
+                          (m_keyframe_interval > 0 && m_since_keyframe >= m_keyframe_interval);
+
+    packet.clear();
+    packet.reserve(maxPacketSize(count));
+    packet.push_back(keyframe ? delta_stream::kKeyframe : delta_stream::kDelta);
+    putVarint(packet, m_sequence);
+
+    if (keyframe) {
+        put<int64_t>(packet, timestamp_ns);
+        put<uint16_t>(packet, static_cast<uint16_t>(width));
+        put<uint16_t>(packet, static_cast<uint16_t>(height));
+        putVarint(packet, static_cast<uint64_t>(count));
+        for (const QuantizedBox& box : m_current) putBox(packet, box);
+
+        m_since_keyframe = 0;
+        m_force_keyframe = false;
+        m_keyframes++;
+        m_previous = m_current;
+    } else {
+        putSigned(packet, timestamp_ns - m_timestamp_ns);
+
+        // Greedy match in the caller's order (highest confidence first for
+        // detector output): best unmatched previous box of the same class
+        const size_t prev_count = m_previous.size();
+        m_match.assign(count, -1);
+        m_matched_by.assign(prev_count, -1);
+        for (int i = 0; i < count; i++) {
+            float best = m_match_iou;
+            for (size_t j = 0; j < prev_count; j++) {
+                if (m_matched_by[j] >= 0 || m_previous[j].class_id != m_current[i].class_id) continue;
+                float overlap = iou(m_current[i], m_previous[j]);
+                if (overlap >= best) {
+                    best = overlap;
+                    m_match[i] = static_cast<int>(j);
+                }
+            }
+            if (m_match[i] >= 0) m_matched_by[m_match[i]] = i;
+        }
+
+        // Kept bitmap, then each kept box's changed fields
+        size_t bitmap_at = packet.size();
+        packet.resize(bitmap_at + (prev_count + 7) / 8, 0);
+        std::vector<QuantizedBox> next;
+        next.reserve(count);
+        for (size_t j = 0; j < prev_count; j++) {
+            int i = m_matched_by[j];
+            if (i < 0) continue;
+            packet[bitmap_at + j / 8] |= static_cast<uint8_t>(1u << (j % 8));
+
+            const QuantizedBox& before = m_previous[j];
+            const QuantizedBox& after = m_current[i];
+            uint8_t mask = 0;
+            for (int k = 0; k < 4; k++) {
+                if (after.coord[k] != before.coord[k]) mask |= static_cast<uint8_t>(1u << k);
+            }
+            if (after.score != before.score) mask |= kScoreChanged;
+            packet.push_back(mask);
+            for (int k = 0; k < 4; k++) {
+                if (mask & (1u << k)) putSigned(packet, static_cast<int>(after.coord[k]) - before.coord[k]);
+            }
+            if (mask & kScoreChanged) putSigned(packet, static_cast<int>(after.score) - before.score);
+            next.push_back(after);
+        }
+
+        putVarint(packet, static_cast<uint64_t>(count) - next.size());
+        for (int i = 0; i < count; i++) {
+            if (m_match[i] >= 0) continue;
+            putBox(packet, m_current[i]);
+            next.push_back(m_current[i]);
+        }
+
+        m_since_keyframe++;
+        m_previous.swap(next);
+    }
+
+    m_sequence++;
+    m_timestamp_ns = timestamp_ns;
+    m_width = width;
+    m_height = height;
+
+    m_packets++;
+    m_boxes += count;
+    m_encoded_bytes += static_cast<int64_t>(packet.size());
+    m_raw_bytes += static_cast<int64_t>(kRawFrameBytes + kRawBoxBytes * count);
+    m_encode_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string DeltaEncoder::statsJson() const {
+    std::ostringstream oss;
+    oss << "{\"packets\":" << m_packets
+        << ",\"keyframes\":" << m_keyframes
+        << ",\"boxes\":" << m_boxes
+        << ",\"encoded_bytes\":" << m_encoded_bytes
+        << ",\"raw_bytes\":" << m_raw_bytes
+        << ",\"compression_ratio\":" << std::fixed << std::setprecision(2)
+        << (m_encoded_bytes > 0 ? static_cast<double>(m_raw_bytes) / m_encoded_bytes : 0.0)
+        << ",\"bytes_per_packet\":"
+        << (m_packets > 0 ? static_cast<double>(m_encoded_bytes) / m_packets : 0.0)
+        << ",\"encode_ms\":" << std::setprecision(3) << m_encode_ms
+        << ",\"encode_us_per_packet\":"
+        << (m_packets > 0 ? m_encode_ms * 1000.0 / m_packets : 0.0)
+        << "}";
+    return oss.str();
+}
+
+// ---------------------------------------------------------------------------
+// Decoder
+
+int DeltaDecoder::decode(const uint8_t* data, size_t size) {
+    if (data == nullptr || size == 0) return static_cast<int>(DeltaStatus::Malformed);
+
+    Cursor in{data, data + size};
+    const uint8_t type = in.fixed<uint8_t>();
+    const uint32_t sequence = static_cast<uint32_t>(in.varint());
+    if (!in.ok || (type != delta_stream::kKeyframe && type != delta_stream::kDelta)) {
+        return static_cast<int>(DeltaStatus::Malformed);
+    }
+
+    int64_t timestamp_ns;
+    int width = m_width;
+    int height = m_height;
+    m_current.clear();
+
+    if (type == delta_stream::kKeyframe) {
+        timestamp_ns = in.fixed<int64_t>();
+        width = in.fixed<uint16_t>();
+        height = in.fixed<uint16_t>();
+        uint64_t count = in.varint();
+        if (!in.ok || count > size) return static_cast<int>(DeltaStatus::Malformed);
+        m_current.resize(count);
+        for (QuantizedBox& box : m_current) {
+            if (!readBox(in, box)) return static_cast<int>(DeltaStatus::Malformed);
+        }
+    } else {
+        if (!m_synced || sequence != m_sequence + 1) {
+            m_synced = false;
+            return static_cast<int>(DeltaStatus::OutOfSync);
+        }
+        timestamp_ns = m_timestamp_ns + in.signedVarint();
+
+        const size_t prev_count = m_previous.size();
+        const uint8_t* bitmap = in.p;
+        if (static_cast<size_t>(in.end - in.p) < (prev_count + 7) / 8) {
+            return static_cast<int>(DeltaStatus::Malformed);
+        }
+        in.p += (prev_count + 7) / 8;
+
+        for (size_t j = 0; j < prev_count; j++) {
+            if ((bitmap[j / 8] & (1u << (j % 8))) == 0) continue;
+            QuantizedBox box = m_previous[j];
+            uint8_t mask = in.fixed<uint8_t>();
+            for (int k = 0; k < 4; k++) {
+                if ((mask & (1u << k)) == 0) continue;
+                int64_t c = box.coord[k] + in.signedVarint();
+                if (c < 0 || c > delta_stream::kCoordSteps) in.ok = false;
+                box.coord[k] = static_cast<uint16_t>(c);
+            }
+            if (mask & kScoreChanged) {
+                int64_t s = box.score + in.signedVarint();
+                if (s < 0 || s > 255) in.ok = false;
+                box.score = static_cast<uint8_t>(s);
+            }
+            if (!in.ok) return static_cast<int>(DeltaStatus::Malformed);
+            m_current.push_back(box);
+        }
+
+        uint64_t added = in.varint();
+        if (!in.ok || added > size) return static_cast<int>(DeltaStatus::Malformed);
+        for (uint64_t i = 0; i < added; i++) {
+            QuantizedBox box;
+            if (!readBox(in, box)) return static_cast<int>(DeltaStatus::Malformed);
+            m_current.push_back(box);
+        }
+    }
+
+    // Commit only complete packets
+    m_synced = true;
+    m_sequence = sequence;
+    m_timestamp_ns = timestamp_ns;
+    m_width = width;
+    m_height = height;
+    m_previous.swap(m_current);
+
+    const float sx = static_cast<float>(width) / delta_stream::kCoordSteps;
+    const float sy = static_cast<float>(height) / delta_stream::kCoordSteps;
+    m_boxes.resize(m_previous.size());
+    for (size_t i = 0; i < m_previous.size(); i++) {
+        const QuantizedBox& q = m_previous[i];
+        m_boxes[i] = {q.class_id, q.score / 255.0f,
+                      q.coord[0] * sx, q.coord[1] * sy, q.coord[2] * sx, q.coord[3] * sy};
+    }
+    return static_cast<int>(m_boxes.size());
+}
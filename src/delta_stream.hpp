@@ -0,0 +1,125 @@
+#ifndef DELTA_STREAM_HPP
+#define DELTA_STREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "detection_log.hpp"
+
+// Delta-encoded detection stream for forwarding results over a narrow link.
+//
+// Each packet is either a keyframe (every box) or a delta against the
+// previous packet: a bitmap of the previous boxes that are still present, a
+// mask of changed fields plus small offsets for each of them, then the added
+// boxes. Boxes are matched to the previous frame by class and IoU.
+// Coordinates are quantized to 1/4096 of the frame size and scores to 1/255,
+// and the encoder keeps the quantized boxes the decoder reconstructs, so
+// rounding error never accumulates across deltas.
+//
+// Packet layout (little-endian; varints are LEB128, signed ones zigzag):
+//   u8 type (0 = keyframe, 1 = delta) | varint sequence
+//   keyframe: i64 timestamp_ns | u16 width | u16 height | varint count
+//             | per box: varint class | u8 score | u16 x1, y1, x2, y2
+//   delta:    signed varint timestamp change | kept bitmap (1 bit per
+//             previous box) | per kept box: u8 mask (bits 0-3 corners,
+//             bit 4 score), one signed varint per set bit
+//             | varint added count | added boxes as in keyframes
+//
+// The decoded frame lists kept boxes in their previous order, then added
+// boxes. A delta whose sequence does not follow the last decoded packet is
+// rejected until the next keyframe.
+namespace delta_stream {
+
+constexpr uint8_t kKeyframe = 0;
+constexpr uint8_t kDelta = 1;
+constexpr int kCoordSteps = 4096;
+
+// A box as carried by the stream
+struct QuantizedBox {
+    int class_id;
+    uint8_t score;
+    uint16_t coord[4];      // x1, y1, x2, y2 in 1/kCoordSteps of the frame
+};
+
+}  // namespace delta_stream
+
+// Failure codes of DeltaDecoder::decode (always negative)
+enum class DeltaStatus {
+    Malformed = -1,     // truncated or invalid packet
+    OutOfSync = -2      // delta without its predecessor; wait for a keyframe
+};
+
+// Not thread-safe: one encoder per forwarded stream
+class DeltaEncoder {
+public:
+    // keyframe_interval: packets between keyframes (0 = first packet only).
+    // match_iou: minimum IoU for a box to be sent as a change of a previous one.
+    explicit DeltaEncoder(int keyframe_interval = 30, float match_iou = 0.3f);
+
+    // Upper bound of the next packet's size for count boxes
+    size_t maxPacketSize(int count) const;
+
+    // Encode one frame (packet is replaced)
+    void encode(int64_t timestamp_ns, int width, int height,
+                const detection_log::Box* boxes, int count,
+                std::vector<uint8_t>& packet);
+
+    // Make the next packet a keyframe, e.g. when a receiver lost sync
+    void requestKeyframe() { m_force_keyframe = true; }
+
+    // Packets, keyframes, boxes, encoded bytes against full-precision boxes
+    // (compression ratio) and encode time, as JSON
+    std::string statsJson() const;
+
+private:
+    int m_keyframe_interval;
+    float m_match_iou;
+    bool m_force_keyframe = true;
+    uint32_t m_sequence = 0;
+    int m_since_keyframe = 0;
+    int64_t m_timestamp_ns = 0;
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<delta_stream::QuantizedBox> m_previous;
+
+    // Reused per packet
+    std::vector<delta_stream::QuantizedBox> m_current;
+    std::vector<int> m_match;       // previous index matched by each current box, or -1
+    std::vector<int> m_matched_by;  // current index matched to each previous box, or -1
+
+    int64_t m_packets = 0;
+    int64_t m_keyframes = 0;
+    int64_t m_boxes = 0;
+    int64_t m_encoded_bytes = 0;
+    int64_t m_raw_bytes = 0;
+    double m_encode_ms = 0.0;
+};
+
+// Not thread-safe: one decoder per received stream
+class DeltaDecoder {
+public:
+    // Apply one packet. Returns the frame's box count, or a negative
+    // DeltaStatus (the previous frame is kept).
+    int decode(const uint8_t* data, size_t size);
+
+    int64_t timestampNs() const { return m_timestamp_ns; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    // Boxes of the last decoded frame, in pixels
+    const std::vector<detection_log::Box>& boxes() const { return m_boxes; }
+
+private:
+    bool m_synced = false;
+    uint32_t m_sequence = 0;
+    int64_t m_timestamp_ns = 0;
+    int m_width = 0;
+    int m_height = 0;
+    std::vector<delta_stream::QuantizedBox> m_previous;
+    std::vector<delta_stream::QuantizedBox> m_current;
+    std::vector<detection_log::Box> m_boxes;
+};
+
+#endif // DELTA_STREAM_HPP
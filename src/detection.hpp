@@ -0,0 +1,13 @@
+#ifndef DETECTION_HPP
+#define DETECTION_HPP
+
+#include <string>
+
+struct Detection {
+    int class_id;
+    std::string class_name;
+    float confidence;
+    float x1, y1, x2, y2;  // bounding box (pixel coordinates)
+};
+
+#endif // DETECTION_HPP
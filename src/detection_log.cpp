@@ -0,0 +1,411 @@
+#include "detection_log.hpp"
+#include "detection.hpp"
+#include "json_escape.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using detection_log::Box;
+
+namespace {
+
+// Fixed part of a frame record after the size prefix
+constexpr size_t kFrameHeaderSize = 8 + 2 + 2 + 2;
+
+// All supported targets are little-endian, so fields are copied as-is
+template <typename T>
+void put(std::vector<uint8_t>& buf, T value) {
+    size_t at = buf.size();
+    buf.resize(at + sizeof(T));
+    memcpy(buf.data() + at, &value, sizeof(T));
+}
+
+template <typename T>
+T get(const uint8_t* p) {
+    T value;
+    memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+uint16_t quantizeCoord(float v, int extent) {
+    if (extent <= 0) return 0;
+    float n = v / static_cast<float>(extent);
+    n = std::min(std::max(n, 0.0f), 1.0f);
+    return static_cast<uint16_t>(std::lround(n * 65535.0f));
+}
+
+uint8_t quantizeScore(float v) {
+    v = std::min(std::max(v, 0.0f), 1.0f);
+    return static_cast<uint8_t>(std::lround(v * 255.0f));
+}
+
+uint16_t clampDimension(int v) {
+    return static_cast<uint16_t>(std::min(std::max(v, 0), 65535));
+}
+
+std::vector<uint8_t> encodeHeader(const std::string& stream_name,
+                                  const std::vector<std::string>& class_names,
+                                  bool wide_class_ids) {
+    std::vector<uint8_t> buf(detection_log::kMagic, detection_log::kMagic + 4);
+    put<uint16_t>(buf, detection_log::kVersion);
+    put<uint16_t>(buf, wide_class_ids ? detection_log::kFlagWideClassIds : 0);
+
+    size_t name_len = std::min<size_t>(stream_name.size(), 65535);
+    put<uint16_t>(buf, static_cast<uint16_t>(name_len));
+    buf.insert(buf.end(), stream_name.begin(), stream_name.begin() + name_len);
+
+    size_t classes = std::min<size_t>(class_names.size(), 65535);
+    put<uint16_t>(buf, static_cast<uint16_t>(classes));
+    for (size_t i = 0; i < classes; i++) {
+        size_t len = std::min<size_t>(class_names[i].size(), 255);
+        buf.push_back(static_cast<uint8_t>(len));
+        buf.insert(buf.end(), class_names[i].begin(), class_names[i].begin() + len);
+    }
+    return buf;
+}
+
+// Parse the stream header. Returns the offset of the first frame, or 0 if invalid.
+size_t decodeHeader(const uint8_t* data, size_t size,
+                    std::string& stream_name,
+                    std::vector<std::string>& class_names,
+                    bool& wide_class_ids) {
+    if (size < 10 || memcmp(data, detection_log::kMagic, 4) != 0) return 0;
+    if (get<uint16_t>(data + 4) != detection_log::kVersion) return 0;
+    wide_class_ids = (get<uint16_t>(data + 6) & detection_log::kFlagWideClassIds) != 0;
+
+    size_t pos = 8;
+    size_t name_len = get<uint16_t>(data + pos);
+    pos += 2;
+    if (pos + name_len + 2 > size) return 0;
+    stream_name.assign(reinterpret_cast<const char*>(data + pos), name_len);
+    pos += name_len;
+
+    size_t classes = get<uint16_t>(data + pos);
+    pos += 2;
+    class_names.clear();
+    class_names.reserve(classes);
+    for (size_t i = 0; i < classes; i++) {
+        if (pos + 1 > size) return 0;
+        size_t len = data[pos++];
+        if (pos + len > size) return 0;
+        class_names.emplace_back(reinterpret_cast<const char*>(data + pos), len);
+        pos += len;
+    }
+    return pos;
+}
+
+size_t detectionBytes(bool wide_class_ids) {
+    return (wide_class_ids ? 2 : 1) + 1 + 4 * 2;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// Writer
+
+DetectionLogWriter::~DetectionLogWriter() {
+    close();
+}
+
+bool DetectionLogWriter::open(const std::string& path,
+                              const std::string& stream_name,
+                              const std::vector<std::string>& class_names) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file != nullptr) return false;
+
+    // Names as the header stores them, so an append compares like with like
+    std::vector<std::string> stored(class_names.begin(),
+                                    class_names.begin() + std::min<size_t>(class_names.size(), 65535));
+    for (std::string& name : stored) {
+        if (name.size() > 255) name.resize(255);
+    }
+
+    bool wide = stored.size() > 255;
+    std::vector<uint8_t> header = encodeHeader(stream_name, stored, wide);
+
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && st.st_size > 0) {
+        // Appending: the stored header must describe the same stream, and a
+        // record torn by a crash is cut off so new frames stay reachable
+        DetectionLogReader existing;
+        if (!existing.open(path) ||
+            existing.streamName() != stream_name ||
+            existing.classNames() != stored) {
+            return false;
+        }
+        size_t valid = existing.validBytes();
+        existing.close();
+        if (valid < static_cast<size_t>(st.st_size) &&
+            truncate(path.c_str(), static_cast<off_t>(valid)) != 0) {
+            return false;
+        }
+    }
+
+    FILE* file = fopen(path.c_str(), "ab");
+    if (file == nullptr) return false;
+
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0 && fwrite(header.data(), 1, header.size(), file) != header.size()) {
+        fclose(file);
+        return false;
+    }
+
+    m_file = file;
+    m_wide_class_ids = wide;
+    m_frames = 0;
+    return true;
+}
+
+void DetectionLogWriter::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file != nullptr) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void DetectionLogWriter::flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file != nullptr) {
+        fflush(m_file);
+    }
+}
+
+bool DetectionLogWriter::writeFrame(int64_t timestamp_ns, int width, int height,
+                                    const Box* boxes, int count) {
+    if (count < 0 || (count > 0 && boxes == nullptr)) return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file == nullptr) return false;
+    if (!appendFrame(timestamp_ns, width, height, count, boxes, nullptr)) return false;
+    return writeRecord();
+}
+
+bool DetectionLogWriter::writeFrame(int64_t timestamp_ns, int width, int height,
+                                    const std::vector<Detection>& detections) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file == nullptr) return false;
+    if (!appendFrame(timestamp_ns, width, height, static_cast<int>(detections.size()),
+                     nullptr, detections.data())) {
+        return false;
+    }
+    return writeRecord();
+}
+
+bool DetectionLogWriter::writeRecord() {
+    if (fwrite(m_record.data(), 1, m_record.size(), m_file) != m_record.size()) return false;
+    m_frames++;
+    return true;
+}
+
+// Encode one frame into m_record from either Box or Detection input. Returns
+// false if it has more detections than a record holds or a class id does not
+// fit the log's id width.
+bool DetectionLogWriter::appendFrame(int64_t timestamp_ns, int width, int height, int count,
+                                     const Box* boxes, const Detection* detections) {
+    if (count > 65535) return false;
+    const int max_id = m_wide_class_ids ? 65535 : 255;
+    for (int i = 0; i < count; i++) {
+        int id = boxes != nullptr ? boxes[i].class_id : detections[i].class_id;
+        if (id < 0 || id > max_id) return false;
+    }
+
+    uint32_t payload = static_cast<uint32_t>(
+        kFrameHeaderSize + static_cast<size_t>(count) * detectionBytes(m_wide_class_ids));
+
+    m_record.clear();
+    m_record.reserve(4 + payload);
+    put<uint32_t>(m_record, payload);
+    put<int64_t>(m_record, timestamp_ns);
+    put<uint16_t>(m_record, clampDimension(width));
+    put<uint16_t>(m_record, clampDimension(height));
+    put<uint16_t>(m_record, static_cast<uint16_t>(count));
+
+    auto field = [&](int i, int which) -> float {
+        if (boxes != nullptr) {
+            const Box& b = boxes[i];
+            return which == 0 ? b.x1 : which == 1 ? b.y1 : which == 2 ? b.x2 : b.y2;
+        }
+        const Detection& d = detections[i];
+        return which == 0 ? d.x1 : which == 1 ? d.y1 : which == 2 ? d.x2 : d.y2;
+    };
+
+    // Columns: class ids, scores, then one column per box coordinate
+    for (int i = 0; i < count; i++) {
+        int id = boxes != nullptr ? boxes[i].class_id : detections[i].class_id;
+        if (m_wide_class_ids) {
+            put<uint16_t>(m_record, static_cast<uint16_t>(id));
+        } else {
+            m_record.push_back(static_cast<uint8_t>(id));
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        float score = boxes != nullptr ? boxes[i].confidence : detections[i].confidence;
+        m_record.push_back(quantizeScore(score));
+    }
+    for (int which = 0; which < 4; which++) {
+        int extent = (which % 2 == 0) ? width : height;
+        for (int i = 0; i < count; i++) {
+            put<uint16_t>(m_record, quantizeCoord(field(i, which), extent));
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+
+DetectionLogReader::~DetectionLogReader() {
+    close();
+}
+
+bool DetectionLogReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    m_size = static_cast<size_t>(st.st_size);
+
+    void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped != MAP_FAILED) {
+        m_data = static_cast<const uint8_t*>(mapped);
+        m_mapped = true;
+    } else {
+        m_fallback.resize(m_size);
+        size_t got = 0;
+        while (got < m_size) {
+            ssize_t n = pread(fd, m_fallback.data() + got, m_size - got, static_cast<off_t>(got));
+            if (n <= 0) break;
+            got += static_cast<size_t>(n);
+        }
+        m_size = got;
+        m_data = m_fallback.data();
+    }
+    ::close(fd);
+
+    size_t pos = decodeHeader(m_data, m_size, m_stream_name, m_class_names, m_wide_class_ids);
+    if (pos == 0) {
+        close();
+        return false;
+    }
+
+    // Index frames by walking the size prefixes; a torn last record is dropped
+    const size_t per_detection = detectionBytes(m_wide_class_ids);
+    while (pos + 4 <= m_size) {
+        size_t payload = get<uint32_t>(m_data + pos);
+        if (payload < kFrameHeaderSize || pos + 4 + payload > m_size) break;
+        size_t count = get<uint16_t>(m_data + pos + 4 + 12);
+        if (payload != kFrameHeaderSize + count * per_detection) break;
+        m_frames.push_back(pos + 4);
+        pos += 4 + payload;
+    }
+    m_valid_bytes = pos;
+    return true;
+}
+
+void DetectionLogReader::close() {
+    if (m_mapped && m_data != nullptr) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_fallback.clear();
+    m_stream_name.clear();
+    m_class_names.clear();
+    m_frames.clear();
+    m_valid_bytes = 0;
+}
+
+bool DetectionLogReader::frameInfo(int64_t index, int64_t& timestamp_ns,
+                                   int& width, int& height, int& count) const {
+    if (index < 0 || index >= frameCount()) return false;
+    const uint8_t* p = m_data + m_frames[static_cast<size_t>(index)];
+    timestamp_ns = get<int64_t>(p);
+    width = get<uint16_t>(p + 8);
+    height = get<uint16_t>(p + 10);
+    count = get<uint16_t>(p + 12);
+    return true;
+}
+
+int DetectionLogReader::readFrame(int64_t index, int64_t& timestamp_ns,
+                                  int& width, int& height,
+                                  Box* boxes, int max_boxes) const {
+    int count = 0;
+    if (!frameInfo(index, timestamp_ns, width, height, count)) return -1;
+    if (boxes == nullptr) return count;
+
+    const uint8_t* ids = m_data + m_frames[static_cast<size_t>(index)] + kFrameHeaderSize;
+    const uint8_t* scores = ids + static_cast<size_t>(count) * (m_wide_class_ids ? 2 : 1);
+    const uint8_t* coords = scores + count;
+
+    int n = std::min(count, std::max(max_boxes, 0));
+    const float sx = width / 65535.0f;
+    const float sy = height / 65535.0f;
+    for (int i = 0; i < n; i++) {
+        Box& b = boxes[i];
+        b.class_id = m_wide_class_ids ? get<uint16_t>(ids + i * 2) : ids[i];
+        b.confidence = scores[i] / 255.0f;
+        b.x1 = get<uint16_t>(coords + (0 * count + i) * 2) * sx;
+        b.y1 = get<uint16_t>(coords + (1 * count + i) * 2) * sy;
+        b.x2 = get<uint16_t>(coords + (2 * count + i) * 2) * sx;
+        b.y2 = get<uint16_t>(coords + (3 * count + i) * 2) * sy;
+    }
+    return count;
+}
+
+int64_t DetectionLogReader::toJsonl(const std::string& out_path) const {
+    if (m_data == nullptr) return -1;
+    std::ofstream out(out_path, std::ios::out | std::ios::trunc);
+    if (!out) return -1;
+
+    std::vector<Box> boxes;
+    std::ostringstream line;
+    for (int64_t f = 0; f < frameCount(); f++) {
+        int64_t timestamp_ns = 0;
+        int width = 0, height = 0, count = 0;
+        frameInfo(f, timestamp_ns, width, height, count);
+        boxes.resize(static_cast<size_t>(count));
+        readFrame(f, timestamp_ns, width, height, boxes.data(), count);
+
+        line.str("");
+        line.clear();
+        line << "{\"stream\":";
+        writeJsonString(line, m_stream_name);
+        line << ",\"timestamp_ns\":" << timestamp_ns
+             << ",\"image_width\":" << width
+             << ",\"image_height\":" << height
+             << ",\"count\":" << count
+             << ",\"detections\":[";
+        for (int i = 0; i < count; i++) {
+            const Box& b = boxes[i];
+            if (i > 0) line << ",";
+            line << "{\"class_id\":" << b.class_id << ",\"class_name\":";
+            writeJsonString(line, b.class_id < static_cast<int>(m_class_names.size())
+                                      ? m_class_names[b.class_id] : "unknown");
+            line << ",\"confidence\":" << std::fixed << std::setprecision(4) << b.confidence
+                 << ",\"x1\":" << std::setprecision(2) << b.x1
+                 << ",\"y1\":" << b.y1
+                 << ",\"x2\":" << b.x2
+                 << ",\"y2\":" << b.y2 << "}";
+        }
+        line << "]}\n";
+        out << line.str();
+    }
+    out.flush();
+    return out ? frameCount() : -1;
+}
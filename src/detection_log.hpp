@@ -0,0 +1,114 @@
+#ifndef DETECTION_LOG_HPP
+#define DETECTION_LOG_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct Detection;
+
+// Append-only binary detection log.
+//
+// Layout (little-endian):
+//   header:  "YDLG" | u16 version | u16 flags | u16 stream name length | name
+//            | u16 class count | per class: u8 length + name bytes
+//   frame:   u32 payload size | i64 timestamp_ns | u16 width | u16 height
+//            | u16 count | class ids[count] (u8, or u16 with kFlagWideClassIds)
+//            | scores[count] u8 | x1[count] y1[count] x2[count] y2[count] u16
+//
+// Scores are quantized to 1/255 and box corners to 1/65535 of the frame size,
+// about 10 bytes per detection. Records are length-prefixed so a reader can
+// index a memory-mapped file without decoding it, and a torn record at the end
+// of a crashed file is simply ignored.
+namespace detection_log {
+
+constexpr char kMagic[4] = {'Y', 'D', 'L', 'G'};
+constexpr uint16_t kVersion = 1;
+constexpr uint16_t kFlagWideClassIds = 1;
+
+// One decoded detection
+struct Box {
+    int class_id;
+    float confidence;
+    float x1, y1, x2, y2;
+};
+
+}  // namespace detection_log
+
+class DetectionLogWriter {
+public:
+    ~DetectionLogWriter();
+
+    // Create or append to a log. Appending requires a matching class table
+    // (compared as stored: names cut to 255 bytes). Class ids are 1 byte for
+    // up to 255 classes, otherwise 2.
+    bool open(const std::string& path,
+              const std::string& stream_name,
+              const std::vector<std::string>& class_names);
+    void close();
+
+    // Returns false, writing nothing, for more than 65535 detections or a
+    // class id that is negative or too wide for the log (> 255 with 1-byte
+    // ids, > 65535 with 2-byte ids)
+    bool writeFrame(int64_t timestamp_ns, int width, int height,
+                    const detection_log::Box* boxes, int count);
+    bool writeFrame(int64_t timestamp_ns, int width, int height,
+                    const std::vector<Detection>& detections);
+
+    void flush();
+
+    int64_t framesWritten() const { return m_frames; }
+
+private:
+    std::mutex m_mutex;
+    FILE* m_file = nullptr;
+    bool m_wide_class_ids = false;
+    int64_t m_frames = 0;
+    std::vector<uint8_t> m_record;  // reused frame buffer
+
+    bool writeRecord();
+    bool appendFrame(int64_t timestamp_ns, int width, int height, int count,
+                     const detection_log::Box* boxes, const Detection* detections);
+};
+
+class DetectionLogReader {
+public:
+    ~DetectionLogReader();
+
+    // Map the log and index its frames. Returns false if it is not a valid log.
+    bool open(const std::string& path);
+    void close();
+
+    const std::string& streamName() const { return m_stream_name; }
+    const std::vector<std::string>& classNames() const { return m_class_names; }
+    int64_t frameCount() const { return static_cast<int64_t>(m_frames.size()); }
+
+    // Bytes covered by the header and complete frames
+    size_t validBytes() const { return m_valid_bytes; }
+
+    // Frame header fields, without decoding the detections
+    bool frameInfo(int64_t index, int64_t& timestamp_ns, int& width, int& height, int& count) const;
+
+    // Decode up to max_boxes detections of a frame. Returns the frame's count or -1.
+    int readFrame(int64_t index, int64_t& timestamp_ns, int& width, int& height,
+                  detection_log::Box* boxes, int max_boxes) const;
+
+    // Write one JSON object per frame. Returns frames written or -1.
+    int64_t toJsonl(const std::string& out_path) const;
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<uint8_t> m_fallback;    // file contents when mmap is unavailable
+
+    std::string m_stream_name;
+    std::vector<std::string> m_class_names;
+    bool m_wide_class_ids = false;
+    std::vector<size_t> m_frames;       // offset of each frame payload
+    size_t m_valid_bytes = 0;
+};
+
+#endif // DETECTION_LOG_HPP
@@ -0,0 +1,173 @@
+#include "detector_group.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+#include "image_decoder.hpp"
+#include "json_escape.hpp"
+
+PreprocessSignature PreprocessSignature::of(const YoloDetector& detector) {
+    PreprocessSignature signature;
+    signature.width = detector.inputWidth();
+    signature.height = detector.inputHeight();
+    signature.letterbox = detector.letterboxInput();
+    signature.format = detector.inputFormat();
+    return signature;
+}
+
+int DetectorGroup::add(const std::string& name, const std::string& model_path,
+                       const std::function<void(YoloDetector&)>& configure) {
+    auto member = std::make_unique<Member>();
+    member->name = name;
+    member->detector = std::make_unique<YoloDetector>();
+    if (configure) {
+        configure(*member->detector);
+    }
+    if (!member->detector->init(model_path)) {
+        return -1;
+    }
+    member->signature = PreprocessSignature::of(*member->detector);
+    member->decoder = member->detector->createDecoder();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_members.push_back(std::move(member));
+    return static_cast<int>(m_members.size()) - 1;
+}
+
+int DetectorGroup::inputFor(const PreprocessSignature& signature) {
+    for (size_t i = 0; i < m_inputs.size(); i++) {
+        if (m_inputs[i]->signature == signature) return static_cast<int>(i);
+    }
+    auto input = std::make_unique<Input>();
+    input->signature = signature;
+    m_inputs.push_back(std::move(input));
+    return static_cast<int>(m_inputs.size()) - 1;
+}
+
+DetectStatus DetectorGroup::detect(
+    const FrameSource& source,
+    float conf_threshold,
+    float iou_threshold,
+    std::vector<GroupResult>& results,
+    int& width,
+    int& height,
+    FrameTiming timing,
+    RequestPriority priority
+) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    results.assign(m_members.size(), GroupResult());
+    if (timing.enqueue_ts_ns == 0) {
+        timing.enqueue_ts_ns = monotonicNowNs();
+    }
+
+    // The frame is decoded / converted once for every member
+    DecodedImage image;
+    FrameView frame;
+    DetectStatus status = source(image, frame);
+    if (status != DetectStatus::Ok) {
+        return status;
+    }
+    width = frame.geometry.rotatedWidth();
+    height = frame.geometry.rotatedHeight();
+    m_frames++;
+
+    for (auto& input : m_inputs) {
+        input->sampled = false;
+    }
+
+    CandidateFilter filter;
+    filter.conf_threshold = conf_threshold;
+    TensorRun run;
+
+    for (size_t i = 0; i < m_members.size(); i++) {
+        Member& member = *m_members[i];
+        GroupResult& result = results[i];
+        YoloDetector& detector = *member.detector;
+
+        const PreprocessSignature signature = PreprocessSignature::of(detector);
+        if (signature != member.signature) {
+            member.signature = signature;
+            member.decoder = detector.createDecoder();
+        }
+        member.input = inputFor(signature);
+        Input& input = *m_inputs[member.input];
+
+        // First member with this signature samples; the others reuse the tensor
+        if (!input.sampled) {
+            const int64_t begin_ns = monotonicNowNs();
+            input.tensor.resize(static_cast<size_t>(3) * signature.width * signature.height);
+            input.stream.sample(frame, signature.width, signature.height, signature.letterbox, signature.format,
+                                input.tensor.data(), input.scale, input.pad_x, input.pad_y);
+            input.sample_ms += (monotonicNowNs() - begin_ns) / 1e6;
+            input.samples++;
+            input.sampled = true;
+        }
+        input.uses++;
+
+        const int64_t shape[4] = {1, 3, signature.height, signature.width};
+        result.status = detector.runTensor(input.tensor.data(), shape, 4, run, timing, priority);
+        if (result.status != DetectStatus::Ok) {
+            continue;
+        }
+
+        // An embedding output, if configured, follows the detection outputs
+        m_views.assign(run.outputs.begin(),
+                       run.outputs.begin() + std::min(run.outputs.size(), detector.detectionOutputCount()));
+        m_candidates.clear();
+        member.decoder->decode(m_views, filter, m_candidates);
+        result.detections = detector.finishCandidates(
+            m_candidates, detector.tensorMapping(width, height, input.scale, input.pad_x, input.pad_y),
+            width, height, iou_threshold, member.decoder->suppressed(), true);
+        run = TensorRun();
+    }
+    m_views.clear();
+    return DetectStatus::Ok;
+}
+
+std::string DetectorGroup::statsJson() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    int64_t samples = 0;
+    int64_t uses = 0;
+    double sample_ms = 0.0;
+    double saved_ms = 0.0;
+    std::ostringstream inputs;
+    for (size_t i = 0; i < m_inputs.size(); i++) {
+        const Input& input = *m_inputs[i];
+        const double mean_ms = input.samples > 0 ? input.sample_ms / input.samples : 0.0;
+        samples += input.samples;
+        uses += input.uses;
+        sample_ms += input.sample_ms;
+        saved_ms += (input.uses - input.samples) * mean_ms;
+
+        inputs << (i > 0 ? "," : "") << "{"
+               << "\"width\":" << input.signature.width
+               << ",\"height\":" << input.signature.height
+               << ",\"letterbox\":" << (input.signature.letterbox ? "true" : "false")
+               << ",\"rgb\":" << (input.signature.format.rgb ? "true" : "false")
+               << ",\"norm\":" << input.signature.format.norm
+               << ",\"models\":[";
+        bool first = true;
+        for (const auto& member : m_members) {
+            if (member->input != static_cast<int>(i)) continue;
+            inputs << (first ? "" : ",");
+            writeJsonString(inputs, member->name);
+            first = false;
+        }
+        inputs << "],\"samples\":" << input.samples
+               << ",\"uses\":" << input.uses
+               << ",\"mean_sample_ms\":" << mean_ms
+               << "}";
+    }
+
+    std::ostringstream oss;
+    oss << "{\"models\":" << m_members.size()
+        << ",\"frames\":" << m_frames
+        << ",\"samples\":" << samples
+        << ",\"samples_unshared\":" << uses
+        << ",\"samples_saved\":" << (uses - samples)
+        << ",\"sample_ms\":" << sample_ms
+        << ",\"saved_ms\":" << saved_ms
+        << ",\"inputs\":[" << inputs.str() << "]}";
+    return oss.str();
+}
@@ -0,0 +1,114 @@
+#ifndef DETECTOR_GROUP_HPP
+#define DETECTOR_GROUP_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "stream_context.hpp"
+#include "yolo_detector.hpp"
+
+// Everything that decides a model's input tensor for a given frame: input
+// size, letterbox vs stretch, channel order and scale. Models with equal
+// signatures accept the same tensor.
+struct PreprocessSignature {
+    int width = 0;
+    int height = 0;
+    bool letterbox = true;
+    TensorFormat format;
+
+    static PreprocessSignature of(const YoloDetector& detector);
+
+    bool operator==(const PreprocessSignature& o) const {
+        return width == o.width && height == o.height && letterbox == o.letterbox &&
+               format.rgb == o.format.rgb && format.norm == o.format.norm;
+    }
+    bool operator!=(const PreprocessSignature& o) const { return !(*this == o); }
+};
+
+// One model's outcome for a frame run through a DetectorGroup
+struct GroupResult {
+    DetectStatus status = DetectStatus::Ok;
+    std::vector<Detection> detections;
+};
+
+// Several models run on the same frames (e.g. a person and a vehicle model).
+//
+// Each frame is produced once and sampled once per distinct
+// PreprocessSignature; models sharing a signature run on the same tensor,
+// read-only and in place (YoloDetector::runTensor), each with its own
+// decoder. Signatures are taken per frame, so a member whose model type or
+// input folding changes moves to the matching input. Every model keeps its
+// own session and scheduler. detect() calls are serialized.
+class DetectorGroup {
+public:
+    // Load a model as the next member; configure (optional) runs on its
+    // detector before the session loads. Returns the member index, or -1 if
+    // the model fails to load.
+    int add(const std::string& name, const std::string& model_path,
+            const std::function<void(YoloDetector&)>& configure = nullptr);
+
+    size_t size() const { return m_members.size(); }
+    YoloDetector& detector(size_t index) { return *m_members[index]->detector; }
+    const std::string& name(size_t index) const { return m_members[index]->name; }
+
+    // Run every member on one frame. results receives one entry per member, in
+    // add order; width / height: the frame size the detections refer to.
+    // Returns the frame source's status (members report theirs in results).
+    DetectStatus detect(
+        const FrameSource& source,
+        float conf_threshold,
+        float iou_threshold,
+        std::vector<GroupResult>& results,
+        int& width,
+        int& height,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive
+    );
+
+    // Frames, distinct inputs with the models they feed, samples taken
+    // against one per model, and the sampling time that sharing saved, as JSON
+    std::string statsJson() const;
+
+private:
+    struct Member {
+        std::string name;
+        std::unique_ptr<YoloDetector> detector;
+        std::unique_ptr<OutputDecoder> decoder;
+        PreprocessSignature signature;  // the decoder is rebuilt when this changes
+        int input = -1;                 // index into m_inputs for the current frame
+    };
+
+    // Tensor for one signature, sampled with its own plan
+    struct Input {
+        PreprocessSignature signature;
+        StreamContext stream;
+        std::vector<float> tensor;
+        float scale = 1.0f;
+        int pad_x = 0;
+        int pad_y = 0;
+        bool sampled = false;           // for the current frame
+
+        int64_t samples = 0;
+        int64_t uses = 0;               // model runs fed from this input
+        double sample_ms = 0.0;
+    };
+
+    std::vector<std::unique_ptr<Member>> m_members;
+    std::vector<std::unique_ptr<Input>> m_inputs;
+
+    mutable std::mutex m_mutex;
+    int64_t m_frames = 0;
+
+    // Reused per model run
+    std::vector<OutputTensor> m_views;
+    std::vector<HeadBox> m_candidates;
+
+    // Input for a signature, created on first use
+    int inputFor(const PreprocessSignature& signature);
+};
+
+#endif // DETECTOR_GROUP_HPP
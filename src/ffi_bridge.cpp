@@ -1,29 +1,316 @@
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <sstream>
+#include <string>
 
+#include "flutter_yolo_open_kit.h"
+#include "batch_scan.hpp"
+#include "delta_stream.hpp"
+#include "detection_log.hpp"
+#include "json_escape.hpp"
+#include "mjpeg_ingest.hpp"
+#include "numa_replicas.hpp"
+#include "stream_context.hpp"
+#include "task_pool.hpp"
+#include "video_scan.hpp"
 #include "yolo_detector.hpp"
 
-#if _WIN32
-#define FFI_PLUGIN_EXPORT __declspec(dllexport)
-#else
-#define FFI_PLUGIN_EXPORT __attribute__((visibility("default")))
-#endif
+static_assert(sizeof(YoloLogBox) == sizeof(detection_log::Box),
+              "YoloLogBox must match detection_log::Box");
+static_assert(sizeof(YoloBox) == sizeof(detection_log::Box), "YoloBox must match detection_log::Box");
+static_assert(static_cast<int>(BackendType::OpenCvDnn) == YOLO_BACKEND_OPENCV_DNN,
+              "BackendType must match YoloBackend");
+static_assert(static_cast<int>(DeltaStatus::Malformed) == YOLO_DELTA_MALFORMED &&
+              static_cast<int>(DeltaStatus::OutOfSync) == YOLO_DELTA_OUT_OF_SYNC,
+              "DeltaStatus must match YoloDeltaStatus");
+static_assert(static_cast<int>(DetectStatus::NotInitialized) == YOLO_ERR_NOT_INITIALIZED &&
+              static_cast<int>(DetectStatus::Preempted) == YOLO_ERR_PREEMPTED,
+              "YoloStatus must match DetectStatus");
 
-extern "C" {
+// Build frame timing from optional caller metadata, stamped at native entry
+static FrameTiming makeTiming(const YoloDetectOptions* options) {
+    FrameTiming timing;
+    timing.enqueue_ts_ns = monotonicNowNs();
+    if (options != nullptr) {
+        timing.capture_ts_ns = options->capture_ts_ns;
+        timing.frame_id = options->frame_id;
+    }
+    return timing;
+}
+
+// Parse a simple JSON array of strings: ["class1", "class2", ...]
+static std::vector<std::string> parseStringArray(const char* json_array) {
+    std::vector<std::string> items;
+    std::string json(json_array);
+
+    size_t pos = 0;
+    while ((pos = json.find("\"", pos)) != std::string::npos) {
+        std::string item;
+        size_t i = pos + 1;
+        for (; i < json.size() && json[i] != '"'; i++) {
+            char c = json[i];
+            if (c == '\\' && i + 1 < json.size()) {
+                c = json[++i];
+                switch (c) {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'r': c = '\r'; break;
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case 'u': {
+                        // BMP code point, re-encoded as UTF-8
+                        unsigned cp = static_cast<unsigned>(strtoul(json.substr(i + 1, 4).c_str(), nullptr, 16));
+                        i += 4;
+                        if (cp < 0x80) {
+                            item += static_cast<char>(cp);
+                        } else if (cp < 0x800) {
+                            item += static_cast<char>(0xC0 | (cp >> 6));
+                            item += static_cast<char>(0x80 | (cp & 0x3F));
+                        } else {
+                            item += static_cast<char>(0xE0 | (cp >> 12));
+                            item += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                            item += static_cast<char>(0x80 | (cp & 0x3F));
+                        }
+                        continue;
+                    }
+                    default: break;  // \" \\ \/
+                }
+            }
+            item += c;
+        }
+        if (i >= json.size()) break;
+
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+        pos = i + 1;
+    }
+    return items;
+}
 
-// Global detector instance
+// Stream context a call belongs to (nullptr = the detector's own state)
+static StreamContext* streamOf(const YoloDetectOptions* options) {
+    return options != nullptr ? reinterpret_cast<StreamContext*>(options->stream) : nullptr;
+}
+
+// Map the C priority to a scheduler class (unknown values are interactive)
+static RequestPriority priorityOf(const YoloDetectOptions* options) {
+    if (options == nullptr) {
+        return RequestPriority::Interactive;
+    }
+    switch (options->priority) {
+        case YOLO_PRIORITY_REALTIME:
+            return RequestPriority::Realtime;
+        case YOLO_PRIORITY_BACKGROUND:
+            return RequestPriority::Background;
+        default:
+            return RequestPriority::Interactive;
+    }
+}
+
+// Global detector instance (the primary replica in NUMA server mode)
 static YoloDetector* g_detector = nullptr;
 
-// Initialize YOLO detector with model path
-FFI_PLUGIN_EXPORT int yolo_init(const char* model_path) {
-    if (g_detector != nullptr) {
+// One detector per NUMA node in server mode (owns g_detector)
+static NumaReplicaSet* g_replicas = nullptr;
+
+// Log currently attached to g_detector
+static DetectionLogWriter* g_attached_log = nullptr;
+
+// Batch scan near-duplicate threshold in dHash bits (-1 = off)
+static std::atomic<int> g_dedup_distance{-1};
+
+// Embedding feature output applied at the next init (empty = none)
+static std::string g_embedding_output;
+static int g_embedding_pooled = 1;
+
+// Fold input normalization into the first convolution at the next init
+static bool g_fold_input = false;
+
+// Inference backend for the next init
+static BackendType g_backend = BackendType::OnnxRuntime;
+
+// Latest result of every detector (all replicas publish here); outlives them
+// so polling never races a release
+static LatestResult g_latest;
+
+// Apply fn to the detector, or to every replica in server mode
+template <typename Fn>
+static void forEachDetector(Fn&& fn) {
+    if (g_replicas != nullptr) {
+        g_replicas->forEach(fn);
+    } else if (g_detector != nullptr) {
+        fn(*g_detector);
+    }
+}
+
+// Run fn on the detector, or on the least-loaded replica in server mode
+template <typename Fn>
+static auto routeDetect(Fn&& fn) -> decltype(fn(*g_detector)) {
+    if (g_replicas != nullptr) {
+        return g_replicas->route(fn);
+    }
+    return fn(*g_detector);
+}
+
+// Frame view of a pixel format descriptor (false if it is malformed)
+static bool frameView(const YoloFrameDesc* desc, FrameView& view) {
+    if (desc == nullptr || desc->width <= 0 || desc->height <= 0) return false;
+
+    const int width = desc->width;
+    const int chroma_width = (width + 1) / 2;
+    auto strideOr = [&](int plane, int packed) {
+        return desc->strides[plane] > 0 ? desc->strides[plane] : packed;
+    };
+
+    FrameGeometry& g = view.geometry;
+    g.width = width;
+    g.height = desc->height;
+    g.rotation = (desc->rotation == 90 || desc->rotation == 180 || desc->rotation == 270) ? desc->rotation : 0;
+    view.data = desc->planes[0];
+
+    switch (desc->format) {
+        case YOLO_PIXEL_NV12:
+        case YOLO_PIXEL_NV21: {
+            const uint8_t* uv = desc->planes[1];
+            if (uv == nullptr) return false;
+            const bool nv21 = desc->format == YOLO_PIXEL_NV21;
+            g.format = SourceFormat::YUV420;
+            g.stride = strideOr(0, width);
+            g.uv_row_stride = strideOr(1, 2 * chroma_width);
+            g.uv_pixel_stride = 2;
+            view.u = nv21 ? uv + 1 : uv;
+            view.v = nv21 ? uv : uv + 1;
+            break;
+        }
+        case YOLO_PIXEL_I420:
+            if (desc->planes[1] == nullptr || desc->planes[2] == nullptr) return false;
+            if (strideOr(1, chroma_width) != strideOr(2, chroma_width)) return false;
+            g.format = SourceFormat::YUV420;
+            g.stride = strideOr(0, width);
+            g.uv_row_stride = strideOr(1, chroma_width);
+            g.uv_pixel_stride = 1;
+            view.u = desc->planes[1];
+            view.v = desc->planes[2];
+            break;
+        case YOLO_PIXEL_RGB:
+            g.format = SourceFormat::RGB;
+            g.stride = strideOr(0, 3 * width);
+            break;
+        case YOLO_PIXEL_BGR:
+            g.format = SourceFormat::BGR;
+            g.stride = strideOr(0, 3 * width);
+            break;
+        case YOLO_PIXEL_RGBA:
+            g.format = SourceFormat::RGBA;
+            g.stride = strideOr(0, 4 * width);
+            break;
+        case YOLO_PIXEL_BGRA:
+            g.format = SourceFormat::BGRA;
+            g.stride = strideOr(0, 4 * width);
+            break;
+        case YOLO_PIXEL_GRAY:
+            g.format = SourceFormat::GRAY;
+            g.stride = strideOr(0, width);
+            break;
+        case YOLO_PIXEL_YUYV:
+            g.format = SourceFormat::YUYV;
+            g.stride = strideOr(0, 4 * chroma_width);
+            break;
+        default:
+            return false;
+    }
+    return view.data != nullptr;
+}
+
+// Frame source for a presence / count input (nullptr if the kind is unknown)
+static FrameSource inputSource(const YoloInput& input) {
+    switch (input.kind) {
+        case YOLO_INPUT_PATH:
+            return YoloDetector::fileSource(input.path);
+        case YOLO_INPUT_ENCODED:
+            return YoloDetector::memorySource(input.data, input.size > 0 ? static_cast<size_t>(input.size) : 0);
+        case YOLO_INPUT_BGRA:
+            return YoloDetector::bgraSource(input.data, input.width, input.height, input.stride);
+        case YOLO_INPUT_YUV420:
+            return YoloDetector::yuvSource(
+                input.data, input.u_data, input.v_data,
+                input.width, input.height,
+                input.stride, input.uv_row_stride, input.uv_pixel_stride,
+                input.rotation);
+        case YOLO_INPUT_FRAME: {
+            FrameView view;
+            if (!frameView(input.frame, view)) return nullptr;
+            return YoloDetector::viewSource(view);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+static void releaseDetectors() {
+    if (g_replicas != nullptr) {
+        delete g_replicas;
+        g_replicas = nullptr;
+    } else {
         delete g_detector;
     }
+    g_detector = nullptr;
+}
+
+extern "C" {
+
+// Initialize YOLO detector with model path
+FFI_PLUGIN_EXPORT int yolo_init(const char* model_path) {
+    releaseDetectors();
     g_detector = new YoloDetector();
+    g_detector->setDetectionLog(g_attached_log);
+    g_detector->setEmbeddingOutput(g_embedding_output, g_embedding_pooled);
+    g_detector->setFoldInputNormalization(g_fold_input);
+    g_detector->setBackend(g_backend);
+    g_detector->setLatestResult(&g_latest);
     return g_detector->init(model_path) ? 1 : 0;
 }
 
+// Initialize server mode: one detector per NUMA node
+FFI_PLUGIN_EXPORT int yolo_init_numa(const char* model_path) {
+    releaseDetectors();
+    auto* replicas = new NumaReplicaSet();
+    if (!replicas->init(model_path, [](YoloDetector& d) {
+            d.setEmbeddingOutput(g_embedding_output, g_embedding_pooled);
+            d.setFoldInputNormalization(g_fold_input);
+            d.setBackend(g_backend);
+            d.setLatestResult(&g_latest);
+        })) {
+        delete replicas;
+        return 0;
+    }
+    g_replicas = replicas;
+    g_detector = &replicas->primary();
+    forEachDetector([](YoloDetector& d) { d.setDetectionLog(g_attached_log); });
+    return static_cast<int>(replicas->size());
+}
+
+// Replica placement and load as JSON (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_get_numa_info() {
+    if (g_replicas == nullptr) {
+        return strdup("{\"numa\":false,\"replicas\":[]}");
+    }
+    return strdup(g_replicas->infoJson().c_str());
+}
+
+// Thread budget for ONNX Runtime and the task pool
+FFI_PLUGIN_EXPORT void yolo_set_thread_budget(int threads) {
+    setThreadBudget(threads);
+}
+
+FFI_PLUGIN_EXPORT int yolo_get_thread_budget() {
+    return threadBudget();
+}
+
 // Run detection on image file path
 // Returns JSON string with detection results (caller must free with free_string)
 FFI_PLUGIN_EXPORT char* yolo_detect_path(
@@ -31,10 +318,23 @@ FFI_PLUGIN_EXPORT char* yolo_detect_path(
     float conf_threshold,
     float iou_threshold
 ) {
+    return yolo_detect_path_ex(image_path, conf_threshold, iou_threshold, nullptr);
+}
+
+FFI_PLUGIN_EXPORT char* yolo_detect_path_ex(
+    const char* image_path,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+) {
+    FrameTiming timing = makeTiming(options);
     if (g_detector == nullptr) {
         return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
     }
-    return g_detector->detectFromPath(image_path, conf_threshold, iou_threshold);
+    return routeDetect([&](YoloDetector& detector) {
+        return detector.detectJson(YoloDetector::fileSource(image_path), conf_threshold, iou_threshold,
+                                   timing, priorityOf(options), streamOf(options));
+    });
 }
 
 // Run detection on image buffer (BGRA format from camera)
@@ -47,10 +347,26 @@ FFI_PLUGIN_EXPORT char* yolo_detect_buffer(
     float conf_threshold,
     float iou_threshold
 ) {
+    return yolo_detect_buffer_ex(image_data, width, height, stride, conf_threshold, iou_threshold, nullptr);
+}
+
+FFI_PLUGIN_EXPORT char* yolo_detect_buffer_ex(
+    const uint8_t* image_data,
+    int width,
+    int height,
+    int stride,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+) {
+    FrameTiming timing = makeTiming(options);
     if (g_detector == nullptr) {
         return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
     }
-    return g_detector->detectFromBuffer(image_data, width, height, stride, conf_threshold, iou_threshold);
+    return routeDetect([&](YoloDetector& detector) {
+        return detector.detectJson(YoloDetector::bgraSource(image_data, width, height, stride),
+                                   conf_threshold, iou_threshold, timing, priorityOf(options), streamOf(options));
+    });
 }
 
 // Run detection on YUV420 buffer (Android camera format)
@@ -69,52 +385,878 @@ FFI_PLUGIN_EXPORT char* yolo_detect_yuv(
     float conf_threshold,
     float iou_threshold
 ) {
-    if (g_detector == nullptr) {
-        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
-    }
-    return g_detector->detectFromYUV(
+    return yolo_detect_yuv_ex(
         y_data, u_data, v_data,
         width, height,
         y_row_stride, uv_row_stride, uv_pixel_stride,
         rotation,
-        conf_threshold, iou_threshold
+        conf_threshold, iou_threshold,
+        nullptr
     );
 }
 
-// Set custom class names (JSON array string)
-FFI_PLUGIN_EXPORT void yolo_set_classes(const char* class_names_json) {
+FFI_PLUGIN_EXPORT char* yolo_detect_yuv_ex(
+    const uint8_t* y_data,
+    const uint8_t* u_data,
+    const uint8_t* v_data,
+    int width,
+    int height,
+    int y_row_stride,
+    int uv_row_stride,
+    int uv_pixel_stride,
+    int rotation,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+) {
+    FrameTiming timing = makeTiming(options);
+    if (g_detector == nullptr) {
+        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
+    }
+    return routeDetect([&](YoloDetector& detector) {
+        return detector.detectJson(
+            YoloDetector::yuvSource(y_data, u_data, v_data,
+                                    width, height,
+                                    y_row_stride, uv_row_stride, uv_pixel_stride,
+                                    rotation),
+            conf_threshold, iou_threshold,
+            timing, priorityOf(options), streamOf(options)
+        );
+    });
+}
+
+// Run detection on a frame in any YoloPixelFormat
+FFI_PLUGIN_EXPORT char* yolo_detect_frame(
+    const YoloFrameDesc* desc,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+) {
+    FrameTiming timing = makeTiming(options);
+    if (g_detector == nullptr) {
+        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
+    }
+    FrameView view;
+    if (!frameView(desc, view)) {
+        return strdup("{\"error\":\"Invalid frame descriptor\",\"code\":\"INVALID_ARGUMENT\"}");
+    }
+    return routeDetect([&](YoloDetector& detector) {
+        return detector.detectJson(YoloDetector::viewSource(view), conf_threshold, iou_threshold,
+                                   timing, priorityOf(options), streamOf(options));
+    });
+}
+
+// Presence check: 1 / 0, or a negative YoloStatus
+FFI_PLUGIN_EXPORT int yolo_detect_presence(
+    const YoloInput* input,
+    const int32_t* class_ids,
+    int class_count,
+    float conf_threshold,
+    const YoloDetectOptions* options
+) {
+    FrameTiming timing = makeTiming(options);
+    if (g_detector == nullptr) {
+        return YOLO_ERR_NOT_INITIALIZED;
+    }
+    FrameSource source = input != nullptr ? inputSource(*input) : nullptr;
+    if (!source) {
+        return YOLO_ERR_INVALID_ARGUMENT;
+    }
+    std::vector<int> classes;
+    if (class_ids != nullptr && class_count > 0) {
+        classes.assign(class_ids, class_ids + class_count);
+    }
+
+    bool present = false;
+    DetectStatus status = routeDetect([&](YoloDetector& detector) {
+        return detector.detectPresence(source, classes, conf_threshold, present, timing, priorityOf(options),
+                                       streamOf(options));
+    });
+    if (status != DetectStatus::Ok) {
+        return static_cast<int>(status);
+    }
+    return present ? 1 : 0;
+}
+
+// Per-class counts after NMS: total, or a negative YoloStatus
+FFI_PLUGIN_EXPORT int yolo_detect_count(
+    const YoloInput* input,
+    const int32_t* class_ids,
+    int class_count,
+    float conf_threshold,
+    float iou_threshold,
+    int32_t* counts,
+    int counts_len,
+    const YoloDetectOptions* options
+) {
+    FrameTiming timing = makeTiming(options);
+    if (counts != nullptr && counts_len > 0) {
+        memset(counts, 0, sizeof(int32_t) * counts_len);
+    }
+    if (g_detector == nullptr) {
+        return YOLO_ERR_NOT_INITIALIZED;
+    }
+    FrameSource source = input != nullptr ? inputSource(*input) : nullptr;
+    if (!source) {
+        return YOLO_ERR_INVALID_ARGUMENT;
+    }
+    std::vector<int> classes;
+    if (class_ids != nullptr && class_count > 0) {
+        classes.assign(class_ids, class_ids + class_count);
+    }
+
+    std::vector<int> per_class;
+    DetectStatus status = routeDetect([&](YoloDetector& detector) {
+        return detector.detectCount(source, classes, conf_threshold, iou_threshold, per_class,
+                                    timing, priorityOf(options), streamOf(options));
+    });
+    if (status != DetectStatus::Ok) {
+        return static_cast<int>(status);
+    }
+
+    int total = 0;
+    for (size_t c = 0; c < per_class.size(); c++) {
+        total += per_class[c];
+        if (counts != nullptr && static_cast<int>(c) < counts_len) {
+            counts[c] = per_class[c];
+        }
+    }
+    return total;
+}
+
+// Embedding feature output for the next init
+FFI_PLUGIN_EXPORT void yolo_set_embedding_output(const char* output_name, int pooled_size) {
+    g_embedding_output = output_name != nullptr ? output_name : "";
+    g_embedding_pooled = std::max(1, pooled_size);
+}
+
+FFI_PLUGIN_EXPORT int yolo_get_embedding_dim() {
+    return g_detector != nullptr ? g_detector->embeddingDim() : 0;
+}
+
+// Input normalization folding for the next init
+FFI_PLUGIN_EXPORT void yolo_set_fold_input(int enabled) {
+    g_fold_input = enabled != 0;
+}
+
+FFI_PLUGIN_EXPORT int yolo_is_input_folded() {
+    return g_detector != nullptr && g_detector->inputFolded() ? 1 : 0;
+}
+
+FFI_PLUGIN_EXPORT int yolo_set_backend(int backend) {
+    if (backend != YOLO_BACKEND_ONNXRUNTIME && backend != YOLO_BACKEND_OPENCV_DNN) {
+        return 0;
+    }
+    BackendType type = static_cast<BackendType>(backend);
+    if (!backendAvailable(type)) {
+        return 0;
+    }
+    g_backend = type;
+    return 1;
+}
+
+FFI_PLUGIN_EXPORT const char* yolo_get_backend_name() {
+    return g_detector != nullptr ? g_detector->backendName() : "";
+}
+
+// Binary result: boxes (and embeddings) into caller buffers
+FFI_PLUGIN_EXPORT int yolo_detect_boxes(
+    const YoloInput* input,
+    float conf_threshold,
+    float iou_threshold,
+    YoloBox* boxes,
+    int max_boxes,
+    float* embeddings,
+    int embedding_capacity,
+    int32_t* image_width,
+    int32_t* image_height,
+    const YoloDetectOptions* options
+) {
+    FrameTiming timing = makeTiming(options);
+    if (g_detector == nullptr) {
+        return YOLO_ERR_NOT_INITIALIZED;
+    }
+    FrameSource source = input != nullptr ? inputSource(*input) : nullptr;
+    if (!source || (max_boxes > 0 && boxes == nullptr)) {
+        return YOLO_ERR_INVALID_ARGUMENT;
+    }
+
+    std::vector<Detection> detections;
+    std::vector<float> pooled;
+    int width = 0;
+    int height = 0;
+    DetectStatus status = routeDetect([&](YoloDetector& detector) {
+        return detector.detectBoxes(source, conf_threshold, iou_threshold, embeddings != nullptr,
+                                    detections, pooled, width, height, timing, priorityOf(options),
+                                    streamOf(options));
+    });
+    if (status != DetectStatus::Ok) {
+        return static_cast<int>(status);
+    }
+
+    if (image_width != nullptr) *image_width = width;
+    if (image_height != nullptr) *image_height = height;
+
+    const int count = static_cast<int>(detections.size());
+    const int written = std::min(count, std::max(max_boxes, 0));
+    for (int i = 0; i < written; i++) {
+        const Detection& d = detections[i];
+        boxes[i] = YoloBox{d.class_id, d.confidence, d.x1, d.y1, d.x2, d.y2};
+    }
+
+    const size_t dim = count > 0 ? pooled.size() / count : 0;
+    if (embeddings != nullptr && dim > 0) {
+        size_t fit = std::min(static_cast<size_t>(written),
+                              static_cast<size_t>(std::max(embedding_capacity, 0)) / dim);
+        memcpy(embeddings, pooled.data(), fit * dim * sizeof(float));
+    }
+    return count;
+}
+
+// Latest-result slot for a stream, or the detector-wide one
+static LatestResult& latestOf(YoloStream* stream) {
+    return stream != nullptr ? reinterpret_cast<StreamContext*>(stream)->latest() : g_latest;
+}
+
+FFI_PLUGIN_EXPORT int64_t yolo_latest_sequence(YoloStream* stream) {
+    return latestOf(stream).sequence();
+}
+
+FFI_PLUGIN_EXPORT int yolo_latest_poll(
+    YoloStream* stream,
+    int64_t last_sequence,
+    YoloLatestInfo* info,
+    YoloBox* boxes,
+    int max_boxes
+) {
+    if (info == nullptr || (max_boxes > 0 && boxes == nullptr)) {
+        return YOLO_ERR_INVALID_ARGUMENT;
+    }
+    LatestResult& latest = latestOf(stream);
+    const LatestFrame* frame = latest.acquire(last_sequence);
+    if (frame == nullptr) {
+        return 0;
+    }
+
+    info->sequence = frame->sequence;
+    info->frame_id = frame->timing.frame_id;
+    info->capture_ts_ns = frame->timing.capture_ts_ns;
+    info->end_ts_ns = frame->timing.end_ts_ns;
+    info->width = frame->width;
+    info->height = frame->height;
+    info->count = static_cast<int32_t>(frame->boxes.size());
+    const int written = std::min(info->count, std::max(max_boxes, 0));
+    for (int i = 0; i < written; i++) {
+        const detection_log::Box& b = frame->boxes[i];
+        boxes[i] = YoloBox{b.class_id, b.confidence, b.x1, b.y1, b.x2, b.y2};
+    }
+    latest.release();
+    return 1;
+}
+
+// Raw tensor run: session outputs handed out in place
+FFI_PLUGIN_EXPORT int yolo_run_tensor(
+    const float* input,
+    const int64_t* shape,
+    int rank,
+    YoloTensorView* outputs,
+    int max_outputs,
+    YoloTensorResult** result,
+    const YoloDetectOptions* options
+) {
+    FrameTiming timing = makeTiming(options);
+    if (result == nullptr) {
+        return YOLO_ERR_INVALID_ARGUMENT;
+    }
+    *result = nullptr;
+    if (g_detector == nullptr) {
+        return YOLO_ERR_NOT_INITIALIZED;
+    }
+    if (max_outputs > 0 && outputs == nullptr) {
+        return YOLO_ERR_INVALID_ARGUMENT;
+    }
+
+    auto* run = new TensorRun();
+    DetectStatus status = routeDetect([&](YoloDetector& detector) {
+        return detector.runTensor(input, shape, rank, *run, timing, priorityOf(options));
+    });
+    if (status != DetectStatus::Ok) {
+        delete run;
+        return static_cast<int>(status);
+    }
+
+    const int count = static_cast<int>(run->outputs.size());
+    for (int i = 0; i < std::min(count, max_outputs); i++) {
+        YoloTensorView& view = outputs[i];
+        memset(&view, 0, sizeof(view));
+        view.name = run->names[i].c_str();
+
+        const OutputTensor& tensor = run->outputs[i];
+        view.data = tensor.data;
+        view.element_count = static_cast<int64_t>(tensor.count);
+        view.rank = static_cast<int32_t>(std::min(tensor.shape.size(), static_cast<size_t>(YOLO_TENSOR_MAX_DIMS)));
+        for (int d = 0; d < view.rank; d++) {
+            view.shape[d] = tensor.shape[d];
+        }
+    }
+    *result = reinterpret_cast<YoloTensorResult*>(run);
+    return count;
+}
+
+FFI_PLUGIN_EXPORT void yolo_tensor_release(YoloTensorResult* result) {
+    delete reinterpret_cast<TensorRun*>(result);
+}
+
+FFI_PLUGIN_EXPORT int yolo_get_input_size(int32_t* width, int32_t* height) {
+    if (g_detector == nullptr || !g_detector->isInitialized()) {
+        return 0;
+    }
+    if (width != nullptr) *width = g_detector->inputWidth();
+    if (height != nullptr) *height = g_detector->inputHeight();
+    return 1;
+}
+
+// Batch scan: prefetch file contents, decode from memory, detect in order
+static char* detectFiles(
+    const std::vector<std::string>& paths,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+) {
+    if (g_detector == nullptr) {
+        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
+    }
+    // Batch scans default to background priority
+    RequestPriority priority = options != nullptr ? priorityOf(options) : RequestPriority::Background;
+    BatchScanOptions scan;
+    scan.dedup_distance = g_dedup_distance.load();
+    // yolo_cancel_background stops a background scan also between files
+    const uint64_t cancels = g_detector->backgroundCancels();
+    std::string json = runBatchScan(paths, scan,
+        [&](const uint8_t* data, size_t size, const FrameTiming& timing, char*& result) {
+            DetectStatus status = DetectStatus::Cancelled;
+            if (priority == RequestPriority::Background && g_detector->backgroundCancels() != cancels) {
+                result = strdup("{\"error\":\"Request cancelled\",\"code\":\"CANCELLED\"}");
+                return status;
+            }
+            result = routeDetect([&](YoloDetector& detector) {
+                return detector.detectJson(YoloDetector::memorySource(data, size), conf_threshold, iou_threshold,
+                                           timing, priority, nullptr, &status);
+            });
+            return status;
+        });
+    return strdup(json.c_str());
+}
+
+FFI_PLUGIN_EXPORT char* yolo_detect_paths(
+    const char* paths_json,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+) {
+    if (paths_json == nullptr) {
+        return strdup("{\"error\":\"No paths given\",\"code\":\"INVALID_ARGUMENT\"}");
+    }
+    return detectFiles(parseStringArray(paths_json), conf_threshold, iou_threshold, options);
+}
+
+FFI_PLUGIN_EXPORT char* yolo_detect_directory(
+    const char* directory,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+) {
+    if (directory == nullptr) {
+        return strdup("{\"error\":\"No directory given\",\"code\":\"INVALID_ARGUMENT\"}");
+    }
+    return detectFiles(listImageFiles(directory), conf_threshold, iou_threshold, options);
+}
+
+FFI_PLUGIN_EXPORT void yolo_set_batch_dedup(int max_distance) {
+    g_dedup_distance.store(max_distance < 0 ? -1 : std::min(max_distance, 128));
+}
+
+// Sparse video scan: skip frames between samples without converting them
+FFI_PLUGIN_EXPORT char* yolo_detect_video(
+    const char* video_path,
+    double interval_seconds,
+    int keyframe_interval,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+) {
+    if (video_path == nullptr) {
+        return strdup("{\"error\":\"No video given\",\"code\":\"INVALID_ARGUMENT\"}");
+    }
+    if (g_detector == nullptr) {
+        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
+    }
+    // Video scans default to background priority, like batch scans
+    RequestPriority priority = options != nullptr ? priorityOf(options) : RequestPriority::Background;
+    VideoScanOptions scan;
+    scan.interval_s = interval_seconds;
+    if (keyframe_interval >= 0) {
+        scan.keyframe_interval = keyframe_interval;
+    }
+    std::string json = runVideoScan(video_path, scan,
+        [&](const FrameView& frame, const FrameTiming& timing) {
+            return routeDetect([&](YoloDetector& detector) {
+                return detector.detectJson(YoloDetector::viewSource(frame), conf_threshold, iou_threshold,
+                                           timing, priority, streamOf(options));
+            });
+        });
+    return strdup(json.c_str());
+}
+
+// MJPEG ingest: frames split and decoded off the calling thread
+static MjpegIngestOptions mjpegOptions(int decode_threads, int decode_scale, int drop_late) {
+    MjpegIngestOptions options;
+    options.decode_threads = decode_threads;
+    options.decode_scale = decode_scale;
+    options.drop_late = drop_late != 0;
+    // Before yolo_init there is no input size, and auto scale decodes at 1
+    if (g_detector != nullptr) {
+        options.min_width = g_detector->inputWidth();
+        options.min_height = g_detector->inputHeight();
+    }
+    return options;
+}
+
+FFI_PLUGIN_EXPORT YoloMjpegIngest* yolo_mjpeg_open_fd(int fd, int decode_threads, int decode_scale, int drop_late) {
+    if (fd < 0) {
+        return nullptr;
+    }
+    return reinterpret_cast<YoloMjpegIngest*>(
+        new MjpegIngest(fd, mjpegOptions(decode_threads, decode_scale, drop_late)));
+}
+
+FFI_PLUGIN_EXPORT YoloMjpegIngest* yolo_mjpeg_open(const char* path, int decode_threads, int decode_scale,
+                                                   int drop_late) {
+    if (path == nullptr) {
+        return nullptr;
+    }
+    return reinterpret_cast<YoloMjpegIngest*>(
+        new MjpegIngest(std::string(path), mjpegOptions(decode_threads, decode_scale, drop_late)));
+}
+
+FFI_PLUGIN_EXPORT char* yolo_mjpeg_detect_next(
+    YoloMjpegIngest* ingest,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+) {
+    if (ingest == nullptr) {
+        return nullptr;
+    }
+    MjpegFrame frame;
+    if (!reinterpret_cast<MjpegIngest*>(ingest)->next(frame)) {
+        return nullptr;
+    }
+    if (g_detector == nullptr) {
+        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
+    }
+
+    FrameTiming timing = makeTiming(options);
+    if (timing.frame_id < 0) {
+        timing.frame_id = frame.index;
+    }
+    if (timing.capture_ts_ns == 0) {
+        timing.capture_ts_ns = frame.read_ts_ns;
+    }
+    char* result = routeDetect([&](YoloDetector& detector) {
+        return detector.detectJson(YoloDetector::viewSource(frame.image.view()), conf_threshold, iou_threshold,
+                                   timing, priorityOf(options), streamOf(options));
+    });
+    if (result == nullptr || result[0] != '{') {
+        return result;
+    }
+
+    std::ostringstream oss;
+    oss << "{\"frame_index\":" << frame.index << ",\"decode_scale\":" << frame.scale << "," << (result + 1);
+    free(result);
+    return strdup(oss.str().c_str());
+}
+
+FFI_PLUGIN_EXPORT char* yolo_mjpeg_get_stats(const YoloMjpegIngest* ingest) {
+    if (ingest == nullptr) {
+        return strdup("{\"error\":\"No ingest\",\"code\":\"INVALID_ARGUMENT\"}");
+    }
+    return strdup(reinterpret_cast<const MjpegIngest*>(ingest)->statsJson().c_str());
+}
+
+FFI_PLUGIN_EXPORT void yolo_mjpeg_close(YoloMjpegIngest* ingest) {
+    delete reinterpret_cast<MjpegIngest*>(ingest);
+}
+
+// Monotonic clock used for capture timestamps
+FFI_PLUGIN_EXPORT int64_t yolo_now_ns() {
+    return monotonicNowNs();
+}
+
+// Get latency metrics as JSON (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_get_metrics() {
+    if (g_detector == nullptr) {
+        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
+    }
+    if (g_replicas != nullptr) {
+        FrameMetrics total;
+        g_replicas->forEach([&](YoloDetector& d) { total.merge(d.metrics()); });
+        return strdup(total.toJson().c_str());
+    }
+    return strdup(g_detector->metricsJson().c_str());
+}
+
+// Reset latency metrics
+FFI_PLUGIN_EXPORT void yolo_reset_metrics() {
+    forEachDetector([](YoloDetector& d) { d.resetMetrics(); });
+}
+
+// Queue limits per class and background preemption
+FFI_PLUGIN_EXPORT void yolo_set_scheduler_limits(
+    int max_realtime,
+    int max_interactive,
+    int max_background,
+    int preempt_background
+) {
     if (g_detector == nullptr) {
         return;
     }
+    SchedulerConfig config = g_detector->schedulerConfig();
+    const int limits[kPriorityCount] = {max_realtime, max_interactive, max_background};
+    for (int c = 0; c < kPriorityCount; c++) {
+        if (limits[c] >= 0) {
+            config.max_queued[c] = limits[c];
+        }
+    }
+    if (preempt_background >= 0) {
+        config.preempt_background = preempt_background != 0;
+    }
+    forEachDetector([&](YoloDetector& d) { d.setSchedulerConfig(config); });
+}
+
+// Cancel queued background calls and abort a running one
+FFI_PLUGIN_EXPORT int yolo_cancel_background() {
+    int affected = 0;
+    forEachDetector([&](YoloDetector& d) { affected += d.cancelBackground(); });
+    return affected;
+}
+
+// Scheduler statistics as JSON (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_get_scheduler_stats() {
+    if (g_detector == nullptr) {
+        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
+    }
+    if (g_replicas != nullptr) {
+        return strdup(g_replicas->schedulerStatsJson().c_str());
+    }
+    return strdup(g_detector->schedulerStatsJson().c_str());
+}
+
+// Open or append to a binary detection log
+FFI_PLUGIN_EXPORT YoloLogWriter* yolo_log_writer_open(
+    const char* path,
+    const char* stream_name,
+    const char* class_names_json
+) {
+    if (path == nullptr) {
+        return nullptr;
+    }
 
-    // Parse simple JSON array: ["class1", "class2", ...]
     std::vector<std::string> names;
-    std::string json(class_names_json);
+    if (class_names_json != nullptr) {
+        names = parseStringArray(class_names_json);
+    } else if (g_detector != nullptr) {
+        names = g_detector->classNames();
+    }
 
-    size_t pos = 0;
-    while ((pos = json.find("\"", pos)) != std::string::npos) {
-        size_t start = pos + 1;
-        size_t end = json.find("\"", start);
-        if (end == std::string::npos) break;
+    auto* writer = new DetectionLogWriter();
+    if (!writer->open(path, stream_name != nullptr ? stream_name : "", names)) {
+        delete writer;
+        return nullptr;
+    }
+    return reinterpret_cast<YoloLogWriter*>(writer);
+}
 
-        std::string name = json.substr(start, end - start);
-        if (!name.empty()) {
-            names.push_back(name);
-        }
-        pos = end + 1;
+// Append one frame to a log
+FFI_PLUGIN_EXPORT int yolo_log_write_frame(
+    YoloLogWriter* writer,
+    int64_t timestamp_ns,
+    int width,
+    int height,
+    const YoloLogBox* boxes,
+    int count
+) {
+    if (writer == nullptr) {
+        return 0;
     }
+    auto* log = reinterpret_cast<DetectionLogWriter*>(writer);
+    return log->writeFrame(timestamp_ns, width, height,
+                           reinterpret_cast<const detection_log::Box*>(boxes), count) ? 1 : 0;
+}
+
+FFI_PLUGIN_EXPORT void yolo_log_writer_flush(YoloLogWriter* writer) {
+    if (writer != nullptr) {
+        reinterpret_cast<DetectionLogWriter*>(writer)->flush();
+    }
+}
+
+// Close a log, detaching it from the detector first
+FFI_PLUGIN_EXPORT void yolo_log_writer_close(YoloLogWriter* writer) {
+    if (writer == nullptr) {
+        return;
+    }
+    auto* log = reinterpret_cast<DetectionLogWriter*>(writer);
+    if (g_attached_log == log) {
+        forEachDetector([](YoloDetector& d) { d.setDetectionLog(nullptr); });
+        g_attached_log = nullptr;
+    }
+    delete log;
+}
+
+// Log every detect call into this writer (NULL detaches)
+FFI_PLUGIN_EXPORT int yolo_log_attach(YoloLogWriter* writer) {
+    if (g_detector == nullptr) {
+        return 0;
+    }
+    g_attached_log = reinterpret_cast<DetectionLogWriter*>(writer);
+    forEachDetector([](YoloDetector& d) { d.setDetectionLog(g_attached_log); });
+    return 1;
+}
+
+// Open a log for reading
+FFI_PLUGIN_EXPORT YoloLogReader* yolo_log_reader_open(const char* path) {
+    if (path == nullptr) {
+        return nullptr;
+    }
+    auto* reader = new DetectionLogReader();
+    if (!reader->open(path)) {
+        delete reader;
+        return nullptr;
+    }
+    return reinterpret_cast<YoloLogReader*>(reader);
+}
+
+FFI_PLUGIN_EXPORT int64_t yolo_log_reader_frame_count(const YoloLogReader* reader) {
+    if (reader == nullptr) {
+        return 0;
+    }
+    return reinterpret_cast<const DetectionLogReader*>(reader)->frameCount();
+}
+
+// Decode one frame of a log
+FFI_PLUGIN_EXPORT int yolo_log_reader_read_frame(
+    const YoloLogReader* reader,
+    int64_t index,
+    int64_t* timestamp_ns,
+    int* width,
+    int* height,
+    YoloLogBox* boxes,
+    int max_boxes
+) {
+    if (reader == nullptr) {
+        return -1;
+    }
+    int64_t ts = 0;
+    int w = 0;
+    int h = 0;
+    int count = reinterpret_cast<const DetectionLogReader*>(reader)->readFrame(
+        index, ts, w, h, reinterpret_cast<detection_log::Box*>(boxes), max_boxes);
+    if (timestamp_ns != nullptr) *timestamp_ns = ts;
+    if (width != nullptr) *width = w;
+    if (height != nullptr) *height = h;
+    return count;
+}
+
+// Stream name and class table as JSON (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_log_reader_info(const YoloLogReader* reader) {
+    if (reader == nullptr) {
+        return strdup("{\"error\":\"Log not open\",\"code\":\"INVALID_LOG\"}");
+    }
+    auto* log = reinterpret_cast<const DetectionLogReader*>(reader);
+
+    std::ostringstream oss;
+    oss << "{\"stream\":";
+    writeJsonString(oss, log->streamName());
+    oss << ",\"frame_count\":" << log->frameCount() << ",\"classes\":[";
+    const auto& names = log->classNames();
+    for (size_t i = 0; i < names.size(); i++) {
+        if (i > 0) oss << ",";
+        writeJsonString(oss, names[i]);
+    }
+    oss << "]}";
+    return strdup(oss.str().c_str());
+}
+
+FFI_PLUGIN_EXPORT void yolo_log_reader_close(YoloLogReader* reader) {
+    delete reinterpret_cast<DetectionLogReader*>(reader);
+}
+
+// Convert a log to JSON lines
+FFI_PLUGIN_EXPORT int64_t yolo_log_to_jsonl(const char* log_path, const char* jsonl_path) {
+    if (log_path == nullptr || jsonl_path == nullptr) {
+        return -1;
+    }
+    DetectionLogReader reader;
+    if (!reader.open(log_path)) {
+        return -1;
+    }
+    return reader.toJsonl(jsonl_path);
+}
+
+FFI_PLUGIN_EXPORT YoloStream* yolo_stream_create(const char* name) {
+    return reinterpret_cast<YoloStream*>(new StreamContext(name != nullptr ? name : ""));
+}
+
+FFI_PLUGIN_EXPORT char* yolo_stream_get_metrics(const YoloStream* stream) {
+    if (stream == nullptr) {
+        return strdup("{\"error\":\"No stream\",\"code\":\"INVALID_ARGUMENT\"}");
+    }
+    return strdup(reinterpret_cast<const StreamContext*>(stream)->statsJson().c_str());
+}
+
+FFI_PLUGIN_EXPORT void yolo_stream_reset_metrics(YoloStream* stream) {
+    if (stream != nullptr) {
+        reinterpret_cast<StreamContext*>(stream)->metrics().reset();
+    }
+}
+
+FFI_PLUGIN_EXPORT void yolo_stream_log_attach(YoloStream* stream, YoloLogWriter* writer) {
+    if (stream != nullptr) {
+        reinterpret_cast<StreamContext*>(stream)->setDetectionLog(reinterpret_cast<DetectionLogWriter*>(writer));
+    }
+}
+
+FFI_PLUGIN_EXPORT void yolo_stream_destroy(YoloStream* stream) {
+    delete reinterpret_cast<StreamContext*>(stream);
+}
+
+FFI_PLUGIN_EXPORT YoloDeltaEncoder* yolo_delta_encoder_create(int keyframe_interval, float match_iou) {
+    return reinterpret_cast<YoloDeltaEncoder*>(new DeltaEncoder(keyframe_interval, match_iou));
+}
+
+// Encode one frame into a delta stream packet
+FFI_PLUGIN_EXPORT int yolo_delta_encode(
+    YoloDeltaEncoder* encoder,
+    int64_t timestamp_ns,
+    int width,
+    int height,
+    const YoloLogBox* boxes,
+    int count,
+    uint8_t* out,
+    int out_capacity
+) {
+    if (encoder == nullptr || out == nullptr || count < 0 || (count > 0 && boxes == nullptr)) {
+        return 0;
+    }
+    auto* stream = reinterpret_cast<DeltaEncoder*>(encoder);
+
+    // Check the bound first so a rejected frame leaves the stream state alone
+    size_t bound = stream->maxPacketSize(count);
+    if (out_capacity < 0 || bound > static_cast<size_t>(out_capacity)) {
+        return -static_cast<int>(bound);
+    }
+
+    thread_local std::vector<uint8_t> packet;
+    stream->encode(timestamp_ns, width, height,
+                   reinterpret_cast<const detection_log::Box*>(boxes), count, packet);
+    memcpy(out, packet.data(), packet.size());
+    return static_cast<int>(packet.size());
+}
+
+FFI_PLUGIN_EXPORT void yolo_delta_request_keyframe(YoloDeltaEncoder* encoder) {
+    if (encoder != nullptr) {
+        reinterpret_cast<DeltaEncoder*>(encoder)->requestKeyframe();
+    }
+}
+
+// Delta stream statistics (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_delta_encoder_stats(const YoloDeltaEncoder* encoder) {
+    if (encoder == nullptr) {
+        return strdup("{\"error\":\"Encoder not created\",\"code\":\"INVALID_ARGUMENT\"}");
+    }
+    return strdup(reinterpret_cast<const DeltaEncoder*>(encoder)->statsJson().c_str());
+}
+
+FFI_PLUGIN_EXPORT void yolo_delta_encoder_destroy(YoloDeltaEncoder* encoder) {
+    delete reinterpret_cast<DeltaEncoder*>(encoder);
+}
+
+FFI_PLUGIN_EXPORT YoloDeltaDecoder* yolo_delta_decoder_create(void) {
+    return reinterpret_cast<YoloDeltaDecoder*>(new DeltaDecoder());
+}
+
+// Apply one delta stream packet
+FFI_PLUGIN_EXPORT int yolo_delta_decode(
+    YoloDeltaDecoder* decoder,
+    const uint8_t* packet,
+    int size,
+    int64_t* timestamp_ns,
+    int* width,
+    int* height,
+    YoloLogBox* boxes,
+    int max_boxes
+) {
+    if (decoder == nullptr || size < 0) {
+        return YOLO_DELTA_MALFORMED;
+    }
+    auto* stream = reinterpret_cast<DeltaDecoder*>(decoder);
+    int count = stream->decode(packet, static_cast<size_t>(size));
+    if (count < 0) {
+        return count;
+    }
+    if (timestamp_ns != nullptr) *timestamp_ns = stream->timestampNs();
+    if (width != nullptr) *width = stream->width();
+    if (height != nullptr) *height = stream->height();
+    return yolo_delta_decoder_boxes(decoder, boxes, max_boxes);
+}
+
+FFI_PLUGIN_EXPORT int yolo_delta_decoder_boxes(const YoloDeltaDecoder* decoder, YoloLogBox* boxes, int max_boxes) {
+    if (decoder == nullptr) {
+        return 0;
+    }
+    const auto& decoded = reinterpret_cast<const DeltaDecoder*>(decoder)->boxes();
+    int count = static_cast<int>(decoded.size());
+    if (boxes != nullptr && max_boxes > 0) {
+        memcpy(boxes, decoded.data(), static_cast<size_t>(std::min(count, max_boxes)) * sizeof(YoloLogBox));
+    }
+    return count;
+}
+
+FFI_PLUGIN_EXPORT void yolo_delta_decoder_destroy(YoloDeltaDecoder* decoder) {
+    delete reinterpret_cast<DeltaDecoder*>(decoder);
+}
+
+// Set custom class names (JSON array string)
+FFI_PLUGIN_EXPORT void yolo_set_classes(const char* class_names_json) {
+    if (g_detector == nullptr) {
+        return;
+    }
+
+    std::vector<std::string> names = parseStringArray(class_names_json);
 
     if (!names.empty()) {
-        g_detector->setClassNames(names);
+        forEachDetector([&](YoloDetector& d) { d.setClassNames(names); });
     }
 }
 
-// Release detector resources
-FFI_PLUGIN_EXPORT void yolo_release() {
+// Current class names as a JSON array
+FFI_PLUGIN_EXPORT char* yolo_get_classes() {
+    std::ostringstream oss;
+    oss << "[";
     if (g_detector != nullptr) {
-        delete g_detector;
-        g_detector = nullptr;
+        const std::vector<std::string>& names = g_detector->classNames();
+        for (size_t i = 0; i < names.size(); i++) {
+            if (i > 0) oss << ",";
+            writeJsonString(oss, names[i]);
+        }
     }
+    oss << "]";
+    return strdup(oss.str().c_str());
+}
+
+// Release detector resources
+FFI_PLUGIN_EXPORT void yolo_release() {
+    releaseDetectors();
 }
 
 // Free allocated string
@@ -0,0 +1,456 @@
+#include "file_prefetcher.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#if !defined(YOLO_HAVE_IO_URING) && defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define YOLO_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#ifndef YOLO_HAVE_IO_URING
+#define YOLO_HAVE_IO_URING 0
+#endif
+
+namespace {
+
+constexpr size_t kNone = static_cast<size_t>(-1);
+
+// Open a file for reading and fill in its size. Returns the fd, or -1 with
+// file.error set.
+int openForRead(PrefetchedFile& file) {
+    int fd = open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        file.error = errno;
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        file.error = errno != 0 ? errno : EINVAL;
+        close(fd);
+        return -1;
+    }
+    file.size = static_cast<size_t>(st.st_size);
+    return fd;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// io_uring ring (raw syscalls, no liburing dependency)
+
+#if YOLO_HAVE_IO_URING
+
+struct FilePrefetcher::Ring {
+    int fd = -1;
+    void* sq_ptr = MAP_FAILED;
+    size_t sq_len = 0;
+    void* cq_ptr = MAP_FAILED;
+    size_t cq_len = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqes_len = 0;
+
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned to_submit = 0;
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_len);
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) munmap(cq_ptr, cq_len);
+        if (sq_ptr != MAP_FAILED) munmap(sq_ptr, sq_len);
+        if (fd >= 0) close(fd);
+    }
+
+    bool init(unsigned entries) {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) return false;
+
+        sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_len = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = false;
+#ifdef IORING_FEAT_SINGLE_MMAP
+        single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+#endif
+        if (single_mmap) {
+            sq_len = cq_len = std::max(sq_len, cq_len);
+        }
+
+        sq_ptr = mmap(nullptr, sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) return false;
+        cq_ptr = single_mmap ? sq_ptr
+                             : mmap(nullptr, cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                    IORING_OFF_CQ_RING);
+        if (cq_ptr == MAP_FAILED) return false;
+        sqes_len = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(
+            mmap(nullptr, sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) return false;
+
+        char* sq = static_cast<char*>(sq_ptr);
+        char* cq = static_cast<char*>(cq_ptr);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // Queue a readv and hand it to the kernel right away
+    void read(int file_fd, iovec* iov, uint64_t offset, uint64_t user_data) {
+        unsigned tail = *sq_tail;
+        unsigned index = tail & *sq_mask;
+        io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = file_fd;
+        sqe->addr = reinterpret_cast<uint64_t>(iov);
+        sqe->len = 1;
+        sqe->off = offset;
+        sqe->user_data = user_data;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        to_submit++;
+        enter(0);
+    }
+
+    // Submit queued entries and optionally wait for completions
+    void enter(unsigned min_complete) {
+        unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        while (true) {
+            long ret = syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+            if (ret >= 0) {
+                to_submit -= std::min(to_submit, static_cast<unsigned>(ret));
+                return;
+            }
+            if (errno != EINTR) return;
+        }
+    }
+
+    // Call fn(user_data, res) for every completion
+    template <typename Fn>
+    void reap(Fn&& fn) {
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes[head & *cq_mask];
+            uint64_t user_data = cqe.user_data;
+            int res = cqe.res;
+            head++;
+            __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+            fn(user_data, res);
+            tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        }
+    }
+};
+
+#else
+
+struct FilePrefetcher::Ring {};
+
+#endif
+
+// ---------------------------------------------------------------------------
+// FilePrefetcher
+
+FilePrefetcher::FilePrefetcher(std::vector<std::string> paths, const PrefetchConfig& config)
+    : m_paths(std::move(paths)), m_config(config) {
+    m_config.depth = std::max(1, std::min(m_config.depth, 256));
+    m_slots.resize(m_config.depth);
+    if (m_paths.empty()) return;
+
+#if YOLO_HAVE_IO_URING
+    auto ring = std::make_unique<Ring>();
+    if (ring->init(static_cast<unsigned>(m_config.depth))) {
+        m_uring = std::move(ring);
+        m_threads.emplace_back(&FilePrefetcher::uringLoop, this);
+        return;
+    }
+#endif
+
+    int readers = std::max(1, std::min(m_config.fallback_threads, static_cast<int>(m_paths.size())));
+    for (int i = 0; i < readers; i++) {
+        m_threads.emplace_back(&FilePrefetcher::preadLoop, this);
+    }
+}
+
+FilePrefetcher::~FilePrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+bool FilePrefetcher::next(PrefetchedFile& file) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_next_deliver >= m_paths.size()) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    m_cv.wait(lock, [&]() { return m_ready.count(m_next_deliver) > 0; });
+    double waited = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    auto it = m_ready.find(m_next_deliver);
+    file = std::move(it->second);
+    m_ready.erase(it);
+    m_next_deliver++;
+
+    file.io_wait_ms = waited;
+    m_io_wait_ms += waited;
+    return true;
+}
+
+void FilePrefetcher::release(PrefetchedFile& file) {
+    if (file.slot >= 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_slots[file.slot].used = false;
+            m_buffered_bytes -= file.size;
+        }
+        m_cv.notify_all();
+    }
+    file.slot = -1;
+    file.data = nullptr;
+}
+
+double FilePrefetcher::totalIoWaitMs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_io_wait_ms;
+}
+
+uint64_t FilePrefetcher::bytesRead() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes_read;
+}
+
+// Failed and empty files need no buffer. Otherwise a free slot and room in
+// the byte budget (or nothing buffered at all, for oversized files).
+bool FilePrefetcher::canClaimLocked(size_t size) const {
+    if (size == 0) return true;
+    bool free_slot = std::any_of(m_slots.begin(), m_slots.end(), [](const Slot& s) { return !s.used; });
+    return free_slot && (m_buffered_bytes == 0 || m_buffered_bytes + size <= m_config.max_buffered_bytes);
+}
+
+int FilePrefetcher::claimLocked(size_t size) {
+    m_next_claim++;
+    if (size == 0) return -1;
+
+    for (size_t i = 0; i < m_slots.size(); i++) {
+        Slot& slot = m_slots[i];
+        if (slot.used) continue;
+        if (slot.capacity < size) {
+            slot.buffer.reset(new uint8_t[size]);
+            slot.capacity = size;
+        }
+        slot.used = true;
+        m_buffered_bytes += size;
+        return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void FilePrefetcher::publish(PrefetchedFile file) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (file.ok()) m_bytes_read += file.size;
+        m_ready[file.index] = std::move(file);
+    }
+    m_cv.notify_all();
+}
+
+// Blocking fallback: each reader takes the next path, opens it, waits its
+// turn for a buffer and preads the whole file
+void FilePrefetcher::preadLoop() {
+    while (true) {
+        PrefetchedFile file;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stop || m_next_open >= m_paths.size()) return;
+            file.index = m_next_open++;
+        }
+        file.path = m_paths[file.index];
+        int fd = openForRead(file);
+        size_t needed = fd >= 0 ? file.size : 0;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [&]() {
+                return m_stop || (m_next_claim == file.index && canClaimLocked(needed));
+            });
+            if (m_stop) {
+                if (fd >= 0) close(fd);
+                return;
+            }
+            file.slot = claimLocked(needed);
+        }
+        m_cv.notify_all();
+
+        if (file.slot >= 0) {
+            file.data = m_slots[file.slot].buffer.get();
+            size_t done = 0;
+            while (done < file.size) {
+                ssize_t n = pread(fd, const_cast<uint8_t*>(file.data) + done, file.size - done,
+                                  static_cast<off_t>(done));
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) {
+                    file.error = errno;
+                    break;
+                }
+                if (n == 0) break;  // file shrank since fstat
+                done += static_cast<size_t>(n);
+            }
+            if (file.ok()) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_buffered_bytes -= file.size - done;
+                file.size = done;
+            }
+        }
+        if (fd >= 0) close(fd);
+        publish(std::move(file));
+    }
+}
+
+#if YOLO_HAVE_IO_URING
+
+// One thread opens files in order, claims buffers and keeps up to `depth`
+// reads in flight on the ring
+void FilePrefetcher::uringLoop() {
+    struct Read {
+        PrefetchedFile file;
+        int fd = -1;
+        size_t done = 0;
+        iovec iov;
+    };
+    std::vector<Read> reads(m_slots.size());
+    Ring& ring = *m_uring;
+    int in_flight = 0;
+
+    bool have_pending = false;
+    PrefetchedFile pending;
+    int pending_fd = -1;
+
+    auto submit = [&](Read& read) {
+        read.iov.iov_base = const_cast<uint8_t*>(read.file.data) + read.done;
+        read.iov.iov_len = read.file.size - read.done;
+        ring.read(read.fd, &read.iov, read.done, static_cast<uint64_t>(read.file.slot));
+    };
+
+    auto finish = [&](Read& read) {
+        close(read.fd);
+        read.fd = -1;
+        in_flight--;
+        if (read.file.ok() && read.done < read.file.size) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buffered_bytes -= read.file.size - read.done;
+            read.file.size = read.done;
+        }
+        publish(std::move(read.file));
+    };
+
+    auto complete = [&](uint64_t user_data, int res) {
+        Read& read = reads[static_cast<size_t>(user_data)];
+        if (res == -EINTR || res == -EAGAIN) {
+            submit(read);
+        } else if (res < 0) {
+            read.file.error = -res;
+            finish(read);
+        } else if (res == 0) {
+            finish(read);  // file shrank since fstat
+        } else {
+            read.done += static_cast<size_t>(res);
+            if (read.done < read.file.size) {
+                submit(read);
+            } else {
+                finish(read);
+            }
+        }
+    };
+
+    while (true) {
+        if (!have_pending) {
+            size_t index = kNone;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_stop && m_next_open < m_paths.size()) index = m_next_open++;
+            }
+            if (index != kNone) {
+                pending = PrefetchedFile();
+                pending.index = index;
+                pending.path = m_paths[index];
+                pending_fd = openForRead(pending);
+                have_pending = true;
+            }
+        }
+
+        if (have_pending) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            size_t needed = pending_fd >= 0 ? pending.size : 0;
+            if (!m_stop && canClaimLocked(needed)) {
+                pending.slot = claimLocked(needed);
+                lock.unlock();
+                have_pending = false;
+                if (pending.slot < 0) {
+                    if (pending_fd >= 0) close(pending_fd);
+                    publish(std::move(pending));
+                } else {
+                    Read& read = reads[pending.slot];
+                    read.file = std::move(pending);
+                    read.file.data = m_slots[read.file.slot].buffer.get();
+                    read.fd = pending_fd;
+                    read.done = 0;
+                    in_flight++;
+                    submit(read);
+                }
+                continue;
+            }
+            if (in_flight == 0) {
+                // Buffers are all with the consumer: wait for a release
+                m_cv.wait(lock, [&]() { return m_stop || canClaimLocked(needed); });
+                if (m_stop) break;
+                continue;
+            }
+        } else if (in_flight == 0) {
+            break;
+        }
+
+        ring.enter(1);
+        ring.reap(complete);
+    }
+
+    if (have_pending && pending_fd >= 0) close(pending_fd);
+    while (in_flight > 0) {
+        ring.enter(1);
+        ring.reap(complete);
+    }
+}
+
+#else
+
+void FilePrefetcher::uringLoop() {}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef FILE_PREFETCHER_HPP
+#define FILE_PREFETCHER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One file's contents, delivered in path order by FilePrefetcher::next()
+struct PrefetchedFile {
+    size_t index = 0;
+    std::string path;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    int error = 0;              // errno of a failed open/read, 0 on success
+    double io_wait_ms = 0.0;    // time next() blocked waiting for this file
+    int slot = -1;              // buffer pool slot, returned by release()
+
+    bool ok() const { return error == 0; }
+};
+
+struct PrefetchConfig {
+    int depth = 8;                              // files read ahead (buffer pool slots)
+    size_t max_buffered_bytes = 64u << 20;      // total buffer memory
+    int fallback_threads = 4;                   // pread readers without io_uring
+};
+
+// Reads a list of files ahead of the consumer into a bounded pool of reusable
+// buffers, so decode threads never block on storage (network mounts, spinning
+// disks).
+//
+// On Linux, reads are issued through io_uring from one I/O thread. Where
+// io_uring is unavailable (older kernels, seccomp sandboxes such as Android
+// apps, other platforms) a few reader threads use blocking pread instead.
+// Files are delivered strictly in order; a file larger than the byte budget
+// is read once nothing else is buffered.
+class FilePrefetcher {
+public:
+    explicit FilePrefetcher(std::vector<std::string> paths, const PrefetchConfig& config = PrefetchConfig());
+    ~FilePrefetcher();
+
+    FilePrefetcher(const FilePrefetcher&) = delete;
+    FilePrefetcher& operator=(const FilePrefetcher&) = delete;
+
+    // Next file in path order. Blocks until it has been read; returns false
+    // once every file has been delivered.
+    bool next(PrefetchedFile& file);
+
+    // Return the file's buffer to the pool (data is invalid afterwards)
+    void release(PrefetchedFile& file);
+
+    // "io_uring" or "pread"
+    const char* backend() const { return m_uring ? "io_uring" : "pread"; }
+
+    // Total time next() spent waiting for reads
+    double totalIoWaitMs() const;
+    uint64_t bytesRead() const;
+
+private:
+    struct Slot {
+        std::unique_ptr<uint8_t[]> buffer;
+        size_t capacity = 0;
+        bool used = false;
+    };
+
+    struct Ring;
+
+    std::vector<std::string> m_paths;
+    PrefetchConfig m_config;
+    std::vector<Slot> m_slots;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<size_t, PrefetchedFile> m_ready;
+    size_t m_next_open = 0;         // next path a reader picks up
+    size_t m_next_claim = 0;        // buffers are claimed in path order
+    size_t m_next_deliver = 0;
+    size_t m_buffered_bytes = 0;
+    uint64_t m_bytes_read = 0;
+    double m_io_wait_ms = 0.0;
+    bool m_stop = false;
+
+    std::unique_ptr<Ring> m_uring;
+    std::vector<std::thread> m_threads;
+
+    bool canClaimLocked(size_t size) const;
+    int claimLocked(size_t size);
+    void publish(PrefetchedFile file);
+
+    void uringLoop();
+    void preadLoop();
+};
+
+#endif // FILE_PREFETCHER_HPP
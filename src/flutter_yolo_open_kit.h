@@ -17,6 +17,23 @@ extern "C" {
 // Returns 1 on success, 0 on failure
 FFI_PLUGIN_EXPORT int yolo_init(const char* model_path);
 
+// Server mode for multi-socket machines: one detector per NUMA node, each
+// loaded with node-local memory and pinned to that node's cores. Detect calls
+// go to the least-loaded replica. Falls back to a single detector when the
+// machine has one node. Returns the number of replicas, 0 on failure.
+FFI_PLUGIN_EXPORT int yolo_init_numa(const char* model_path);
+
+// Replica nodes, CPUs, load and scheduler stats as JSON (caller must free
+// with free_string)
+FFI_PLUGIN_EXPORT char* yolo_get_numa_info(void);
+
+// Threads the library may use: ONNX Runtime intra-op threads (from the next
+// yolo_init) and the internal task pool used by preprocessing (as soon as
+// running preprocessing passes finish; detect calls may overlap it).
+// 0 restores the default, min(4, hardware threads).
+FFI_PLUGIN_EXPORT void yolo_set_thread_budget(int threads);
+FFI_PLUGIN_EXPORT int yolo_get_thread_budget(void);
+
 // Run detection on image file path
 // Returns JSON string with detection results (caller must free with free_string)
 FFI_PLUGIN_EXPORT char* yolo_detect_path(
@@ -36,9 +53,619 @@ FFI_PLUGIN_EXPORT char* yolo_detect_buffer(
     float iou_threshold
 );
 
+// Run detection on YUV420 buffer (Android camera format)
+// rotation: 0, 90, 180, 270 degrees clockwise
+// Returns JSON string with detection results (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_detect_yuv(
+    const uint8_t* y_data,
+    const uint8_t* u_data,
+    const uint8_t* v_data,
+    int width,
+    int height,
+    int y_row_stride,
+    int uv_row_stride,
+    int uv_pixel_stride,
+    int rotation,
+    float conf_threshold,
+    float iou_threshold
+);
+
+// Scheduling class of a detect call. Higher classes run first; queued
+// realtime frames are superseded by newer ones (FRAME_SHED), full queues
+// reject new calls (QUEUE_FULL), and a running background call is aborted
+// when realtime or interactive work arrives (CANCELLED).
+typedef enum YoloPriority {
+    YOLO_PRIORITY_INTERACTIVE = 0,  // default: user-triggered calls
+    YOLO_PRIORITY_REALTIME = 1,     // camera frames
+    YOLO_PRIORITY_BACKGROUND = 2    // batch / gallery scans
+} YoloPriority;
+
+// Per-camera context (see yolo_stream_create)
+typedef struct YoloStream YoloStream;
+
+// Optional per-call metadata for the *_ex detect entry points
+typedef struct YoloDetectOptions {
+    // Capture time on the yolo_now_ns() clock (0 = unknown)
+    int64_t capture_ts_ns;
+    // Caller frame id echoed back in the result (-1 = none)
+    int64_t frame_id;
+    // YoloPriority value
+    int32_t priority;
+    // Camera the frame belongs to (NULL = the detector's own state)
+    YoloStream* stream;
+} YoloDetectOptions;
+
+// Monotonic clock used for capture timestamps, in nanoseconds
+FFI_PLUGIN_EXPORT int64_t yolo_now_ns(void);
+
+// Same as yolo_detect_path / yolo_detect_buffer / yolo_detect_yuv, plus
+// options (may be NULL). The result additionally reports frame_id,
+// queue_wait_ms, processing_ms and frame_age_ms (capture to result).
+FFI_PLUGIN_EXPORT char* yolo_detect_path_ex(
+    const char* image_path,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+);
+
+FFI_PLUGIN_EXPORT char* yolo_detect_buffer_ex(
+    const uint8_t* image_data,
+    int width,
+    int height,
+    int stride,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+);
+
+FFI_PLUGIN_EXPORT char* yolo_detect_yuv_ex(
+    const uint8_t* y_data,
+    const uint8_t* u_data,
+    const uint8_t* v_data,
+    int width,
+    int height,
+    int y_row_stride,
+    int uv_row_stride,
+    int uv_pixel_stride,
+    int rotation,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+);
+
+// Pixel layouts accepted by yolo_detect_frame. Every layout is sampled in
+// place straight into the model input (no intermediate RGB frame).
+typedef enum YoloPixelFormat {
+    YOLO_PIXEL_NV12 = 0,    // planes[0] Y, planes[1] interleaved UV
+    YOLO_PIXEL_NV21 = 1,    // planes[0] Y, planes[1] interleaved VU
+    YOLO_PIXEL_I420 = 2,    // planes[0] Y, planes[1] U, planes[2] V
+    YOLO_PIXEL_RGB = 3,     // planes[0] packed, 3 bytes per pixel
+    YOLO_PIXEL_BGR = 4,     // planes[0] packed, 3 bytes per pixel
+    YOLO_PIXEL_RGBA = 5,    // planes[0] packed, 4 bytes per pixel (alpha ignored)
+    YOLO_PIXEL_BGRA = 6,    // planes[0] packed, 4 bytes per pixel (alpha ignored)
+    YOLO_PIXEL_GRAY = 7,    // planes[0] 1 byte per pixel
+    YOLO_PIXEL_YUYV = 8     // planes[0] packed 4:2:2, Y0 U Y1 V per pixel pair
+} YoloPixelFormat;
+
+// A frame in one of the YoloPixelFormat layouts. strides[i] is the row
+// stride of planes[i] in bytes (0 = tightly packed); chroma planes are
+// subsampled 2x2. Unused planes are ignored.
+typedef struct YoloFrameDesc {
+    int32_t format;             // YoloPixelFormat value
+    int32_t width;
+    int32_t height;
+    int32_t rotation;           // 0, 90, 180, 270 degrees clockwise
+    const uint8_t* planes[3];
+    int32_t strides[3];
+} YoloFrameDesc;
+
+// Run detection on a frame described by desc. options may be NULL.
+// Returns JSON string with detection results (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_detect_frame(
+    const YoloFrameDesc* desc,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+);
+
+// Input of the presence / count calls: the same sources as yolo_detect_path,
+// yolo_detect_buffer and yolo_detect_yuv, plus encoded bytes in memory.
+// Unused fields are ignored.
+typedef enum YoloInputKind {
+    YOLO_INPUT_PATH = 0,        // path
+    YOLO_INPUT_ENCODED = 1,     // data + size: JPEG/PNG/BMP bytes
+    YOLO_INPUT_BGRA = 2,        // data, width, height, stride
+    YOLO_INPUT_YUV420 = 3,      // data (Y), u_data, v_data, width, height, strides, rotation
+    YOLO_INPUT_FRAME = 4        // frame
+} YoloInputKind;
+
+typedef struct YoloInput {
+    int32_t kind;               // YoloInputKind value
+    const char* path;
+    const uint8_t* data;
+    int64_t size;
+    const uint8_t* u_data;
+    const uint8_t* v_data;
+    int32_t width;
+    int32_t height;
+    int32_t stride;             // BGRA row stride or Y row stride
+    int32_t uv_row_stride;
+    int32_t uv_pixel_stride;
+    int32_t rotation;           // 0, 90, 180, 270 degrees clockwise
+    const YoloFrameDesc* frame;
+} YoloInput;
+
+// Failure codes of the presence / count calls (always negative)
+typedef enum YoloStatus {
+    YOLO_ERR_NOT_INITIALIZED = -1,
+    YOLO_ERR_INVALID_ARGUMENT = -2,
+    YOLO_ERR_IMAGE_LOAD_FAILED = -3,
+    YOLO_ERR_DECODER_UNAVAILABLE = -4,
+    YOLO_ERR_QUEUE_FULL = -5,
+    YOLO_ERR_FRAME_SHED = -6,
+    YOLO_ERR_CANCELLED = -7,
+    YOLO_ERR_PREEMPTED = -8
+} YoloStatus;
+
+// Whether the image contains a detection of one of class_ids (NULL or
+// class_count 0 = any class) scoring at least conf_threshold. Decoding stops
+// at the first hit; no NMS and no JSON. options may be NULL.
+// Returns 1 if present, 0 if not, or a negative YoloStatus.
+FFI_PLUGIN_EXPORT int yolo_detect_presence(
+    const YoloInput* input,
+    const int32_t* class_ids,
+    int class_count,
+    float conf_threshold,
+    const YoloDetectOptions* options
+);
+
+// Per-class detection counts after NMS, without building detection JSON.
+// counts[class_id] receives each class's count for the first counts_len
+// classes (counts may be NULL for the total only); class_ids filters as in
+// yolo_detect_presence. options may be NULL.
+// Returns the total count, or a negative YoloStatus.
+FFI_PLUGIN_EXPORT int yolo_detect_count(
+    const YoloInput* input,
+    const int32_t* class_ids,
+    int class_count,
+    float conf_threshold,
+    float iou_threshold,
+    int32_t* counts,
+    int counts_len,
+    const YoloDetectOptions* options
+);
+
+// Per-detection appearance embeddings for re-identification, pooled in the
+// same pass from a neck feature map the model exposes as an extra
+// [1, C, H, W] output named output_name. pooled_size is the RoIAlign bins per
+// side: 1 = average pooling (C floats), 2 = 4 * C floats. Embeddings are
+// L2-normalized. Applies from the next yolo_init / yolo_init_numa; NULL or ""
+// disables.
+FFI_PLUGIN_EXPORT void yolo_set_embedding_output(const char* output_name, int pooled_size);
+
+// Floats per embedding (0 if the loaded model has no embedding output)
+FFI_PLUGIN_EXPORT int yolo_get_embedding_dim(void);
+
+// Fold the RGB channel order and /255 scaling of YOLOv8 / PP-YOLOE models
+// into the first convolution's weights at load, so frames are fed as raw BGR
+// 0-255 and preprocessing skips the per-pixel multiply. Results are the same
+// up to float rounding. Applies from the next yolo_init / yolo_init_numa;
+// models whose input does not feed a single plain Conv load unchanged.
+FFI_PLUGIN_EXPORT void yolo_set_fold_input(int enabled);
+
+// 1 if the loaded model was rewritten by yolo_set_fold_input
+FFI_PLUGIN_EXPORT int yolo_is_input_folded(void);
+
+// Engine that runs the model
+typedef enum YoloBackend {
+    YOLO_BACKEND_ONNXRUNTIME = 0,   // default; NNAPI / Core ML on mobile
+    YOLO_BACKEND_OPENCV_DNN = 1     // OpenCV DNN on the CPU, same .onnx file
+} YoloBackend;
+
+// Inference backend (YoloBackend) for the next yolo_init / yolo_init_numa.
+// OpenCV DNN sizes OpenCV's process-wide thread pool (cv::setNumThreads) and
+// cannot preempt a running background call.
+// Returns 1, or 0 if that backend was not compiled in (setting unchanged).
+FFI_PLUGIN_EXPORT int yolo_set_backend(int backend);
+
+// Name of the loaded model's backend ("onnxruntime", "opencv-dnn"), "" before
+// init. Static string, do not free.
+FFI_PLUGIN_EXPORT const char* yolo_get_backend_name(void);
+
+// One detection of a binary result (pixel coordinates)
+typedef struct YoloBox {
+    int32_t class_id;
+    float confidence;
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+} YoloBox;
+
+// Binary detection result: up to max_boxes boxes by descending confidence
+// and, if embeddings is not NULL, yolo_get_embedding_dim() floats per written
+// box (as many as fit in embedding_capacity floats). image_width /
+// image_height (may be NULL) receive the frame size boxes refer to.
+// options may be NULL. Returns the number of detections (may exceed
+// max_boxes), or a negative YoloStatus.
+FFI_PLUGIN_EXPORT int yolo_detect_boxes(
+    const YoloInput* input,
+    float conf_threshold,
+    float iou_threshold,
+    YoloBox* boxes,
+    int max_boxes,
+    float* embeddings,
+    int embedding_capacity,
+    int32_t* image_width,
+    int32_t* image_height,
+    const YoloDetectOptions* options
+);
+
+// Latest-result polling for a UI that repaints faster than detection runs.
+// Every finished detection / box result (yolo_detect_*, except presence and
+// count) is published into a triple-buffered slot: the detector-wide one, or
+// the stream's own for calls made with YoloDetectOptions.stream (stream NULL
+// selects the detector-wide slot, which survives yolo_init / yolo_release).
+// Both calls are lock-free leaf calls that never wait for a running detection.
+
+// Summary of the frame returned by yolo_latest_poll
+typedef struct YoloLatestInfo {
+    int64_t sequence;           // increases with every published frame
+    int64_t frame_id;           // YoloDetectOptions.frame_id, or -1
+    int64_t capture_ts_ns;      // 0 if the caller gave none
+    int64_t end_ts_ns;          // result ready (yolo_now_ns clock)
+    int32_t width;              // frame size the boxes refer to
+    int32_t height;
+    int32_t count;              // detections in the frame (may exceed max_boxes)
+} YoloLatestInfo;
+
+// Sequence of the newest published frame (0 = none yet)
+FFI_PLUGIN_EXPORT int64_t yolo_latest_sequence(YoloStream* stream);
+
+// Copy the newest frame into info and up to max_boxes boxes if its sequence
+// differs from last_sequence. Returns 1 if a frame was copied, 0 if there is
+// nothing newer (or another thread is polling the same slot), or a negative
+// YoloStatus.
+FFI_PLUGIN_EXPORT int yolo_latest_poll(
+    YoloStream* stream,
+    int64_t last_sequence,
+    YoloLatestInfo* info,
+    YoloBox* boxes,
+    int max_boxes
+);
+
+// Raw tensor I/O for pipelines with their own preprocessing or decoding
+#define YOLO_TENSOR_MAX_DIMS 8
+
+// Opaque outputs of yolo_run_tensor
+typedef struct YoloTensorResult YoloTensorResult;
+
+// One model output, read in place
+typedef struct YoloTensorView {
+    const char* name;
+    const float* data;          // NULL if the output is not float32
+    int64_t element_count;
+    int32_t rank;
+    int64_t shape[YOLO_TENSOR_MAX_DIMS];
+} YoloTensorView;
+
+// Run the model on a prepared input tensor (float32, shape [N, 3, H, W],
+// rank 4) with no preprocessing or decoding. The tensor is laid out as the
+// model expects: YOLOv8 / PP-YOLOE RGB in [0, 1] (raw BGR 0-255 when
+// yolo_is_input_folded), YOLOX BGR 0-255; input is not copied and only needs
+// to stay valid for the call. PP-YOLOE's scale_factor input is fed as 1.
+// outputs receives views of the first max_outputs outputs (detection outputs,
+// then the embedding output if set) pointing into *result, which stays valid
+// until yolo_tensor_release, even across yolo_release. options may be NULL.
+// Returns the number of outputs, or a negative YoloStatus (*result is NULL).
+FFI_PLUGIN_EXPORT int yolo_run_tensor(
+    const float* input,
+    const int64_t* shape,
+    int rank,
+    YoloTensorView* outputs,
+    int max_outputs,
+    YoloTensorResult** result,
+    const YoloDetectOptions* options
+);
+
+FFI_PLUGIN_EXPORT void yolo_tensor_release(YoloTensorResult* result);
+
+// Model input width and height. Returns 0 if no model is loaded.
+FFI_PLUGIN_EXPORT int yolo_get_input_size(int32_t* width, int32_t* height);
+
+// Batch detection over image files (JSON array of paths, or the .jpg/.jpeg/
+// .png/.bmp files in a directory, sorted by name). File contents are read
+// ahead with io_uring where available (a few pread threads otherwise) into a
+// bounded buffer pool and decoded from memory. options may be NULL, in which
+// case calls run at background priority; frame_id is the file index. A file
+// preempted by higher priority work is run again once that work has drained;
+// yolo_cancel_background stops a background scan.
+// Returns {"backend","count","bytes_read","io_wait_ms","skipped","skip_rate",
+// "preempted","cancelled","results":[...]} where each result is a detection
+// result plus "path" and its "io_wait_ms" ("preempted" if it was retried).
+// After a cancel, the files not processed are listed with code CANCELLED
+// (caller must free with free_string).
+FFI_PLUGIN_EXPORT char* yolo_detect_paths(
+    const char* paths_json,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+);
+
+FFI_PLUGIN_EXPORT char* yolo_detect_directory(
+    const char* directory,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+);
+
+// Near-duplicate skipping for batch scans: each file is hashed (dHash) from a
+// reduced decode, and when a recent image with the same dimensions is at most
+// max_distance bits away its detections are reused instead of running the
+// model. Reused results carry "reused_from" and "hash_distance"; the scan
+// reports "skipped" and "skip_rate". -1 disables (default); 0 reuses only
+// identical hashes, 8-12 (of 128 bits) catches typical burst shots.
+FFI_PLUGIN_EXPORT void yolo_set_batch_dedup(int max_distance);
+
+// Sparse detection over a video file: one frame every interval_seconds of
+// media time (<= 0 = every frame). Frames between samples are decoded
+// without color conversion (grab without retrieve), or skipped by seeking
+// when the gap exceeds keyframe_interval frames (the assumed GOP length;
+// 0 = never seek, negative = default 250). Only sampled frames are converted
+// and detected. options may be NULL, in which case calls run at background
+// priority; frame_id is the frame index in the video.
+// Returns {"fps","frame_count","duration_s","sampled","skipped","seeks",
+// "decode_ms","convert_ms","detect_ms","wall_ms","media_s",
+// "realtime_factor","results":[...]} where each result is a detection result
+// plus "frame_index" and "time_s", or an error with code VIDEO_OPEN_FAILED /
+// DECODER_UNAVAILABLE (built without OpenCV videoio) (caller must free with
+// free_string).
+FFI_PLUGIN_EXPORT char* yolo_detect_video(
+    const char* video_path,
+    double interval_seconds,
+    int keyframe_interval,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+);
+
+// MJPEG byte-stream ingest (concatenated JPEGs from a pipe, file or socket,
+// e.g. ffmpeg -f mjpeg): a reader thread splits frames into pooled buffers,
+// several JPEGs are decoded in parallel at a reduced IDCT scale, and frames
+// are detected in stream order.
+typedef struct YoloMjpegIngest YoloMjpegIngest;
+
+// decode_threads: parallel decoders (<= 0 = thread budget). decode_scale: 1,
+// 2, 4 or 8, or 0 for the largest that keeps frames at least the model input
+// size (full size before yolo_init). drop_late: 1 to drop the oldest
+// undelivered frame when detection falls behind (live sources), 0 to pause
+// reading instead.
+// yolo_mjpeg_open_fd reads fd, which the caller keeps and closes after
+// yolo_mjpeg_close; yolo_mjpeg_open opens path (a FIFO may have no writer
+// yet). Returns NULL on invalid arguments; open / read errors are reported
+// by yolo_mjpeg_get_stats.
+FFI_PLUGIN_EXPORT YoloMjpegIngest* yolo_mjpeg_open_fd(int fd, int decode_threads, int decode_scale, int drop_late);
+FFI_PLUGIN_EXPORT YoloMjpegIngest* yolo_mjpeg_open(const char* path, int decode_threads, int decode_scale,
+                                                   int drop_late);
+
+// Detect on the next frame in stream order, blocking until it is decoded.
+// Returns a detection result plus "frame_index" (position in the stream) and
+// "decode_scale" (as applied: 1 where the decoder cannot scale); boxes and
+// image size refer to the decoded frame. frame_id defaults to the frame index
+// and capture_ts_ns to when the frame was read.
+// Returns NULL at the end of the stream (caller must free with free_string).
+FFI_PLUGIN_EXPORT char* yolo_mjpeg_detect_next(
+    YoloMjpegIngest* ingest,
+    float conf_threshold,
+    float iou_threshold,
+    const YoloDetectOptions* options
+);
+
+// {"frames","delivered","dropped","corrupt","oversize","skipped_bytes",
+// "bytes_read","decode_threads","decode_scale","scan","decode_ms",
+// "mean_decode_ms","consumer_wait_ms","reader_stall_ms","elapsed_s",
+// "source_fps","delivered_fps","eof","error"} (caller must free with
+// free_string)
+FFI_PLUGIN_EXPORT char* yolo_mjpeg_get_stats(const YoloMjpegIngest* ingest);
+
+// Stop reading and release; no yolo_mjpeg_detect_next call may be running
+FFI_PLUGIN_EXPORT void yolo_mjpeg_close(YoloMjpegIngest* ingest);
+
+// Get latency metrics as JSON: queue wait, processing time and a frame age
+// histogram (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_get_metrics(void);
+
+// Reset latency metrics
+FFI_PLUGIN_EXPORT void yolo_reset_metrics(void);
+
+// Queue limits per class (queued, not running, calls; 0 = never queue) and
+// whether background calls are preempted. Negative values keep the current limit.
+FFI_PLUGIN_EXPORT void yolo_set_scheduler_limits(
+    int max_realtime,
+    int max_interactive,
+    int max_background,
+    int preempt_background
+);
+
+// Cancel queued background calls and abort a running one (not on OpenCV DNN,
+// which cannot abort a run). Returns the number of calls affected.
+FFI_PLUGIN_EXPORT int yolo_cancel_background(void);
+
+// Per-class admitted / rejected / shed / cancelled / preempted counts as JSON,
+// with "preemption_supported" (false on OpenCV DNN, where background calls
+// are never preempted). After yolo_init_numa the counts cover all replicas;
+// yolo_get_numa_info has them per replica (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_get_scheduler_stats(void);
+
+// Compact binary detection log for offline analytics: one header with the
+// class table per stream, then per frame a timestamp, the image size and
+// columnar quantized boxes/scores (about 10 bytes per detection). Logs are
+// append-only and memory-mapped for reading.
+typedef struct YoloLogWriter YoloLogWriter;
+typedef struct YoloLogReader YoloLogReader;
+
+// One detection as written to / read from a log (pixel coordinates)
+typedef struct YoloLogBox {
+    int32_t class_id;
+    float confidence;
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+} YoloLogBox;
+
+// Create a log, or append to an existing one with the same stream name and
+// class table. class_names_json: JSON array, or NULL for the detector's classes.
+// Names are stored cut to 255 bytes. Returns NULL on failure.
+FFI_PLUGIN_EXPORT YoloLogWriter* yolo_log_writer_open(
+    const char* path,
+    const char* stream_name,
+    const char* class_names_json
+);
+
+// Append one frame. Returns 1 on success, 0 on failure (including more than
+// 65535 boxes, or a class id outside the log's range: 0-255 for up to 255
+// classes, else 0-65535).
+FFI_PLUGIN_EXPORT int yolo_log_write_frame(
+    YoloLogWriter* writer,
+    int64_t timestamp_ns,
+    int width,
+    int height,
+    const YoloLogBox* boxes,
+    int count
+);
+
+FFI_PLUGIN_EXPORT void yolo_log_writer_flush(YoloLogWriter* writer);
+
+// Close the log (detaches it from the detector first)
+FFI_PLUGIN_EXPORT void yolo_log_writer_close(YoloLogWriter* writer);
+
+// Log every detect call of the detector into this writer (NULL detaches).
+// Frames are stamped with the capture timestamp when given, else the start time.
+// Returns 1 on success, 0 if the detector is not initialized.
+FFI_PLUGIN_EXPORT int yolo_log_attach(YoloLogWriter* writer);
+
+// Open a log for reading. Returns NULL if the file is not a valid log.
+FFI_PLUGIN_EXPORT YoloLogReader* yolo_log_reader_open(const char* path);
+
+FFI_PLUGIN_EXPORT int64_t yolo_log_reader_frame_count(const YoloLogReader* reader);
+
+// Decode a frame into up to max_boxes boxes (boxes may be NULL to query the count).
+// Returns the frame's detection count, or -1 if index is out of range.
+FFI_PLUGIN_EXPORT int yolo_log_reader_read_frame(
+    const YoloLogReader* reader,
+    int64_t index,
+    int64_t* timestamp_ns,
+    int* width,
+    int* height,
+    YoloLogBox* boxes,
+    int max_boxes
+);
+
+// Stream name and class table as JSON (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_log_reader_info(const YoloLogReader* reader);
+
+FFI_PLUGIN_EXPORT void yolo_log_reader_close(YoloLogReader* reader);
+
+// Convert a log to JSON lines (one object per frame).
+// Returns the number of frames written, or -1 on failure.
+FFI_PLUGIN_EXPORT int64_t yolo_log_to_jsonl(const char* log_path, const char* jsonl_path);
+
+// Per-camera stream contexts for serving several cameras from one loaded
+// model. A stream carries the state that depends on its camera: the sampling
+// plan for its frame geometry, its own frame metrics and detection log. Pass
+// it in YoloDetectOptions.stream; the model session, scheduler and global
+// metrics stay shared. Streams survive yolo_init / yolo_release. Frames of
+// one stream should be submitted in order.
+FFI_PLUGIN_EXPORT YoloStream* yolo_stream_create(const char* name);
+
+// Name, last frame size, sampling plan rebuilds and the stream's frame
+// metrics (same fields as yolo_get_metrics) as JSON (caller must free with
+// free_string)
+FFI_PLUGIN_EXPORT char* yolo_stream_get_metrics(const YoloStream* stream);
+
+FFI_PLUGIN_EXPORT void yolo_stream_reset_metrics(YoloStream* stream);
+
+// Log this stream's frames to writer instead of the log attached with
+// yolo_log_attach (NULL to detach). The writer must outlive the attachment.
+FFI_PLUGIN_EXPORT void yolo_stream_log_attach(YoloStream* stream, YoloLogWriter* writer);
+
+// No call using the stream may be in flight
+FFI_PLUGIN_EXPORT void yolo_stream_destroy(YoloStream* stream);
+
+// Delta-encoded result stream for forwarding detections over a narrow link.
+// Packets are keyframes (every box) or deltas against the previous packet:
+// boxes still present (matched by class and IoU) carry only their changed
+// corners / score as small offsets, plus the added boxes. Coordinates are
+// quantized to 1/4096 of the frame size, scores to 1/255. Keyframes are sent
+// every keyframe_interval packets, on a frame size change and on request.
+// Encoders and decoders are not thread-safe; use one per stream.
+typedef struct YoloDeltaEncoder YoloDeltaEncoder;
+typedef struct YoloDeltaDecoder YoloDeltaDecoder;
+
+// Failure codes of yolo_delta_decode (always negative)
+typedef enum YoloDeltaStatus {
+    YOLO_DELTA_MALFORMED = -1,      // truncated or invalid packet
+    YOLO_DELTA_OUT_OF_SYNC = -2     // a packet was lost; wait for a keyframe
+} YoloDeltaStatus;
+
+// keyframe_interval: packets between keyframes (0 = first packet only).
+// match_iou: minimum IoU for a box to be sent as a change of a previous one
+// (e.g. 0.3).
+FFI_PLUGIN_EXPORT YoloDeltaEncoder* yolo_delta_encoder_create(int keyframe_interval, float match_iou);
+
+// Encode one frame's boxes (pixel coordinates) into out. Returns the packet
+// size, or minus the required capacity if out_capacity is too small (the
+// frame is then not encoded).
+FFI_PLUGIN_EXPORT int yolo_delta_encode(
+    YoloDeltaEncoder* encoder,
+    int64_t timestamp_ns,
+    int width,
+    int height,
+    const YoloLogBox* boxes,
+    int count,
+    uint8_t* out,
+    int out_capacity
+);
+
+// Make the next packet a keyframe (e.g. the receiver reported OUT_OF_SYNC)
+FFI_PLUGIN_EXPORT void yolo_delta_request_keyframe(YoloDeltaEncoder* encoder);
+
+// Packets, keyframes, boxes, encoded_bytes, raw_bytes (full-precision boxes),
+// compression_ratio, bytes_per_packet, encode_ms and encode_us_per_packet as
+// JSON (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_delta_encoder_stats(const YoloDeltaEncoder* encoder);
+
+FFI_PLUGIN_EXPORT void yolo_delta_encoder_destroy(YoloDeltaEncoder* encoder);
+
+FFI_PLUGIN_EXPORT YoloDeltaDecoder* yolo_delta_decoder_create(void);
+
+// Apply one packet and write the reconstructed frame into up to max_boxes
+// boxes (boxes may be NULL). Returns the frame's detection count, or a
+// negative YoloDeltaStatus (the decoder keeps its previous frame).
+FFI_PLUGIN_EXPORT int yolo_delta_decode(
+    YoloDeltaDecoder* decoder,
+    const uint8_t* packet,
+    int size,
+    int64_t* timestamp_ns,
+    int* width,
+    int* height,
+    YoloLogBox* boxes,
+    int max_boxes
+);
+
+// Boxes of the last decoded frame, as written by yolo_delta_decode.
+// Returns the frame's detection count.
+FFI_PLUGIN_EXPORT int yolo_delta_decoder_boxes(const YoloDeltaDecoder* decoder, YoloLogBox* boxes, int max_boxes);
+
+FFI_PLUGIN_EXPORT void yolo_delta_decoder_destroy(YoloDeltaDecoder* decoder);
+
 // Set custom class names (JSON array string)
 FFI_PLUGIN_EXPORT void yolo_set_classes(const char* class_names_json);
 
+// Current class names as a JSON array (caller must free with free_string)
+FFI_PLUGIN_EXPORT char* yolo_get_classes(void);
+
 // Release detector resources
 FFI_PLUGIN_EXPORT void yolo_release(void);
 
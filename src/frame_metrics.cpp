@@ -0,0 +1,135 @@
+#include "frame_metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+// Bucket upper bounds in ms: roughly one bucket per frame interval at 60/30 fps
+// at the low end, then coarser steps to show how far behind the camera we are
+const double FrameMetrics::kBucketUpperMs[FrameMetrics::kNumBuckets - 1] = {
+    16.7, 33.3, 50.0, 66.7, 100.0, 150.0, 250.0, 500.0, 1000.0, 2000.0
+};
+
+int64_t monotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+FrameMetrics::FrameMetrics() {
+    reset();
+}
+
+void FrameMetrics::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frames = 0;
+    m_frames_with_capture_ts = 0;
+    m_queue_wait_sum_ms = 0.0;
+    m_queue_wait_max_ms = 0.0;
+    m_processing_sum_ms = 0.0;
+    m_processing_max_ms = 0.0;
+    m_age_sum_ms = 0.0;
+    m_age_max_ms = 0.0;
+    m_last_age_ms = 0.0;
+    m_last_frame_id = -1;
+    std::fill(m_age_buckets, m_age_buckets + kNumBuckets, 0);
+}
+
+void FrameMetrics::record(const FrameTiming& timing) {
+    double queue_wait = timing.queueWaitMs();
+    double processing = timing.processingMs();
+    double age = timing.frameAgeMs();
+
+    int bucket = kNumBuckets - 1;
+    for (int i = 0; i < kNumBuckets - 1; i++) {
+        if (age <= kBucketUpperMs[i]) {
+            bucket = i;
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frames++;
+    if (timing.capture_ts_ns > 0) m_frames_with_capture_ts++;
+    m_queue_wait_sum_ms += queue_wait;
+    m_queue_wait_max_ms = std::max(m_queue_wait_max_ms, queue_wait);
+    m_processing_sum_ms += processing;
+    m_processing_max_ms = std::max(m_processing_max_ms, processing);
+    m_age_sum_ms += age;
+    m_age_max_ms = std::max(m_age_max_ms, age);
+    m_last_age_ms = age;
+    m_last_frame_id = timing.frame_id;
+    m_age_buckets[bucket]++;
+}
+
+void FrameMetrics::merge(const FrameMetrics& other) {
+    if (&other == this) return;
+    std::lock(m_mutex, other.m_mutex);
+    std::lock_guard<std::mutex> lock(m_mutex, std::adopt_lock);
+    std::lock_guard<std::mutex> other_lock(other.m_mutex, std::adopt_lock);
+
+    if (other.m_frames > 0) {
+        m_last_age_ms = other.m_last_age_ms;
+        m_last_frame_id = other.m_last_frame_id;
+    }
+    m_frames += other.m_frames;
+    m_frames_with_capture_ts += other.m_frames_with_capture_ts;
+    m_queue_wait_sum_ms += other.m_queue_wait_sum_ms;
+    m_queue_wait_max_ms = std::max(m_queue_wait_max_ms, other.m_queue_wait_max_ms);
+    m_processing_sum_ms += other.m_processing_sum_ms;
+    m_processing_max_ms = std::max(m_processing_max_ms, other.m_processing_max_ms);
+    m_age_sum_ms += other.m_age_sum_ms;
+    m_age_max_ms = std::max(m_age_max_ms, other.m_age_max_ms);
+    for (int i = 0; i < kNumBuckets; i++) {
+        m_age_buckets[i] += other.m_age_buckets[i];
+    }
+}
+
+double FrameMetrics::agePercentileMs(double fraction) const {
+    if (m_frames == 0) return 0.0;
+    int64_t target = static_cast<int64_t>(fraction * m_frames + 0.5);
+    int64_t seen = 0;
+    for (int i = 0; i < kNumBuckets - 1; i++) {
+        seen += m_age_buckets[i];
+        if (seen >= target) return kBucketUpperMs[i];
+    }
+    return m_age_max_ms;
+}
+
+std::string FrameMetrics::toJson() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    double n = m_frames > 0 ? static_cast<double>(m_frames) : 1.0;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    oss << "{"
+        << "\"frames\":" << m_frames << ","
+        << "\"frames_with_capture_ts\":" << m_frames_with_capture_ts << ","
+        << "\"last_frame_id\":" << m_last_frame_id << ","
+        << "\"queue_wait_ms\":{\"mean\":" << m_queue_wait_sum_ms / n
+        << ",\"max\":" << m_queue_wait_max_ms << "},"
+        << "\"processing_ms\":{\"mean\":" << m_processing_sum_ms / n
+        << ",\"max\":" << m_processing_max_ms << "},"
+        << "\"frame_age_ms\":{\"mean\":" << m_age_sum_ms / n
+        << ",\"max\":" << m_age_max_ms
+        << ",\"last\":" << m_last_age_ms
+        << ",\"p50\":" << agePercentileMs(0.50)
+        << ",\"p90\":" << agePercentileMs(0.90)
+        << ",\"p99\":" << agePercentileMs(0.99) << "},"
+        << "\"frame_age_histogram\":[";
+
+    for (int i = 0; i < kNumBuckets; i++) {
+        if (i > 0) oss << ",";
+        oss << "{\"le_ms\":";
+        if (i < kNumBuckets - 1) {
+            oss << kBucketUpperMs[i];
+        } else {
+            oss << "null";
+        }
+        oss << ",\"count\":" << m_age_buckets[i] << "}";
+    }
+    oss << "]}";
+
+    return oss.str();
+}
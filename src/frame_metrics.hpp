@@ -0,0 +1,65 @@
+#ifndef FRAME_METRICS_HPP
+#define FRAME_METRICS_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Monotonic clock shared by the native side and callers (yolo_now_ns)
+int64_t monotonicNowNs();
+
+// Timing of one detect call, from capture to result
+struct FrameTiming {
+    int64_t frame_id = -1;          // caller frame id (-1 = none)
+    int64_t capture_ts_ns = 0;      // capture time on the monotonic clock (0 = unknown)
+    int64_t enqueue_ts_ns = 0;      // native call entry
+    int64_t start_ts_ns = 0;        // detector acquired, processing starts
+    int64_t end_ts_ns = 0;          // result ready
+
+    double queueWaitMs() const { return (start_ts_ns - enqueue_ts_ns) / 1e6; }
+    double processingMs() const { return (end_ts_ns - start_ts_ns) / 1e6; }
+
+    // Glass-to-result age; falls back to native call entry without a capture time
+    double frameAgeMs() const {
+        int64_t origin = capture_ts_ns > 0 ? capture_ts_ns : enqueue_ts_ns;
+        return (end_ts_ns - origin) / 1e6;
+    }
+};
+
+// Running latency statistics with a frame age histogram.
+// Thread-safe; record() is called once per detect call.
+class FrameMetrics {
+public:
+    FrameMetrics();
+
+    void record(const FrameTiming& timing);
+    void reset();
+
+    // Add another instance's counts (e.g. one per detector replica)
+    void merge(const FrameMetrics& other);
+
+    // JSON object with counters, means/maxima and the frame age histogram
+    std::string toJson() const;
+
+private:
+    static constexpr int kNumBuckets = 11;
+    static const double kBucketUpperMs[kNumBuckets - 1];  // last bucket is open-ended
+
+    mutable std::mutex m_mutex;
+    int64_t m_frames;
+    int64_t m_frames_with_capture_ts;
+    double m_queue_wait_sum_ms;
+    double m_queue_wait_max_ms;
+    double m_processing_sum_ms;
+    double m_processing_max_ms;
+    double m_age_sum_ms;
+    double m_age_max_ms;
+    double m_last_age_ms;
+    int64_t m_last_frame_id;
+    int64_t m_age_buckets[kNumBuckets];
+
+    // Smallest bucket bound at or above the given fraction of frames
+    double agePercentileMs(double fraction) const;
+};
+
+#endif // FRAME_METRICS_HPP
@@ -0,0 +1,204 @@
+#include "frame_pipeline.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+#include "detection_log.hpp"
+#include "image_decoder.hpp"
+
+enum { kPreprocessStage = 0, kInferenceStage = 1, kDecodeStage = 2 };
+
+void DetectionLogSink::consume(const FrameResult& result) {
+    if (result.status != DetectStatus::Ok) return;
+    int64_t timestamp_ns = result.timing.capture_ts_ns > 0 ? result.timing.capture_ts_ns : result.timing.start_ts_ns;
+    m_log.writeFrame(timestamp_ns, result.width, result.height, result.detections);
+}
+
+bool FramePipeline::Queue::push(std::unique_ptr<Item> item) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [this]() { return m_closed || m_items.size() < m_capacity; });
+    if (m_closed) return false;
+    m_items.push_back(std::move(item));
+    m_not_empty.notify_one();
+    return true;
+}
+
+bool FramePipeline::Queue::pop(std::unique_ptr<Item>& item) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_empty.wait(lock, [this]() { return m_closed || !m_items.empty(); });
+    if (m_items.empty()) return false;
+    item = std::move(m_items.front());
+    m_items.pop_front();
+    m_not_full.notify_one();
+    return true;
+}
+
+// Items already queued are still delivered
+void FramePipeline::Queue::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+}
+
+FramePipeline::FramePipeline(YoloDetector& detector, ResultSink& sink, const PipelineConfig& config)
+    : m_detector(detector)
+    , m_sink(sink)
+    , m_config(config)
+    , m_stream("pipeline")
+    , m_decoder(detector.createDecoder())
+    , m_sources(static_cast<size_t>(std::max(1, config.depth)))
+    , m_prepared(static_cast<size_t>(std::max(1, config.depth)))
+    , m_inferred(static_cast<size_t>(std::max(1, config.depth))) {
+    m_threads.emplace_back(&FramePipeline::preprocessLoop, this);
+    m_threads.emplace_back(&FramePipeline::inferenceLoop, this);
+    m_threads.emplace_back(&FramePipeline::decodeLoop, this);
+}
+
+FramePipeline::~FramePipeline() {
+    finish();
+}
+
+bool FramePipeline::push(FrameSource source, FrameTiming timing) {
+    auto item = std::make_unique<Item>();
+    item->source = std::move(source);
+    item->timing = timing;
+    if (item->timing.enqueue_ts_ns == 0) {
+        item->timing.enqueue_ts_ns = monotonicNowNs();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        if (m_first_push_ns == 0) m_first_push_ns = item->timing.enqueue_ts_ns;
+    }
+    return m_sources.push(std::move(item));
+}
+
+void FramePipeline::finish() {
+    std::lock_guard<std::mutex> lock(m_finish_mutex);
+    if (m_finished) return;
+    m_finished = true;
+
+    // Each stage closes the next queue once its input is drained
+    m_sources.close();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+void FramePipeline::addStageTime(int stage, int64_t begin_ns) {
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    m_stats[stage].items++;
+    m_stats[stage].busy_ms += (monotonicNowNs() - begin_ns) / 1e6;
+}
+
+void FramePipeline::preprocessLoop() {
+    const int input_width = m_detector.inputWidth();
+    const int input_height = m_detector.inputHeight();
+    const bool letterbox = m_detector.letterboxInput();
+    const TensorFormat format = m_detector.inputFormat();
+
+    std::unique_ptr<Item> item;
+    while (m_sources.pop(item)) {
+        const int64_t begin_ns = monotonicNowNs();
+        item->timing.start_ts_ns = begin_ns;
+        DecodedImage image;
+        FrameView frame;
+        item->status = item->source(image, frame);
+        item->source = nullptr;
+        if (item->status == DetectStatus::Ok) {
+            // Detections are reported in the rotated frame
+            item->width = frame.geometry.rotatedWidth();
+            item->height = frame.geometry.rotatedHeight();
+            item->tensor.resize(static_cast<size_t>(3) * input_width * input_height);
+            m_stream.sample(frame, input_width, input_height, letterbox, format, item->tensor.data(),
+                            item->scale, item->pad_x, item->pad_y);
+        }
+        addStageTime(kPreprocessStage, begin_ns);
+        m_prepared.push(std::move(item));
+    }
+    m_prepared.close();
+}
+
+void FramePipeline::inferenceLoop() {
+    const int64_t shape[4] = {1, 3, m_detector.inputHeight(), m_detector.inputWidth()};
+
+    std::unique_ptr<Item> item;
+    while (m_prepared.pop(item)) {
+        if (item->status == DetectStatus::Ok) {
+            const int64_t begin_ns = monotonicNowNs();
+            item->status = m_detector.runTensor(item->tensor.data(), shape, 4, item->run,
+                                                item->timing, m_config.priority);
+            addStageTime(kInferenceStage, begin_ns);
+        }
+        item->tensor = std::vector<float>();
+        m_inferred.push(std::move(item));
+    }
+    m_inferred.close();
+}
+
+void FramePipeline::decodeLoop() {
+    CandidateFilter filter;
+    filter.conf_threshold = m_config.conf_threshold;
+    std::vector<OutputTensor> views;
+    std::vector<HeadBox> candidates;
+
+    std::unique_ptr<Item> item;
+    while (m_inferred.pop(item)) {
+        const int64_t begin_ns = monotonicNowNs();
+        FrameResult result;
+        result.timing = item->timing;
+        result.status = item->status;
+        result.width = item->width;
+        result.height = item->height;
+        if (item->status == DetectStatus::Ok) {
+            views.assign(item->run.outputs.begin(),
+                         item->run.outputs.begin() + std::min(item->run.outputs.size(),
+                                                              m_detector.detectionOutputCount()));
+            candidates.clear();
+            m_decoder->decode(views, filter, candidates);
+            result.detections = m_detector.finishCandidates(
+                candidates,
+                m_detector.tensorMapping(item->width, item->height, item->scale, item->pad_x, item->pad_y),
+                item->width, item->height, m_config.iou_threshold, m_decoder->suppressed(), true);
+        }
+        item.reset();
+
+        // Frame metrics cover the whole pipeline, queue waits included
+        result.timing.end_ts_ns = monotonicNowNs();
+        if (result.status == DetectStatus::Ok) {
+            m_stream.metrics().record(result.timing);
+        }
+        m_sink.consume(result);
+        addStageTime(kDecodeStage, begin_ns);
+
+        std::lock_guard<std::mutex> lock(m_stats_mutex);
+        m_last_result_ns = monotonicNowNs();
+    }
+}
+
+std::string FramePipeline::statsJson() const {
+    static const char* const kStageNames[3] = {"preprocess", "inference", "decode"};
+
+    std::lock_guard<std::mutex> lock(m_stats_mutex);
+    const double wall_ms = m_last_result_ns > m_first_push_ns ? (m_last_result_ns - m_first_push_ns) / 1e6 : 0.0;
+    const int64_t frames = m_stats[kDecodeStage].items;
+
+    std::ostringstream oss;
+    oss << "{\"frames\":" << frames
+        << ",\"wall_ms\":" << wall_ms
+        << ",\"fps\":" << (wall_ms > 0.0 ? frames * 1000.0 / wall_ms : 0.0)
+        << ",\"depth\":" << m_config.depth
+        << ",\"stages\":{";
+    for (int stage = 0; stage < 3; stage++) {
+        const StageStats& stats = m_stats[stage];
+        oss << (stage > 0 ? "," : "") << "\"" << kStageNames[stage] << "\":{"
+            << "\"items\":" << stats.items
+            << ",\"busy_ms\":" << stats.busy_ms
+            << ",\"mean_ms\":" << (stats.items > 0 ? stats.busy_ms / stats.items : 0.0)
+            << ",\"utilization\":" << (wall_ms > 0.0 ? stats.busy_ms / wall_ms : 0.0)
+            << "}";
+    }
+    oss << "},\"stream\":" << m_stream.statsJson() << "}";
+    return oss.str();
+}
@@ -0,0 +1,160 @@
+#ifndef FRAME_PIPELINE_HPP
+#define FRAME_PIPELINE_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "detection.hpp"
+#include "stream_context.hpp"
+#include "yolo_detector.hpp"
+
+// One frame's outcome at the end of a FramePipeline
+struct FrameResult {
+    FrameTiming timing;
+    DetectStatus status = DetectStatus::Ok;
+    int width = 0;              // frame size the detections refer to
+    int height = 0;
+    std::vector<Detection> detections;
+};
+
+// Last stage of a FramePipeline. consume() is called from the pipeline's
+// decode thread, one frame at a time, in push order.
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+    virtual void consume(const FrameResult& result) = 0;
+};
+
+// Calls a function for every frame
+class CallbackSink : public ResultSink {
+public:
+    explicit CallbackSink(std::function<void(const FrameResult&)> callback) : m_callback(std::move(callback)) {}
+    void consume(const FrameResult& result) override { m_callback(result); }
+
+private:
+    std::function<void(const FrameResult&)> m_callback;
+};
+
+// Appends every successful frame to a binary detection log. The writer must
+// outlive the sink.
+class DetectionLogSink : public ResultSink {
+public:
+    explicit DetectionLogSink(DetectionLogWriter& log) : m_log(log) {}
+    void consume(const FrameResult& result) override;
+
+private:
+    DetectionLogWriter& m_log;
+};
+
+struct PipelineConfig {
+    int depth = 2;                  // frames buffered between consecutive stages
+    float conf_threshold = 0.25f;
+    float iou_threshold = 0.45f;
+    RequestPriority priority = RequestPriority::Interactive;
+};
+
+// Runs the stages of a detection pass for successive frames on three
+// threads, so sampling and decoding of neighbouring frames overlap
+// inference:
+//
+//   source + preprocess  ->  inference  ->  decode + sink
+//
+// The preprocess stage samples with its own plan (a StreamContext) into a
+// per-frame tensor, inference goes through YoloDetector::runTensor (and so
+// its scheduler), and the decode stage owns a decoder from
+// YoloDetector::createDecoder(). Bounded queues between the stages cap the
+// frames in flight at about 3 * depth + 3. Results reach the sink in push
+// order, failed frames included.
+class FramePipeline {
+public:
+    FramePipeline(YoloDetector& detector, ResultSink& sink, const PipelineConfig& config = PipelineConfig());
+    ~FramePipeline();
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Queue a frame, blocking while the first stage is full. The source runs
+    // on the preprocess thread; memory it references must stay valid until
+    // the frame's result is consumed. Returns false after finish().
+    bool push(FrameSource source, FrameTiming timing = FrameTiming());
+
+    // Process every queued frame, then stop the threads
+    void finish();
+
+    // Frames, wall time and per-stage busy time / items as JSON
+    std::string statsJson() const;
+
+private:
+    struct Item {
+        FrameSource source;
+        FrameTiming timing;
+        DetectStatus status = DetectStatus::Ok;
+        int width = 0;
+        int height = 0;
+
+        // Preprocess output
+        std::vector<float> tensor;
+        float scale = 1.0f;
+        int pad_x = 0;
+        int pad_y = 0;
+
+        // Inference output
+        TensorRun run;
+    };
+
+    // Blocking FIFO of at most capacity items; pop() returns false once it is
+    // closed and drained
+    class Queue {
+    public:
+        explicit Queue(size_t capacity) : m_capacity(capacity) {}
+        bool push(std::unique_ptr<Item> item);
+        bool pop(std::unique_ptr<Item>& item);
+        void close();
+
+    private:
+        size_t m_capacity;
+        std::mutex m_mutex;
+        std::condition_variable m_not_empty;
+        std::condition_variable m_not_full;
+        std::deque<std::unique_ptr<Item>> m_items;
+        bool m_closed = false;
+    };
+
+    struct StageStats {
+        int64_t items = 0;
+        double busy_ms = 0.0;
+    };
+
+    YoloDetector& m_detector;
+    ResultSink& m_sink;
+    PipelineConfig m_config;
+    StreamContext m_stream;
+    std::unique_ptr<OutputDecoder> m_decoder;
+
+    Queue m_sources;
+    Queue m_prepared;
+    Queue m_inferred;
+
+    mutable std::mutex m_stats_mutex;
+    StageStats m_stats[3];
+    int64_t m_first_push_ns = 0;
+    int64_t m_last_result_ns = 0;
+
+    std::mutex m_finish_mutex;
+    bool m_finished = false;
+    std::vector<std::thread> m_threads;
+
+    void preprocessLoop();
+    void inferenceLoop();
+    void decodeLoop();
+    void addStageTime(int stage, int64_t begin_ns);
+};
+
+#endif // FRAME_PIPELINE_HPP
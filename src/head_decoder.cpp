@@ -0,0 +1,131 @@
+#include "head_decoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+bool HeadDecoder::classify(int64_t channels, int class_hint, HeadLayout& layout, int& num_classes) {
+    const int64_t dfl_channels = 4 * kRegMax;
+
+    // Known class count first, then the COCO layouts, then whichever fits
+    if (class_hint > 0 && channels == dfl_channels + class_hint) {
+        layout = HeadLayout::DFL;
+    } else if (class_hint > 0 && channels == 5 + class_hint) {
+        layout = HeadLayout::YOLOX;
+    } else if (channels == 85) {
+        layout = HeadLayout::YOLOX;
+    } else if (channels > dfl_channels) {
+        layout = HeadLayout::DFL;
+    } else if (channels > 5) {
+        layout = HeadLayout::YOLOX;
+    } else {
+        return false;
+    }
+    num_classes = static_cast<int>(channels - (layout == HeadLayout::DFL ? dfl_channels : 5));
+    return true;
+}
+
+void HeadDecoder::decode(const HeadTensor& head, HeadLayout layout, float conf_threshold, std::vector<HeadBox>& out) {
+    if (head.data == nullptr || head.height <= 0 || head.width <= 0) return;
+    if (layout == HeadLayout::DFL) {
+        decodeDfl(head, conf_threshold, out);
+    } else {
+        decodeYolox(head, conf_threshold, out);
+    }
+}
+
+// Objectness plane first; class scores are only read for cells that pass it
+void HeadDecoder::decodeYolox(const HeadTensor& head, float conf_threshold, std::vector<HeadBox>& out) {
+    const int cells = head.height * head.width;
+    const int num_classes = head.channels - 5;
+    const float stride = static_cast<float>(head.stride);
+    const float* objectness = head.data + 4 * cells;
+    const float* classes = head.data + 5 * cells;
+
+    for (int p = 0; p < cells; p++) {
+        const float obj = objectness[p];
+        if (obj < conf_threshold) continue;
+
+        float best = 0.0f;
+        int best_class = 0;
+        for (int c = 0; c < num_classes; c++) {
+            float score = classes[static_cast<size_t>(c) * cells + p];
+            if (score > best) {
+                best = score;
+                best_class = c;
+            }
+        }
+        const float confidence = obj * best;
+        if (confidence < conf_threshold) continue;
+
+        const float gx = static_cast<float>(p % head.width);
+        const float gy = static_cast<float>(p / head.width);
+        const float cx = (head.data[p] + gx) * stride;
+        const float cy = (head.data[cells + p] + gy) * stride;
+        const float w = std::exp(head.data[2 * cells + p]) * stride;
+        const float h = std::exp(head.data[3 * cells + p]) * stride;
+
+        out.push_back({best_class, confidence, cx - w / 2.0f, cy - h / 2.0f, cx + w / 2.0f, cy + h / 2.0f});
+    }
+}
+
+// Best class per cell in one sequential pass per class plane (in logit
+// space, so sigmoid is only evaluated for candidates), then the DFL box
+// expectation for candidate cells
+void HeadDecoder::decodeDfl(const HeadTensor& head, float conf_threshold, std::vector<HeadBox>& out) {
+    const int cells = head.height * head.width;
+    const int num_classes = head.channels - 4 * kRegMax;
+    const float stride = static_cast<float>(head.stride);
+    const float* classes = head.data + static_cast<size_t>(4 * kRegMax) * cells;
+
+    m_best_score.assign(cells, -std::numeric_limits<float>::infinity());
+    m_best_class.assign(cells, 0);
+    for (int c = 0; c < num_classes; c++) {
+        const float* plane = classes + static_cast<size_t>(c) * cells;
+        for (int p = 0; p < cells; p++) {
+            if (plane[p] > m_best_score[p]) {
+                m_best_score[p] = plane[p];
+                m_best_class[p] = c;
+            }
+        }
+    }
+
+    float logit_threshold;
+    if (conf_threshold <= 0.0f) {
+        logit_threshold = -std::numeric_limits<float>::infinity();
+    } else if (conf_threshold >= 1.0f) {
+        return;
+    } else {
+        logit_threshold = std::log(conf_threshold / (1.0f - conf_threshold));
+    }
+
+    for (int p = 0; p < cells; p++) {
+        if (m_best_score[p] < logit_threshold) continue;
+        const float score = 1.0f / (1.0f + std::exp(-m_best_score[p]));
+
+        // Distance of each side (left, top, right, bottom) in cells:
+        // expectation of the softmax over kRegMax bins
+        float distance[4];
+        for (int side = 0; side < 4; side++) {
+            const float* bins = head.data + static_cast<size_t>(side * kRegMax) * cells + p;
+            float max_logit = bins[0];
+            for (int b = 1; b < kRegMax; b++) {
+                max_logit = std::max(max_logit, bins[static_cast<size_t>(b) * cells]);
+            }
+            float sum = 0.0f;
+            float weighted = 0.0f;
+            for (int b = 0; b < kRegMax; b++) {
+                float e = std::exp(bins[static_cast<size_t>(b) * cells] - max_logit);
+                sum += e;
+                weighted += e * b;
+            }
+            distance[side] = weighted / sum;
+        }
+
+        const float ax = static_cast<float>(p % head.width) + 0.5f;
+        const float ay = static_cast<float>(p / head.width) + 0.5f;
+        out.push_back({m_best_class[p], score,
+                       (ax - distance[0]) * stride, (ay - distance[1]) * stride,
+                       (ax + distance[2]) * stride, (ay + distance[3]) * stride});
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef HEAD_DECODER_HPP
+#define HEAD_DECODER_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Channel layout of a raw (un-concatenated) detection head [1, C, H, W]
+enum class HeadLayout {
+    YOLOX,      // C = 4 + 1 + nc: raw box (dx, dy, log w, log h), sigmoid objectness, sigmoid classes
+    DFL         // C = 4 * 16 + nc: box side distributions (YOLOv8/v11), class logits
+};
+
+// One stride head as produced by the model, channel-major
+struct HeadTensor {
+    const float* data = nullptr;
+    int channels = 0;
+    int height = 0;
+    int width = 0;
+    int stride = 0;     // input pixels per cell
+};
+
+// A box in model input (letterboxed) coordinates
+struct HeadBox {
+    int class_id;
+    float score;
+    float x1, y1, x2, y2;
+};
+
+// Decodes per-stride head outputs directly, for models exported without the
+// trailing Reshape/Concat/Transpose that merges them into [1, 84, 8400] or
+// [1, 8400, 85]. Each head is read in place: class planes are scanned
+// sequentially to find candidate cells, and only those cells' boxes are
+// decoded.
+class HeadDecoder {
+public:
+    static constexpr int kRegMax = 16;  // DFL bins per box side
+
+    // Layout and class count from the head channel count; class_hint (the
+    // number of known class names, or 0) breaks ties between the layouts
+    static bool classify(int64_t channels, int class_hint, HeadLayout& layout, int& num_classes);
+
+    // Append boxes scoring at least conf_threshold
+    void decode(const HeadTensor& head, HeadLayout layout, float conf_threshold, std::vector<HeadBox>& out);
+
+private:
+    // Per-cell best class over the class planes, reused across frames
+    std::vector<float> m_best_score;
+    std::vector<int> m_best_class;
+
+    void decodeYolox(const HeadTensor& head, float conf_threshold, std::vector<HeadBox>& out);
+    void decodeDfl(const HeadTensor& head, float conf_threshold, std::vector<HeadBox>& out);
+};
+
+#endif // HEAD_DECODER_HPP
@@ -0,0 +1,201 @@
+#include "image_decoder.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#if YOLO_USE_OPENCV
+
+#include <opencv2/opencv.hpp>
+
+namespace {
+
+bool fromMat(cv::Mat&& image, DecodedImage& out) {
+    if (image.empty() || image.type() != CV_8UC3) {
+        return false;
+    }
+    auto mat = std::make_shared<cv::Mat>(std::move(image));
+    out.format = SourceFormat::BGR;
+    out.width = mat->cols;
+    out.height = mat->rows;
+    out.stride = static_cast<int>(mat->step);
+    out.data = mat->data;
+    out.storage = mat;
+    return true;
+}
+
+}  // namespace
+
+bool imageDecoderAvailable() {
+    return true;
+}
+
+bool decodeImageFile(const char* path, DecodedImage& out) {
+    try {
+        return fromMat(cv::imread(path, cv::IMREAD_COLOR), out);
+    } catch (const cv::Exception&) {
+        return false;
+    }
+}
+
+bool decodeImageMemory(const uint8_t* data, size_t size, DecodedImage& out) {
+    try {
+        cv::Mat encoded(1, static_cast<int>(size), CV_8UC1, const_cast<uint8_t*>(data));
+        return fromMat(cv::imdecode(encoded, cv::IMREAD_COLOR), out);
+    } catch (const cv::Exception&) {
+        return false;
+    }
+}
+
+bool decodeImageScaled(const uint8_t* data, size_t size, int scale, DecodedImage& out) {
+    int flags = cv::IMREAD_COLOR;
+    switch (scale) {
+        case 2: flags = cv::IMREAD_REDUCED_COLOR_2; break;
+        case 4: flags = cv::IMREAD_REDUCED_COLOR_4; break;
+        case 8: flags = cv::IMREAD_REDUCED_COLOR_8; break;
+        default: break;
+    }
+    try {
+        cv::Mat encoded(1, static_cast<int>(size), CV_8UC1, const_cast<uint8_t*>(data));
+        return fromMat(cv::imdecode(encoded, flags), out);
+    } catch (const cv::Exception&) {
+        return false;
+    }
+}
+
+bool decodeImagePreview(const uint8_t* data, size_t size, DecodedImage& out) {
+    return decodeImageScaled(data, size, 8, out);
+}
+
+#elif __has_include("stb_image.h")
+
+// stb_image is fetched by linux/download_libs.sh (or dropped into the
+// include path by hand for other platforms)
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_PNG
+#define STBI_ONLY_BMP
+#include "stb_image.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+bool fromStb(stbi_uc* pixels, int width, int height, DecodedImage& out) {
+    if (pixels == nullptr) {
+        return false;
+    }
+    out.format = SourceFormat::RGB;
+    out.width = width;
+    out.height = height;
+    out.stride = width * 3;
+    out.data = pixels;
+    out.storage = std::shared_ptr<void>(pixels, [](void* p) { stbi_image_free(p); });
+    return true;
+}
+
+}  // namespace
+
+bool imageDecoderAvailable() {
+    return true;
+}
+
+bool decodeImageFile(const char* path, DecodedImage& out) {
+    int width = 0, height = 0, channels = 0;
+    stbi_uc* pixels = stbi_load(path, &width, &height, &channels, 3);
+    return fromStb(pixels, width, height, out);
+}
+
+bool decodeImageMemory(const uint8_t* data, size_t size, DecodedImage& out) {
+    int width = 0, height = 0, channels = 0;
+    stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size),
+                                            &width, &height, &channels, 3);
+    return fromStb(pixels, width, height, out);
+}
+
+bool decodeImageScaled(const uint8_t* data, size_t size, int, DecodedImage& out) {
+    return decodeImageMemory(data, size, out);
+}
+
+bool decodeImagePreview(const uint8_t* data, size_t size, DecodedImage& out) {
+    return decodeImageMemory(data, size, out);
+}
+
+#else
+
+// No decoder in this build: file and memory entry points report an error,
+// raw frame entry points still work.
+bool imageDecoderAvailable() {
+    return false;
+}
+
+bool decodeImageFile(const char*, DecodedImage&) {
+    return false;
+}
+
+bool decodeImageMemory(const uint8_t*, size_t, DecodedImage&) {
+    return false;
+}
+
+bool decodeImageScaled(const uint8_t*, size_t, int, DecodedImage&) {
+    return false;
+}
+
+bool decodeImagePreview(const uint8_t*, size_t, DecodedImage&) {
+    return false;
+}
+
+#endif
+
+namespace {
+
+uint32_t readBE16(const uint8_t* p) { return (p[0] << 8) | p[1]; }
+uint32_t readBE32(const uint8_t* p) { return (readBE16(p) << 16) | readBE16(p + 2); }
+int32_t readLE32(const uint8_t* p) {
+    return static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24));
+}
+
+}  // namespace
+
+bool probeImageSize(const uint8_t* data, size_t size, int& width, int& height) {
+    static const uint8_t kPng[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+    if (size >= 24 && memcmp(data, kPng, 8) == 0) {
+        width = static_cast<int>(readBE32(data + 16));
+        height = static_cast<int>(readBE32(data + 20));
+        return width > 0 && height > 0;
+    }
+
+    if (size >= 26 && data[0] == 'B' && data[1] == 'M') {
+        width = readLE32(data + 18);
+        height = std::abs(readLE32(data + 22));
+        return width > 0 && height > 0;
+    }
+
+    if (size >= 4 && data[0] == 0xFF && data[1] == 0xD8) {
+        // Walk the marker segments up to the first start-of-frame
+        size_t pos = 2;
+        while (pos + 4 <= size) {
+            if (data[pos] != 0xFF) return false;
+            uint8_t marker = data[pos + 1];
+            if (marker == 0xFF) {
+                pos++;
+                continue;
+            }
+            if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+                pos += 2;
+                continue;
+            }
+            uint32_t length = readBE16(data + pos + 2);
+            bool sof = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+            if (sof) {
+                if (pos + 9 > size) return false;
+                height = static_cast<int>(readBE16(data + pos + 5));
+                width = static_cast<int>(readBE16(data + pos + 7));
+                return width > 0 && height > 0;
+            }
+            pos += 2 + length;
+        }
+    }
+    return false;
+}
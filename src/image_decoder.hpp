@@ -0,0 +1,57 @@
+#ifndef IMAGE_DECODER_HPP
+#define IMAGE_DECODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "sampling_plan.hpp"
+
+// Build with OpenCV (default). Set YOLO_USE_OPENCV=0 to build without it:
+// image files are then decoded with stb_image and all frame processing uses
+// the built-in sampling kernels.
+#ifndef YOLO_USE_OPENCV
+#define YOLO_USE_OPENCV 1
+#endif
+
+// Decoded image pixels (packed BGR or RGB depending on the decoder)
+struct DecodedImage {
+    SourceFormat format = SourceFormat::BGR;
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    const uint8_t* data = nullptr;
+    std::shared_ptr<void> storage;  // keeps the pixel memory alive
+
+    FrameView view() const {
+        FrameView frame;
+        frame.geometry.format = format;
+        frame.geometry.width = width;
+        frame.geometry.height = height;
+        frame.geometry.stride = stride;
+        frame.data = data;
+        return frame;
+    }
+};
+
+// Whether this build can decode image files at all
+bool imageDecoderAvailable();
+
+// Decode an image file (JPEG/PNG/BMP). Returns false on failure.
+bool decodeImageFile(const char* path, DecodedImage& out);
+
+// Decode an encoded image held in memory. Returns false on failure.
+bool decodeImageMemory(const uint8_t* data, size_t size, DecodedImage& out);
+
+// Decode at 1/scale (scale 2, 4 or 8; anything else decodes at full size).
+// JPEGs are scaled in the IDCT by OpenCV, which skips most of the decoding
+// work; other formats, and stb_image, decode at full size.
+bool decodeImageScaled(const uint8_t* data, size_t size, int scale, DecodedImage& out);
+
+// Cheap low-resolution decode for hashing: decodeImageScaled at 1/8
+bool decodeImagePreview(const uint8_t* data, size_t size, DecodedImage& out);
+
+// Image dimensions from the JPEG/PNG/BMP header, without decoding pixels
+bool probeImageSize(const uint8_t* data, size_t size, int& width, int& height);
+
+#endif // IMAGE_DECODER_HPP
@@ -0,0 +1,51 @@
+#include "image_hash.hpp"
+
+#include <algorithm>
+
+namespace {
+
+constexpr int kHashCells = 9;     // 9x9 cells -> 8x8 neighbour pairs per direction
+
+// Samples per cell side; full-size decodes are subsampled to keep this cheap
+constexpr int kSamplesPerCell = 16;
+
+}  // namespace
+
+ImageHash differenceHash(const DecodedImage& image) {
+    const int channels = image.format == SourceFormat::BGRA ? 4 : 3;
+    float cells[kHashCells][kHashCells];
+
+    for (int cy = 0; cy < kHashCells; cy++) {
+        const int y0 = cy * image.height / kHashCells;
+        const int y1 = std::max(y0 + 1, (cy + 1) * image.height / kHashCells);
+        const int ystep = std::max(1, (y1 - y0) / kSamplesPerCell);
+
+        for (int cx = 0; cx < kHashCells; cx++) {
+            const int x0 = cx * image.width / kHashCells;
+            const int x1 = std::max(x0 + 1, (cx + 1) * image.width / kHashCells);
+            const int xstep = std::max(1, (x1 - x0) / kSamplesPerCell);
+
+            uint32_t sum = 0;
+            uint32_t count = 0;
+            for (int y = y0; y < y1 && y < image.height; y += ystep) {
+                const uint8_t* row = image.data + static_cast<size_t>(y) * image.stride;
+                for (int x = x0; x < x1 && x < image.width; x += xstep) {
+                    const uint8_t* p = row + x * channels;
+                    // Symmetric in the outer channels, so BGR and RGB hash alike
+                    sum += p[0] + 2 * p[1] + p[2];
+                    count++;
+                }
+            }
+            cells[cy][cx] = count > 0 ? static_cast<float>(sum) / count : 0.0f;
+        }
+    }
+
+    ImageHash hash;
+    for (int i = 0; i < kHashCells - 1; i++) {
+        for (int j = 0; j < kHashCells - 1; j++) {
+            hash.horizontal = (hash.horizontal << 1) | (cells[i][j] > cells[i][j + 1] ? 1u : 0u);
+            hash.vertical = (hash.vertical << 1) | (cells[j][i] > cells[j + 1][i] ? 1u : 0u);
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,26 @@
+#ifndef IMAGE_HASH_HPP
+#define IMAGE_HASH_HPP
+
+#include <cstdint>
+
+#include "image_decoder.hpp"
+
+// Difference hash (dHash) of a packed BGR/RGB image: the image is reduced to
+// 9x9 grayscale cell averages, and each bit records whether a cell is
+// brighter than its right (horizontal) or lower (vertical) neighbour.
+// Robust to scaling, recompression and small exposure changes, so burst
+// shots land a few bits apart. Using both directions keeps images with only
+// vertical or only horizontal structure from colliding.
+struct ImageHash {
+    uint64_t horizontal = 0;
+    uint64_t vertical = 0;
+};
+
+ImageHash differenceHash(const DecodedImage& image);
+
+// Number of differing bits (0-128)
+inline int hammingDistance(const ImageHash& a, const ImageHash& b) {
+    return __builtin_popcountll(a.horizontal ^ b.horizontal) + __builtin_popcountll(a.vertical ^ b.vertical);
+}
+
+#endif // IMAGE_HASH_HPP
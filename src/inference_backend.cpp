@@ -0,0 +1,347 @@
+#include "inference_backend.hpp"
+
+#include <fstream>
+#include <iterator>
+
+#include <onnxruntime/onnxruntime_cxx_api.h>
+#include <onnxruntime/onnxruntime_session_options_config_keys.h>
+
+#include "task_pool.hpp"
+
+#ifndef YOLO_USE_OPENCV
+#define YOLO_USE_OPENCV 1
+#endif
+
+// The OpenCV DNN backend needs the dnn module, which minimal OpenCV builds
+// leave out
+#if !defined(YOLO_HAVE_OPENCV_DNN) && YOLO_USE_OPENCV && defined(__has_include)
+#if __has_include(<opencv2/dnn.hpp>)
+#define YOLO_HAVE_OPENCV_DNN 1
+#endif
+#endif
+
+#ifndef YOLO_HAVE_OPENCV_DNN
+#define YOLO_HAVE_OPENCV_DNN 0
+#endif
+
+#if YOLO_HAVE_OPENCV_DNN
+#include <opencv2/core.hpp>
+#include <opencv2/dnn.hpp>
+#endif
+
+// Set to 1 to enable debug logging, 0 for production
+#define YOLO_DEBUG 0
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#include <onnxruntime/nnapi_provider_factory.h>
+#if YOLO_DEBUG
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, "YoloKit", __VA_ARGS__)
+#else
+#define LOGD(...) do {} while(0)
+#endif
+#elif defined(__APPLE__)
+#include <os/log.h>
+#include <onnxruntime/coreml_provider_factory.h>
+#if YOLO_DEBUG
+#define LOGD(...) os_log(OS_LOG_DEFAULT, __VA_ARGS__)
+#else
+#define LOGD(...) do {} while(0)
+#endif
+#else
+#define LOGD(...) do {} while(0)
+#endif
+
+namespace {
+
+size_t elementCount(const int64_t* shape, int rank) {
+    size_t count = 1;
+    for (int i = 0; i < rank; i++) {
+        count *= static_cast<size_t>(shape[i] > 0 ? shape[i] : 0);
+    }
+    return count;
+}
+
+// ---------------------------------------------------------------------------
+// ONNX Runtime
+
+class OrtBackend : public InferenceBackend {
+public:
+    explicit OrtBackend(const BackendOptions& options) : m_options(options) {}
+
+    const char* name() const override { return "onnxruntime"; }
+
+    bool load(const std::string& path, std::string& error) override {
+        try {
+            setUp();
+            return adopt(std::make_unique<Ort::Session>(*m_env, path.c_str(), *m_session_options), error);
+        } catch (const Ort::Exception& e) {
+            error = e.what();
+            return false;
+        }
+    }
+
+    bool loadFromMemory(const std::vector<uint8_t>& model, std::string& error) override {
+        try {
+            setUp();
+            return adopt(std::make_unique<Ort::Session>(*m_env, model.data(), model.size(), *m_session_options),
+                         error);
+        } catch (const Ort::Exception& e) {
+            error = e.what();
+            return false;
+        }
+    }
+
+    const ModelSignature& signature() const override { return m_signature; }
+
+    bool run(const std::vector<BackendInput>& inputs, const std::vector<std::string>& output_names,
+             BackendOutputs& outputs, std::string& error) override {
+        if (!m_session || inputs.size() != m_signature.inputs.size()) {
+            error = "No model loaded or wrong input count";
+            return false;
+        }
+
+        // Inputs are wrapped, not copied
+        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        std::vector<Ort::Value> input_values;
+        std::vector<const char*> input_names;
+        for (size_t i = 0; i < inputs.size(); i++) {
+            const BackendInput& input = inputs[i];
+            input_values.push_back(Ort::Value::CreateTensor<float>(
+                memory_info, const_cast<float*>(input.data), elementCount(input.shape, input.rank),
+                input.shape, static_cast<size_t>(input.rank)));
+            input_names.push_back(m_signature.inputs[i].name.c_str());
+        }
+        std::vector<const char*> names;
+        for (const auto& name : output_names) {
+            names.push_back(name.c_str());
+        }
+
+        try {
+            auto values = std::make_shared<std::vector<Ort::Value>>(m_session->Run(
+                m_run_options,
+                input_names.data(), input_values.data(), input_values.size(),
+                names.data(), names.size()));
+
+            // The values own their memory, so views outlive the session
+            outputs.tensors.resize(values->size());
+            for (size_t i = 0; i < values->size(); i++) {
+                auto info = (*values)[i].GetTensorTypeAndShapeInfo();
+                OutputTensor& tensor = outputs.tensors[i];
+                tensor.shape = info.GetShape();
+                tensor.count = info.GetElementCount();
+                tensor.data = info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT
+                              ? (*values)[i].GetTensorData<float>()
+                              : nullptr;
+            }
+            outputs.storage = std::move(values);
+        } catch (const Ort::Exception& e) {
+            error = e.what();
+            return false;
+        }
+        return true;
+    }
+
+    bool supportsCancel() const override { return true; }
+    void cancel() override { m_run_options.SetTerminate(); }
+    void clearCancel() override { m_run_options.UnsetTerminate(); }
+
+private:
+    BackendOptions m_options;
+    std::unique_ptr<Ort::Env> m_env;
+    std::unique_ptr<Ort::SessionOptions> m_session_options;
+    std::unique_ptr<Ort::Session> m_session;
+    Ort::RunOptions m_run_options;
+    ModelSignature m_signature;
+
+    void setUp() {
+        if (m_env) return;
+        m_env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "YoloKit");
+
+        m_session_options = std::make_unique<Ort::SessionOptions>();
+        m_session_options->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        m_session_options->SetIntraOpNumThreads(m_options.intra_op_threads > 0 ? m_options.intra_op_threads
+                                                                                : threadBudget());
+        if (!m_options.intra_op_affinities.empty()) {
+            m_session_options->AddConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities,
+                                              m_options.intra_op_affinities.c_str());
+        }
+        m_session_options->SetInterOpNumThreads(2);
+
+        // Enable hardware acceleration
+#ifdef __ANDROID__
+        LOGD("Attempting to enable NNAPI...");
+        uint32_t nnapi_flags = NNAPI_FLAG_USE_NONE;
+        OrtStatus* status = OrtSessionOptionsAppendExecutionProvider_Nnapi(*m_session_options, nnapi_flags);
+        if (status != nullptr) {
+            const char* error_msg = Ort::GetApi().GetErrorMessage(status);
+            LOGD("NNAPI failed: %s", error_msg);
+            Ort::GetApi().ReleaseStatus(status);
+        } else {
+            LOGD("NNAPI execution provider enabled");
+        }
+#elif defined(__APPLE__)
+        LOGD("Attempting to enable Core ML...");
+        uint32_t coreml_flags = 0;
+        OrtStatus* status = OrtSessionOptionsAppendExecutionProvider_CoreML(*m_session_options, coreml_flags);
+        if (status != nullptr) {
+            const char* error_msg = Ort::GetApi().GetErrorMessage(status);
+            LOGD("Core ML failed: %s", error_msg);
+            Ort::GetApi().ReleaseStatus(status);
+        } else {
+            LOGD("Core ML execution provider enabled");
+        }
+#endif
+    }
+
+    bool adopt(std::unique_ptr<Ort::Session> session, std::string& error) {
+        ModelSignature signature;
+        Ort::AllocatorWithDefaultOptions allocator;
+        for (size_t i = 0; i < session->GetInputCount(); i++) {
+            ModelTensorInfo info;
+            info.name = session->GetInputNameAllocated(i, allocator).get();
+            info.shape = session->GetInputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape();
+            signature.inputs.push_back(std::move(info));
+        }
+        for (size_t i = 0; i < session->GetOutputCount(); i++) {
+            ModelTensorInfo info;
+            info.name = session->GetOutputNameAllocated(i, allocator).get();
+            info.shape = session->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape();
+            signature.outputs.push_back(std::move(info));
+        }
+        if (signature.inputs.empty() || signature.outputs.empty()) {
+            error = "Model declares no inputs or outputs";
+            return false;
+        }
+        m_session = std::move(session);
+        m_signature = std::move(signature);
+        return true;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// OpenCV DNN
+
+#if YOLO_HAVE_OPENCV_DNN
+
+class OpenCvDnnBackend : public InferenceBackend {
+public:
+    explicit OpenCvDnnBackend(const BackendOptions& options) : m_options(options) {}
+
+    const char* name() const override { return "opencv-dnn"; }
+
+    bool load(const std::string& path, std::string& error) override {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<uint8_t> model((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (model.empty()) {
+            error = "Could not read " + path;
+            return false;
+        }
+        return loadFromMemory(model, error);
+    }
+
+    bool loadFromMemory(const std::vector<uint8_t>& model, std::string& error) override {
+        // cv::dnn reports no signature before a forward pass; read it from
+        // the model itself
+        ModelSignature signature;
+        if (!readModelSignature(model, signature, error)) {
+            return false;
+        }
+        try {
+            cv::dnn::Net net = cv::dnn::readNetFromONNX(reinterpret_cast<const char*>(model.data()), model.size());
+            if (net.empty()) {
+                error = "OpenCV could not import the model";
+                return false;
+            }
+            net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+            net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+
+            // cv::dnn runs on OpenCV's global thread pool: this sizes it for
+            // the whole process, not just this backend
+            cv::setNumThreads(m_options.intra_op_threads > 0 ? m_options.intra_op_threads : threadBudget());
+
+            m_net = net;
+            m_signature = std::move(signature);
+        } catch (const cv::Exception& e) {
+            error = e.what();
+            return false;
+        }
+        return true;
+    }
+
+    const ModelSignature& signature() const override { return m_signature; }
+
+    bool run(const std::vector<BackendInput>& inputs, const std::vector<std::string>& output_names,
+             BackendOutputs& outputs, std::string& error) override {
+        if (m_net.empty() || inputs.size() != m_signature.inputs.size()) {
+            error = "No model loaded or wrong input count";
+            return false;
+        }
+        try {
+            // Inputs are wrapped, not copied
+            for (size_t i = 0; i < inputs.size(); i++) {
+                const BackendInput& input = inputs[i];
+                std::vector<int> sizes(input.shape, input.shape + input.rank);
+                cv::Mat blob(input.rank, sizes.data(), CV_32F, const_cast<float*>(input.data));
+                m_net.setInput(blob, m_signature.inputs[i].name);
+            }
+
+            auto mats = std::make_shared<std::vector<cv::Mat>>();
+            std::vector<cv::String> names(output_names.begin(), output_names.end());
+            m_net.forward(*mats, names);
+
+            outputs.tensors.resize(mats->size());
+            for (size_t i = 0; i < mats->size(); i++) {
+                cv::Mat& mat = (*mats)[i];
+                if (mat.type() != CV_32F) {
+                    mat.convertTo(mat, CV_32F);
+                }
+                if (!mat.isContinuous()) {
+                    mat = mat.clone();
+                }
+                OutputTensor& tensor = outputs.tensors[i];
+                tensor.data = mat.ptr<float>();
+                tensor.shape.assign(mat.size.p, mat.size.p + mat.dims);
+                tensor.count = mat.total();
+            }
+            outputs.storage = std::move(mats);
+        } catch (const cv::Exception& e) {
+            error = e.what();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    BackendOptions m_options;
+    cv::dnn::Net m_net;
+    ModelSignature m_signature;
+};
+
+#endif  // YOLO_HAVE_OPENCV_DNN
+
+}  // namespace
+
+bool backendAvailable(BackendType type) {
+    switch (type) {
+        case BackendType::OnnxRuntime:
+            return true;
+        case BackendType::OpenCvDnn:
+            return YOLO_HAVE_OPENCV_DNN != 0;
+    }
+    return false;
+}
+
+std::unique_ptr<InferenceBackend> makeInferenceBackend(BackendType type, const BackendOptions& options) {
+    switch (type) {
+        case BackendType::OnnxRuntime:
+            return std::make_unique<OrtBackend>(options);
+        case BackendType::OpenCvDnn:
+#if YOLO_HAVE_OPENCV_DNN
+            return std::make_unique<OpenCvDnnBackend>(options);
+#else
+            return nullptr;
+#endif
+    }
+    return nullptr;
+}
@@ -0,0 +1,76 @@
+#ifndef INFERENCE_BACKEND_HPP
+#define INFERENCE_BACKEND_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "onnx_rewrite.hpp"
+#include "output_decoder.hpp"
+
+// Engines that can run the detector's .onnx model.
+//
+// OpenCV DNN runs on OpenCV's process-wide thread pool: loading a model calls
+// cv::setNumThreads, which applies to every cv:: call in the process (the
+// last model loaded wins). Its runs cannot be aborted, so a running
+// background request is not preempted.
+enum class BackendType {
+    OnnxRuntime = 0,    // default; NNAPI / Core ML execution providers on mobile
+    OpenCvDnn = 1       // cv::dnn on the CPU (needs OpenCV built with the dnn module)
+};
+
+// One float input tensor, used in place for the duration of a run
+struct BackendInput {
+    const float* data = nullptr;
+    const int64_t* shape = nullptr;
+    int rank = 0;
+};
+
+// Outputs of one run. The views stay valid as long as storage is held, also
+// after later runs and after the backend is gone.
+struct BackendOutputs {
+    std::vector<OutputTensor> tensors;
+    std::shared_ptr<void> storage;
+};
+
+struct BackendOptions {
+    int intra_op_threads = 0;           // 0 = thread budget
+    std::string intra_op_affinities;    // ONNX Runtime thread affinity string
+};
+
+// Inference stage of the detector: loads a model and runs it on float
+// tensors. Runs of one instance are serialized by the caller.
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() = default;
+
+    virtual const char* name() const = 0;
+
+    // Load a model file, or a serialized model (e.g. after a rewrite). On
+    // failure the previously loaded model, if any, is kept.
+    virtual bool load(const std::string& path, std::string& error) = 0;
+    virtual bool loadFromMemory(const std::vector<uint8_t>& model, std::string& error) = 0;
+
+    // Inputs and outputs of the loaded model
+    virtual const ModelSignature& signature() const = 0;
+
+    // Run with one input per signature input (same order) and fetch the
+    // named outputs, in that order
+    virtual bool run(const std::vector<BackendInput>& inputs, const std::vector<std::string>& output_names,
+                     BackendOutputs& outputs, std::string& error) = 0;
+
+    // Abort a run in progress from another thread, where the engine allows
+    // it (supportsCancel()). Stays in effect until clearCancel().
+    virtual bool supportsCancel() const { return false; }
+    virtual void cancel() {}
+    virtual void clearCancel() {}
+};
+
+// Whether the backend was compiled in
+bool backendAvailable(BackendType type);
+
+// New backend, or nullptr if it is not available
+std::unique_ptr<InferenceBackend> makeInferenceBackend(BackendType type, const BackendOptions& options);
+
+#endif // INFERENCE_BACKEND_HPP
@@ -0,0 +1,23 @@
+#include "json_escape.hpp"
+
+void writeJsonString(std::ostream& os, const std::string& s) {
+    static const char kHex[] = "0123456789abcdef";
+    os << '"';
+    for (char c : s) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        switch (c) {
+            case '"': os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n"; break;
+            case '\r': os << "\\r"; break;
+            case '\t': os << "\\t"; break;
+            default:
+                if (u < 0x20) {
+                    os << "\\u00" << kHex[u >> 4] << kHex[u & 0xF];
+                } else {
+                    os << c;
+                }
+        }
+    }
+    os << '"';
+}
@@ -0,0 +1,12 @@
+#ifndef JSON_ESCAPE_HPP
+#define JSON_ESCAPE_HPP
+
+#include <ostream>
+#include <string>
+
+// Write s as a quoted JSON string. Quotes and backslashes are escaped, \n,
+// \r and \t use their short forms and other bytes below 0x20 become \u00XX;
+// everything else (UTF-8 included) is copied as is.
+void writeJsonString(std::ostream& os, const std::string& s);
+
+#endif // JSON_ESCAPE_HPP
@@ -0,0 +1,45 @@
+#include "latest_result.hpp"
+
+LatestResult::LatestResult() {
+    // Room for a typical frame, so publishing rarely allocates
+    for (LatestFrame& slot : m_slots) {
+        slot.boxes.reserve(64);
+    }
+}
+
+void LatestResult::publish(const FrameTiming& timing, int width, int height,
+                           const std::vector<Detection>& detections) {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    LatestFrame& frame = m_slots[m_back];
+    frame.sequence = ++m_next_sequence;
+    frame.timing = timing;
+    frame.width = width;
+    frame.height = height;
+    frame.boxes.clear();
+    for (const Detection& d : detections) {
+        frame.boxes.push_back({d.class_id, d.confidence, d.x1, d.y1, d.x2, d.y2});
+    }
+
+    // Release: the slot's contents are visible to the reader that takes it
+    m_back = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel) & kIndexMask;
+    m_sequence.store(frame.sequence, std::memory_order_release);
+}
+
+const LatestFrame* LatestResult::acquire(int64_t last_sequence) {
+    if (m_reading.exchange(true, std::memory_order_acquire)) {
+        return nullptr;
+    }
+    if (m_middle.load(std::memory_order_relaxed) & kFresh) {
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndexMask;
+    }
+    const LatestFrame& frame = m_slots[m_front];
+    if (frame.sequence == 0 || frame.sequence == last_sequence) {
+        m_reading.store(false, std::memory_order_release);
+        return nullptr;
+    }
+    return &frame;
+}
+
+void LatestResult::release() {
+    m_reading.store(false, std::memory_order_release);
+}
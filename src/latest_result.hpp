@@ -0,0 +1,64 @@
+#ifndef LATEST_RESULT_HPP
+#define LATEST_RESULT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "detection.hpp"
+#include "detection_log.hpp"
+#include "frame_metrics.hpp"
+
+// One published frame
+struct LatestFrame {
+    int64_t sequence = 0;       // 0 = nothing published yet
+    FrameTiming timing;
+    int width = 0;
+    int height = 0;
+    std::vector<detection_log::Box> boxes;
+};
+
+// Newest detection result, for a UI that repaints faster than detection
+// runs and only ever wants the latest frame.
+//
+// Triple buffer: the writer fills its back slot and swaps it with the middle
+// slot (marking it fresh); a reader swaps a fresh middle slot with its front
+// slot and reads that, so neither ever waits for the other and a frame is
+// never torn. Writers (several replicas may publish) are serialized among
+// themselves; readers never take a lock. A second reader arriving while
+// another is reading sees no update rather than waiting.
+class LatestResult {
+public:
+    LatestResult();
+
+    // Copy a finished frame into the back slot and make it the latest
+    void publish(const FrameTiming& timing, int width, int height, const std::vector<Detection>& detections);
+
+    // Sequence of the newest published frame (0 = none); a single atomic load
+    int64_t sequence() const { return m_sequence.load(std::memory_order_acquire); }
+
+    // The newest frame if its sequence differs from last_sequence, else
+    // nullptr. A non-null frame stays unchanged until release().
+    const LatestFrame* acquire(int64_t last_sequence);
+    void release();
+
+private:
+    static constexpr uint32_t kIndexMask = 3;
+    static constexpr uint32_t kFresh = 4;
+
+    LatestFrame m_slots[3];
+    std::atomic<uint32_t> m_middle{1};      // slot index | kFresh when unread
+    std::atomic<int64_t> m_sequence{0};
+
+    // Writer side
+    std::mutex m_write_mutex;
+    uint32_t m_back = 0;
+    int64_t m_next_sequence = 0;
+
+    // Reader side
+    std::atomic<bool> m_reading{false};
+    uint32_t m_front = 2;
+};
+
+#endif // LATEST_RESULT_HPP
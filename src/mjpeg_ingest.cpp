@@ -0,0 +1,523 @@
+#include "mjpeg_ingest.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "frame_metrics.hpp"
+#include "simd.hpp"
+#include "task_pool.hpp"
+
+namespace {
+
+// Bytes requested per read(); buffers grow to hold a whole frame
+constexpr size_t kReadChunk = 256u << 10;
+
+// Longest a blocked read delays stop()
+constexpr int kPollMs = 100;
+
+// Index of the first 0xFF byte in [p, p + n), or n
+size_t findMarkerByte(const uint8_t* p, size_t n) {
+    size_t i = 0;
+#if defined(YOLO_SIMD_SSE2)
+    const __m128i ff = _mm_set1_epi8(static_cast<char>(0xFF));
+    for (; i + 16 <= n; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, ff));
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+#elif defined(YOLO_SIMD_NEON)
+    const uint8x16_t ff = vdupq_n_u8(0xFF);
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16_t eq = vceqq_u8(vld1q_u8(p + i), ff);
+        // Narrow each byte's compare result to 4 bits of a 64-bit mask
+        const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        if (mask != 0) return i + (__builtin_ctzll(mask) >> 2);
+    }
+#endif
+    const void* hit = std::memchr(p + i, 0xFF, n - i);
+    return hit != nullptr ? static_cast<size_t>(static_cast<const uint8_t*>(hit) - p) : n;
+}
+
+const char* scanBackend() {
+#if defined(YOLO_SIMD_SSE2)
+    return "sse2";
+#elif defined(YOLO_SIMD_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+// Markers without a length field
+bool standaloneMarker(uint8_t marker) {
+    return marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7);
+}
+
+// Scale a frame was actually decoded at: source size / decoded size. The
+// decoder may ignore the request (stb_image build, non-JPEG data).
+int appliedScale(const uint8_t* data, size_t size, int requested, const DecodedImage& image) {
+    int width = 0;
+    int height = 0;
+    if (requested <= 1 || image.width <= 0 || !probeImageSize(data, size, width, height)) {
+        return 1;
+    }
+    return std::max(1, static_cast<int>(std::lround(static_cast<double>(width) / image.width)));
+}
+
+}  // namespace
+
+MjpegIngest::MjpegIngest(int fd, const MjpegIngestOptions& options)
+    : m_options(options), m_fd(fd) {
+    start();
+}
+
+MjpegIngest::MjpegIngest(const std::string& path, const MjpegIngestOptions& options)
+    : m_options(options), m_path(path), m_owns_fd(true) {
+    start();
+}
+
+MjpegIngest::~MjpegIngest() {
+    stop();
+    if (m_owns_fd && m_fd >= 0) {
+        ::close(m_fd);
+    }
+}
+
+void MjpegIngest::start() {
+    if (m_options.decode_threads <= 0) {
+        m_options.decode_threads = threadBudget();
+    }
+    m_options.queue_depth = std::max(m_options.queue_depth, 0);
+    m_reader = std::thread(&MjpegIngest::readerLoop, this);
+    for (int i = 0; i < m_options.decode_threads; i++) {
+        m_decoders.emplace_back(&MjpegIngest::decoderLoop, this);
+    }
+}
+
+void MjpegIngest::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_reader.joinable()) {
+        m_reader.join();
+    }
+    for (std::thread& decoder : m_decoders) {
+        if (decoder.joinable()) {
+            decoder.join();
+        }
+    }
+}
+
+std::unique_ptr<MjpegIngest::Buffer> MjpegIngest::takeBuffer() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_free.empty()) {
+        return std::make_unique<Buffer>();
+    }
+    std::unique_ptr<Buffer> buffer = std::move(m_free.back());
+    m_free.pop_back();
+    buffer->size = 0;
+    return buffer;
+}
+
+bool MjpegIngest::dropOldestLocked() {
+    // A frame no decoder has started on costs nothing to drop
+    if (!m_encoded.empty()) {
+        Encoded oldest = std::move(m_encoded.front());
+        m_encoded.pop_front();
+        m_free.push_back(std::move(oldest.buffer));
+        m_decoded[oldest.index] = Decoded();
+        m_dropped++;
+        return true;
+    }
+    for (auto& entry : m_decoded) {
+        if (entry.second.ok) {
+            entry.second = Decoded();
+            m_undelivered--;
+            m_dropped++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void MjpegIngest::emit(std::unique_ptr<Buffer>& buffer, size_t begin, size_t end) {
+    // The frame keeps the buffer; the start of the next frame moves to a new one
+    std::unique_ptr<Buffer> next = takeBuffer();
+    const size_t tail = buffer->size - end;
+    if (next->capacity < tail + kReadChunk) {
+        next->capacity = std::max(buffer->capacity, tail + kReadChunk);
+        next->data.reset(new uint8_t[next->capacity]);
+    }
+    std::memcpy(next->data.get(), buffer->data.get() + end, tail);
+    next->size = tail;
+
+    Encoded frame;
+    frame.read_ts_ns = monotonicNowNs();
+    frame.buffer = std::move(buffer);
+    frame.offset = begin;
+    frame.size = end - begin;
+    buffer = std::move(next);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const int capacity = m_options.decode_threads + m_options.queue_depth;
+    const int64_t stall_begin_ns = frame.read_ts_ns;
+    bool stalled = false;
+    while (!m_stop &&
+           static_cast<int>(m_encoded.size()) + m_decoding + m_undelivered >= capacity) {
+        if (m_options.drop_late && dropOldestLocked()) {
+            continue;
+        }
+        stalled = true;
+        m_cv.wait(lock);
+    }
+    if (stalled) {
+        m_stall_ms += (monotonicNowNs() - stall_begin_ns) / 1e6;
+    }
+    if (m_stop) {
+        m_free.push_back(std::move(frame.buffer));
+        return;
+    }
+    frame.index = m_frames++;
+    m_encoded.push_back(std::move(frame));
+    lock.unlock();
+    m_cv.notify_all();
+}
+
+void MjpegIngest::readerLoop() {
+    int error = 0;
+    if (!m_path.empty()) {
+        // Opened non-blocking so a FIFO without a writer does not block
+        // stop(); reads then block in poll()
+        m_fd = ::open(m_path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (m_fd < 0) {
+            error = errno;
+        } else {
+            ::fcntl(m_fd, F_SETFL, ::fcntl(m_fd, F_GETFL) & ~O_NONBLOCK);
+        }
+    } else if (m_fd < 0) {
+        error = EBADF;
+    }
+
+    std::unique_ptr<Buffer> buffer = takeBuffer();
+    ScanState state = ScanState::FindSoi;
+    size_t pos = 0;             // next byte to scan
+    size_t frame_begin = 0;     // SOI of the frame being split
+    size_t garbage_begin = 0;   // bytes from here to an SOI belong to no frame
+    uint64_t skipped = 0;
+    int64_t corrupt = 0;
+    int64_t oversize = 0;
+
+    while (error == 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_skipped_bytes += skipped;
+            m_corrupt += corrupt;
+            m_oversize += oversize;
+            if (m_stop) break;
+        }
+        skipped = 0;
+        corrupt = 0;
+        oversize = 0;
+
+        if (buffer->capacity - buffer->size < kReadChunk) {
+            const size_t capacity = std::max(buffer->capacity * 2, buffer->size + kReadChunk);
+            std::unique_ptr<uint8_t[]> grown(new uint8_t[capacity]);
+            std::memcpy(grown.get(), buffer->data.get(), buffer->size);
+            buffer->data = std::move(grown);
+            buffer->capacity = capacity;
+        }
+
+        pollfd pfd = {m_fd, POLLIN, 0};
+        const int ready = ::poll(&pfd, 1, kPollMs);
+        if (ready < 0 && errno != EINTR) {
+            error = errno;
+            break;
+        }
+        if (ready <= 0) continue;
+
+        const ssize_t n = ::read(m_fd, buffer->data.get() + buffer->size, buffer->capacity - buffer->size);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            error = errno;
+            break;
+        }
+        if (n == 0) break;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_first_read_ns == 0) m_first_read_ns = monotonicNowNs();
+            m_bytes_read += static_cast<uint64_t>(n);
+        }
+        buffer->size += static_cast<size_t>(n);
+
+        // Split every frame completed by this read
+        bool more = true;
+        while (more) {
+            const uint8_t* data = buffer->data.get();
+            const size_t size = buffer->size;
+
+            switch (state) {
+                case ScanState::FindSoi: {
+                    const size_t i = pos + findMarkerByte(data + pos, size - pos);
+                    if (i + 1 >= size) {
+                        pos = i;
+                        more = false;
+                    } else if (data[i + 1] == 0xD8) {
+                        skipped += i - garbage_begin;
+                        frame_begin = i;
+                        pos = i + 2;
+                        state = ScanState::Header;
+                    } else {
+                        pos = i + 1;
+                    }
+                    break;
+                }
+
+                // Marker segments before the scan data are skipped by length
+                case ScanState::Header: {
+                    if (pos + 2 > size) {
+                        more = false;
+                        break;
+                    }
+                    const uint8_t marker = data[pos + 1];
+                    if (data[pos] != 0xFF) {
+                        corrupt++;
+                        state = ScanState::FindSoi;
+                        garbage_begin = pos;
+                    } else if (marker == 0xFF) {
+                        pos++;      // fill byte
+                    } else if (marker == 0xD9) {
+                        emit(buffer, frame_begin, pos + 2);
+                        state = ScanState::FindSoi;
+                        pos = frame_begin = garbage_begin = 0;
+                    } else if (marker == 0xD8) {
+                        corrupt++;  // truncated frame, a new one starts here
+                        frame_begin = pos;
+                        pos += 2;
+                    } else if (standaloneMarker(marker)) {
+                        pos += 2;
+                    } else if (pos + 4 > size) {
+                        more = false;
+                    } else {
+                        const size_t length = (static_cast<size_t>(data[pos + 2]) << 8) | data[pos + 3];
+                        if (length < 2) {
+                            corrupt++;
+                            state = ScanState::FindSoi;
+                            garbage_begin = pos;
+                        } else {
+                            pos += 2 + length;
+                            if (marker == 0xDA) state = ScanState::Entropy;
+                        }
+                    }
+                    break;
+                }
+
+                // Entropy-coded data: 0xFF is followed by a stuffed 0x00, a
+                // restart marker, EOI, or (progressive JPEGs) another segment
+                case ScanState::Entropy: {
+                    if (pos >= size) {
+                        more = false;
+                        break;
+                    }
+                    const size_t i = pos + findMarkerByte(data + pos, size - pos);
+                    if (i + 1 >= size) {
+                        pos = i;
+                        more = false;
+                        break;
+                    }
+                    const uint8_t marker = data[i + 1];
+                    if (marker == 0x00 || (marker >= 0xD0 && marker <= 0xD7)) {
+                        pos = i + 2;
+                    } else if (marker == 0xFF) {
+                        pos = i + 1;
+                    } else if (marker == 0xD9) {
+                        emit(buffer, frame_begin, i + 2);
+                        state = ScanState::FindSoi;
+                        pos = frame_begin = garbage_begin = 0;
+                    } else if (marker == 0xD8) {
+                        corrupt++;
+                        frame_begin = i;
+                        pos = i + 2;
+                        state = ScanState::Header;
+                    } else {
+                        pos = i;
+                        state = ScanState::Header;
+                    }
+                    break;
+                }
+            }
+        }
+
+        if (state != ScanState::FindSoi && buffer->size - frame_begin > m_options.max_frame_bytes) {
+            oversize++;
+            state = ScanState::FindSoi;
+            pos = garbage_begin = buffer->size;
+        }
+
+        // Drop bytes that can no longer be part of a frame
+        size_t discard = frame_begin;
+        if (state == ScanState::FindSoi) {
+            skipped += pos - garbage_begin;
+            discard = pos;
+            garbage_begin = pos;
+        }
+        if (discard > 0) {
+            std::memmove(buffer->data.get(), buffer->data.get() + discard, buffer->size - discard);
+            buffer->size -= discard;
+            pos -= discard;
+            garbage_begin -= std::min(garbage_begin, discard);
+            frame_begin = 0;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_skipped_bytes += skipped;
+        m_corrupt += corrupt + (state != ScanState::FindSoi ? 1 : 0);
+        m_oversize += oversize;
+        m_error = error;
+        m_reader_end_ns = monotonicNowNs();
+        m_reader_done = true;
+        m_free.push_back(std::move(buffer));
+    }
+    m_cv.notify_all();
+}
+
+int MjpegIngest::scaleFor(const uint8_t* data, size_t size) const {
+    const int scale = m_options.decode_scale;
+    if (scale == 2 || scale == 4 || scale == 8) {
+        return scale;
+    }
+    // Auto scale needs a minimum size to keep; without one, decode full size
+    if (scale != 0 || m_options.min_width <= 0 || m_options.min_height <= 0) {
+        return 1;
+    }
+    int width = 0;
+    int height = 0;
+    if (!probeImageSize(data, size, width, height)) {
+        return 1;
+    }
+    for (int candidate = 8; candidate > 1; candidate /= 2) {
+        // The IDCT rounds scaled sizes up
+        if ((width + candidate - 1) / candidate >= m_options.min_width &&
+            (height + candidate - 1) / candidate >= m_options.min_height) {
+            return candidate;
+        }
+    }
+    return 1;
+}
+
+void MjpegIngest::decoderLoop() {
+    for (;;) {
+        Encoded job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [&] { return m_stop || !m_encoded.empty() || m_reader_done; });
+            if (m_stop || m_encoded.empty()) return;
+            job = std::move(m_encoded.front());
+            m_encoded.pop_front();
+            m_decoding++;
+        }
+
+        const uint8_t* jpeg = job.buffer->data.get() + job.offset;
+        Decoded decoded;
+        decoded.frame.index = job.index;
+        decoded.frame.read_ts_ns = job.read_ts_ns;
+        decoded.frame.bytes = job.size;
+        const int requested = scaleFor(jpeg, job.size);
+        const int64_t begin_ns = monotonicNowNs();
+        decoded.ok = decodeImageScaled(jpeg, job.size, requested, decoded.frame.image);
+        const double decode_ms = (monotonicNowNs() - begin_ns) / 1e6;
+        decoded.frame.scale = decoded.ok ? appliedScale(jpeg, job.size, requested, decoded.frame.image) : 1;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_decoding--;
+            m_free.push_back(std::move(job.buffer));
+            m_decode_ms += decode_ms;
+            m_decoded_count++;
+            if (decoded.ok) {
+                m_last_scale = decoded.frame.scale;
+                m_undelivered++;
+            } else {
+                m_corrupt++;
+            }
+            m_decoded[job.index] = std::move(decoded);
+        }
+        m_cv.notify_all();
+    }
+}
+
+bool MjpegIngest::next(MjpegFrame& frame) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const int64_t begin_ns = monotonicNowNs();
+    for (;;) {
+        if (m_stop) return false;
+
+        auto it = m_decoded.find(m_next_deliver);
+        if (it != m_decoded.end()) {
+            Decoded decoded = std::move(it->second);
+            m_decoded.erase(it);
+            m_next_deliver++;
+            if (!decoded.ok) continue;
+
+            m_undelivered--;
+            m_delivered++;
+            m_last_deliver_ns = monotonicNowNs();
+            m_wait_ms += (m_last_deliver_ns - begin_ns) / 1e6;
+            lock.unlock();
+            m_cv.notify_all();
+            frame = std::move(decoded.frame);
+            return true;
+        }
+        if (m_reader_done && m_next_deliver >= m_frames) {
+            return false;
+        }
+        m_cv.wait(lock);
+    }
+}
+
+std::string MjpegIngest::statsJson() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const int64_t end_ns = m_reader_done ? m_reader_end_ns : monotonicNowNs();
+    const double elapsed_s = m_first_read_ns > 0 ? (end_ns - m_first_read_ns) / 1e9 : 0.0;
+    const double deliver_s = m_first_read_ns > 0 ? (m_last_deliver_ns - m_first_read_ns) / 1e9 : 0.0;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "{\"frames\":" << m_frames
+        << ",\"delivered\":" << m_delivered
+        << ",\"dropped\":" << m_dropped
+        << ",\"corrupt\":" << m_corrupt
+        << ",\"oversize\":" << m_oversize
+        << ",\"skipped_bytes\":" << m_skipped_bytes
+        << ",\"bytes_read\":" << m_bytes_read
+        << ",\"decode_threads\":" << m_options.decode_threads
+        << ",\"decode_scale\":" << m_last_scale
+        << ",\"scan\":\"" << scanBackend() << "\""
+        << ",\"decode_ms\":" << m_decode_ms
+        << ",\"mean_decode_ms\":" << (m_decoded_count > 0 ? m_decode_ms / m_decoded_count : 0.0)
+        << ",\"consumer_wait_ms\":" << m_wait_ms
+        << ",\"reader_stall_ms\":" << m_stall_ms
+        << ",\"elapsed_s\":" << elapsed_s
+        << ",\"source_fps\":" << (elapsed_s > 0.0 ? m_frames / elapsed_s : 0.0)
+        << ",\"delivered_fps\":" << (deliver_s > 0.0 ? m_delivered / deliver_s : 0.0)
+        << ",\"eof\":" << (m_reader_done ? "true" : "false")
+        << ",\"error\":";
+    if (m_error != 0) {
+        oss << "\"" << std::strerror(m_error) << "\"";
+    } else {
+        oss << "null";
+    }
+    oss << "}";
+    return oss.str();
+}
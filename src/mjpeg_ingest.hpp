@@ -0,0 +1,161 @@
+#ifndef MJPEG_INGEST_HPP
+#define MJPEG_INGEST_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "image_decoder.hpp"
+
+struct MjpegIngestOptions {
+    // Parallel JPEG decoders (<= 0 = threadBudget())
+    int decode_threads = 0;
+
+    // IDCT scale: 1, 2, 4 or 8, or 0 for the largest scale that keeps the
+    // frame at least min_width x min_height (e.g. the model input size);
+    // 0 without a minimum size decodes at full size
+    int decode_scale = 1;
+    int min_width = 0;
+    int min_height = 0;
+
+    // Decoded frames buffered ahead of the consumer, on top of one per decoder
+    int queue_depth = 4;
+
+    // Live sources: when the consumer falls behind, drop the oldest frame not
+    // yet delivered instead of pausing reads (which stalls a pipe's writer)
+    bool drop_late = false;
+
+    // Frames larger than this are discarded and the stream resynchronized
+    size_t max_frame_bytes = 32u << 20;
+};
+
+// One frame delivered by MjpegIngest::next()
+struct MjpegFrame {
+    int64_t index = 0;          // position in the stream (dropped frames leave gaps)
+    int64_t read_ts_ns = 0;     // when its last byte was read (monotonic clock)
+    size_t bytes = 0;           // JPEG size
+    int scale = 1;              // scale it was decoded at (1 if the decoder cannot scale)
+    DecodedImage image;
+};
+
+// Reads an MJPEG byte stream (concatenated JPEGs, e.g. ffmpeg -f mjpeg or
+// image2pipe, an MJPEG camera socket) from a file descriptor and delivers
+// decoded frames in stream order.
+//
+//   reader thread  ->  decoder threads  ->  next()
+//
+// The reader splits frames by walking the JPEG marker segments and scanning
+// entropy-coded data for 0xFF bytes 16 at a time (SSE2 / NEON), so every
+// byte is looked at once; the bytes read stay in pooled buffers that are
+// handed to a decoder whole, with only the start of the following frame
+// copied. Decoders work on several frames at once at a reduced IDCT scale;
+// frames are reordered before delivery. Frames in flight are bounded, so a
+// slow consumer either pauses reading or, with drop_late, drops frames.
+class MjpegIngest {
+public:
+    // Read from fd, which stays open and owned by the caller
+    MjpegIngest(int fd, const MjpegIngestOptions& options = MjpegIngestOptions());
+
+    // Open path (file, FIFO, character device) on the reader thread, so a
+    // FIFO without a writer yet does not block the caller
+    MjpegIngest(const std::string& path, const MjpegIngestOptions& options = MjpegIngestOptions());
+
+    ~MjpegIngest();
+
+    MjpegIngest(const MjpegIngest&) = delete;
+    MjpegIngest& operator=(const MjpegIngest&) = delete;
+
+    // Next decoded frame in stream order. Blocks until it is ready; returns
+    // false at the end of the stream or after stop(). Frames that fail to
+    // decode are skipped.
+    bool next(MjpegFrame& frame);
+
+    // Stop reading and decoding; wakes a blocked next()
+    void stop();
+
+    // {"frames","delivered","dropped","corrupt","oversize","skipped_bytes",
+    //  "bytes_read","decode_threads","decode_scale","scan","decode_ms",
+    //  "mean_decode_ms","consumer_wait_ms","reader_stall_ms","elapsed_s",
+    //  "source_fps","delivered_fps","eof","error"}
+    // source_fps counts every frame split from the stream; delivered_fps the
+    // ones handed to next(). consumer_wait_ms is time next() waited for a
+    // decode, reader_stall_ms time reading paused on a slow consumer.
+    std::string statsJson() const;
+
+private:
+    struct Buffer {
+        std::unique_ptr<uint8_t[]> data;
+        size_t capacity = 0;
+        size_t size = 0;
+    };
+
+    struct Encoded {
+        int64_t index = 0;
+        int64_t read_ts_ns = 0;
+        std::unique_ptr<Buffer> buffer;
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    struct Decoded {
+        bool ok = false;        // false: dropped or failed, skipped by next()
+        MjpegFrame frame;
+    };
+
+    enum class ScanState { FindSoi, Header, Entropy };
+
+    MjpegIngestOptions m_options;
+    std::string m_path;
+    int m_fd = -1;
+    bool m_owns_fd = false;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<std::unique_ptr<Buffer>> m_free;
+    std::deque<Encoded> m_encoded;              // waiting for a decoder
+    std::map<int64_t, Decoded> m_decoded;       // reorder buffer, by index
+    int m_decoding = 0;
+    int m_undelivered = 0;                      // decoded frames in m_decoded
+    int64_t m_next_deliver = 0;
+    bool m_reader_done = false;
+    bool m_stop = false;
+
+    // Stats (under m_mutex)
+    int64_t m_frames = 0;
+    int64_t m_delivered = 0;
+    int64_t m_dropped = 0;
+    int64_t m_corrupt = 0;
+    int64_t m_oversize = 0;
+    uint64_t m_skipped_bytes = 0;
+    uint64_t m_bytes_read = 0;
+    double m_decode_ms = 0.0;
+    int64_t m_decoded_count = 0;
+    double m_wait_ms = 0.0;
+    double m_stall_ms = 0.0;
+    int64_t m_first_read_ns = 0;
+    int64_t m_reader_end_ns = 0;
+    int64_t m_last_deliver_ns = 0;
+    int m_last_scale = 1;
+    int m_error = 0;                            // errno of a failed open / read
+
+    std::thread m_reader;
+    std::vector<std::thread> m_decoders;
+
+    void start();
+    std::unique_ptr<Buffer> takeBuffer();
+    bool dropOldestLocked();
+    void emit(std::unique_ptr<Buffer>& buffer, size_t begin, size_t end);
+
+    void readerLoop();
+    void decoderLoop();
+    int scaleFor(const uint8_t* data, size_t size) const;
+};
+
+#endif // MJPEG_INGEST_HPP
@@ -0,0 +1,106 @@
+#include "numa_replicas.hpp"
+#include "task_pool.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+// ORT affinity string for the intra-op threads after the calling thread:
+// one core each, 1-based logical processor ids ("2;3;4")
+std::string intraOpAffinities(const std::vector<int>& cpus, int threads) {
+    std::ostringstream oss;
+    for (int i = 1; i < threads; i++) {
+        if (i > 1) oss << ";";
+        oss << cpus[i % cpus.size()] + 1;
+    }
+    return oss.str();
+}
+
+}  // namespace
+
+bool NumaReplicaSet::init(const std::string& model_path,
+                          const std::function<void(YoloDetector&)>& configure) {
+    m_replicas.clear();
+
+    std::vector<NumaNode> nodes = numaNodes();
+    m_numa = nodes.size() > 1;
+    if (!m_numa) {
+        // Single node or no topology: one plain detector
+        nodes.assign(1, NumaNode());
+    }
+
+    for (const NumaNode& node : nodes) {
+        auto replica = std::make_unique<Replica>();
+        replica->node = node;
+        replica->detector = std::make_unique<YoloDetector>();
+        if (m_numa) {
+            int threads = std::min(threadBudget(), static_cast<int>(node.cpus.size()));
+            replica->detector->setIntraOpThreads(threads, intraOpAffinities(node.cpus, threads));
+        }
+        if (configure) {
+            configure(*replica->detector);
+        }
+        m_replicas.push_back(std::move(replica));
+    }
+
+    // Load every session on a thread pinned to its node (first-touch placement)
+    std::vector<char> ok(m_replicas.size(), 0);
+    std::vector<std::thread> loaders;
+    for (size_t i = 0; i < m_replicas.size(); i++) {
+        loaders.emplace_back([this, i, &ok, &model_path]() {
+            Replica& replica = *m_replicas[i];
+            ScopedThreadAffinity pin(m_numa ? replica.node.cpus : std::vector<int>());
+            ok[i] = replica.detector->init(model_path) ? 1 : 0;
+        });
+    }
+    for (auto& loader : loaders) {
+        loader.join();
+    }
+
+    if (std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+        m_replicas.clear();
+        return false;
+    }
+    return true;
+}
+
+NumaReplicaSet::Replica& NumaReplicaSet::acquireLeastLoaded() {
+    const size_t n = m_replicas.size();
+    const size_t start = m_next.fetch_add(1) % n;
+    Replica* best = m_replicas[start].get();
+    for (size_t i = 1; i < n; i++) {
+        Replica* candidate = m_replicas[(start + i) % n].get();
+        if (candidate->in_flight.load() < best->in_flight.load()) {
+            best = candidate;
+        }
+    }
+    best->in_flight.fetch_add(1);
+    return *best;
+}
+
+std::string NumaReplicaSet::schedulerStatsJson() const {
+    SchedulerStats stats = m_replicas.front()->detector->schedulerStats();
+    for (size_t i = 1; i < m_replicas.size(); i++) {
+        stats.merge(m_replicas[i]->detector->schedulerStats());
+    }
+    return stats.json();
+}
+
+std::string NumaReplicaSet::infoJson() const {
+    std::ostringstream oss;
+    oss << "{\"numa\":" << (m_numa ? "true" : "false") << ",\"replicas\":[";
+    for (size_t i = 0; i < m_replicas.size(); i++) {
+        const Replica& replica = *m_replicas[i];
+        if (i > 0) oss << ",";
+        oss << "{\"node\":" << (m_numa ? replica.node.id : -1)
+            << ",\"cpus\":\"" << formatCpuList(replica.node.cpus) << "\""
+            << ",\"in_flight\":" << replica.in_flight.load()
+            << ",\"served\":" << replica.served.load()
+            << ",\"scheduler\":" << replica.detector->schedulerStatsJson()
+            << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
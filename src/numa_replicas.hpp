@@ -0,0 +1,76 @@
+#ifndef NUMA_REPLICAS_HPP
+#define NUMA_REPLICAS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "numa_topology.hpp"
+#include "yolo_detector.hpp"
+
+// Server mode for multi-socket machines: one detector (ONNX Runtime session)
+// per NUMA node.
+//
+// Each session is created on a thread pinned to its node, so weights and
+// prepacked buffers are first-touched in local memory, and its intra-op
+// threads are pinned to the node's cores. Requests go to the replica with the
+// fewest requests in flight and run with the calling thread pinned to that
+// node. Without NUMA topology this is a single unpinned detector.
+class NumaReplicaSet {
+public:
+    // Create the replicas; configure (optional) runs on each detector before
+    // its session loads. Returns false if any session fails to load.
+    bool init(const std::string& model_path,
+              const std::function<void(YoloDetector&)>& configure = nullptr);
+
+    size_t size() const { return m_replicas.size(); }
+    bool isNuma() const { return m_numa; }
+
+    // Replica used for settings queries (class names, configuration)
+    YoloDetector& primary() { return *m_replicas.front()->detector; }
+
+    // Run fn(detector) on the least-loaded replica
+    template <typename Fn>
+    auto route(Fn&& fn) -> decltype(fn(std::declval<YoloDetector&>())) {
+        Replica& replica = acquireLeastLoaded();
+        ScopedThreadAffinity pin(m_numa ? replica.node.cpus : std::vector<int>());
+        auto result = fn(*replica.detector);
+        replica.in_flight.fetch_sub(1);
+        replica.served.fetch_add(1);
+        return result;
+    }
+
+    // Apply fn(detector) to every replica
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (auto& replica : m_replicas) {
+            fn(*replica->detector);
+        }
+    }
+
+    // Nodes, CPUs, in-flight and served requests per replica as JSON
+    std::string infoJson() const;
+
+    // Scheduler stats of all replicas combined, in the single-detector schema
+    std::string schedulerStatsJson() const;
+
+private:
+    struct Replica {
+        NumaNode node;
+        std::unique_ptr<YoloDetector> detector;
+        std::atomic<int> in_flight{0};
+        std::atomic<uint64_t> served{0};
+    };
+
+    std::vector<std::unique_ptr<Replica>> m_replicas;
+    std::atomic<unsigned> m_next{0};    // rotates the starting point so ties spread out
+    bool m_numa = false;
+
+    Replica& acquireLeastLoaded();
+};
+
+#endif // NUMA_REPLICAS_HPP
@@ -0,0 +1,112 @@
+#include "numa_topology.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || item == "\n") continue;
+        size_t dash = item.find('-');
+        int first = atoi(item.c_str());
+        int last = dash == std::string::npos ? first : atoi(item.c_str() + dash + 1);
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::ostringstream oss;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) j++;
+        if (i > 0) oss << ",";
+        oss << cpus[i];
+        if (j > i) oss << "-" << cpus[j];
+        i = j + 1;
+    }
+    return oss.str();
+}
+
+#if defined(__linux__)
+
+std::vector<NumaNode> numaNodes() {
+    std::vector<NumaNode> nodes;
+    const char* root = "/sys/devices/system/node";
+    DIR* dir = opendir(root);
+    if (dir == nullptr) return nodes;
+
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+            name.find_first_not_of("0123456789", 4) != std::string::npos) {
+            continue;
+        }
+        std::ifstream file(std::string(root) + "/" + name + "/cpulist");
+        std::string list;
+        if (!file || !std::getline(file, list)) continue;
+
+        NumaNode node;
+        node.id = atoi(name.c_str() + 4);
+        node.cpus = parseCpuList(list);
+        if (!node.cpus.empty()) {
+            nodes.push_back(node);
+        }
+    }
+    closedir(dir);
+
+    std::sort(nodes.begin(), nodes.end(),
+              [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return nodes;
+}
+
+ScopedThreadAffinity::ScopedThreadAffinity(const std::vector<int>& cpus) {
+    if (cpus.empty()) return;
+
+    cpu_set_t current;
+    CPU_ZERO(&current);
+    if (sched_getaffinity(0, sizeof(current), &current) != 0) return;
+
+    cpu_set_t wanted;
+    CPU_ZERO(&wanted);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &wanted);
+    }
+    if (sched_setaffinity(0, sizeof(wanted), &wanted) != 0) return;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &current)) m_saved.push_back(cpu);
+    }
+    m_applied = true;
+}
+
+ScopedThreadAffinity::~ScopedThreadAffinity() {
+    if (!m_applied) return;
+    cpu_set_t saved;
+    CPU_ZERO(&saved);
+    for (int cpu : m_saved) CPU_SET(cpu, &saved);
+    sched_setaffinity(0, sizeof(saved), &saved);
+}
+
+#else
+
+std::vector<NumaNode> numaNodes() {
+    return {};
+}
+
+ScopedThreadAffinity::ScopedThreadAffinity(const std::vector<int>&) {}
+
+ScopedThreadAffinity::~ScopedThreadAffinity() {}
+
+#endif
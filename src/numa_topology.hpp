@@ -0,0 +1,41 @@
+#ifndef NUMA_TOPOLOGY_HPP
+#define NUMA_TOPOLOGY_HPP
+
+#include <string>
+#include <vector>
+
+// One NUMA node and the logical CPUs attached to it
+struct NumaNode {
+    int id = 0;
+    std::vector<int> cpus;
+};
+
+// NUMA nodes with at least one online CPU, from /sys/devices/system/node on
+// Linux. Empty when the topology is unavailable (other platforms, containers
+// without sysfs), which callers treat as a single node.
+std::vector<NumaNode> numaNodes();
+
+// Parse a sysfs CPU list such as "0-3,8-11"
+std::vector<int> parseCpuList(const std::string& list);
+
+// Format CPUs as a sysfs style list ("0-3,8-11")
+std::string formatCpuList(const std::vector<int>& cpus);
+
+// Pin the calling thread to a set of CPUs for the lifetime of this object and
+// restore its previous affinity afterwards. No-op where unsupported.
+class ScopedThreadAffinity {
+public:
+    explicit ScopedThreadAffinity(const std::vector<int>& cpus);
+    ~ScopedThreadAffinity();
+
+    ScopedThreadAffinity(const ScopedThreadAffinity&) = delete;
+    ScopedThreadAffinity& operator=(const ScopedThreadAffinity&) = delete;
+
+    bool applied() const { return m_applied; }
+
+private:
+    bool m_applied = false;
+    std::vector<int> m_saved;
+};
+
+#endif // NUMA_TOPOLOGY_HPP
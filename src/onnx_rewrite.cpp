@@ -0,0 +1,418 @@
+#include "onnx_rewrite.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Field numbers of the ONNX messages involved (onnx.proto)
+constexpr uint32_t kModelGraph = 7;
+constexpr uint32_t kGraphNode = 1;
+constexpr uint32_t kGraphInitializer = 5;
+constexpr uint32_t kGraphInput = 11;
+constexpr uint32_t kGraphOutput = 12;
+constexpr uint32_t kValueInfoName = 1;
+constexpr uint32_t kValueInfoType = 2;
+constexpr uint32_t kTypeTensor = 1;
+constexpr uint32_t kTypeTensorShape = 2;
+constexpr uint32_t kShapeDim = 1;
+constexpr uint32_t kDimValue = 1;
+constexpr uint32_t kNodeInput = 1;
+constexpr uint32_t kNodeOpType = 4;
+constexpr uint32_t kNodeAttribute = 5;
+constexpr uint32_t kAttributeName = 1;
+constexpr uint32_t kAttributeInt = 3;
+constexpr uint32_t kTensorDims = 1;
+constexpr uint32_t kTensorDataType = 2;
+constexpr uint32_t kTensorFloatData = 4;
+constexpr uint32_t kTensorName = 8;
+constexpr uint32_t kTensorRawData = 9;
+constexpr uint32_t kTensorDataLocation = 14;
+
+constexpr uint64_t kDataTypeFloat = 1;
+constexpr uint64_t kDataLocationExternal = 1;
+
+enum WireType : uint8_t { kVarint = 0, kFixed64 = 1, kBytes = 2, kFixed32 = 5 };
+
+// One top-level field of a serialized message
+struct Field {
+    uint32_t number = 0;
+    uint8_t wire = 0;
+    const uint8_t* begin = nullptr;     // key
+    const uint8_t* end = nullptr;       // one past the value
+    const uint8_t* data = nullptr;      // length-delimited payload
+    size_t size = 0;
+    uint64_t value = 0;                 // varint value
+
+    std::string str() const { return std::string(reinterpret_cast<const char*>(data), size); }
+};
+
+bool readVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool parseFields(const uint8_t* p, size_t n, std::vector<Field>& fields) {
+    const uint8_t* end = p + n;
+    fields.clear();
+    while (p < end) {
+        Field f;
+        f.begin = p;
+        uint64_t key;
+        if (!readVarint(p, end, key)) return false;
+        f.number = static_cast<uint32_t>(key >> 3);
+        f.wire = static_cast<uint8_t>(key & 7);
+        switch (f.wire) {
+            case kVarint:
+                if (!readVarint(p, end, f.value)) return false;
+                break;
+            case kFixed64:
+                if (end - p < 8) return false;
+                p += 8;
+                break;
+            case kFixed32:
+                if (end - p < 4) return false;
+                p += 4;
+                break;
+            case kBytes: {
+                uint64_t len;
+                if (!readVarint(p, end, len) || len > static_cast<uint64_t>(end - p)) return false;
+                f.data = p;
+                f.size = static_cast<size_t>(len);
+                p += len;
+                break;
+            }
+            default:
+                return false;   // groups are not used by onnx.proto
+        }
+        f.end = p;
+        fields.push_back(f);
+    }
+    return true;
+}
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void putBytesField(std::vector<uint8_t>& out, uint32_t number, const uint8_t* data, size_t size) {
+    putVarint(out, (static_cast<uint64_t>(number) << 3) | kBytes);
+    putVarint(out, size);
+    out.insert(out.end(), data, data + size);
+}
+
+// Copy of a message with the field at index replaced by new payload bytes
+std::vector<uint8_t> replaceField(const uint8_t* msg, size_t size, const std::vector<Field>& fields,
+                                  size_t index, const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> out;
+    out.reserve(size + payload.size() - fields[index].size + 8);
+    out.insert(out.end(), msg, fields[index].begin);
+    putBytesField(out, fields[index].number, payload.data(), payload.size());
+    out.insert(out.end(), fields[index].end, msg + size);
+    return out;
+}
+
+struct Node {
+    size_t field;                       // index in the graph's fields
+    std::string op_type;
+    std::vector<std::string> inputs;
+    int64_t group = 1;
+};
+
+bool parseNode(const Field& field, Node& node) {
+    std::vector<Field> fields;
+    if (!parseFields(field.data, field.size, fields)) return false;
+    std::vector<Field> attr;
+    for (const Field& f : fields) {
+        if (f.wire != kBytes) continue;
+        if (f.number == kNodeInput) {
+            node.inputs.push_back(f.str());
+        } else if (f.number == kNodeOpType) {
+            node.op_type = f.str();
+        } else if (f.number == kNodeAttribute && parseFields(f.data, f.size, attr)) {
+            bool is_group = false;
+            int64_t value = 1;
+            for (const Field& a : attr) {
+                if (a.number == kAttributeName && a.wire == kBytes) is_group = a.str() == "group";
+                if (a.number == kAttributeInt && a.wire == kVarint) value = static_cast<int64_t>(a.value);
+            }
+            if (is_group) node.group = value;
+        }
+    }
+    return true;
+}
+
+// Re-encode a float [M, 3, kH, kW] weight tensor with the fold applied.
+// Every field except the data is kept; data is written as raw_data.
+bool foldWeights(const Field& tensor, const InputFold& fold, std::vector<uint8_t>& out, std::string& error) {
+    std::vector<Field> fields;
+    if (!parseFields(tensor.data, tensor.size, fields)) {
+        error = "Malformed weight tensor";
+        return false;
+    }
+
+    std::vector<int64_t> dims;
+    uint64_t data_type = 0;
+    std::vector<float> values;
+    for (const Field& f : fields) {
+        if (f.number == kTensorDims) {
+            if (f.wire == kVarint) {
+                dims.push_back(static_cast<int64_t>(f.value));
+            } else if (f.wire == kBytes) {
+                const uint8_t* p = f.data;
+                uint64_t v;
+                while (p < f.data + f.size && readVarint(p, f.data + f.size, v)) {
+                    dims.push_back(static_cast<int64_t>(v));
+                }
+            }
+        } else if (f.number == kTensorDataType && f.wire == kVarint) {
+            data_type = f.value;
+        } else if (f.number == kTensorDataLocation && f.wire == kVarint && f.value == kDataLocationExternal) {
+            error = "Weights are stored as external data";
+            return false;
+        } else if ((f.number == kTensorRawData || f.number == kTensorFloatData) && f.wire == kBytes) {
+            size_t at = values.size();
+            values.resize(at + f.size / sizeof(float));
+            memcpy(values.data() + at, f.data, (f.size / sizeof(float)) * sizeof(float));
+        } else if (f.number == kTensorFloatData && f.wire == kFixed32) {
+            float v;
+            memcpy(&v, f.begin + (f.end - f.begin - 4), sizeof(float));
+            values.push_back(v);
+        }
+    }
+
+    if (data_type != kDataTypeFloat) {
+        error = "First convolution weights are not float32";
+        return false;
+    }
+    if (dims.size() != 4 || dims[1] != 3) {
+        error = "First convolution does not take 3 channels";
+        return false;
+    }
+    const size_t kernel = static_cast<size_t>(dims[2] * dims[3]);
+    const size_t filters = static_cast<size_t>(dims[0]);
+    if (kernel == 0 || values.size() != filters * 3 * kernel) {
+        error = "Weight tensor size does not match its shape";
+        return false;
+    }
+
+    for (size_t m = 0; m < filters; m++) {
+        float* filter = values.data() + m * 3 * kernel;
+        if (fold.swap_rb) {
+            std::swap_ranges(filter, filter + kernel, filter + 2 * kernel);
+        }
+        for (size_t i = 0; i < 3 * kernel; i++) {
+            filter[i] *= fold.scale;
+        }
+    }
+
+    out.clear();
+    for (const Field& f : fields) {
+        if (f.number == kTensorRawData || f.number == kTensorFloatData) continue;
+        out.insert(out.end(), f.begin, f.end);
+    }
+    putBytesField(out, kTensorRawData, reinterpret_cast<const uint8_t*>(values.data()),
+                  values.size() * sizeof(float));
+    return true;
+}
+
+// Nested length-delimited field of a message, if present
+bool findMessage(const uint8_t* data, size_t size, uint32_t number, Field& found) {
+    std::vector<Field> fields;
+    if (!parseFields(data, size, fields)) return false;
+    for (const Field& f : fields) {
+        if (f.number == number && f.wire == kBytes) {
+            found = f;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ValueInfoProto: name and tensor shape (dimensions without a value are -1)
+bool parseValueInfo(const Field& field, ModelTensorInfo& info) {
+    std::vector<Field> fields;
+    if (!parseFields(field.data, field.size, fields)) return false;
+    for (const Field& f : fields) {
+        if (f.wire != kBytes) continue;
+        if (f.number == kValueInfoName) {
+            info.name = f.str();
+        } else if (f.number == kValueInfoType) {
+            Field tensor;
+            Field shape;
+            if (!findMessage(f.data, f.size, kTypeTensor, tensor) ||
+                !findMessage(tensor.data, tensor.size, kTypeTensorShape, shape)) {
+                continue;
+            }
+            std::vector<Field> dims;
+            if (!parseFields(shape.data, shape.size, dims)) return false;
+            for (const Field& dim : dims) {
+                if (dim.number != kShapeDim || dim.wire != kBytes) continue;
+                int64_t value = -1;
+                std::vector<Field> dim_fields;
+                if (parseFields(dim.data, dim.size, dim_fields)) {
+                    for (const Field& d : dim_fields) {
+                        if (d.number == kDimValue && d.wire == kVarint) value = static_cast<int64_t>(d.value);
+                    }
+                }
+                info.shape.push_back(value);
+            }
+        }
+    }
+    return !info.name.empty();
+}
+
+}  // namespace
+
+bool readModelSignature(const std::vector<uint8_t>& model, ModelSignature& signature, std::string& error) {
+    signature = ModelSignature();
+    Field graph;
+    if (!findMessage(model.data(), model.size(), kModelGraph, graph)) {
+        error = "Not a serialized ONNX model";
+        return false;
+    }
+    std::vector<Field> graph_fields;
+    if (!parseFields(graph.data, graph.size, graph_fields)) {
+        error = "Malformed graph";
+        return false;
+    }
+
+    // Older exports also list initializers as graph inputs
+    std::vector<std::string> initializers;
+    std::vector<Field> tensor_fields;
+    for (const Field& f : graph_fields) {
+        if (f.number != kGraphInitializer || f.wire != kBytes) continue;
+        if (!parseFields(f.data, f.size, tensor_fields)) continue;
+        for (const Field& t : tensor_fields) {
+            if (t.number == kTensorName && t.wire == kBytes) initializers.push_back(t.str());
+        }
+    }
+
+    for (const Field& f : graph_fields) {
+        if ((f.number != kGraphInput && f.number != kGraphOutput) || f.wire != kBytes) continue;
+        ModelTensorInfo info;
+        if (!parseValueInfo(f, info)) {
+            error = "Malformed graph input or output";
+            return false;
+        }
+        if (f.number == kGraphOutput) {
+            signature.outputs.push_back(std::move(info));
+        } else if (std::find(initializers.begin(), initializers.end(), info.name) == initializers.end()) {
+            signature.inputs.push_back(std::move(info));
+        }
+    }
+    if (signature.inputs.empty() || signature.outputs.empty()) {
+        error = "Model declares no inputs or outputs";
+        return false;
+    }
+    return true;
+}
+
+bool foldInputNormalization(const std::vector<uint8_t>& model,
+                            const std::string& input_name,
+                            const InputFold& fold,
+                            std::vector<uint8_t>& out,
+                            std::string& error) {
+    std::vector<Field> model_fields;
+    if (!parseFields(model.data(), model.size(), model_fields)) {
+        error = "Not a serialized ONNX model";
+        return false;
+    }
+    size_t graph_index = model_fields.size();
+    for (size_t i = 0; i < model_fields.size(); i++) {
+        if (model_fields[i].number == kModelGraph && model_fields[i].wire == kBytes) graph_index = i;
+    }
+    if (graph_index == model_fields.size()) {
+        error = "Model has no graph";
+        return false;
+    }
+    const Field& graph = model_fields[graph_index];
+
+    std::vector<Field> graph_fields;
+    if (!parseFields(graph.data, graph.size, graph_fields)) {
+        error = "Malformed graph";
+        return false;
+    }
+
+    // The image input must feed exactly one node: a plain Conv
+    std::vector<Node> nodes;
+    for (size_t i = 0; i < graph_fields.size(); i++) {
+        if (graph_fields[i].number != kGraphNode || graph_fields[i].wire != kBytes) continue;
+        Node node;
+        node.field = i;
+        if (!parseNode(graph_fields[i], node)) {
+            error = "Malformed node";
+            return false;
+        }
+        nodes.push_back(std::move(node));
+    }
+
+    const Node* conv = nullptr;
+    int consumers = 0;
+    for (const Node& node : nodes) {
+        for (const std::string& in : node.inputs) {
+            if (in == input_name) {
+                consumers++;
+                conv = &node;
+                break;
+            }
+        }
+    }
+    if (consumers != 1 || conv->op_type != "Conv" || conv->inputs.size() < 2 ||
+        conv->inputs[0] != input_name) {
+        error = "Input does not feed a single Conv";
+        return false;
+    }
+    if (conv->group != 1) {
+        error = "First convolution is grouped";
+        return false;
+    }
+
+    // The weights must belong to this Conv alone
+    const std::string& weight_name = conv->inputs[1];
+    for (const Node& node : nodes) {
+        if (&node == conv) continue;
+        for (const std::string& in : node.inputs) {
+            if (in == weight_name) {
+                error = "First convolution weights are shared";
+                return false;
+            }
+        }
+    }
+
+    size_t weight_index = graph_fields.size();
+    std::vector<Field> tensor_fields;
+    for (size_t i = 0; i < graph_fields.size() && weight_index == graph_fields.size(); i++) {
+        const Field& f = graph_fields[i];
+        if (f.number != kGraphInitializer || f.wire != kBytes) continue;
+        if (!parseFields(f.data, f.size, tensor_fields)) continue;
+        for (const Field& t : tensor_fields) {
+            if (t.number == kTensorName && t.wire == kBytes && t.str() == weight_name) {
+                weight_index = i;
+                break;
+            }
+        }
+    }
+    if (weight_index == graph_fields.size()) {
+        error = "First convolution weights are not an initializer";
+        return false;
+    }
+
+    std::vector<uint8_t> tensor;
+    if (!foldWeights(graph_fields[weight_index], fold, tensor, error)) {
+        return false;
+    }
+
+    std::vector<uint8_t> new_graph = replaceField(graph.data, graph.size, graph_fields, weight_index, tensor);
+    out = replaceField(model.data(), model.size(), model_fields, graph_index, new_graph);
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef ONNX_REWRITE_HPP
+#define ONNX_REWRITE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Load-time rewrite of a serialized ONNX model that absorbs input
+// normalization into the first convolution.
+//
+// A YOLOv8 / PP-YOLOE model expects RGB scaled to [0, 1]. When the image
+// input feeds exactly one Conv (group 1, float weights [M, 3, kH, kW] stored
+// in the model), multiplying those weights by scale and swapping their first
+// and last input channels gives the same outputs for raw BGR 0-255 input:
+// the convolution is linear, and its zero padding is unaffected by scaling.
+// Only that weight initializer is re-encoded; every other protobuf field is
+// copied byte for byte, so no ONNX or protobuf library is needed.
+struct InputFold {
+    float scale = 1.0f / 255.0f;    // multiplier the model expects on 0-255 input
+    bool swap_rb = true;            // model expects RGB, input will be BGR
+};
+
+// Rewrite model into out. Returns false (out untouched) if the graph does not
+// have the required shape; error then says why.
+bool foldInputNormalization(const std::vector<uint8_t>& model,
+                            const std::string& input_name,
+                            const InputFold& fold,
+                            std::vector<uint8_t>& out,
+                            std::string& error);
+
+// Name and shape (-1 = dynamic) of a graph input or output
+struct ModelTensorInfo {
+    std::string name;
+    std::vector<int64_t> shape;
+};
+
+// Graph inputs (initializers excluded) and outputs in declaration order
+struct ModelSignature {
+    std::vector<ModelTensorInfo> inputs;
+    std::vector<ModelTensorInfo> outputs;
+};
+
+// Read the signature of a serialized model without loading it, for
+// backends that do not report it themselves
+bool readModelSignature(const std::vector<uint8_t>& model, ModelSignature& signature, std::string& error);
+
+#endif // ONNX_REWRITE_HPP
@@ -0,0 +1,279 @@
+#include "output_decoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// The two meaningful dimensions of a merged output: [d1, d2], [1, d1, d2],
+// or the element count of a 1D output
+bool outputDims(const OutputTensor& output, int64_t& dim1, int64_t& dim2) {
+    if (output.data == nullptr) return false;
+    if (output.shape.size() == 2) {
+        dim1 = output.shape[0];
+        dim2 = output.shape[1];
+    } else if (output.shape.size() >= 3) {
+        dim1 = output.shape[1];
+        dim2 = output.shape[2];
+    } else if (output.shape.size() == 1) {
+        dim1 = static_cast<int64_t>(output.count);
+        dim2 = 0;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// PP-YOLOE: [N, 6], [1, N, 6] or [1, 6, N] rows of
+// (class_id, score, x1, y1, x2, y2), already decoded and suppressed
+class PpyoloeDecoder : public OutputDecoder {
+public:
+    void decode(const std::vector<OutputTensor>& outputs, const CandidateFilter& filter,
+                std::vector<HeadBox>& out) override {
+        if (outputs.empty()) return;
+        const OutputTensor& output = outputs[0];
+        int64_t dim1 = 0, dim2 = 0;
+        if (!outputDims(output, dim1, dim2)) return;
+
+        int64_t num_detections;
+        if (dim2 == 6 && dim1 > 0) {
+            num_detections = dim1;
+        } else if (dim1 == 6 && dim2 > 0) {
+            num_detections = dim2;
+        } else {
+            num_detections = static_cast<int64_t>(output.count / 6);
+        }
+        num_detections = std::min(num_detections, static_cast<int64_t>(output.count / 6));
+
+        // Rows are read row-major whatever the reported layout
+        for (int64_t i = 0; i < num_detections; i++) {
+            const float* row = output.data + i * 6;
+            const int class_id = static_cast<int>(row[0]);
+            const float score = row[1];
+            if (score < filter.conf_threshold) continue;
+            if (class_id < 0) continue;
+            if (!filter.allows(class_id)) continue;
+
+            out.push_back({class_id, score, row[2], row[3], row[4], row[5]});
+            if (filter.first_hit) return;
+        }
+    }
+
+    bool suppressed() const override { return true; }
+};
+
+// YOLOX: [1, N, 5 + nc] of raw (dx, dy, log w, log h), objectness, class
+// scores over the stride 8 / 16 / 32 grids. The grid is laid out once for
+// the model's input size.
+class YoloxDecoder : public OutputDecoder {
+public:
+    YoloxDecoder(int input_width, int input_height) {
+        for (int stride : {8, 16, 32}) {
+            const int grid_w = input_width / stride;
+            const int grid_h = input_height / stride;
+            for (int gy = 0; gy < grid_h; gy++) {
+                for (int gx = 0; gx < grid_w; gx++) {
+                    m_grid.push_back({static_cast<float>(gx), static_cast<float>(gy), static_cast<float>(stride)});
+                }
+            }
+        }
+    }
+
+    void decode(const std::vector<OutputTensor>& outputs, const CandidateFilter& filter,
+                std::vector<HeadBox>& out) override {
+        if (outputs.empty()) return;
+        const OutputTensor& output = outputs[0];
+        int64_t dim1 = 0, dim2 = 0;
+        if (!outputDims(output, dim1, dim2) || dim2 <= 5) return;
+
+        const int features = static_cast<int>(dim2);
+        const int num_classes = features - 5;
+        const int64_t num_boxes = std::min({dim1, static_cast<int64_t>(m_grid.size()),
+                                            static_cast<int64_t>(output.count / features)});
+
+        for (int64_t i = 0; i < num_boxes; i++) {
+            const float* box = output.data + i * features;
+
+            // Early filter by objectness
+            const float objectness = box[4];
+            if (objectness < filter.conf_threshold) continue;
+
+            float max_class_score = 0.0f;
+            int max_class = 0;
+            const float* class_scores = box + 5;
+            for (int c = 0; c < num_classes; c++) {
+                if (class_scores[c] > max_class_score) {
+                    max_class_score = class_scores[c];
+                    max_class = c;
+                }
+            }
+
+            const float confidence = objectness * max_class_score;
+            if (confidence < filter.conf_threshold) continue;
+            if (!filter.allows(max_class)) continue;
+
+            const GridCell& cell = m_grid[i];
+            const float cx = (box[0] + cell.x) * cell.stride;
+            const float cy = (box[1] + cell.y) * cell.stride;
+            const float w = std::exp(box[2]) * cell.stride;
+            const float h = std::exp(box[3]) * cell.stride;
+
+            out.push_back({max_class, confidence, cx - w / 2.0f, cy - h / 2.0f, cx + w / 2.0f, cy + h / 2.0f});
+            if (filter.first_hit) return;
+        }
+    }
+
+private:
+    struct GridCell {
+        float x;
+        float y;
+        float stride;
+    };
+    std::vector<GridCell> m_grid;
+};
+
+// YOLOv8/v11: [1, 4 + nc, N] (channel-major) or [1, N, 4 + nc] of decoded
+// (cx, cy, w, h) and class scores, no objectness
+class DenseDecoder : public OutputDecoder {
+public:
+    void decode(const std::vector<OutputTensor>& outputs, const CandidateFilter& filter,
+                std::vector<HeadBox>& out) override {
+        if (outputs.empty()) return;
+        const OutputTensor& output = outputs[0];
+        int64_t dim1 = 0, dim2 = 0;
+        if (!outputDims(output, dim1, dim2)) return;
+
+        const bool transposed = dim1 > dim2;    // [1, num_boxes, features]
+        const int64_t num_boxes = transposed ? dim1 : dim2;
+        const int64_t features = transposed ? dim2 : dim1;
+        if (num_boxes <= 0 || features <= 4 || static_cast<size_t>(num_boxes * features) > output.count) return;
+
+        if (transposed) {
+            decodeRows(output.data, num_boxes, features, filter, out);
+        } else {
+            decodePlanes(output.data, num_boxes, features, filter, out);
+        }
+    }
+
+private:
+    // Per-box best class over the class planes, reused across frames
+    std::vector<float> m_best_score;
+    std::vector<int> m_best_class;
+
+    static bool emit(float cx, float cy, float w, float h, int class_id, float score,
+                     const CandidateFilter& filter, std::vector<HeadBox>& out) {
+        out.push_back({class_id, score, cx - w / 2.0f, cy - h / 2.0f, cx + w / 2.0f, cy + h / 2.0f});
+        return filter.first_hit;
+    }
+
+    void decodeRows(const float* output, int64_t num_boxes, int64_t features, const CandidateFilter& filter,
+                    std::vector<HeadBox>& out) {
+        const int64_t num_classes = features - 4;
+        for (int64_t i = 0; i < num_boxes; i++) {
+            const float* box = output + i * features;
+            float max_score = 0.0f;
+            int max_class = 0;
+            for (int64_t c = 0; c < num_classes; c++) {
+                if (box[4 + c] > max_score) {
+                    max_score = box[4 + c];
+                    max_class = static_cast<int>(c);
+                }
+            }
+            if (max_score < filter.conf_threshold) continue;
+            if (!filter.allows(max_class)) continue;
+            if (emit(box[0], box[1], box[2], box[3], max_class, max_score, filter, out)) return;
+        }
+    }
+
+    // One sequential pass per class plane instead of a strided walk over
+    // every class for every box
+    void decodePlanes(const float* output, int64_t num_boxes, int64_t features, const CandidateFilter& filter,
+                      std::vector<HeadBox>& out) {
+        const size_t n = static_cast<size_t>(num_boxes);
+        m_best_score.assign(n, 0.0f);
+        m_best_class.assign(n, 0);
+        for (int64_t c = 0; c < features - 4; c++) {
+            const float* plane = output + (4 + c) * num_boxes;
+            for (size_t i = 0; i < n; i++) {
+                if (plane[i] > m_best_score[i]) {
+                    m_best_score[i] = plane[i];
+                    m_best_class[i] = static_cast<int>(c);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            if (m_best_score[i] < filter.conf_threshold) continue;
+            if (!filter.allows(m_best_class[i])) continue;
+            if (emit(output[i], output[n + i], output[2 * n + i], output[3 * n + i],
+                     m_best_class[i], m_best_score[i], filter, out)) {
+                return;
+            }
+        }
+    }
+};
+
+// Raw per-stride heads, decoded in place by HeadDecoder
+class HeadsDecoder : public OutputDecoder {
+public:
+    HeadsDecoder(HeadLayout layout, int input_height) : m_layout(layout), m_input_height(input_height) {}
+
+    void decode(const std::vector<OutputTensor>& outputs, const CandidateFilter& filter,
+                std::vector<HeadBox>& out) override {
+        const size_t first_box = out.size();
+        for (const OutputTensor& output : outputs) {
+            if (output.data == nullptr || output.shape.size() != 4 || output.shape[2] <= 0 || output.shape[3] <= 0) {
+                continue;
+            }
+
+            HeadTensor head;
+            head.data = output.data;
+            head.channels = static_cast<int>(output.shape[1]);
+            head.height = static_cast<int>(output.shape[2]);
+            head.width = static_cast<int>(output.shape[3]);
+            head.stride = m_input_height / head.height;
+
+            const size_t first = out.size();
+            m_decoder.decode(head, m_layout, filter.conf_threshold, out);
+
+            // Presence: stop at the first head with an allowed candidate
+            if (filter.first_hit) {
+                auto hit = std::find_if(out.begin() + first, out.end(),
+                                        [&](const HeadBox& box) { return filter.allows(box.class_id); });
+                if (hit != out.end()) {
+                    HeadBox box = *hit;
+                    out.resize(first_box);
+                    out.push_back(box);
+                    return;
+                }
+                out.resize(first);
+            }
+        }
+
+        out.erase(std::remove_if(out.begin() + first_box, out.end(),
+                                 [&](const HeadBox& box) { return !filter.allows(box.class_id); }),
+                  out.end());
+    }
+
+private:
+    HeadLayout m_layout;
+    int m_input_height;
+    HeadDecoder m_decoder;
+};
+
+}  // namespace
+
+std::unique_ptr<OutputDecoder> makeOutputDecoder(ModelType type, int input_width, int input_height) {
+    switch (type) {
+        case ModelType::PPYOLOE:
+            return std::make_unique<PpyoloeDecoder>();
+        case ModelType::YOLOX:
+            return std::make_unique<YoloxDecoder>(input_width, input_height);
+        default:
+            return std::make_unique<DenseDecoder>();
+    }
+}
+
+std::unique_ptr<OutputDecoder> makeHeadsDecoder(HeadLayout layout, int input_height) {
+    return std::make_unique<HeadsDecoder>(layout, input_height);
+}
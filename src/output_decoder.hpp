@@ -0,0 +1,70 @@
+#ifndef OUTPUT_DECODER_HPP
+#define OUTPUT_DECODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "head_decoder.hpp"
+
+// Model type for different output formats
+enum class ModelType {
+    YOLOV8,     // [1, 84, 8400] - no objectness
+    YOLOX,      // [1, 8400, 85] - has objectness
+    PPYOLOE     // [1, N, 6] - already decoded with NMS
+};
+
+// One model output as the decoding stage sees it, independent of the
+// inference backend that produced it
+struct OutputTensor {
+    const float* data = nullptr;
+    std::vector<int64_t> shape;
+    size_t count = 0;
+};
+
+// Model output coordinates to frame coordinates: x = (x_out - pad_x) / scale_x
+struct BoxMapping {
+    float scale_x = 1.0f;
+    float scale_y = 1.0f;
+    float pad_x = 0.0f;
+    float pad_y = 0.0f;
+};
+
+// Which candidates a decoder keeps
+struct CandidateFilter {
+    float conf_threshold = 0.25f;
+    const std::vector<bool>* allowed = nullptr;     // indexed by class id; null or empty = every class
+    bool first_hit = false;                         // stop at the first kept candidate (presence)
+
+    bool allows(int class_id) const {
+        return allowed == nullptr || allowed->empty() ||
+               (class_id >= 0 && class_id < static_cast<int>(allowed->size()) && (*allowed)[class_id]);
+    }
+};
+
+// Decoding stage: raw output tensors to candidate boxes in the model's
+// output coordinates (HeadBox). Mapping back to the frame, NMS and class
+// names are left to the caller. One decoder per model format is picked when
+// the model is loaded, so the per-candidate loops carry no format branches.
+// Decoders keep scratch buffers: one instance per thread.
+class OutputDecoder {
+public:
+    virtual ~OutputDecoder() = default;
+
+    // Append the candidates passing filter
+    virtual void decode(const std::vector<OutputTensor>& outputs, const CandidateFilter& filter,
+                        std::vector<HeadBox>& out) = 0;
+
+    // Whether the model output already went through NMS
+    virtual bool suppressed() const { return false; }
+};
+
+// Decoder for a merged output ([1, 84, N] / [1, N, 84], [1, N, 85] or
+// PP-YOLOE [N, 6]) of a model with the given input size
+std::unique_ptr<OutputDecoder> makeOutputDecoder(ModelType type, int input_width, int input_height);
+
+// Decoder for raw per-stride heads [1, C, H, W]
+std::unique_ptr<OutputDecoder> makeHeadsDecoder(HeadLayout layout, int input_height);
+
+#endif // OUTPUT_DECODER_HPP
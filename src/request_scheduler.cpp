@@ -0,0 +1,221 @@
+#include "request_scheduler.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+RequestScheduler::Lease::Lease(Lease&& other) noexcept
+    : m_scheduler(other.m_scheduler), m_status(other.m_status) {
+    other.m_scheduler = nullptr;
+}
+
+RequestScheduler::Lease::~Lease() {
+    if (m_scheduler != nullptr && m_status == AdmitStatus::Granted) {
+        m_scheduler->release();
+    }
+}
+
+RequestScheduler::Lease RequestScheduler::acquire(RequestPriority priority) {
+    const int cls = static_cast<int>(priority);
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Idle detector: queues are always drained before it goes idle
+    if (!m_busy) {
+        m_busy = true;
+        m_active_priority = priority;
+        m_active_cancel = false;
+        m_cancel_explicit = false;
+        m_stats[cls].admitted++;
+        return Lease(this, AdmitStatus::Granted);
+    }
+
+    // Admission control
+    auto& queue = m_queues[cls];
+    const size_t limit = static_cast<size_t>(m_config.max_queued[cls] > 0 ? m_config.max_queued[cls] : 0);
+    if (queue.size() >= limit) {
+        if (priority != RequestPriority::Realtime || queue.empty()) {
+            m_stats[cls].rejected++;
+            return Lease(this, AdmitStatus::Rejected);
+        }
+        // Newest realtime frame wins: shed the oldest queued one
+        Waiter* oldest = queue.front();
+        queue.pop_front();
+        oldest->status = AdmitStatus::Shed;
+        oldest->pending = false;
+        m_stats[cls].shed++;
+        m_cv.notify_all();
+    }
+
+    if (priority != RequestPriority::Background && m_busy &&
+        m_active_priority == RequestPriority::Background && m_config.preempt_background) {
+        requestCancelLocked();
+    }
+
+    Waiter self{AdmitStatus::Granted, true};
+    queue.push_back(&self);
+    m_cv.wait(lock, [&]() { return !self.pending; });
+
+    if (self.status == AdmitStatus::Granted) {
+        m_stats[cls].admitted++;
+    }
+    return Lease(this, self.status);
+}
+
+void RequestScheduler::release() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_busy = false;
+    m_active_cancel = false;
+    m_cancel_explicit = false;
+    grantNextLocked();
+}
+
+// Hand the detector to the oldest waiter of the highest non-empty class
+void RequestScheduler::grantNextLocked() {
+    for (int c = 0; c < kPriorityCount; c++) {
+        if (m_queues[c].empty()) continue;
+        Waiter* next = m_queues[c].front();
+        m_queues[c].pop_front();
+        next->status = AdmitStatus::Granted;
+        next->pending = false;
+        m_busy = true;
+        m_active_priority = static_cast<RequestPriority>(c);
+        m_active_cancel = false;
+        m_cancel_explicit = false;
+        m_cv.notify_all();
+        return;
+    }
+}
+
+void RequestScheduler::requestCancelLocked() {
+    if (m_active_cancel || !m_preemption_supported) return;
+    m_active_cancel = true;
+    if (m_cancel_handler) {
+        m_cancel_handler();
+    }
+}
+
+void RequestScheduler::setCancelHandler(std::function<void()> handler) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cancel_handler = std::move(handler);
+}
+
+void RequestScheduler::setPreemptionSupported(bool supported) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_preemption_supported = supported;
+}
+
+void RequestScheduler::setConfig(const SchedulerConfig& config) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+}
+
+SchedulerConfig RequestScheduler::config() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+bool RequestScheduler::cancelRequested() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_active_cancel;
+}
+
+int RequestScheduler::cancelBackground() {
+    const int cls = static_cast<int>(RequestPriority::Background);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_background_cancels++;
+    int affected = 0;
+    for (Waiter* waiter : m_queues[cls]) {
+        waiter->status = AdmitStatus::Cancelled;
+        waiter->pending = false;
+        m_stats[cls].cancelled++;
+        affected++;
+    }
+    m_queues[cls].clear();
+    if (affected > 0) {
+        m_cv.notify_all();
+    }
+
+    if (m_busy && m_active_priority == RequestPriority::Background && m_preemption_supported) {
+        if (!m_active_cancel) {
+            requestCancelLocked();
+            affected++;
+        }
+        // Also when already being preempted: it must not be retried
+        m_cancel_explicit = true;
+    }
+    return affected;
+}
+
+uint64_t RequestScheduler::backgroundCancels() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_background_cancels;
+}
+
+bool RequestScheduler::noteStopped(RequestPriority priority) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ClassStats& stats = m_stats[static_cast<int>(priority)];
+    if (m_cancel_explicit) {
+        stats.cancelled++;
+        return true;
+    }
+    stats.preempted++;
+    return false;
+}
+
+SchedulerStats RequestScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    SchedulerStats stats;
+    stats.busy = m_busy;
+    stats.preemption_supported = m_preemption_supported;
+    for (int c = 0; c < kPriorityCount; c++) {
+        const ClassStats& s = m_stats[c];
+        SchedulerStats::Class& out = stats.classes[c];
+        out.queued = m_queues[c].size();
+        out.max_queued = m_config.max_queued[c];
+        out.admitted = s.admitted;
+        out.rejected = s.rejected;
+        out.shed = s.shed;
+        out.cancelled = s.cancelled;
+        out.preempted = s.preempted;
+    }
+    return stats;
+}
+
+void SchedulerStats::merge(const SchedulerStats& other) {
+    busy = busy || other.busy;
+    preemption_supported = preemption_supported && other.preemption_supported;
+    for (int c = 0; c < kPriorityCount; c++) {
+        Class& into = classes[c];
+        const Class& from = other.classes[c];
+        into.queued += from.queued;
+        into.max_queued = std::max(into.max_queued, from.max_queued);
+        into.admitted += from.admitted;
+        into.rejected += from.rejected;
+        into.shed += from.shed;
+        into.cancelled += from.cancelled;
+        into.preempted += from.preempted;
+    }
+}
+
+std::string SchedulerStats::json() const {
+    static const char* kNames[kPriorityCount] = {"realtime", "interactive", "background"};
+
+    std::ostringstream oss;
+    oss << "{\"busy\":" << (busy ? "true" : "false")
+        << ",\"preemption_supported\":" << (preemption_supported ? "true" : "false");
+    for (int c = 0; c < kPriorityCount; c++) {
+        const Class& s = classes[c];
+        oss << ",\"" << kNames[c] << "\":{"
+            << "\"queued\":" << s.queued << ","
+            << "\"max_queued\":" << s.max_queued << ","
+            << "\"admitted\":" << s.admitted << ","
+            << "\"rejected\":" << s.rejected << ","
+            << "\"shed\":" << s.shed << ","
+            << "\"cancelled\":" << s.cancelled << ","
+            << "\"preempted\":" << s.preempted
+            << "}";
+    }
+    oss << "}";
+    return oss.str();
+}
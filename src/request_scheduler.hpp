@@ -0,0 +1,159 @@
+#ifndef REQUEST_SCHEDULER_HPP
+#define REQUEST_SCHEDULER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// Priority classes, highest first
+enum class RequestPriority {
+    Realtime = 0,       // camera frames: only the newest queued frame matters
+    Interactive = 1,    // user-triggered calls
+    Background = 2      // batch scans
+};
+
+constexpr int kPriorityCount = 3;
+
+enum class AdmitStatus {
+    Granted,
+    Rejected,   // queue for this class was full
+    Shed,       // replaced by a newer realtime frame
+    Cancelled   // cancelled while queued
+};
+
+struct SchedulerConfig {
+    // Queued (not running) requests allowed per class
+    int max_queued[kPriorityCount] = {1, 16, 64};
+    // Terminate a running background inference when higher priority work arrives
+    bool preempt_background = true;
+};
+
+// Snapshot of a scheduler's queues and counters
+struct SchedulerStats {
+    struct Class {
+        size_t queued = 0;
+        int max_queued = 0;
+        uint64_t admitted = 0;
+        uint64_t rejected = 0;
+        uint64_t shed = 0;
+        uint64_t cancelled = 0;
+        uint64_t preempted = 0;
+    };
+
+    bool busy = false;
+    bool preemption_supported = true;
+    Class classes[kPriorityCount];
+
+    // Add another scheduler's snapshot (e.g. one per replica): counts and
+    // queued are summed, max_queued stays the per-scheduler limit
+    void merge(const SchedulerStats& other);
+
+    // {"busy","preemption_supported","realtime":{"queued","max_queued",
+    //  "admitted","rejected","shed","cancelled","preempted"},"interactive",
+    //  "background"}
+    std::string json() const;
+};
+
+// Grants exclusive use of the detector by priority instead of arrival order.
+//
+// Waiting requests are served highest class first, FIFO within a class.
+// Realtime frames are shed oldest-first when their queue is full (a newer
+// frame supersedes them), other classes reject new arrivals. A running
+// background request is asked to stop through the cancel handler (ORT
+// RunOptions termination) when realtime or interactive work arrives, unless
+// the backend cannot abort a run (setPreemptionSupported(false)).
+class RequestScheduler {
+public:
+    // Exclusive access for one request, released on destruction
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&&) = delete;
+        Lease(const Lease&) = delete;
+        ~Lease();
+
+        bool granted() const { return m_status == AdmitStatus::Granted; }
+        AdmitStatus status() const { return m_status; }
+
+    private:
+        friend class RequestScheduler;
+        Lease(RequestScheduler* scheduler, AdmitStatus status)
+            : m_scheduler(scheduler), m_status(status) {}
+
+        RequestScheduler* m_scheduler;
+        AdmitStatus m_status;
+    };
+
+    // Block until the request may run, or it is rejected / shed / cancelled
+    Lease acquire(RequestPriority priority);
+
+    // Called with the scheduler lock held to abort the running request
+    void setCancelHandler(std::function<void()> handler);
+
+    // Whether the cancel handler can abort a run. Without it a running
+    // request always completes and is never counted as preempted.
+    void setPreemptionSupported(bool supported);
+
+    void setConfig(const SchedulerConfig& config);
+    SchedulerConfig config() const;
+
+    // Whether the running request has been asked to stop
+    bool cancelRequested() const;
+
+    // Cancel queued background requests and stop a running one.
+    // Returns the number of requests affected.
+    int cancelBackground();
+
+    // Number of cancelBackground() calls so far; a background job spanning
+    // several requests (a batch scan) stops when it changes
+    uint64_t backgroundCancels() const;
+
+    SchedulerStats stats() const;
+
+    // Per-class admitted / rejected / shed / cancelled / preempted counts and
+    // "preemption_supported" as JSON
+    std::string statsJson() const { return stats().json(); }
+
+    // Count a running request that stopped because of cancelRequested().
+    // Returns true if cancelBackground() stopped it (counted as cancelled),
+    // false if higher priority work preempted it (worth retrying).
+    bool noteStopped(RequestPriority priority);
+
+private:
+    struct Waiter {
+        AdmitStatus status;
+        bool pending;
+    };
+
+    struct ClassStats {
+        uint64_t admitted = 0;
+        uint64_t rejected = 0;
+        uint64_t shed = 0;
+        uint64_t cancelled = 0;
+        uint64_t preempted = 0;
+    };
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    SchedulerConfig m_config;
+    std::function<void()> m_cancel_handler;
+    bool m_preemption_supported = true;
+
+    std::deque<Waiter*> m_queues[kPriorityCount];
+    ClassStats m_stats[kPriorityCount];
+
+    bool m_busy = false;
+    RequestPriority m_active_priority = RequestPriority::Interactive;
+    bool m_active_cancel = false;
+    bool m_cancel_explicit = false;     // the cancel came from cancelBackground()
+    uint64_t m_background_cancels = 0;
+
+    void release();
+    void grantNextLocked();
+    void requestCancelLocked();
+};
+
+#endif // REQUEST_SCHEDULER_HPP
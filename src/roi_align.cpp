@@ -0,0 +1,95 @@
+#include "roi_align.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr int kSamplesPerBin = 2;  // per side
+
+// Bilinear sample position: four neighbouring cell offsets and weights
+struct Tap {
+    int offset[4];
+    float weight[4];
+};
+
+bool makeTap(const FeatureMap& map, float x, float y, Tap& tap) {
+    if (y < -1.0f || y > map.height || x < -1.0f || x > map.width) return false;
+    x = std::min(std::max(x, 0.0f), static_cast<float>(map.width - 1));
+    y = std::min(std::max(y, 0.0f), static_cast<float>(map.height - 1));
+
+    const int x0 = static_cast<int>(x);
+    const int y0 = static_cast<int>(y);
+    const int x1 = std::min(x0 + 1, map.width - 1);
+    const int y1 = std::min(y0 + 1, map.height - 1);
+    const float lx = x - x0;
+    const float ly = y - y0;
+
+    tap.offset[0] = y0 * map.width + x0;
+    tap.offset[1] = y0 * map.width + x1;
+    tap.offset[2] = y1 * map.width + x0;
+    tap.offset[3] = y1 * map.width + x1;
+    tap.weight[0] = (1.0f - ly) * (1.0f - lx);
+    tap.weight[1] = (1.0f - ly) * lx;
+    tap.weight[2] = ly * (1.0f - lx);
+    tap.weight[3] = ly * lx;
+    return true;
+}
+
+}  // namespace
+
+void roiAlignEmbedding(const FeatureMap& map, float x1, float y1, float x2, float y2, int pooled, float* out) {
+    const int bins = pooled * pooled;
+    const size_t plane = static_cast<size_t>(map.height) * map.width;
+    std::fill(out, out + static_cast<size_t>(map.channels) * bins, 0.0f);
+
+    // Cell centres sit at integer + 0.5; boxes are at least one cell wide
+    x1 -= 0.5f;
+    y1 -= 0.5f;
+    const float bin_w = std::max(x2 - 0.5f - x1, 1.0f) / pooled;
+    const float bin_h = std::max(y2 - 0.5f - y1, 1.0f) / pooled;
+    const float sample_weight = 1.0f / (kSamplesPerBin * kSamplesPerBin);
+
+    // Gather the taps once, then sweep every channel plane with them
+    std::vector<Tap> taps;
+    std::vector<int> tap_bin;
+    taps.reserve(static_cast<size_t>(bins) * kSamplesPerBin * kSamplesPerBin);
+    for (int by = 0; by < pooled; by++) {
+        for (int bx = 0; bx < pooled; bx++) {
+            for (int sy = 0; sy < kSamplesPerBin; sy++) {
+                for (int sx = 0; sx < kSamplesPerBin; sx++) {
+                    Tap tap;
+                    float y = y1 + (by + (sy + 0.5f) / kSamplesPerBin) * bin_h;
+                    float x = x1 + (bx + (sx + 0.5f) / kSamplesPerBin) * bin_w;
+                    if (!makeTap(map, x, y, tap)) continue;
+                    taps.push_back(tap);
+                    tap_bin.push_back(by * pooled + bx);
+                }
+            }
+        }
+    }
+
+    for (int c = 0; c < map.channels; c++) {
+        const float* channel = map.data + c * plane;
+        float* dst = out + static_cast<size_t>(c) * bins;
+        for (size_t t = 0; t < taps.size(); t++) {
+            const Tap& tap = taps[t];
+            dst[tap_bin[t]] += sample_weight * (tap.weight[0] * channel[tap.offset[0]] +
+                                                tap.weight[1] * channel[tap.offset[1]] +
+                                                tap.weight[2] * channel[tap.offset[2]] +
+                                                tap.weight[3] * channel[tap.offset[3]]);
+        }
+    }
+
+    float norm = 0.0f;
+    for (int i = 0; i < map.channels * bins; i++) {
+        norm += out[i] * out[i];
+    }
+    if (norm > 0.0f) {
+        const float inv = 1.0f / std::sqrt(norm);
+        for (int i = 0; i < map.channels * bins; i++) {
+            out[i] *= inv;
+        }
+    }
+}
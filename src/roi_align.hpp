@@ -0,0 +1,18 @@
+#ifndef ROI_ALIGN_HPP
+#define ROI_ALIGN_HPP
+
+// One image's channel-major feature map [C, H, W], e.g. a neck output
+struct FeatureMap {
+    const float* data = nullptr;
+    int channels = 0;
+    int height = 0;
+    int width = 0;
+};
+
+// Appearance embedding of a box given in feature map cells: RoIAlign into
+// pooled x pooled bins (each the mean of 2x2 bilinear samples, pixel-centre
+// aligned), written channel-major as channels * pooled * pooled floats and
+// L2-normalized, so two embeddings compare by their dot product.
+void roiAlignEmbedding(const FeatureMap& map, float x1, float y1, float x2, float y2, int pooled, float* out);
+
+#endif // ROI_ALIGN_HPP
@@ -0,0 +1,433 @@
+#include "sampling_plan.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "simd.hpp"
+#include "task_pool.hpp"
+
+namespace {
+
+// Which source axis a rotated axis walks along, and in which direction
+struct AxisMap {
+    bool along_x;
+    bool reversed;
+};
+
+// Axis walked by the rotated image's columns
+AxisMap columnAxis(int rotation) {
+    switch (rotation) {
+        case 90:  return {false, true};   // dst(x', y') = src(y', H-1-x')
+        case 180: return {true, true};
+        case 270: return {false, false};  // dst(x', y') = src(W-1-y', x')
+        default:  return {true, false};
+    }
+}
+
+// Axis walked by the rotated image's rows
+AxisMap rowAxis(int rotation) {
+    switch (rotation) {
+        case 90:  return {true, false};
+        case 180: return {false, true};
+        case 270: return {true, true};
+        default:  return {false, false};
+    }
+}
+
+int bytesPerPixel(SourceFormat format) {
+    switch (format) {
+        case SourceFormat::BGRA:
+        case SourceFormat::RGBA: return 4;
+        case SourceFormat::BGR:
+        case SourceFormat::RGB:  return 3;
+        case SourceFormat::YUYV: return 2;
+        default:                 return 1;
+    }
+}
+
+// BT.601 limited range, same coefficients as cv::COLOR_YUV2BGR_NV21
+constexpr float kYuvCY = 1.164383f;
+constexpr float kYuvCUB = 2.017232f;
+constexpr float kYuvCUG = -0.391762f;
+constexpr float kYuvCVG = -0.812968f;
+constexpr float kYuvCVR = 1.596027f;
+
+// Two most recently gathered source rows, keyed by their byte offset.
+// Consecutive output rows often share a source row (upscaling, and every
+// chroma row in YUV420), so each one is only gathered once.
+class RowCache {
+public:
+    explicit RowCache(size_t row_len) {
+        m_rows[0].resize(row_len);
+        m_rows[1].resize(row_len);
+    }
+
+    // Rows for keys a and b, calling fill(key, dst) for any that are missing
+    template <typename Fill>
+    void get(int32_t a, int32_t b, const int32_t*& row_a, const int32_t*& row_b, Fill fill) {
+        int slot_a = find(a);
+        if (slot_a < 0) {
+            slot_a = (find(b) == 0) ? 1 : 0;
+            fill(a, m_rows[slot_a].data());
+            m_keys[slot_a] = a;
+        }
+        int slot_b = find(b);
+        if (slot_b < 0) {
+            slot_b = 1 - slot_a;
+            fill(b, m_rows[slot_b].data());
+            m_keys[slot_b] = b;
+        }
+        row_a = m_rows[slot_a].data();
+        row_b = m_rows[slot_b].data();
+    }
+
+private:
+    int32_t m_keys[2] = {-1, -1};
+    std::vector<int32_t> m_rows[2];
+
+    int find(int32_t key) const {
+        if (m_keys[0] == key) return 0;
+        if (m_keys[1] == key) return 1;
+        return -1;
+    }
+};
+
+// out[x] = top[x] * w0 + bottom[x] * w1
+inline void blendRows(const int32_t* top, const int32_t* bottom, float w0, float w1,
+                      int n, float* out) {
+    const simd::f32x4 vw0 = simd::splat(w0);
+    const simd::f32x4 vw1 = simd::splat(w1);
+    int x = 0;
+    for (; x + 4 <= n; x += 4) {
+        simd::store(out + x, simd::loadInt(top + x) * vw0 + simd::loadInt(bottom + x) * vw1);
+    }
+    for (; x < n; x++) {
+        out[x] = top[x] * w0 + bottom[x] * w1;
+    }
+}
+
+}  // namespace
+
+void SamplingPlan::build(const FrameGeometry& geometry, int dst_width, int dst_height, bool letterbox) {
+    m_geometry = geometry;
+    m_dst_width = dst_width;
+    m_dst_height = dst_height;
+    m_letterbox = letterbox;
+    m_valid = false;
+
+    const int src_w = geometry.rotatedWidth();
+    const int src_h = geometry.rotatedHeight();
+    if (src_w <= 0 || src_h <= 0 || dst_width <= 0 || dst_height <= 0) {
+        return;
+    }
+
+    if (letterbox) {
+        // YOLOX/YOLOv8: keep aspect ratio, pad with gray
+        float scale_x = static_cast<float>(dst_width) / src_w;
+        float scale_y = static_cast<float>(dst_height) / src_h;
+        m_scale = std::min(scale_x, scale_y);
+        m_content_width = std::max(1, static_cast<int>(src_w * m_scale));
+        m_content_height = std::max(1, static_cast<int>(src_h * m_scale));
+        m_pad_x = (dst_width - m_content_width) / 2;
+        m_pad_y = (dst_height - m_content_height) / 2;
+    } else {
+        // PP-YOLOE: direct resize, no padding
+        m_scale = 1.0f;
+        m_content_width = dst_width;
+        m_content_height = dst_height;
+        m_pad_x = 0;
+        m_pad_y = 0;
+    }
+
+    const int bpp = bytesPerPixel(geometry.format);
+
+    // Chroma steps: YUV420 halves both axes with its own strides, YUYV shares
+    // one U/V pair per two pixels of the same row
+    const bool yuyv = geometry.format == SourceFormat::YUYV;
+    const int chroma_step = yuyv ? 4 : geometry.uv_pixel_stride;
+    const int chroma_row_stride = yuyv ? geometry.stride : geometry.uv_row_stride;
+    const int chroma_row_shift = yuyv ? 0 : 1;
+
+    auto buildTaps = [&](std::vector<Tap>& taps, int dst_len, int src_len, AxisMap axis) {
+        taps.resize(dst_len);
+
+        // Same sample positions as cv::resize INTER_LINEAR (half-pixel centers)
+        const double inv_scale = static_cast<double>(src_len) / dst_len;
+
+        for (int d = 0; d < dst_len; d++) {
+            double f = (d + 0.5) * inv_scale - 0.5;
+            int i0 = static_cast<int>(std::floor(f));
+            double frac = f - i0;
+            if (i0 < 0) {
+                i0 = 0;
+                frac = 0.0;
+            }
+            if (i0 >= src_len - 1) {
+                i0 = src_len - 1;
+                frac = 0.0;
+            }
+            int i1 = std::min(i0 + 1, src_len - 1);
+
+            // Rotated index -> source index
+            int s0 = axis.reversed ? (src_len - 1 - i0) : i0;
+            int s1 = axis.reversed ? (src_len - 1 - i1) : i1;
+
+            Tap& tap = taps[d];
+            if (axis.along_x) {
+                tap.off0 = s0 * bpp;
+                tap.off1 = s1 * bpp;
+                tap.coff0 = (s0 >> 1) * chroma_step;
+                tap.coff1 = (s1 >> 1) * chroma_step;
+            } else {
+                tap.off0 = s0 * geometry.stride;
+                tap.off1 = s1 * geometry.stride;
+                tap.coff0 = (s0 >> chroma_row_shift) * chroma_row_stride;
+                tap.coff1 = (s1 >> chroma_row_shift) * chroma_row_stride;
+            }
+            tap.w1 = static_cast<int32_t>(std::lround(frac * (1 << kCoefBits)));
+            tap.w0 = (1 << kCoefBits) - tap.w1;
+        }
+    };
+
+    buildTaps(m_col_taps, m_content_width, src_w, columnAxis(geometry.rotation));
+    buildTaps(m_row_taps, m_content_height, src_h, rowAxis(geometry.rotation));
+
+    m_valid = true;
+}
+
+bool SamplingPlan::matches(const FrameGeometry& geometry, int dst_width, int dst_height, bool letterbox) const {
+    return m_valid && m_geometry == geometry &&
+           m_dst_width == dst_width && m_dst_height == dst_height &&
+           m_letterbox == letterbox;
+}
+
+void SamplingPlan::sample(const FrameView& frame, const TensorFormat& format, float* tensor) const {
+    if (!m_valid) return;
+
+    // planes[k] receives source channel k (B, G, R)
+    const size_t channel_size = static_cast<size_t>(m_dst_width) * m_dst_height;
+    float* planes[3];
+    if (format.rgb) {
+        planes[0] = tensor + 2 * channel_size;
+        planes[1] = tensor + channel_size;
+        planes[2] = tensor;
+    } else {
+        planes[0] = tensor;
+        planes[1] = tensor + channel_size;
+        planes[2] = tensor + 2 * channel_size;
+    }
+
+    if (m_letterbox) {
+        fillPadding(planes, kPadValue * format.norm);
+    }
+
+    switch (m_geometry.format) {
+        case SourceFormat::RGB:
+            // Same kernel as BGR with the R and B destinations swapped
+            std::swap(planes[0], planes[2]);
+            samplePacked<3>(frame, planes, format.norm);
+            break;
+        case SourceFormat::BGR:
+            samplePacked<3>(frame, planes, format.norm);
+            break;
+        case SourceFormat::BGRA:
+            samplePacked<4>(frame, planes, format.norm);
+            break;
+        case SourceFormat::RGBA:
+            std::swap(planes[0], planes[2]);
+            samplePacked<4>(frame, planes, format.norm);
+            break;
+        case SourceFormat::GRAY:
+            sampleGray(frame, planes, format.norm);
+            break;
+        case SourceFormat::YUV420:
+            sampleYuv(frame, frame.u, frame.v, planes, format.norm);
+            break;
+        case SourceFormat::YUYV:
+            // Luma taps step 2 bytes per pixel, chroma taps 4 bytes per pair
+            sampleYuv(frame, frame.data + 1, frame.data + 3, planes, format.norm);
+            break;
+    }
+}
+
+template <int BPP>
+void SamplingPlan::gatherPackedRow(const uint8_t* row, int32_t* out) const {
+    const int n = m_content_width;
+    int32_t* out0 = out;
+    int32_t* out1 = out + n;
+    int32_t* out2 = out + 2 * n;
+
+    for (int x = 0; x < n; x++) {
+        const Tap& cx = m_col_taps[x];
+        const uint8_t* a = row + cx.off0;
+        const uint8_t* b = row + cx.off1;
+        out0[x] = a[0] * cx.w0 + b[0] * cx.w1;
+        out1[x] = a[1] * cx.w0 + b[1] * cx.w1;
+        out2[x] = a[2] * cx.w0 + b[2] * cx.w1;
+    }
+}
+
+void SamplingPlan::gatherPlaneRow(const uint8_t* row, bool chroma, int32_t* out) const {
+    const int n = m_content_width;
+    if (chroma) {
+        for (int x = 0; x < n; x++) {
+            const Tap& cx = m_col_taps[x];
+            out[x] = row[cx.coff0] * cx.w0 + row[cx.coff1] * cx.w1;
+        }
+    } else {
+        for (int x = 0; x < n; x++) {
+            const Tap& cx = m_col_taps[x];
+            out[x] = row[cx.off0] * cx.w0 + row[cx.off1] * cx.w1;
+        }
+    }
+}
+
+template <int BPP>
+void SamplingPlan::samplePacked(const FrameView& frame, float* planes[3], float norm) const {
+    const int n = m_content_width;
+    const float weight_scale = norm / static_cast<float>(1 << (2 * kCoefBits));
+
+    auto rows = [&](int y_begin, int y_end) {
+        RowCache cache(static_cast<size_t>(3) * n);
+        auto gather = [&](int32_t offset, int32_t* out) {
+            gatherPackedRow<BPP>(frame.data + offset, out);
+        };
+
+        for (int y = y_begin; y < y_end; y++) {
+            const Tap& ry = m_row_taps[y];
+            const int32_t* top;
+            const int32_t* bottom;
+            cache.get(ry.off0, ry.off1, top, bottom, gather);
+
+            const size_t row_start = static_cast<size_t>(y + m_pad_y) * m_dst_width + m_pad_x;
+            const float w0 = ry.w0 * weight_scale;
+            const float w1 = ry.w1 * weight_scale;
+            for (int ch = 0; ch < 3; ch++) {
+                blendRows(top + ch * n, bottom + ch * n, w0, w1, n, planes[ch] + row_start);
+            }
+        }
+    };
+    TaskPool::shared().parallelFor(0, m_content_height, kRowsPerTask, rows);
+}
+
+void SamplingPlan::sampleGray(const FrameView& frame, float* planes[3], float norm) const {
+    const int n = m_content_width;
+    const float weight_scale = norm / static_cast<float>(1 << (2 * kCoefBits));
+
+    auto rows = [&](int y_begin, int y_end) {
+        RowCache cache(n);
+        auto gather = [&](int32_t offset, int32_t* out) {
+            gatherPlaneRow(frame.data + offset, false, out);
+        };
+
+        for (int y = y_begin; y < y_end; y++) {
+            const Tap& ry = m_row_taps[y];
+            const int32_t* top;
+            const int32_t* bottom;
+            cache.get(ry.off0, ry.off1, top, bottom, gather);
+
+            const size_t row_start = static_cast<size_t>(y + m_pad_y) * m_dst_width + m_pad_x;
+            float* out = planes[0] + row_start;
+            blendRows(top, bottom, ry.w0 * weight_scale, ry.w1 * weight_scale, n, out);
+            std::copy(out, out + n, planes[1] + row_start);
+            std::copy(out, out + n, planes[2] + row_start);
+        }
+    };
+    TaskPool::shared().parallelFor(0, m_content_height, kRowsPerTask, rows);
+}
+
+void SamplingPlan::sampleYuv(const FrameView& frame, const uint8_t* u_base, const uint8_t* v_base,
+                             float* planes[3], float norm) const {
+    const int n = m_content_width;
+    const float weight_scale = 1.0f / static_cast<float>(1 << (2 * kCoefBits));
+
+    const simd::f32x4 k16 = simd::splat(16.0f);
+    const simd::f32x4 k128 = simd::splat(128.0f);
+    const simd::f32x4 zero = simd::splat(0.0f);
+    const simd::f32x4 k255 = simd::splat(255.0f);
+    const simd::f32x4 cy = simd::splat(kYuvCY);
+    const simd::f32x4 cub = simd::splat(kYuvCUB);
+    const simd::f32x4 cug = simd::splat(kYuvCUG);
+    const simd::f32x4 cvg = simd::splat(kYuvCVG);
+    const simd::f32x4 cvr = simd::splat(kYuvCVR);
+    const simd::f32x4 vnorm = simd::splat(norm);
+
+    auto rows = [&](int y_begin, int y_end) {
+        RowCache luma_cache(n);
+        RowCache u_cache(n);
+        RowCache v_cache(n);
+
+        auto gather_y = [&](int32_t offset, int32_t* out) {
+            gatherPlaneRow(frame.data + offset, false, out);
+        };
+        auto gather_u = [&](int32_t offset, int32_t* out) {
+            gatherPlaneRow(u_base + offset, true, out);
+        };
+        auto gather_v = [&](int32_t offset, int32_t* out) {
+            gatherPlaneRow(v_base + offset, true, out);
+        };
+
+        // Interpolated Y, U, V for one output row
+        std::vector<float> yuv(static_cast<size_t>(3) * n);
+        float* lum = yuv.data();
+        float* cu = lum + n;
+        float* cv = cu + n;
+
+        for (int y = y_begin; y < y_end; y++) {
+            const Tap& ry = m_row_taps[y];
+            const int32_t* top;
+            const int32_t* bottom;
+            const float w0 = ry.w0 * weight_scale;
+            const float w1 = ry.w1 * weight_scale;
+
+            luma_cache.get(ry.off0, ry.off1, top, bottom, gather_y);
+            blendRows(top, bottom, w0, w1, n, lum);
+            u_cache.get(ry.coff0, ry.coff1, top, bottom, gather_u);
+            blendRows(top, bottom, w0, w1, n, cu);
+            v_cache.get(ry.coff0, ry.coff1, top, bottom, gather_v);
+            blendRows(top, bottom, w0, w1, n, cv);
+
+            const size_t row_start = static_cast<size_t>(y + m_pad_y) * m_dst_width + m_pad_x;
+            float* out_b = planes[0] + row_start;
+            float* out_g = planes[1] + row_start;
+            float* out_r = planes[2] + row_start;
+
+            int x = 0;
+            for (; x + 4 <= n; x += 4) {
+                simd::f32x4 yy = simd::max(simd::load(lum + x) - k16, zero) * cy;
+                simd::f32x4 u = simd::load(cu + x) - k128;
+                simd::f32x4 v = simd::load(cv + x) - k128;
+                simd::store(out_r + x, simd::min(simd::max(yy + cvr * v, zero), k255) * vnorm);
+                simd::store(out_g + x, simd::min(simd::max(yy + cvg * v + cug * u, zero), k255) * vnorm);
+                simd::store(out_b + x, simd::min(simd::max(yy + cub * u, zero), k255) * vnorm);
+            }
+            for (; x < n; x++) {
+                float yy = std::max(lum[x] - 16.0f, 0.0f) * kYuvCY;
+                float u = cu[x] - 128.0f;
+                float v = cv[x] - 128.0f;
+                out_r[x] = std::min(std::max(yy + kYuvCVR * v, 0.0f), 255.0f) * norm;
+                out_g[x] = std::min(std::max(yy + kYuvCVG * v + kYuvCUG * u, 0.0f), 255.0f) * norm;
+                out_b[x] = std::min(std::max(yy + kYuvCUB * u, 0.0f), 255.0f) * norm;
+            }
+        }
+    };
+    TaskPool::shared().parallelFor(0, m_content_height, kRowsPerTask, rows);
+}
+
+void SamplingPlan::fillPadding(float* planes[3], float value) const {
+    for (int ch = 0; ch < 3; ch++) {
+        float* plane = planes[ch];
+
+        // Top and bottom bands
+        std::fill(plane, plane + static_cast<size_t>(m_pad_y) * m_dst_width, value);
+        std::fill(plane + static_cast<size_t>(m_pad_y + m_content_height) * m_dst_width,
+                  plane + static_cast<size_t>(m_dst_height) * m_dst_width, value);
+
+        // Left and right bands of content rows
+        for (int y = m_pad_y; y < m_pad_y + m_content_height; y++) {
+            float* row = plane + static_cast<size_t>(y) * m_dst_width;
+            std::fill(row, row + m_pad_x, value);
+            std::fill(row + m_pad_x + m_content_width, row + m_dst_width, value);
+        }
+    }
+}
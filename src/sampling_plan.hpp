@@ -0,0 +1,123 @@
+#ifndef SAMPLING_PLAN_HPP
+#define SAMPLING_PLAN_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Pixel layouts the sampler can read directly
+enum class SourceFormat {
+    BGR,        // packed 3 bytes per pixel (cv::imread)
+    RGB,        // packed 3 bytes per pixel (stb_image)
+    BGRA,       // packed 4 bytes per pixel (iOS camera)
+    RGBA,       // packed 4 bytes per pixel (GL readback, decoded images)
+    GRAY,       // 1 byte per pixel, replicated to all three channels
+    YUV420,     // Y plane + U/V planes with row/pixel stride (Android camera)
+    YUYV        // packed 4:2:2, Y0 U Y1 V per pixel pair (UVC webcams)
+};
+
+// Everything that determines the sampling coordinates of a frame.
+// Camera streams keep this constant for thousands of frames.
+struct FrameGeometry {
+    SourceFormat format = SourceFormat::BGR;
+    int width = 0;              // source width (before rotation)
+    int height = 0;             // source height (before rotation)
+    int stride = 0;             // bytes per row (Y plane for YUV420)
+    int uv_row_stride = 0;      // YUV420 only
+    int uv_pixel_stride = 0;    // YUV420 only (1 = I420, 2 = NV12/NV21)
+    int rotation = 0;           // 0, 90, 180, 270 degrees clockwise
+
+    bool operator==(const FrameGeometry& o) const {
+        return format == o.format && width == o.width && height == o.height &&
+               stride == o.stride && uv_row_stride == o.uv_row_stride &&
+               uv_pixel_stride == o.uv_pixel_stride && rotation == o.rotation;
+    }
+    bool operator!=(const FrameGeometry& o) const { return !(*this == o); }
+
+    // Dimensions after rotation
+    int rotatedWidth() const { return (rotation == 90 || rotation == 270) ? height : width; }
+    int rotatedHeight() const { return (rotation == 90 || rotation == 270) ? width : height; }
+};
+
+// One frame's pixel planes plus its geometry
+struct FrameView {
+    FrameGeometry geometry;
+    const uint8_t* data = nullptr;  // packed pixels or Y plane
+    const uint8_t* u = nullptr;     // YUV420 only (first U byte for NV12/NV21)
+    const uint8_t* v = nullptr;     // YUV420 only (first V byte for NV12/NV21)
+};
+
+// How the sampled pixels are written into the CHW float tensor
+struct TensorFormat {
+    bool rgb = false;       // channel order: false = BGR, true = RGB
+    float norm = 1.0f;      // multiplier applied to 0-255 values
+};
+
+// Precomputed bilinear sampling plan from a source frame straight into the
+// model input tensor. Rotation, letterbox scale/padding and YUV chroma
+// subsampling are all folded into per-row and per-column source offsets with
+// fixed-point weights, so a frame is converted, rotated and resized in a
+// single pass with no intermediate images.
+//
+// Sampling is separable: a scalar horizontal pass gathers each needed source
+// row along the column taps (cached, so upscaled rows and shared chroma rows
+// are gathered once), then a SIMD vertical pass blends two rows, converts
+// YUV to BGR if needed and writes normalized floats. Bands of output rows are
+// sampled in parallel on the shared task pool.
+class SamplingPlan {
+public:
+    // Build the plan for a geometry and model input size.
+    // letterbox: keep aspect ratio with gray padding, otherwise stretch.
+    void build(const FrameGeometry& geometry, int dst_width, int dst_height, bool letterbox);
+
+    // Whether the plan can be reused for this geometry and input size
+    bool matches(const FrameGeometry& geometry, int dst_width, int dst_height, bool letterbox) const;
+
+    // Sample a frame into a CHW tensor of dst_width * dst_height * 3 floats
+    void sample(const FrameView& frame, const TensorFormat& format, float* tensor) const;
+
+    bool isValid() const { return m_valid; }
+
+    // Letterbox parameters used to map detections back to the rotated frame
+    float scale() const { return m_scale; }
+    int padX() const { return m_pad_x; }
+    int padY() const { return m_pad_y; }
+
+private:
+    // Two neighbouring source samples along one axis
+    struct Tap {
+        int32_t off0, off1;     // luma / packed byte offsets
+        int32_t coff0, coff1;   // chroma byte offsets (YUV420 / YUYV only)
+        int32_t w0, w1;         // fixed-point weights, w0 + w1 == 1 << kCoefBits
+    };
+
+    static constexpr int kCoefBits = 11;
+    static constexpr uint8_t kPadValue = 114;
+    static constexpr int kRowsPerTask = 32;
+
+    bool m_valid = false;
+    FrameGeometry m_geometry;
+    int m_dst_width = 0;
+    int m_dst_height = 0;
+    bool m_letterbox = true;
+
+    float m_scale = 1.0f;
+    int m_pad_x = 0;
+    int m_pad_y = 0;
+    int m_content_width = 0;
+    int m_content_height = 0;
+
+    std::vector<Tap> m_col_taps;    // one per content column
+    std::vector<Tap> m_row_taps;    // one per content row
+
+    template <int BPP>
+    void samplePacked(const FrameView& frame, float* planes[3], float norm) const;
+    template <int BPP>
+    void gatherPackedRow(const uint8_t* row, int32_t* out) const;
+    void gatherPlaneRow(const uint8_t* row, bool chroma, int32_t* out) const;
+    void sampleGray(const FrameView& frame, float* planes[3], float norm) const;
+    void sampleYuv(const FrameView& frame, const uint8_t* u, const uint8_t* v,
+                   float* planes[3], float norm) const;
+    void fillPadding(float* planes[3], float value) const;
+};
+
+#endif // SAMPLING_PLAN_HPP
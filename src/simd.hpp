@@ -0,0 +1,87 @@
+#ifndef YOLO_SIMD_HPP
+#define YOLO_SIMD_HPP
+
+// Minimal 4-lane float vector used by the image kernels.
+// NEON on arm64/armv7 (Android, iOS, Jetson, Raspberry Pi), SSE2 on x86_64,
+// plain scalar code elsewhere.
+
+#include <cstdint>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define YOLO_SIMD_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define YOLO_SIMD_SSE2 1
+#endif
+
+namespace simd {
+
+#if defined(YOLO_SIMD_NEON)
+
+struct f32x4 { float32x4_t v; };
+
+inline f32x4 splat(float x) { return {vdupq_n_f32(x)}; }
+inline f32x4 load(const float* p) { return {vld1q_f32(p)}; }
+inline f32x4 loadInt(const int32_t* p) { return {vcvtq_f32_s32(vld1q_s32(p))}; }
+inline void store(float* p, f32x4 a) { vst1q_f32(p, a.v); }
+inline f32x4 operator+(f32x4 a, f32x4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline f32x4 operator-(f32x4 a, f32x4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline f32x4 operator*(f32x4 a, f32x4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline f32x4 min(f32x4 a, f32x4 b) { return {vminq_f32(a.v, b.v)}; }
+inline f32x4 max(f32x4 a, f32x4 b) { return {vmaxq_f32(a.v, b.v)}; }
+
+#elif defined(YOLO_SIMD_SSE2)
+
+struct f32x4 { __m128 v; };
+
+inline f32x4 splat(float x) { return {_mm_set1_ps(x)}; }
+inline f32x4 load(const float* p) { return {_mm_loadu_ps(p)}; }
+inline f32x4 loadInt(const int32_t* p) {
+    return {_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))};
+}
+inline void store(float* p, f32x4 a) { _mm_storeu_ps(p, a.v); }
+inline f32x4 operator+(f32x4 a, f32x4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline f32x4 operator-(f32x4 a, f32x4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline f32x4 operator*(f32x4 a, f32x4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline f32x4 min(f32x4 a, f32x4 b) { return {_mm_min_ps(a.v, b.v)}; }
+inline f32x4 max(f32x4 a, f32x4 b) { return {_mm_max_ps(a.v, b.v)}; }
+
+#else
+
+struct f32x4 { float v[4]; };
+
+inline f32x4 splat(float x) { return {{x, x, x, x}}; }
+inline f32x4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline f32x4 loadInt(const int32_t* p) {
+    return {{static_cast<float>(p[0]), static_cast<float>(p[1]),
+             static_cast<float>(p[2]), static_cast<float>(p[3])}};
+}
+inline void store(float* p, f32x4 a) {
+    for (int i = 0; i < 4; i++) p[i] = a.v[i];
+}
+inline f32x4 operator+(f32x4 a, f32x4 b) {
+    return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+}
+inline f32x4 operator-(f32x4 a, f32x4 b) {
+    return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+}
+inline f32x4 operator*(f32x4 a, f32x4 b) {
+    return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+}
+inline f32x4 min(f32x4 a, f32x4 b) {
+    f32x4 r;
+    for (int i = 0; i < 4; i++) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+    return r;
+}
+inline f32x4 max(f32x4 a, f32x4 b) {
+    f32x4 r;
+    for (int i = 0; i < 4; i++) r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+    return r;
+}
+
+#endif
+
+}  // namespace simd
+
+#endif // YOLO_SIMD_HPP
@@ -0,0 +1,47 @@
+#include "stream_context.hpp"
+
+#include <sstream>
+
+#include "detection_log.hpp"
+#include "json_escape.hpp"
+
+void StreamContext::sample(const FrameView& frame, int dst_width, int dst_height, bool letterbox,
+                           const TensorFormat& format, float* tensor, float& scale, int& pad_x, int& pad_y) {
+    std::lock_guard<std::mutex> lock(m_plan_mutex);
+    if (!m_plan.matches(frame.geometry, dst_width, dst_height, letterbox)) {
+        m_plan.build(frame.geometry, dst_width, dst_height, letterbox);
+        m_plan_builds++;
+    }
+    m_width = frame.geometry.rotatedWidth();
+    m_height = frame.geometry.rotatedHeight();
+    scale = m_plan.scale();
+    pad_x = m_plan.padX();
+    pad_y = m_plan.padY();
+    m_plan.sample(frame, format, tensor);
+}
+
+void StreamContext::setDetectionLog(DetectionLogWriter* log) {
+    std::lock_guard<std::mutex> lock(m_log_mutex);
+    m_log = log;
+}
+
+bool StreamContext::logFrame(int64_t timestamp_ns, int width, int height, const std::vector<Detection>& detections) {
+    std::lock_guard<std::mutex> lock(m_log_mutex);
+    if (m_log == nullptr) return false;
+    m_log->writeFrame(timestamp_ns, width, height, detections);
+    return true;
+}
+
+std::string StreamContext::statsJson() const {
+    std::ostringstream oss;
+    oss << "{\"name\":";
+    writeJsonString(oss, m_name);
+    {
+        std::lock_guard<std::mutex> lock(m_plan_mutex);
+        oss << ",\"width\":" << m_width
+            << ",\"height\":" << m_height
+            << ",\"plan_builds\":" << m_plan_builds;
+    }
+    oss << ",\"metrics\":" << m_metrics.toJson() << "}";
+    return oss.str();
+}
@@ -0,0 +1,65 @@
+#ifndef STREAM_CONTEXT_HPP
+#define STREAM_CONTEXT_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "detection.hpp"
+#include "frame_metrics.hpp"
+#include "latest_result.hpp"
+#include "sampling_plan.hpp"
+
+class DetectionLogWriter;
+
+// Per-camera state for one of several streams sharing a detector.
+//
+// The model session, scheduler and input tensor stay with the detector;
+// the stream carries what depends on the camera: the sampling plan for its
+// frame geometry (so cameras of different resolutions do not rebuild a
+// shared plan on every frame), its own frame metrics and its detection log.
+// Frames of one stream are expected in order; calls on the same stream are
+// serialized while its plan is in use.
+class StreamContext {
+public:
+    explicit StreamContext(std::string name = std::string()) : m_name(std::move(name)) {}
+
+    const std::string& name() const { return m_name; }
+
+    // Sample a frame with this stream's plan, rebuilding it only when the
+    // geometry or input size changes. Returns the letterbox parameters.
+    void sample(const FrameView& frame, int dst_width, int dst_height, bool letterbox,
+                const TensorFormat& format, float* tensor, float& scale, int& pad_x, int& pad_y);
+
+    FrameMetrics& metrics() { return m_metrics; }
+
+    // Newest detection / box result of this stream's frames
+    LatestResult& latest() { return m_latest; }
+
+    // Detection log for this stream's frames (nullptr to detach); replaces the
+    // detector's log for them. The writer must outlive the attachment.
+    void setDetectionLog(DetectionLogWriter* log);
+
+    // Append a frame to the attached log. Returns false if none is attached.
+    bool logFrame(int64_t timestamp_ns, int width, int height, const std::vector<Detection>& detections);
+
+    // Name, last geometry, plan rebuilds and frame metrics as JSON
+    std::string statsJson() const;
+
+private:
+    std::string m_name;
+    FrameMetrics m_metrics;
+    LatestResult m_latest;
+
+    mutable std::mutex m_plan_mutex;
+    SamplingPlan m_plan;
+    int m_width = 0;
+    int m_height = 0;
+    int64_t m_plan_builds = 0;
+
+    std::mutex m_log_mutex;
+    DetectionLogWriter* m_log = nullptr;
+};
+
+#endif // STREAM_CONTEXT_HPP
@@ -0,0 +1,248 @@
+#include "task_pool.hpp"
+
+#include <algorithm>
+
+namespace {
+
+std::atomic<int> g_thread_budget{0};
+
+// Yields a waiting caller spends looking for work before it sleeps
+constexpr int kSpinRounds = 64;
+
+int defaultThreadBudget() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return std::max(1, std::min(4, static_cast<int>(hw)));
+}
+
+// Pool and worker index of the current thread (-1 outside any pool)
+thread_local const TaskPool* t_pool = nullptr;
+thread_local int t_worker = -1;
+
+// Pool this thread is inside an outer parallelFor of, so nested calls on
+// the caller's thread are not counted again
+thread_local const TaskPool* t_holding = nullptr;
+
+}  // namespace
+
+int threadBudget() {
+    int budget = g_thread_budget.load();
+    return budget > 0 ? budget : defaultThreadBudget();
+}
+
+void setThreadBudget(int threads) {
+    g_thread_budget.store(threads > 0 ? threads : 0);
+    TaskPool::shared().resize(threadBudget());
+}
+
+TaskPool::TaskPool(int threads) {
+    start(threads);
+}
+
+TaskPool::~TaskPool() {
+    stop();
+}
+
+TaskPool& TaskPool::shared() {
+    static TaskPool pool(threadBudget());
+    return pool;
+}
+
+void TaskPool::resize(int threads) {
+    std::unique_lock<std::mutex> lock(m_resize_mutex);
+    m_resize_cv.wait(lock, [&]() { return !m_resizing; });
+    if (threadCount() == std::max(threads, 1)) return;
+
+    // Running calls still use the queues; new ones wait until we are done
+    m_resizing = true;
+    m_resize_cv.wait(lock, [&]() { return m_active_calls == 0; });
+    stop();
+    start(threads);
+    m_resizing = false;
+    lock.unlock();
+    m_resize_cv.notify_all();
+}
+
+void TaskPool::enter() {
+    std::unique_lock<std::mutex> lock(m_resize_mutex);
+    m_resize_cv.wait(lock, [&]() { return !m_resizing; });
+    m_active_calls++;
+}
+
+void TaskPool::leave() {
+    std::lock_guard<std::mutex> lock(m_resize_mutex);
+    if (--m_active_calls == 0 && m_resizing) {
+        m_resize_cv.notify_all();
+    }
+}
+
+void TaskPool::start(int threads) {
+    const int workers = std::max(threads, 1) - 1;
+    m_stop = false;
+    m_queues.clear();
+    for (int i = 0; i <= workers; i++) {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < workers; i++) {
+        m_workers.emplace_back(&TaskPool::workerLoop, this, i);
+    }
+    m_thread_count.store(workers + 1);
+}
+
+void TaskPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stop = true;
+    }
+    m_sleep_cv.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+int TaskPool::queueIndex() const {
+    // Outside threads share the last queue
+    return (t_pool == this && t_worker >= 0) ? t_worker : static_cast<int>(m_workers.size());
+}
+
+void TaskPool::push(int queue, const Task& task) {
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+        m_queues[queue]->tasks.push_back(task);
+    }
+    m_queued.fetch_add(1);
+    if (m_sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_sleep_cv.notify_one();
+    }
+}
+
+// Newest task from our own queue, else the oldest task of another queue
+bool TaskPool::popOrSteal(int queue, Task& task) {
+    if (m_queued.load() == 0) return false;
+
+    {
+        Queue& own = *m_queues[queue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            m_queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    const int count = static_cast<int>(m_queues.size());
+    for (int i = 1; i < count; i++) {
+        Queue& victim = *m_queues[(queue + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            m_queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Split the range in halves, leaving the upper halves for thieves, then run
+// the remaining chunk
+void TaskPool::execute(int queue, Task task) {
+    while (task.end - task.begin > task.grain) {
+        int mid = task.begin + (task.end - task.begin) / 2;
+        task.group->pending.fetch_add(1);
+        push(queue, Task{task.fn, mid, task.end, task.grain, task.group});
+        task.end = mid;
+    }
+    (*task.fn)(task.begin, task.end);
+    finish(*task.group);
+}
+
+// The last chunk of a group marks it done and wakes its caller if it sleeps;
+// the group is not touched after the lock is released
+void TaskPool::finish(Group& group) {
+    if (group.pending.fetch_sub(1) != 1) return;
+    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    group.done = true;
+    if (group.sleeping) m_sleep_cv.notify_all();
+}
+
+void TaskPool::workerLoop(int index) {
+    t_pool = this;
+    t_worker = index;
+
+    Task task;
+    while (true) {
+        if (popOrSteal(index, task)) {
+            execute(index, task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_sleepers.fetch_add(1);
+        m_sleep_cv.wait(lock, [&]() { return m_stop || m_queued.load() > 0; });
+        m_sleepers.fetch_sub(1);
+        if (m_stop) return;
+    }
+}
+
+void TaskPool::parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& fn) {
+    if (end <= begin) return;
+    grain = std::max(grain, 1);
+
+    // Workers and nested calls run inside the outermost caller's call
+    struct Guard {
+        TaskPool* pool;
+        const TaskPool* previous;
+        ~Guard() {
+            if (pool != nullptr) {
+                t_holding = previous;
+                pool->leave();
+            }
+        }
+    } guard{nullptr, t_holding};
+    if (t_pool != this && t_holding != this) {
+        enter();
+        guard.pool = this;
+        t_holding = this;
+    }
+
+    if (m_workers.empty() || end - begin <= grain) {
+        fn(begin, end);
+        return;
+    }
+
+    Group group;
+    group.pending.store(1);
+    const int queue = queueIndex();
+    execute(queue, Task{&fn, begin, end, grain, &group});
+
+    // Help with queued work (ours or anyone's) until every chunk is done.
+    // With nothing to help with, spin briefly and then sleep until the last
+    // chunk finishes or new work is queued, so waiting does not hold a core
+    Task task;
+    int idle = 0;
+    while (group.pending.load() > 0) {
+        if (popOrSteal(queue, task)) {
+            execute(queue, task);
+            idle = 0;
+            continue;
+        }
+        if (++idle < kSpinRounds) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        group.sleeping = true;
+        m_sleepers.fetch_add(1);
+        m_sleep_cv.wait(lock, [&]() { return group.done || m_queued.load() > 0; });
+        m_sleepers.fetch_sub(1);
+        group.sleeping = false;
+        idle = 0;
+    }
+
+    // The last chunk may still be inside finish(); the group lives on our stack
+    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+    group.sleeping = true;
+    m_sleep_cv.wait(lock, [&]() { return group.done; });
+}
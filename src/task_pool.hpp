@@ -0,0 +1,102 @@
+#ifndef TASK_POOL_HPP
+#define TASK_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads the library may keep busy: ONNX Runtime intra-op threads (applied
+// at the next init) and the shared task pool (applied once running
+// parallelFor calls finish). Defaults to min(4, hardware threads). Inference
+// and the pool's stages never run at the same time for one detector, so both
+// use the whole budget.
+int threadBudget();
+void setThreadBudget(int threads);
+
+// Work-stealing fork-join pool for the detector's own parallel stages.
+//
+// Each worker owns a deque: it pushes split-off work to the back and pops from
+// the back (depth first, cache warm), idle workers steal from the front of
+// other deques (the largest remaining ranges). Threads outside the pool share
+// one extra deque. A thread waiting in parallelFor runs queued tasks instead of
+// blocking, so nested parallelFor calls cannot deadlock.
+class TaskPool {
+public:
+    // threads: total parallelism including the calling thread
+    explicit TaskPool(int threads);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    // Pool sized by threadBudget()
+    static TaskPool& shared();
+
+    // Restart with a new thread count. New parallelFor calls wait while
+    // running ones finish, then the workers are rebuilt; must not be called
+    // from inside a parallelFor task.
+    void resize(int threads);
+    int threadCount() const { return m_thread_count.load(); }
+
+    // Call fn(chunk_begin, chunk_end) over [begin, end), split into chunks of
+    // at most grain items, and return when all chunks are done. The calling
+    // thread takes part. fn must not throw.
+    void parallelFor(int begin, int end, int grain, const std::function<void(int, int)>& fn);
+
+private:
+    struct Group {
+        std::atomic<int> pending{0};
+        bool sleeping = false;  // caller waits on m_sleep_cv (guarded by m_sleep_mutex)
+        bool done = false;      // last chunk finished (guarded by m_sleep_mutex)
+    };
+
+    struct Task {
+        const std::function<void(int, int)>* fn;
+        int begin;
+        int end;
+        int grain;
+        Group* group;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Outermost parallelFor calls in progress; resize() waits for none and
+    // holds off new ones while it rebuilds the workers and queues
+    std::mutex m_resize_mutex;
+    std::condition_variable m_resize_cv;
+    int m_active_calls = 0;
+    bool m_resizing = false;
+    std::atomic<int> m_thread_count{1};
+
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<Queue>> m_queues;   // one per worker + one shared by outside threads
+
+    std::atomic<int> m_queued{0};
+    std::atomic<int> m_sleepers{0};
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_sleep_cv;
+    bool m_stop = false;
+
+    void start(int threads);
+    void stop();
+    void workerLoop(int index);
+
+    void enter();
+    void leave();
+
+    int queueIndex() const;
+    void push(int queue, const Task& task);
+    bool popOrSteal(int queue, Task& task);
+    void execute(int queue, Task task);
+    void finish(Group& group);
+};
+
+#endif // TASK_POOL_HPP
@@ -0,0 +1,160 @@
+#include "video_scan.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#ifndef YOLO_USE_OPENCV
+#define YOLO_USE_OPENCV 1
+#endif
+
+// Video decoding needs the videoio module, which minimal OpenCV builds
+// leave out
+#if !defined(YOLO_HAVE_OPENCV_VIDEOIO) && YOLO_USE_OPENCV && defined(__has_include)
+#if __has_include(<opencv2/videoio.hpp>)
+#define YOLO_HAVE_OPENCV_VIDEOIO 1
+#endif
+#endif
+
+#ifndef YOLO_HAVE_OPENCV_VIDEOIO
+#define YOLO_HAVE_OPENCV_VIDEOIO 0
+#endif
+
+#if YOLO_HAVE_OPENCV_VIDEOIO
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#endif
+
+bool videoScanAvailable() {
+    return YOLO_HAVE_OPENCV_VIDEOIO != 0;
+}
+
+#if YOLO_HAVE_OPENCV_VIDEOIO
+
+namespace {
+
+// Assumed when the container does not report a frame rate
+constexpr double kDefaultFps = 30.0;
+
+double elapsedMs(int64_t begin_ns) {
+    return (monotonicNowNs() - begin_ns) / 1e6;
+}
+
+}  // namespace
+
+std::string runVideoScan(const std::string& path,
+                         const VideoScanOptions& options,
+                         const VideoDetectFn& detect) {
+    const int64_t scan_begin_ns = monotonicNowNs();
+    cv::VideoCapture capture(path);
+    if (!capture.isOpened()) {
+        return "{\"error\":\"Could not open video\",\"code\":\"VIDEO_OPEN_FAILED\"}";
+    }
+
+    double fps = capture.get(cv::CAP_PROP_FPS);
+    if (!(fps > 0.0) || !std::isfinite(fps)) {
+        fps = kDefaultFps;
+    }
+    const double reported_frames = capture.get(cv::CAP_PROP_FRAME_COUNT);
+    const int64_t frame_count = reported_frames > 0.0 ? static_cast<int64_t>(reported_frames) : 0;
+
+    const int64_t step = options.interval_s > 0.0
+                         ? std::max<int64_t>(1, std::llround(options.interval_s * fps))
+                         : 1;
+    const int64_t first = std::max<int64_t>(0, std::llround(options.start_s * fps));
+    const int64_t end = options.end_s > 0.0 ? std::llround(options.end_s * fps)
+                                            : std::numeric_limits<int64_t>::max();
+
+    std::ostringstream results;
+    cv::Mat image;
+    int64_t position = 0;       // index of the frame the next grab() returns
+    int64_t sampled = 0;
+    int64_t skipped = 0;
+    int64_t seeks = 0;
+    double decode_ms = 0.0;
+    double convert_ms = 0.0;
+    double detect_ms = 0.0;
+
+    for (int64_t next = first; next < end; next += step) {
+        int64_t begin_ns = monotonicNowNs();
+
+        // Long gaps: seek, which decodes from the preceding keyframe only
+        const int64_t gap = next - position;
+        if (options.keyframe_interval > 0 && gap > options.keyframe_interval &&
+            capture.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(next))) {
+            position = next;
+            seeks++;
+        }
+
+        // Short gaps: demux and decode, but never convert
+        bool ok = true;
+        while (ok && position < next) {
+            ok = capture.grab();
+            position++;
+            skipped++;
+        }
+        ok = ok && capture.grab();
+        decode_ms += elapsedMs(begin_ns);
+        if (!ok) break;
+        const int64_t index = position++;
+
+        begin_ns = monotonicNowNs();
+        ok = capture.retrieve(image) && !image.empty() && image.type() == CV_8UC3;
+        convert_ms += elapsedMs(begin_ns);
+        if (!ok) continue;
+
+        FrameView frame;
+        frame.geometry.format = SourceFormat::BGR;
+        frame.geometry.width = image.cols;
+        frame.geometry.height = image.rows;
+        frame.geometry.stride = static_cast<int>(image.step);
+        frame.data = image.data;
+
+        FrameTiming timing;
+        timing.frame_id = index;
+        begin_ns = monotonicNowNs();
+        char* result = detect(frame, timing);
+        detect_ms += elapsedMs(begin_ns);
+
+        if (sampled++ > 0) results << ",";
+        results << "{\"frame_index\":" << index
+                << ",\"time_s\":" << std::fixed << std::setprecision(3) << index / fps << ",";
+        if (result != nullptr && result[0] == '{') {
+            results << (result + 1);
+        } else {
+            results << "\"error\":\"Detection failed\",\"code\":\"NULL_RESULT\"}";
+        }
+        free(result);
+    }
+
+    const double wall_ms = elapsedMs(scan_begin_ns);
+    const double media_s = std::max<int64_t>(0, position - first) / fps;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "{\"fps\":" << fps
+        << ",\"frame_count\":" << frame_count
+        << ",\"duration_s\":" << frame_count / fps
+        << ",\"sampled\":" << sampled
+        << ",\"skipped\":" << skipped
+        << ",\"seeks\":" << seeks
+        << ",\"decode_ms\":" << decode_ms
+        << ",\"convert_ms\":" << convert_ms
+        << ",\"detect_ms\":" << detect_ms
+        << ",\"wall_ms\":" << wall_ms
+        << ",\"media_s\":" << media_s
+        << ",\"realtime_factor\":" << (wall_ms > 0.0 ? media_s * 1000.0 / wall_ms : 0.0)
+        << ",\"results\":[" << results.str() << "]}";
+    return oss.str();
+}
+
+#else
+
+std::string runVideoScan(const std::string&, const VideoScanOptions&, const VideoDetectFn&) {
+    return "{\"error\":\"Built without a video decoder\",\"code\":\"DECODER_UNAVAILABLE\"}";
+}
+
+#endif  // YOLO_HAVE_OPENCV_VIDEOIO
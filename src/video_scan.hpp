@@ -0,0 +1,46 @@
+#ifndef VIDEO_SCAN_HPP
+#define VIDEO_SCAN_HPP
+
+#include <functional>
+#include <string>
+
+#include "frame_metrics.hpp"
+#include "sampling_plan.hpp"
+
+struct VideoScanOptions {
+    // Media time between sampled frames (<= 0 = every frame)
+    double interval_s = 1.0;
+
+    // Range to scan in media seconds (end_s <= 0 = to the end)
+    double start_s = 0.0;
+    double end_s = 0.0;
+
+    // Assumed distance between keyframes in frames (x264 / x265 default).
+    // Gaps longer than this seek, which decodes from the preceding keyframe;
+    // shorter gaps are skipped with grab() (0 = never seek).
+    int keyframe_interval = 250;
+};
+
+// Runs one sampled frame (packed BGR); returns a malloc'd JSON result
+// (detection or error)
+using VideoDetectFn = std::function<char*(const FrameView& frame, const FrameTiming& timing)>;
+
+// Whether video files can be decoded (OpenCV built with videoio)
+bool videoScanAvailable();
+
+// Detect on frames of a video file sampled every interval_s. Frames between
+// samples are only demuxed and decoded (grab() without retrieve()), or
+// skipped by seeking when the gap is longer than keyframe_interval; only
+// sampled frames are converted to BGR and detected. frame_id is the frame
+// index in the video.
+//
+// Returns {"fps","frame_count","duration_s","sampled","skipped","seeks",
+// "decode_ms","convert_ms","detect_ms","wall_ms","media_s","realtime_factor",
+// "results":[...]}; each result is the usual detection JSON plus
+// "frame_index" and "time_s". decode_ms covers grab() and seeks,
+// convert_ms retrieve() of sampled frames.
+std::string runVideoScan(const std::string& path,
+                         const VideoScanOptions& options,
+                         const VideoDetectFn& detect);
+
+#endif // VIDEO_SCAN_HPP
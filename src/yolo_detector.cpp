@@ -1,28 +1,32 @@
 #include "yolo_detector.hpp"
+#include "detection_log.hpp"
+#include "image_decoder.hpp"
+#include "json_escape.hpp"
+#include "onnx_rewrite.hpp"
+#include "roi_align.hpp"
 
 // Set to 1 to enable debug logging, 0 for production
 #define YOLO_DEBUG 0
 
+#if YOLO_USE_OPENCV
+#include <opencv2/core.hpp>
+#endif
+
 #ifdef __ANDROID__
-#include <opencv2/opencv.hpp>
 #include <android/log.h>
-#include <onnxruntime/nnapi_provider_factory.h>
 #if YOLO_DEBUG
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, "YoloKit", __VA_ARGS__)
 #else
 #define LOGD(...) do {} while(0)
 #endif
 #elif defined(__APPLE__)
-#include <opencv2/opencv.hpp>
 #include <os/log.h>
-#include <onnxruntime/coreml_provider_factory.h>
 #if YOLO_DEBUG
 #define LOGD(...) os_log(OS_LOG_DEFAULT, __VA_ARGS__)
 #else
 #define LOGD(...) do {} while(0)
 #endif
 #else
-#include <opencv2/opencv.hpp>
 #define LOGD(...) do {} while(0)
 #endif
 
@@ -32,9 +36,8 @@
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
-#include <chrono>
-
-using namespace std::chrono;
+#include <fstream>
+#include <iterator>
 
 // Default COCO class names (80 classes)
 static const std::vector<std::string> COCO_CLASSES = {
@@ -57,6 +60,9 @@ YoloDetector::YoloDetector()
     , m_num_classes(80)
     , m_model_type(ModelType::YOLOX)  // Default to YOLOX
     , m_class_names(COCO_CLASSES) {
+    m_scheduler.setCancelHandler([this]() {
+        if (m_backend) m_backend->cancel();
+    });
 }
 
 YoloDetector::~YoloDetector() {
@@ -64,9 +70,7 @@ YoloDetector::~YoloDetector() {
 }
 
 void YoloDetector::release() {
-    m_session.reset();
-    m_session_options.reset();
-    m_env.reset();
+    m_backend.reset();
     m_initialized = false;
     LOGD("YOLO detector released");
 }
@@ -75,56 +79,29 @@ bool YoloDetector::init(const std::string& model_path) {
     try {
         LOGD("Initializing YOLO detector with model: %s", model_path.c_str());
 
-        // Create environment
-        m_env = std::make_unique<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "YoloKit");
-
-        // Create session options
-        m_session_options = std::make_unique<Ort::SessionOptions>();
-        m_session_options->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-        m_session_options->SetIntraOpNumThreads(4);
-        m_session_options->SetInterOpNumThreads(2);
-
-        // Enable hardware acceleration
-#ifdef __ANDROID__
-        LOGD("Attempting to enable NNAPI...");
-        uint32_t nnapi_flags = NNAPI_FLAG_USE_NONE;
-        OrtStatus* status = OrtSessionOptionsAppendExecutionProvider_Nnapi(*m_session_options, nnapi_flags);
-        if (status != nullptr) {
-            const char* error_msg = Ort::GetApi().GetErrorMessage(status);
-            LOGD("NNAPI failed: %s", error_msg);
-            Ort::GetApi().ReleaseStatus(status);
-        } else {
-            LOGD("NNAPI execution provider enabled");
+        BackendOptions options;
+        options.intra_op_threads = m_intra_op_threads;
+        options.intra_op_affinities = m_intra_op_affinities;
+        m_backend = makeInferenceBackend(m_backend_type, options);
+        std::string error;
+        if (!m_backend || !m_backend->load(model_path, error)) {
+            LOGD("Could not load model: %s", error.c_str());
+            m_backend.reset();
+            return false;
         }
-#elif defined(__APPLE__)
-        LOGD("Attempting to enable Core ML...");
-        uint32_t coreml_flags = 0;
-        OrtStatus* status = OrtSessionOptionsAppendExecutionProvider_CoreML(*m_session_options, coreml_flags);
-        if (status != nullptr) {
-            const char* error_msg = Ort::GetApi().GetErrorMessage(status);
-            LOGD("Core ML failed: %s", error_msg);
-            Ort::GetApi().ReleaseStatus(status);
-        } else {
-            LOGD("Core ML execution provider enabled");
-        }
-#endif
-
-        // Create session
-        m_session = std::make_unique<Ort::Session>(*m_env, model_path.c_str(), *m_session_options);
+        LOGD("Inference backend: %s", m_backend->name());
+        m_scheduler.setPreemptionSupported(m_backend->supportsCancel());
 
         // Get input info
-        size_t num_inputs = m_session->GetInputCount();
+        const ModelSignature& signature = m_backend->signature();
+        size_t num_inputs = signature.inputs.size();
         LOGD("Model has %zu inputs", num_inputs);
 
         bool has_scale_factor_input = false;
         for (size_t i = 0; i < num_inputs; i++) {
-            auto name = m_session->GetInputNameAllocated(i, m_allocator);
-            std::string name_str = name.get();
+            const std::string& name_str = signature.inputs[i].name;
             m_input_names_str.push_back(name_str);
-
-            auto type_info = m_session->GetInputTypeInfo(i);
-            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
-            auto shape = tensor_info.GetShape();
+            const std::vector<int64_t>& shape = signature.inputs[i].shape;
 
             // Check if this is a scale_factor input (PP-YOLOE)
             if (name_str.find("scale") != std::string::npos) {
@@ -154,22 +131,37 @@ bool YoloDetector::init(const std::string& model_path) {
         }
 
         // Get output info
-        size_t num_outputs = m_session->GetOutputCount();
+        size_t num_outputs = signature.outputs.size();
         LOGD("Model has %zu outputs", num_outputs);
+        m_multi_head = false;
+        m_embedding_channels = 0;
+        size_t head_outputs = 0;
+        int64_t head_channels = 0;
 
         for (size_t i = 0; i < num_outputs; i++) {
-            auto name = m_session->GetOutputNameAllocated(i, m_allocator);
-            m_output_names_str.push_back(name.get());
+            const char* name = signature.outputs[i].name.c_str();
+            const std::vector<int64_t>& shape = signature.outputs[i].shape;
 
-            auto type_info = m_session->GetOutputTypeInfo(i);
-            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
-            auto shape = tensor_info.GetShape();
+            // The embedding feature map is only fetched on request
+            if (!m_embedding_output.empty() && m_embedding_output == name) {
+                if (shape.size() == 4 && shape[1] > 0) {
+                    m_embedding_channels = static_cast<int>(shape[1]);
+                }
+                LOGD("Output %zu: %s (embedding features, %d channels)", i, name, m_embedding_channels);
+                continue;
+            }
+            m_output_names_str.push_back(name);
 
             int64_t dim1 = shape.size() > 1 ? shape[1] : 0;
             int64_t dim2 = shape.size() > 2 ? shape[2] : 0;
 
             LOGD("Output %zu: %s, shape: [%lld, %lld, %lld]",
-                 i, name.get(), shape[0], dim1, dim2);
+                 i, name, shape.size() > 0 ? shape[0] : -1, dim1, dim2);
+
+            if (shape.size() == 4 && (head_outputs == 0 || dim1 == head_channels)) {
+                head_outputs++;
+                head_channels = dim1;
+            }
 
             // Skip model type detection if already detected as PP-YOLOE
             if (m_model_type == ModelType::PPYOLOE) {
@@ -211,48 +203,210 @@ bool YoloDetector::init(const std::string& model_path) {
             }
         }
 
+        // Several [1, C, H, W] outputs with the same C: raw stride heads
+        // exported without the merging Reshape/Concat/Transpose
+        const size_t detect_outputs = m_output_names_str.size();
+        if (m_model_type != ModelType::PPYOLOE && detect_outputs > 1 && head_outputs == detect_outputs) {
+            m_head_channels = head_channels;
+            m_multi_head = applyHeadLayout();
+            LOGD("Detected %zu raw stride heads", detect_outputs);
+        }
+
+        // YOLOX already takes raw BGR 0-255; nothing to fold
+        m_input_folded = false;
+        if (m_fold_input && m_model_type != ModelType::YOLOX) {
+            foldInput(model_path);
+        }
+        configureStages();
+
         m_initialized = true;
         LOGD("YOLO detector initialized successfully (input: %dx%d, classes: %d)",
              m_input_width, m_input_height, m_num_classes);
         return true;
 
-    } catch (const Ort::Exception& e) {
-        LOGD("ONNX Runtime error: %s", e.what());
-        return false;
     } catch (const std::exception& e) {
         LOGD("Error: %s", e.what());
         return false;
     }
 }
 
+void YoloDetector::foldInput(const std::string& model_path) {
+    std::string input_name;
+    for (const auto& name : m_input_names_str) {
+        if (name.find("scale") == std::string::npos) {
+            input_name = name;
+            break;
+        }
+    }
+
+    std::ifstream file(model_path, std::ios::binary);
+    std::vector<uint8_t> model((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (input_name.empty() || model.empty()) return;
+
+    InputFold fold;
+    fold.scale = 1.0f / 255.0f;
+    fold.swap_rb = true;
+    std::vector<uint8_t> folded;
+    std::string error;
+    if (!foldInputNormalization(model, input_name, fold, folded, error)) {
+        LOGD("Input normalization not folded: %s", error.c_str());
+        return;
+    }
+
+    if (!m_backend->loadFromMemory(folded, error)) {
+        LOGD("Folded model not loaded: %s", error.c_str());
+        return;
+    }
+    m_input_folded = true;
+    LOGD("Input normalization folded into the first convolution");
+}
+
 void YoloDetector::setClassNames(const std::vector<std::string>& names) {
     m_class_names = names;
     m_num_classes = static_cast<int>(names.size());
+
+    // The class count may settle which head layout the channel count means
+    if (m_multi_head) {
+        applyHeadLayout();
+        configureStages();
+    }
 }
 
-char* YoloDetector::detectFromPath(
-    const char* image_path,
-    float conf_threshold,
-    float iou_threshold
-) {
-    if (!m_initialized) {
-        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
+bool YoloDetector::setBackend(BackendType type) {
+    if (!backendAvailable(type)) {
+        return false;
     }
+    m_backend_type = type;
+    return true;
+}
 
-    auto start = high_resolution_clock::now();
+void YoloDetector::setModelType(ModelType type) {
+    m_model_type = type;
+    if (m_initialized) {
+        configureStages();
+    }
+}
+
+bool YoloDetector::applyHeadLayout() {
+    HeadLayout layout;
+    int head_classes = 0;
+    if (!HeadDecoder::classify(m_head_channels, static_cast<int>(m_class_names.size()), layout, head_classes)) {
+        return false;
+    }
 
-    cv::Mat image = cv::imread(image_path);
-    if (image.empty()) {
-        return strdup("{\"error\":\"Could not load image\",\"code\":\"IMAGE_LOAD_FAILED\"}");
+    // DFL heads come from YOLOv8/v11 exports (RGB, /255); YOLOX heads keep
+    // YOLOX preprocessing (BGR, 0-255)
+    m_head_layout = layout;
+    m_model_type = layout == HeadLayout::DFL ? ModelType::YOLOV8 : ModelType::YOLOX;
+    m_num_classes = head_classes;
+    LOGD("Head layout: %s, %d classes", layout == HeadLayout::DFL ? "DFL" : "YOLOX", head_classes);
+    return true;
+}
+
+void YoloDetector::configureStages() {
+    // PP-YOLOE: direct resize to input size (NO letterbox)
+    // YOLOX/YOLOv8: letterbox resize (keep aspect ratio with gray padding)
+    m_letterbox = m_model_type != ModelType::PPYOLOE;
+
+    // YOLOX: BGR format, NO normalization (0-255 range)
+    // YOLOv8/PP-YOLOE: RGB format, normalized to [0, 1], unless that was
+    // folded into the first convolution
+    if (m_model_type == ModelType::YOLOX || m_input_folded) {
+        m_input_format.rgb = false;
+        m_input_format.norm = 1.0f;
+    } else {
+        m_input_format.rgb = true;
+        m_input_format.norm = 1.0f / 255.0f;
     }
 
-    std::vector<Detection> detections = detect(
-        image.data, image.cols, image.rows, conf_threshold, iou_threshold);
+    m_decoder = createDecoder();
+}
+
+std::unique_ptr<OutputDecoder> YoloDetector::createDecoder() const {
+    if (m_multi_head) {
+        return makeHeadsDecoder(m_head_layout, m_input_height);
+    }
+    return makeOutputDecoder(m_model_type, m_input_width, m_input_height);
+}
+
+BoxMapping YoloDetector::tensorMapping(int frame_width, int frame_height, float scale, int pad_x, int pad_y) const {
+    BoxMapping mapping;
+    if (!m_letterbox) {
+        // Stretched to the input size (PP-YOLOE with scale_factor 1)
+        mapping.scale_x = static_cast<float>(m_input_width) / frame_width;
+        mapping.scale_y = static_cast<float>(m_input_height) / frame_height;
+        return mapping;
+    }
+    mapping.scale_x = scale;
+    mapping.scale_y = scale;
+    mapping.pad_x = static_cast<float>(pad_x);
+    mapping.pad_y = static_cast<float>(pad_y);
+    return mapping;
+}
+
+std::vector<Detection> YoloDetector::finishCandidates(
+    const std::vector<HeadBox>& candidates,
+    const BoxMapping& mapping,
+    int frame_width,
+    int frame_height,
+    float iou_threshold,
+    bool suppressed,
+    bool class_names
+) const {
+    std::vector<Detection> detections;
+    detections.reserve(candidates.size());
+    const float max_x = static_cast<float>(frame_width);
+    const float max_y = static_cast<float>(frame_height);
+    for (const HeadBox& box : candidates) {
+        Detection det;
+        det.x1 = std::max(0.0f, std::min((box.x1 - mapping.pad_x) / mapping.scale_x, max_x));
+        det.y1 = std::max(0.0f, std::min((box.y1 - mapping.pad_y) / mapping.scale_y, max_y));
+        det.x2 = std::max(0.0f, std::min((box.x2 - mapping.pad_x) / mapping.scale_x, max_x));
+        det.y2 = std::max(0.0f, std::min((box.y2 - mapping.pad_y) / mapping.scale_y, max_y));
+        det.confidence = box.score;
+        det.class_id = box.class_id;
+        detections.push_back(det);
+    }
+
+    if (!suppressed && iou_threshold >= 0.0f) {
+        detections = nms(detections, iou_threshold);
+    }
+
+    // Names only for what survived NMS
+    if (class_names) {
+        for (Detection& det : detections) {
+            det.class_name = (det.class_id < static_cast<int>(m_class_names.size()))
+                             ? m_class_names[det.class_id]
+                             : "class_" + std::to_string(det.class_id);
+        }
+    }
+    return detections;
+}
+
+void YoloDetector::setDetectionLog(DetectionLogWriter* log) {
+    std::lock_guard<std::mutex> lock(m_log_mutex);
+    m_log = log;
+}
 
-    auto end = high_resolution_clock::now();
-    long long inference_time = duration_cast<milliseconds>(end - start).count();
+char* YoloDetector::detectFromPath(
+    const char* image_path,
+    float conf_threshold,
+    float iou_threshold,
+    FrameTiming timing,
+    RequestPriority priority
+) {
+    return detectJson(fileSource(image_path), conf_threshold, iou_threshold, timing, priority);
+}
 
-    return toJson(detections, inference_time, image.cols, image.rows);
+char* YoloDetector::detectFromMemory(
+    const uint8_t* data,
+    size_t size,
+    float conf_threshold,
+    float iou_threshold,
+    FrameTiming timing,
+    RequestPriority priority
+) {
+    return detectJson(memorySource(data, size), conf_threshold, iou_threshold, timing, priority);
 }
 
 char* YoloDetector::detectFromBuffer(
@@ -261,29 +415,74 @@ char* YoloDetector::detectFromBuffer(
     int height,
     int stride,
     float conf_threshold,
-    float iou_threshold
+    float iou_threshold,
+    FrameTiming timing,
+    RequestPriority priority
 ) {
-    if (!m_initialized) {
-        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
-    }
+    return detectJson(bgraSource(image_data, width, height, stride),
+                      conf_threshold, iou_threshold, timing, priority);
+}
 
-    auto start = high_resolution_clock::now();
+char* YoloDetector::detectFromYUV(
+    const uint8_t* y_data,
+    const uint8_t* u_data,
+    const uint8_t* v_data,
+    int width,
+    int height,
+    int y_row_stride,
+    int uv_row_stride,
+    int uv_pixel_stride,
+    int rotation,
+    float conf_threshold,
+    float iou_threshold,
+    FrameTiming timing,
+    RequestPriority priority
+) {
+    return detectJson(yuvSource(y_data, u_data, v_data, width, height,
+                                y_row_stride, uv_row_stride, uv_pixel_stride, rotation),
+                      conf_threshold, iou_threshold, timing, priority);
+}
 
-    // Convert BGRA to BGR
-    cv::Mat bgra(height, width, CV_8UC4, const_cast<uint8_t*>(image_data), stride);
-    cv::Mat bgr;
-    cv::cvtColor(bgra, bgr, cv::COLOR_BGRA2BGR);
+char* YoloDetector::detectFromFrame(
+    const FrameView& frame,
+    float conf_threshold,
+    float iou_threshold,
+    FrameTiming timing,
+    RequestPriority priority
+) {
+    return detectJson(viewSource(frame), conf_threshold, iou_threshold, timing, priority);
+}
 
-    std::vector<Detection> detections = detect(
-        bgr.data, bgr.cols, bgr.rows, conf_threshold, iou_threshold);
+FrameSource YoloDetector::fileSource(const char* image_path) {
+    return [image_path](DecodedImage& image, FrameView& frame) {
+        if (!imageDecoderAvailable()) return DetectStatus::DecoderUnavailable;
+        if (image_path == nullptr || !decodeImageFile(image_path, image)) return DetectStatus::ImageLoadFailed;
+        frame = image.view();
+        return DetectStatus::Ok;
+    };
+}
 
-    auto end = high_resolution_clock::now();
-    long long inference_time = duration_cast<milliseconds>(end - start).count();
+FrameSource YoloDetector::memorySource(const uint8_t* data, size_t size) {
+    return [data, size](DecodedImage& image, FrameView& frame) {
+        if (!imageDecoderAvailable()) return DetectStatus::DecoderUnavailable;
+        if (data == nullptr || !decodeImageMemory(data, size, image)) return DetectStatus::ImageLoadFailed;
+        frame = image.view();
+        return DetectStatus::Ok;
+    };
+}
 
-    return toJson(detections, inference_time, width, height);
+FrameSource YoloDetector::bgraSource(const uint8_t* image_data, int width, int height, int stride) {
+    // BGRA is sampled directly (alpha channel skipped)
+    FrameView view;
+    view.geometry.format = SourceFormat::BGRA;
+    view.geometry.width = width;
+    view.geometry.height = height;
+    view.geometry.stride = stride;
+    view.data = image_data;
+    return viewSource(view);
 }
 
-char* YoloDetector::detectFromYUV(
+FrameSource YoloDetector::yuvSource(
     const uint8_t* y_data,
     const uint8_t* u_data,
     const uint8_t* v_data,
@@ -292,133 +491,321 @@ char* YoloDetector::detectFromYUV(
     int y_row_stride,
     int uv_row_stride,
     int uv_pixel_stride,
-    int rotation,
+    int rotation
+) {
+    // Y/U/V planes are sampled in place: the plan handles I420 (pixel stride 1),
+    // NV12/NV21 (pixel stride 2, interleaved) and the rotation, so no repacking
+    // into NV21 and no full-frame BGR conversion is needed.
+    FrameView view;
+    view.geometry.format = SourceFormat::YUV420;
+    view.geometry.width = width;
+    view.geometry.height = height;
+    view.geometry.stride = y_row_stride;
+    view.geometry.uv_row_stride = uv_row_stride;
+    view.geometry.uv_pixel_stride = uv_pixel_stride;
+    view.geometry.rotation = (rotation == 90 || rotation == 180 || rotation == 270) ? rotation : 0;
+    view.data = y_data;
+    view.u = u_data;
+    view.v = v_data;
+
+    return viewSource(view);
+}
+
+FrameSource YoloDetector::viewSource(const FrameView& view) {
+    return [view](DecodedImage&, FrameView& frame) {
+        const bool planar = view.geometry.format == SourceFormat::YUV420;
+        if (view.data == nullptr || (planar && (view.u == nullptr || view.v == nullptr)) ||
+            view.geometry.width <= 0 || view.geometry.height <= 0) {
+            return DetectStatus::InvalidInput;
+        }
+        frame = view;
+        return DetectStatus::Ok;
+    };
+}
+
+DetectStatus YoloDetector::detectPresence(
+    const FrameSource& source,
+    const std::vector<int>& class_ids,
     float conf_threshold,
-    float iou_threshold
+    bool& present,
+    FrameTiming timing,
+    RequestPriority priority,
+    StreamContext* stream
 ) {
-    if (!m_initialized) {
-        return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
-    }
+    DetectQuery query;
+    query.mode = DetectQuery::Mode::Presence;
+    query.allowed = classMask(class_ids);
+    query.stream = stream;
 
-    auto start = high_resolution_clock::now();
+    std::vector<Detection> detections;
+    int width = 0;
+    int height = 0;
+    DetectStatus status = runFrame(source, query, conf_threshold, 1.0f, timing, priority, detections, width, height);
+    present = status == DetectStatus::Ok && !detections.empty();
+    return status;
+}
 
-    // Create NV21 format buffer (Y plane + interleaved VU)
-    // This is the most common format on Android
-    std::vector<uint8_t> nv21_data(width * height * 3 / 2);
+DetectStatus YoloDetector::detectCount(
+    const FrameSource& source,
+    const std::vector<int>& class_ids,
+    float conf_threshold,
+    float iou_threshold,
+    std::vector<int>& counts,
+    FrameTiming timing,
+    RequestPriority priority,
+    StreamContext* stream
+) {
+    DetectQuery query;
+    query.mode = DetectQuery::Mode::Count;
+    query.allowed = classMask(class_ids);
+    query.stream = stream;
 
-    // Copy Y plane (handle stride if different from width)
-    if (y_row_stride == width) {
-        memcpy(nv21_data.data(), y_data, width * height);
-    } else {
-        for (int row = 0; row < height; row++) {
-            memcpy(nv21_data.data() + row * width, y_data + row * y_row_stride, width);
+    std::vector<Detection> detections;
+    int width = 0;
+    int height = 0;
+    DetectStatus status = runFrame(source, query, conf_threshold, iou_threshold, timing, priority,
+                                   detections, width, height);
+
+    counts.assign(std::max(m_num_classes, 0), 0);
+    for (const Detection& d : detections) {
+        if (d.class_id >= static_cast<int>(counts.size())) {
+            counts.resize(d.class_id + 1, 0);
         }
+        counts[d.class_id]++;
     }
+    return status;
+}
 
-    // Copy UV data - handle different formats
-    uint8_t* uv_dst = nv21_data.data() + width * height;
+DetectStatus YoloDetector::detectBoxes(
+    const FrameSource& source,
+    float conf_threshold,
+    float iou_threshold,
+    bool with_embeddings,
+    std::vector<Detection>& detections,
+    std::vector<float>& embeddings,
+    int& width,
+    int& height,
+    FrameTiming timing,
+    RequestPriority priority,
+    StreamContext* stream
+) {
+    DetectQuery query;
+    query.mode = DetectQuery::Mode::Boxes;
+    query.embeddings = with_embeddings ? &embeddings : nullptr;
+    query.stream = stream;
+
+    embeddings.clear();
+    DetectStatus status = runFrame(source, query, conf_threshold, iou_threshold, timing, priority,
+                                   detections, width, height);
+    if (status == DetectStatus::Ok) {
+        publishFrame(detections, timing, width, height, stream);
+    }
+    return status;
+}
 
-    if (uv_pixel_stride == 1) {
-        // I420/YV12 format: U and V are in separate planes
-        // Interleave V and U to create NV21
-        for (int row = 0; row < height / 2; row++) {
-            for (int col = 0; col < width / 2; col++) {
-                int src_offset = row * uv_row_stride + col;
-                int dst_offset = row * width + col * 2;
-                uv_dst[dst_offset] = v_data[src_offset];      // V first (NV21)
-                uv_dst[dst_offset + 1] = u_data[src_offset];  // U second
-            }
-        }
-    } else if (uv_pixel_stride == 2) {
-        // NV21 or NV12 format: UV already interleaved
-        // Android YUV_420_888 with pixel_stride=2 means U and V point to same buffer
-        // U points to first byte, V points to second byte (or vice versa)
-        // We need to check which order and convert to NV21 (VU order)
-
-        // Check if it's already NV21 (V comes before U in memory)
-        if (v_data < u_data) {
-            // Already NV21 format, just copy
-            if (uv_row_stride == width) {
-                memcpy(uv_dst, v_data, width * height / 2);
-            } else {
-                for (int row = 0; row < height / 2; row++) {
-                    memcpy(uv_dst + row * width, v_data + row * uv_row_stride, width);
-                }
-            }
-        } else {
-            // NV12 format (UV order), need to swap to NV21 (VU order)
-            for (int row = 0; row < height / 2; row++) {
-                for (int col = 0; col < width / 2; col++) {
-                    int src_offset = row * uv_row_stride + col * 2;
-                    int dst_offset = row * width + col * 2;
-                    uv_dst[dst_offset] = v_data[src_offset];      // V (was at +1 in NV12)
-                    uv_dst[dst_offset + 1] = u_data[src_offset];  // U (was at +0 in NV12)
-                }
-            }
+std::vector<bool> YoloDetector::classMask(const std::vector<int>& class_ids) const {
+    std::vector<bool> mask;
+    for (int id : class_ids) {
+        if (id < 0) continue;
+        if (id >= static_cast<int>(mask.size())) {
+            mask.resize(std::max(id + 1, m_num_classes), false);
         }
+        mask[id] = true;
     }
+    return mask;
+}
 
-    // Convert NV21 to BGR
-    cv::Mat nv21(height * 3 / 2, width, CV_8UC1, nv21_data.data());
-    cv::Mat bgr;
-    cv::cvtColor(nv21, bgr, cv::COLOR_YUV2BGR_NV21);
+// Why the scheduler did not grant a lease
+static DetectStatus leaseStatus(const RequestScheduler::Lease& lease) {
+    switch (lease.status()) {
+        case AdmitStatus::Rejected: return DetectStatus::QueueFull;
+        case AdmitStatus::Shed: return DetectStatus::FrameShed;
+        default: return DetectStatus::Cancelled;
+    }
+}
 
-    // Apply rotation if needed
-    if (rotation == 90) {
-        cv::rotate(bgr, bgr, cv::ROTATE_90_CLOCKWISE);
-    } else if (rotation == 180) {
-        cv::rotate(bgr, bgr, cv::ROTATE_180);
-    } else if (rotation == 270) {
-        cv::rotate(bgr, bgr, cv::ROTATE_90_COUNTERCLOCKWISE);
+DetectStatus YoloDetector::runFrame(
+    const FrameSource& source,
+    const DetectQuery& query,
+    float conf_threshold,
+    float iou_threshold,
+    FrameTiming& timing,
+    RequestPriority priority,
+    std::vector<Detection>& detections,
+    int& width,
+    int& height
+) {
+    if (timing.enqueue_ts_ns == 0) {
+        timing.enqueue_ts_ns = monotonicNowNs();
+    }
+    RequestScheduler::Lease lease = m_scheduler.acquire(priority);
+    timing.start_ts_ns = monotonicNowNs();
+    if (!lease.granted()) {
+        return leaseStatus(lease);
     }
 
-    // Get final dimensions after rotation
-    int final_width = bgr.cols;
-    int final_height = bgr.rows;
+    if (!m_initialized) {
+        return DetectStatus::NotInitialized;
+    }
+
+    DecodedImage image;
+    FrameView frame;
+    DetectStatus status = source(image, frame);
+    if (status != DetectStatus::Ok) {
+        return status;
+    }
+
+    // Detections are reported in the rotated frame
+    width = frame.geometry.rotatedWidth();
+    height = frame.geometry.rotatedHeight();
+
+    detections = detect(frame, conf_threshold, iou_threshold, query);
+    if (m_preempted) {
+        return m_scheduler.noteStopped(priority) ? DetectStatus::Cancelled : DetectStatus::Preempted;
+    }
+
+    timing.end_ts_ns = monotonicNowNs();
+    m_metrics.record(timing);
+    if (query.stream != nullptr) {
+        query.stream->metrics().record(timing);
+    }
+    return DetectStatus::Ok;
+}
+
+DetectStatus YoloDetector::runTensor(
+    const float* input,
+    const int64_t* shape,
+    int rank,
+    TensorRun& run,
+    FrameTiming timing,
+    RequestPriority priority
+) {
+    if (input == nullptr || shape == nullptr || rank != 4 || shape[1] != 3) {
+        return DetectStatus::InvalidInput;
+    }
+    for (int i = 0; i < rank; i++) {
+        if (shape[i] <= 0) return DetectStatus::InvalidInput;
+    }
+
+    if (timing.enqueue_ts_ns == 0) {
+        timing.enqueue_ts_ns = monotonicNowNs();
+    }
+    RequestScheduler::Lease lease = m_scheduler.acquire(priority);
+    timing.start_ts_ns = monotonicNowNs();
+    if (!lease.granted()) {
+        return leaseStatus(lease);
+    }
+
+    if (!m_initialized) {
+        return DetectStatus::NotInitialized;
+    }
+
+    run.names = m_output_names_str;
+    if (m_embedding_channels > 0) {
+        run.names.push_back(m_embedding_output);
+    }
+
+    // The caller's tensor is used in place
+    std::vector<float> scale_factor_data(static_cast<size_t>(shape[0]) * 2, 1.0f);
+    const int64_t scale_shape[2] = {shape[0], 2};
+    std::vector<BackendInput> inputs;
+    for (const auto& name : m_input_names_str) {
+        if (m_model_type == ModelType::PPYOLOE && m_input_names_str.size() >= 2 &&
+            name.find("scale") != std::string::npos) {
+            inputs.push_back({scale_factor_data.data(), scale_shape, 2});
+        } else {
+            inputs.push_back({input, shape, rank});
+        }
+    }
+
+    m_backend->clearCancel();
+    if (m_scheduler.cancelRequested()) {
+        return m_scheduler.noteStopped(priority) ? DetectStatus::Cancelled : DetectStatus::Preempted;
+    }
+    BackendOutputs outputs;
+    std::string error;
+    if (!m_backend->run(inputs, run.names, outputs, error)) {
+        LOGD("Inference error: %s", error.c_str());
+        run.names.clear();
+        if (m_scheduler.cancelRequested()) {
+            return m_scheduler.noteStopped(priority) ? DetectStatus::Cancelled : DetectStatus::Preempted;
+        }
+        return DetectStatus::InvalidInput;
+    }
+    run.outputs = std::move(outputs.tensors);
+    run.storage = std::move(outputs.storage);
 
-    std::vector<Detection> detections = detect(
-        bgr.data, final_width, final_height, conf_threshold, iou_threshold);
+    timing.end_ts_ns = monotonicNowNs();
+    m_metrics.record(timing);
+    return DetectStatus::Ok;
+}
 
-    auto end = high_resolution_clock::now();
-    long long inference_time = duration_cast<milliseconds>(end - start).count();
+char* YoloDetector::detectJson(
+    const FrameSource& source,
+    float conf_threshold,
+    float iou_threshold,
+    FrameTiming timing,
+    RequestPriority priority,
+    StreamContext* stream,
+    DetectStatus* status_out
+) {
+    DetectQuery query;
+    query.stream = stream;
 
-    return toJson(detections, inference_time, final_width, final_height);
+    std::vector<Detection> detections;
+    int width = 0;
+    int height = 0;
+    DetectStatus status = runFrame(source, query, conf_threshold, iou_threshold, timing, priority,
+                                   detections, width, height);
+    if (status_out != nullptr) {
+        *status_out = status;
+    }
+    if (status != DetectStatus::Ok) {
+        return statusError(status);
+    }
+    return finishFrame(detections, timing, width, height, stream);
 }
 
 std::vector<Detection> YoloDetector::detect(
-    const uint8_t* bgr_data,
-    int width,
-    int height,
+    const FrameView& frame,
     float conf_threshold,
-    float iou_threshold
+    float iou_threshold,
+    const DetectQuery& query
 ) {
     std::vector<Detection> results;
+    m_preempted = false;
+
+    // Detections are reported in the rotated frame
+    const int width = frame.geometry.rotatedWidth();
+    const int height = frame.geometry.rotatedHeight();
 
     try {
         // Preprocess
         float scale;
         int pad_x, pad_y;
-        std::vector<float> input_tensor = preprocess(bgr_data, width, height, scale, pad_x, pad_y);
+        preprocess(frame, query.stream, scale, pad_x, pad_y);
+        std::vector<float>& input_tensor = m_input_tensor;
 
         // Prepare input
-        std::vector<int64_t> input_shape = {1, 3, m_input_height, m_input_width};
-        Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-
-        // Prepare input names and output names
-        std::vector<const char*> input_names;
-        std::vector<const char*> output_names;
-        for (const auto& name : m_input_names_str) {
-            input_names.push_back(name.c_str());
-        }
-        for (const auto& name : m_output_names_str) {
-            output_names.push_back(name.c_str());
+        const int64_t input_shape[4] = {1, 3, m_input_height, m_input_width};
+        const BackendInput image_input = {input_tensor.data(), input_shape, 4};
+
+        // Output names: detection outputs, then the embedding features if wanted
+        const bool want_embeddings = query.embeddings != nullptr && m_embedding_channels > 0 &&
+                                     query.mode != DetectQuery::Mode::Presence;
+        const std::vector<std::string>* output_names = &m_output_names_str;
+        std::vector<std::string> names_with_features;
+        if (want_embeddings) {
+            names_with_features = m_output_names_str;
+            names_with_features.push_back(m_embedding_output);
+            output_names = &names_with_features;
         }
 
-        std::vector<Ort::Value> input_values;
+        std::vector<BackendInput> inputs;
 
         // Declare scale_factor outside if block to keep it alive during inference
-        std::vector<float> scale_factor_data;
-        std::vector<int64_t> scale_shape = {1, 2};
+        float scale_factor_data[2] = {1.0f, 1.0f};
+        const int64_t scale_shape[2] = {1, 2};
 
         if (m_model_type == ModelType::PPYOLOE && m_input_names_str.size() >= 2) {
             // PP-YOLOE requires two inputs: image and scale_factor
@@ -442,56 +829,88 @@ std::vector<Detection> YoloDetector::detect(
             // Model will use this to scale output coordinates back to original space
             float scale_y = static_cast<float>(m_input_height) / static_cast<float>(height);
             float scale_x = static_cast<float>(m_input_width) / static_cast<float>(width);
-            scale_factor_data = {scale_y, scale_x};
+            scale_factor_data[0] = scale_y;
+            scale_factor_data[1] = scale_x;
 
             LOGD("PP-YOLOE scale_factor: [%.4f, %.4f] (input/orig, orig: %dx%d, input: %dx%d)",
                  scale_y, scale_x, width, height, m_input_width, m_input_height);
 
             // Create input tensors in correct order
-            std::vector<Ort::Value> temp_values;
             for (size_t i = 0; i < m_input_names_str.size(); i++) {
                 if (static_cast<int>(i) == image_idx) {
-                    temp_values.push_back(Ort::Value::CreateTensor<float>(
-                        memory_info, input_tensor.data(), input_tensor.size(),
-                        input_shape.data(), input_shape.size()));
+                    inputs.push_back(image_input);
                 } else if (static_cast<int>(i) == scale_idx) {
-                    temp_values.push_back(Ort::Value::CreateTensor<float>(
-                        memory_info, scale_factor_data.data(), scale_factor_data.size(),
-                        scale_shape.data(), scale_shape.size()));
+                    inputs.push_back({scale_factor_data, scale_shape, 2});
                 }
             }
-            input_values = std::move(temp_values);
 
             LOGD("PP-YOLOE: Using %zu inputs (image_idx=%d, scale_idx=%d)",
-                 input_values.size(), image_idx, scale_idx);
+                 inputs.size(), image_idx, scale_idx);
         } else {
             // Single input model (YOLOX, YOLOv8)
-            input_values.push_back(Ort::Value::CreateTensor<float>(
-                memory_info, input_tensor.data(), input_tensor.size(),
-                input_shape.data(), input_shape.size()));
+            inputs.push_back(image_input);
         }
 
-        // Run inference
-        auto outputs = m_session->Run(
-            Ort::RunOptions{nullptr},
-            input_names.data(), input_values.data(), input_values.size(),
-            output_names.data(), output_names.size());
+        // Run inference (the scheduler may terminate it to serve higher priority work)
+        m_backend->clearCancel();
+        BackendOutputs outputs;
+        std::string error;
+        bool ran = false;
+        if (m_scheduler.cancelRequested()) {
+            m_preempted = true;
+        } else {
+            ran = m_backend->run(inputs, *output_names, outputs, error);
+        }
+        if (!ran) {
+            if (!m_preempted) {
+                LOGD("Inference error: %s", error.c_str());
+                m_preempted = m_scheduler.cancelRequested();
+            }
+            return results;
+        }
 
-        // Get output tensor info
-        auto output_info = outputs[0].GetTensorTypeAndShapeInfo();
-        auto output_shape = output_info.GetShape();
-        size_t output_count = output_info.GetElementCount();
-        float* output_data = outputs[0].GetTensorMutableData<float>();
+        // Feature map for embeddings comes last; detection outputs keep their order
+        OutputTensor features;
+        if (want_embeddings) {
+            features = std::move(outputs.tensors.back());
+            outputs.tensors.pop_back();
+        }
 
-        LOGD("Output tensor: shape dims=%zu, element_count=%zu", output_shape.size(), output_count);
+        // Decode in model output coordinates, then map to the frame. PP-YOLOE
+        // was fed the real scale_factor, so its boxes are already in the frame.
+        CandidateFilter filter;
+        filter.conf_threshold = conf_threshold;
+        filter.allowed = &query.allowed;
+        filter.first_hit = query.mode == DetectQuery::Mode::Presence;
+        m_candidates.clear();
+        m_decoder->decode(outputs.tensors, filter, m_candidates);
+
+        BoxMapping mapping;
+        if (m_model_type != ModelType::PPYOLOE) {
+            mapping = tensorMapping(width, height, scale, pad_x, pad_y);
+        }
+        results = finishCandidates(m_candidates, mapping, width, height,
+                                   filter.first_hit ? -1.0f : iou_threshold, m_decoder->suppressed(),
+                                   query.mode == DetectQuery::Mode::Detections);
+        LOGD("Detected %zu objects (%zu candidates)", results.size(), m_candidates.size());
 
-        // Postprocess
-        results = postprocess(output_data, output_shape, output_count, width, height, scale, pad_x, pad_y, conf_threshold, iou_threshold);
+        if (want_embeddings) {
+            // PP-YOLOE stretches the frame to the input size; the others letterbox
+            if (m_model_type == ModelType::PPYOLOE) {
+                poolEmbeddings(features, results,
+                               static_cast<float>(m_input_width) / width,
+                               static_cast<float>(m_input_height) / height,
+                               0.0f, 0.0f, *query.embeddings);
+            } else {
+                poolEmbeddings(features, results, scale, scale,
+                               static_cast<float>(pad_x), static_cast<float>(pad_y), *query.embeddings);
+            }
+        }
 
-    } catch (const Ort::Exception& e) {
-        LOGD("ONNX Runtime error: %s", e.what());
+#if YOLO_USE_OPENCV
     } catch (const cv::Exception& e) {
         LOGD("OpenCV error: %s", e.what());
+#endif
     } catch (const std::exception& e) {
         LOGD("Error: %s", e.what());
     }
@@ -499,378 +918,75 @@ std::vector<Detection> YoloDetector::detect(
     return results;
 }
 
-std::vector<float> YoloDetector::preprocess(
-    const uint8_t* bgr_data,
-    int width,
-    int height,
+void YoloDetector::preprocess(
+    const FrameView& frame,
+    StreamContext* stream,
     float& scale,
     int& pad_x,
     int& pad_y
 ) {
-    // Create cv::Mat from BGR data
-    cv::Mat image(height, width, CV_8UC3, const_cast<uint8_t*>(bgr_data));
-
-    cv::Mat resized_final;
-
-    if (m_model_type == ModelType::PPYOLOE) {
-        // PP-YOLOE: Direct resize to input size (NO letterbox)
-        cv::resize(image, resized_final, cv::Size(m_input_width, m_input_height), 0, 0, cv::INTER_LINEAR);
-        scale = 1.0f;  // Not used for PP-YOLOE
-        pad_x = 0;
-        pad_y = 0;
-        LOGD("PP-YOLOE preprocess: direct resize %dx%d -> %dx%d", width, height, m_input_width, m_input_height);
-    } else {
-        // YOLOX/YOLOv8: Letterbox resize (keep aspect ratio with padding)
-        float scale_x = static_cast<float>(m_input_width) / width;
-        float scale_y = static_cast<float>(m_input_height) / height;
-        scale = std::min(scale_x, scale_y);
-
-        int new_width = static_cast<int>(width * scale);
-        int new_height = static_cast<int>(height * scale);
-
-        pad_x = (m_input_width - new_width) / 2;
-        pad_y = (m_input_height - new_height) / 2;
-
-        // Resize
-        cv::Mat resized;
-        cv::resize(image, resized, cv::Size(new_width, new_height), 0, 0, cv::INTER_LINEAR);
-
-        // Create padded image (gray padding: 114)
-        resized_final = cv::Mat(m_input_height, m_input_width, CV_8UC3, cv::Scalar(114, 114, 114));
-        resized.copyTo(resized_final(cv::Rect(pad_x, pad_y, new_width, new_height)));
-    }
-
-    // Convert to CHW format
-    std::vector<float> tensor(3 * m_input_height * m_input_width);
-    int channel_size = m_input_height * m_input_width;
-
-    if (m_model_type == ModelType::YOLOX) {
-        // YOLOX: BGR format, NO normalization (0-255 range)
-        for (int y = 0; y < m_input_height; y++) {
-            for (int x = 0; x < m_input_width; x++) {
-                cv::Vec3b pixel = resized_final.at<cv::Vec3b>(y, x);
-                int idx = y * m_input_width + x;
-                tensor[0 * channel_size + idx] = static_cast<float>(pixel[0]);  // B
-                tensor[1 * channel_size + idx] = static_cast<float>(pixel[1]);  // G
-                tensor[2 * channel_size + idx] = static_cast<float>(pixel[2]);  // R
-            }
-        }
-    } else {
-        // YOLOv8/PP-YOLOE: RGB format, normalized to [0, 1]
-        cv::Mat rgb;
-        cv::cvtColor(resized_final, rgb, cv::COLOR_BGR2RGB);
-
-        for (int y = 0; y < m_input_height; y++) {
-            for (int x = 0; x < m_input_width; x++) {
-                cv::Vec3b pixel = rgb.at<cv::Vec3b>(y, x);
-                int idx = y * m_input_width + x;
-                tensor[0 * channel_size + idx] = pixel[0] / 255.0f;  // R
-                tensor[1 * channel_size + idx] = pixel[1] / 255.0f;  // G
-                tensor[2 * channel_size + idx] = pixel[2] / 255.0f;  // B
-            }
-        }
-    }
+    const bool letterbox = m_letterbox;
+    const TensorFormat& format = m_input_format;
 
-    return tensor;
-}
+    m_input_tensor.resize(static_cast<size_t>(3) * m_input_height * m_input_width);
 
-std::vector<Detection> YoloDetector::postprocess(
-    const float* output,
-    const std::vector<int64_t>& output_shape,
-    size_t output_count,
-    int original_width,
-    int original_height,
-    float scale,
-    int pad_x,
-    int pad_y,
-    float conf_threshold,
-    float iou_threshold
-) {
-    std::vector<Detection> detections;
-
-    // Handle different output shape dimensions
-    int64_t dim1 = 0, dim2 = 0;
-
-    if (output_shape.size() == 2) {
-        // 2D output: could be [batch, total_values] or [num_detections, 6]
-        dim1 = output_shape[0];
-        dim2 = output_shape[1];
-        LOGD("Postprocess: model_type=%d, shape=[%lld, %lld] (2D), count=%zu",
-             static_cast<int>(m_model_type), dim1, dim2, output_count);
-    } else if (output_shape.size() >= 3) {
-        dim1 = output_shape[1];
-        dim2 = output_shape[2];
-        LOGD("Postprocess: model_type=%d, shape=[1, %lld, %lld], count=%zu",
-             static_cast<int>(m_model_type), dim1, dim2, output_count);
-    } else if (output_shape.size() == 1) {
-        // 1D output - use element count
-        dim1 = static_cast<int64_t>(output_count);
-        dim2 = 0;
-        LOGD("Postprocess: model_type=%d, shape=[%lld] (1D), count=%zu",
-             static_cast<int>(m_model_type), dim1, output_count);
-    } else {
-        LOGD("Unexpected output shape size: %zu", output_shape.size());
-        return detections;
-    }
-
-    if (m_model_type == ModelType::PPYOLOE) {
-        // PP-YOLOE output can be:
-        // [N, 6] = 2D format (dim1=N, dim2=6)
-        // [1, N, 6] = 3D format (dim1=N, dim2=6)
-        // [1, 6, N] = transposed 3D format (dim1=6, dim2=N)
-        // Coordinates are in letterbox scale, need to convert back
-
-        bool transposed = false;
-        int num_detections = 0;
-
-        if (output_shape.size() == 2) {
-            // 2D output: [N, 6] format
-            if (dim2 == 6) {
-                num_detections = static_cast<int>(dim1);
-                transposed = false;
-            } else if (dim1 == 6) {
-                num_detections = static_cast<int>(dim2);
-                transposed = true;
-            } else {
-                // Use element count
-                num_detections = static_cast<int>(output_count / 6);
-            }
-        } else if (output_shape.size() >= 3) {
-            if (dim1 == 6 && dim2 > 0) {
-                // [1, 6, N] format
-                transposed = true;
-                num_detections = static_cast<int>(dim2);
-            } else if (dim2 == 6 && dim1 > 0) {
-                // [1, N, 6] format
-                transposed = false;
-                num_detections = static_cast<int>(dim1);
-            } else if (dim1 == 6) {
-                // [1, 6, N] with dynamic N - use element count
-                transposed = true;
-                num_detections = static_cast<int>(output_count / 6);
-            }
-        } else {
-            // Fallback: use element count
-            num_detections = static_cast<int>(output_count / 6);
-        }
-
-        LOGD("PP-YOLOE: processing %d detections, transposed=%d, dim1=%lld, dim2=%lld, count=%zu",
-             num_detections, transposed, dim1, dim2, output_count);
-
-
-        // If num_detections is 0, no objects detected
-        if (num_detections <= 0) {
-            LOGD("PP-YOLOE: no detections");
-            return detections;
-        }
-
-        for (int i = 0; i < num_detections; i++) {
-            int class_id;
-            float score, x1, y1, x2, y2;
-
-            // PP-YOLOE output [N, 6] format - always row-major
-            // Each row: [class_id, score, x1, y1, x2, y2]
-            const float* det_data = output + i * 6;
-            class_id = static_cast<int>(det_data[0]);
-            score = det_data[1];
-            x1 = det_data[2];
-            y1 = det_data[3];
-            x2 = det_data[4];
-            y2 = det_data[5];
-
-            if (score < conf_threshold) continue;
-            if (class_id < 0) continue;
-
-            // PP-YOLOE with scale_factor=[input/orig] outputs coordinates already in original image space
-            // The model internally uses scale_factor to convert its predictions
-            // No additional scaling needed here
-
-            // Clamp to image bounds
-            x1 = std::max(0.0f, std::min(x1, static_cast<float>(original_width)));
-            y1 = std::max(0.0f, std::min(y1, static_cast<float>(original_height)));
-            x2 = std::max(0.0f, std::min(x2, static_cast<float>(original_width)));
-            y2 = std::max(0.0f, std::min(y2, static_cast<float>(original_height)));
-
-            Detection det;
-            det.x1 = x1;
-            det.y1 = y1;
-            det.x2 = x2;
-            det.y2 = y2;
-            det.confidence = score;
-            det.class_id = class_id;
-            det.class_name = (class_id < static_cast<int>(m_class_names.size()))
-                             ? m_class_names[class_id]
-                             : "class_" + std::to_string(class_id);
-
-            detections.push_back(det);
-        }
-
-        // PP-YOLOE already has NMS applied
-        LOGD("PP-YOLOE: detected %zu objects", detections.size());
-        return detections;
+    // Each stream keeps the plan for its own camera geometry
+    if (stream != nullptr) {
+        stream->sample(frame, m_input_width, m_input_height, letterbox, format, m_input_tensor.data(),
+                       scale, pad_x, pad_y);
+        return;
     }
 
-    if (m_model_type == ModelType::YOLOX) {
-        // YOLOX output: [1, num_boxes, 85] = [cx, cy, w, h, objectness, class_scores...]
-        // Need to decode with grid and stride
-        // 8400 = 80*80 + 40*40 + 20*20 (strides: 8, 16, 32)
-        int num_boxes = static_cast<int>(dim1);
-        int features = static_cast<int>(dim2);  // 85 = 4 + 1 + 80
-
-        LOGD("YOLOX: processing %d boxes with %d features", num_boxes, features);
-
-        // Generate grids and strides for decoding
-        std::vector<float> grids_x, grids_y, strides_vec;
-        int strides[] = {8, 16, 32};
-
-        for (int stride : strides) {
-            int grid_size = m_input_width / stride;
-            for (int gy = 0; gy < grid_size; gy++) {
-                for (int gx = 0; gx < grid_size; gx++) {
-                    grids_x.push_back(static_cast<float>(gx));
-                    grids_y.push_back(static_cast<float>(gy));
-                    strides_vec.push_back(static_cast<float>(stride));
-                }
-            }
-        }
-
-        for (int i = 0; i < num_boxes; i++) {
-            const float* box_data = output + i * features;
-
-            float objectness = box_data[4];
-
-            // Early filter by objectness
-            if (objectness < conf_threshold) continue;
-
-            // Find max class score
-            float max_class_score = 0.0f;
-            int max_class = 0;
-            const float* class_scores = box_data + 5;
-
-            for (int c = 0; c < m_num_classes; c++) {
-                if (class_scores[c] > max_class_score) {
-                    max_class_score = class_scores[c];
-                    max_class = c;
-                }
-            }
+    // Rebuild the sampling plan only when the frame geometry changes
+    if (!m_plan.matches(frame.geometry, m_input_width, m_input_height, letterbox)) {
+        m_plan.build(frame.geometry, m_input_width, m_input_height, letterbox);
+        LOGD("Sampling plan rebuilt: %dx%d rot=%d -> %dx%d (letterbox=%d)",
+             frame.geometry.width, frame.geometry.height, frame.geometry.rotation,
+             m_input_width, m_input_height, letterbox);
+    }
 
-            // Final confidence = objectness * class_score
-            float confidence = objectness * max_class_score;
-            if (confidence < conf_threshold) continue;
-
-            // Decode coordinates using grid and stride
-            float grid_x = grids_x[i];
-            float grid_y = grids_y[i];
-            float stride = strides_vec[i];
-
-            float cx = (box_data[0] + grid_x) * stride;
-            float cy = (box_data[1] + grid_y) * stride;
-            float w = std::exp(box_data[2]) * stride;
-            float h = std::exp(box_data[3]) * stride;
-
-            // Convert from letterbox coordinates to original image coordinates
-            float x1 = (cx - w / 2.0f - pad_x) / scale;
-            float y1 = (cy - h / 2.0f - pad_y) / scale;
-            float x2 = (cx + w / 2.0f - pad_x) / scale;
-            float y2 = (cy + h / 2.0f - pad_y) / scale;
-
-            // Clamp to image bounds
-            x1 = std::max(0.0f, std::min(x1, static_cast<float>(original_width)));
-            y1 = std::max(0.0f, std::min(y1, static_cast<float>(original_height)));
-            x2 = std::max(0.0f, std::min(x2, static_cast<float>(original_width)));
-            y2 = std::max(0.0f, std::min(y2, static_cast<float>(original_height)));
-
-            Detection det;
-            det.x1 = x1;
-            det.y1 = y1;
-            det.x2 = x2;
-            det.y2 = y2;
-            det.confidence = confidence;
-            det.class_id = max_class;
-            det.class_name = (max_class < static_cast<int>(m_class_names.size()))
-                             ? m_class_names[max_class]
-                             : "class_" + std::to_string(max_class);
-
-            detections.push_back(det);
-        }
-    } else {
-        // YOLOv8/v11 output: [1, 84, num_boxes] or [1, num_boxes, 84]
-        // No objectness, direct class scores
-        bool transposed = (dim1 > dim2);  // [1, num_boxes, features]
-        int num_boxes = transposed ? static_cast<int>(dim1) : static_cast<int>(dim2);
-        int features = transposed ? static_cast<int>(dim2) : static_cast<int>(dim1);
-        int num_classes = features - 4;
-
-        LOGD("YOLOv8: processing %d boxes, transposed=%d", num_boxes, transposed);
-
-        for (int i = 0; i < num_boxes; i++) {
-            float cx, cy, w, h;
-
-            if (transposed) {
-                const float* box_data = output + i * features;
-                cx = box_data[0];
-                cy = box_data[1];
-                w = box_data[2];
-                h = box_data[3];
-            } else {
-                cx = output[0 * num_boxes + i];
-                cy = output[1 * num_boxes + i];
-                w = output[2 * num_boxes + i];
-                h = output[3 * num_boxes + i];
-            }
+    scale = m_plan.scale();
+    pad_x = m_plan.padX();
+    pad_y = m_plan.padY();
+    m_plan.sample(frame, format, m_input_tensor.data());
+}
 
-            // Find max class score
-            float max_score = 0.0f;
-            int max_class = 0;
+void YoloDetector::poolEmbeddings(
+    const OutputTensor& features,
+    const std::vector<Detection>& detections,
+    float scale_x,
+    float scale_y,
+    float pad_x,
+    float pad_y,
+    std::vector<float>& embeddings
+) {
+    embeddings.clear();
+    const std::vector<int64_t>& shape = features.shape;
+    if (features.data == nullptr || shape.size() != 4 || shape[1] != m_embedding_channels ||
+        shape[2] <= 0 || shape[3] <= 0) {
+        LOGD("Unexpected embedding feature shape");
+        return;
+    }
 
-            for (int c = 0; c < num_classes; c++) {
-                float score;
-                if (transposed) {
-                    score = output[i * features + 4 + c];
-                } else {
-                    score = output[(4 + c) * num_boxes + i];
-                }
+    FeatureMap map;
+    map.data = features.data;
+    map.channels = static_cast<int>(shape[1]);
+    map.height = static_cast<int>(shape[2]);
+    map.width = static_cast<int>(shape[3]);
 
-                if (score > max_score) {
-                    max_score = score;
-                    max_class = c;
-                }
-            }
+    // Model input pixels -> feature cells
+    const float cells_x = static_cast<float>(map.width) / m_input_width;
+    const float cells_y = static_cast<float>(map.height) / m_input_height;
 
-            if (max_score < conf_threshold) continue;
-
-            // Convert from letterbox coordinates to original image coordinates
-            float x1 = (cx - w / 2.0f - pad_x) / scale;
-            float y1 = (cy - h / 2.0f - pad_y) / scale;
-            float x2 = (cx + w / 2.0f - pad_x) / scale;
-            float y2 = (cy + h / 2.0f - pad_y) / scale;
-
-            // Clamp to image bounds
-            x1 = std::max(0.0f, std::min(x1, static_cast<float>(original_width)));
-            y1 = std::max(0.0f, std::min(y1, static_cast<float>(original_height)));
-            x2 = std::max(0.0f, std::min(x2, static_cast<float>(original_width)));
-            y2 = std::max(0.0f, std::min(y2, static_cast<float>(original_height)));
-
-            Detection det;
-            det.x1 = x1;
-            det.y1 = y1;
-            det.x2 = x2;
-            det.y2 = y2;
-            det.confidence = max_score;
-            det.class_id = max_class;
-            det.class_name = (max_class < static_cast<int>(m_class_names.size()))
-                             ? m_class_names[max_class]
-                             : "class_" + std::to_string(max_class);
-
-            detections.push_back(det);
-        }
+    const size_t dim = static_cast<size_t>(embeddingDim());
+    embeddings.resize(detections.size() * dim);
+    for (size_t i = 0; i < detections.size(); i++) {
+        const Detection& d = detections[i];
+        roiAlignEmbedding(map,
+                          (d.x1 * scale_x + pad_x) * cells_x, (d.y1 * scale_y + pad_y) * cells_y,
+                          (d.x2 * scale_x + pad_x) * cells_x, (d.y2 * scale_y + pad_y) * cells_y,
+                          m_embedding_pooled, embeddings.data() + i * dim);
     }
-
-    // Apply NMS
-    detections = nms(detections, iou_threshold);
-
-    LOGD("Detected %zu objects after NMS", detections.size());
-    return detections;
 }
 
 float YoloDetector::iou(const Detection& a, const Detection& b) {
@@ -920,12 +1036,66 @@ std::vector<Detection> YoloDetector::nms(
     return result;
 }
 
+char* YoloDetector::statusError(DetectStatus status) {
+    switch (status) {
+        case DetectStatus::NotInitialized:
+            return strdup("{\"error\":\"Detector not initialized\",\"code\":\"NOT_INITIALIZED\"}");
+        case DetectStatus::InvalidInput:
+            return strdup("{\"error\":\"Invalid image buffer\",\"code\":\"INVALID_ARGUMENT\"}");
+        case DetectStatus::ImageLoadFailed:
+            return strdup("{\"error\":\"Could not load image\",\"code\":\"IMAGE_LOAD_FAILED\"}");
+        case DetectStatus::DecoderUnavailable:
+            return strdup("{\"error\":\"Built without an image decoder\",\"code\":\"DECODER_UNAVAILABLE\"}");
+        case DetectStatus::QueueFull:
+            return strdup("{\"error\":\"Request queue is full\",\"code\":\"QUEUE_FULL\"}");
+        case DetectStatus::FrameShed:
+            return strdup("{\"error\":\"Superseded by a newer frame\",\"code\":\"FRAME_SHED\"}");
+        case DetectStatus::Preempted:
+            return strdup("{\"error\":\"Preempted by a higher priority request\",\"code\":\"CANCELLED\"}");
+        default:
+            return strdup("{\"error\":\"Request cancelled\",\"code\":\"CANCELLED\"}");
+    }
+}
+
+char* YoloDetector::finishFrame(
+    const std::vector<Detection>& detections,
+    FrameTiming& timing,
+    int image_width,
+    int image_height,
+    StreamContext* stream
+) {
+    publishFrame(detections, timing, image_width, image_height, stream);
+    return toJson(detections, timing, image_width, image_height);
+}
+
+void YoloDetector::publishFrame(
+    const std::vector<Detection>& detections,
+    const FrameTiming& timing,
+    int image_width,
+    int image_height,
+    StreamContext* stream
+) {
+    LatestResult& latest = stream != nullptr ? stream->latest() : *m_latest_target;
+    latest.publish(timing, image_width, image_height, detections);
+
+    int64_t timestamp_ns = timing.capture_ts_ns > 0 ? timing.capture_ts_ns : timing.start_ts_ns;
+    if (stream != nullptr && stream->logFrame(timestamp_ns, image_width, image_height, detections)) {
+        return;
+    }
+    std::lock_guard<std::mutex> log_lock(m_log_mutex);
+    if (m_log != nullptr) {
+        m_log->writeFrame(timestamp_ns, image_width, image_height, detections);
+    }
+}
+
 char* YoloDetector::toJson(
     const std::vector<Detection>& detections,
-    long long inference_time_ms,
+    const FrameTiming& timing,
     int image_width,
     int image_height
 ) {
+    long long inference_time_ms = (timing.end_ts_ns - timing.start_ts_ns) / 1000000;
+
     std::ostringstream oss;
     oss << "{\"detections\":[";
 
@@ -934,7 +1104,9 @@ char* YoloDetector::toJson(
         if (i > 0) oss << ",";
         oss << "{"
             << "\"class_id\":" << d.class_id << ","
-            << "\"class_name\":\"" << d.class_name << "\","
+            << "\"class_name\":";
+        writeJsonString(oss, d.class_name);
+        oss << ","
             << "\"confidence\":" << std::fixed << std::setprecision(4) << d.confidence << ","
             << "\"x1\":" << std::setprecision(2) << d.x1 << ","
             << "\"y1\":" << d.y1 << ","
@@ -947,7 +1119,11 @@ char* YoloDetector::toJson(
         << "\"count\":" << detections.size() << ","
         << "\"inference_time_ms\":" << inference_time_ms << ","
         << "\"image_width\":" << image_width << ","
-        << "\"image_height\":" << image_height
+        << "\"image_height\":" << image_height << ","
+        << "\"frame_id\":" << timing.frame_id << ","
+        << "\"queue_wait_ms\":" << std::fixed << std::setprecision(2) << timing.queueWaitMs() << ","
+        << "\"processing_ms\":" << timing.processingMs() << ","
+        << "\"frame_age_ms\":" << timing.frameAgeMs()
         << "}";
 
     std::string json = oss.str();
@@ -1,24 +1,71 @@
 #ifndef YOLO_DETECTOR_HPP
 #define YOLO_DETECTOR_HPP
 
+#include <algorithm>
+#include <functional>
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 
-#include <onnxruntime/onnxruntime_cxx_api.h>
+#include "detection.hpp"
+#include "frame_metrics.hpp"
+#include "head_decoder.hpp"
+#include "inference_backend.hpp"
+#include "latest_result.hpp"
+#include "output_decoder.hpp"
+#include "request_scheduler.hpp"
+#include "sampling_plan.hpp"
+#include "stream_context.hpp"
 
-struct Detection {
-    int class_id;
-    std::string class_name;
-    float confidence;
-    float x1, y1, x2, y2;  // bounding box (pixel coordinates)
+class DetectionLogWriter;
+struct DecodedImage;
+
+// Outcome of a detect call that reports no JSON (presence / count)
+enum class DetectStatus {
+    Ok = 0,
+    NotInitialized = -1,
+    InvalidInput = -2,
+    ImageLoadFailed = -3,
+    DecoderUnavailable = -4,
+    QueueFull = -5,
+    FrameShed = -6,
+    Cancelled = -7,
+    Preempted = -8
 };
 
-// Model type for different output formats
-enum class ModelType {
-    YOLOV8,     // [1, 84, 8400] - no objectness
-    YOLOX,      // [1, 8400, 85] - has objectness
-    PPYOLOE     // [1, N, 6] - already decoded with NMS
+// What a detection pass has to produce. Presence returns at the first
+// candidate of an allowed class (no NMS); Count and Boxes run NMS but skip
+// class name strings. Candidates of other classes are dropped before NMS.
+struct DetectQuery {
+    enum class Mode { Detections, Presence, Count, Boxes };
+
+    Mode mode = Mode::Detections;
+    std::vector<bool> allowed;  // indexed by class id; empty = every class
+
+    // Filled with one pooled appearance embedding per final detection when
+    // set and the model exposes an embedding output
+    std::vector<float>* embeddings = nullptr;
+
+    // Per-camera plan, metrics and log when the call belongs to a stream
+    StreamContext* stream = nullptr;
+
+    bool allows(int class_id) const {
+        return allowed.empty() ||
+               (class_id >= 0 && class_id < static_cast<int>(allowed.size()) && allowed[class_id]);
+    }
+};
+
+// Produces the frame of a request once it is admitted: either a view of
+// caller memory, or an image decoded into storage
+using FrameSource = std::function<DetectStatus(DecodedImage& storage, FrameView& frame)>;
+
+// Outputs of YoloDetector::runTensor, read in place. storage keeps the
+// backend's output memory alive; independent of the detector once filled.
+struct TensorRun {
+    std::vector<std::string> names;
+    std::vector<OutputTensor> outputs;
+    std::shared_ptr<void> storage;
 };
 
 class YoloDetector {
@@ -29,15 +76,66 @@ public:
     // Initialize with ONNX model path
     bool init(const std::string& model_path);
 
+    // Intra-op thread count (0 = thread budget) and ORT thread affinity string,
+    // applied at init
+    void setIntraOpThreads(int threads, const std::string& affinities = std::string()) {
+        m_intra_op_threads = threads;
+        m_intra_op_affinities = affinities;
+    }
+
+    // Inference backend, applied at init (ONNX Runtime by default). Returns
+    // false if the backend was not compiled in.
+    bool setBackend(BackendType type);
+    BackendType backend() const { return m_backend_type; }
+
+    // Name of the loaded backend ("onnxruntime", "opencv-dnn"), empty before init
+    const char* backendName() const { return m_backend ? m_backend->name() : ""; }
+
+    // Model output holding a neck feature map [1, C, H, W] to pool
+    // per-detection appearance embeddings from (RoIAlign into pooled x pooled
+    // bins, C * pooled^2 floats, L2-normalized). Applied at init; that output
+    // is then left out of detection decoding.
+    void setEmbeddingOutput(const std::string& name, int pooled_size = 1) {
+        m_embedding_output = name;
+        m_embedding_pooled = std::max(1, pooled_size);
+    }
+
+    // Fold the RGB channel order and /255 scaling of YOLOv8 / PP-YOLOE models
+    // into the first convolution's weights at init, so frames are sampled as
+    // raw BGR 0-255. Applied at init; models whose input does not feed a
+    // single plain Conv load unchanged.
+    void setFoldInputNormalization(bool enabled) { m_fold_input = enabled; }
+
+    // Whether the loaded model was rewritten by setFoldInputNormalization
+    bool inputFolded() const { return m_input_folded; }
+
+    // Floats per embedding (0 if the model has no embedding output)
+    int embeddingDim() const { return m_embedding_channels * m_embedding_pooled * m_embedding_pooled; }
+
     // Set model type explicitly (auto-detected by default)
-    void setModelType(ModelType type) { m_model_type = type; }
+    void setModelType(ModelType type);
 
     // Run detection on image path
     // Returns JSON string (caller must free)
+    // timing: optional frame id / capture timestamp, filled in and reported in the result
+    // priority: scheduling class; may be rejected, shed or preempted (error result)
     char* detectFromPath(
         const char* image_path,
         float conf_threshold = 0.25f,
-        float iou_threshold = 0.45f
+        float iou_threshold = 0.45f,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive
+    );
+
+    // Run detection on an encoded image (JPEG/PNG/BMP) already in memory,
+    // e.g. file contents read ahead by a batch scan
+    char* detectFromMemory(
+        const uint8_t* data,
+        size_t size,
+        float conf_threshold = 0.25f,
+        float iou_threshold = 0.45f,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive
     );
 
     // Run detection on image buffer (BGRA format from camera)
@@ -47,7 +145,9 @@ public:
         int height,
         int stride,
         float conf_threshold = 0.25f,
-        float iou_threshold = 0.45f
+        float iou_threshold = 0.45f,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive
     );
 
     // Run detection on YUV420 buffer (Android camera format)
@@ -63,18 +163,178 @@ public:
         int uv_pixel_stride,
         int rotation = 0,
         float conf_threshold = 0.25f,
-        float iou_threshold = 0.45f
+        float iou_threshold = 0.45f,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive
+    );
+
+    // Run detection on a frame in any SourceFormat, sampled in place.
+    // The planes must stay valid until the call returns.
+    char* detectFromFrame(
+        const FrameView& frame,
+        float conf_threshold = 0.25f,
+        float iou_threshold = 0.45f,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive
     );
 
+    // Frame sources for the presence / count calls, matching the inputs of
+    // detectFromPath, detectFromMemory, detectFromBuffer, detectFromYUV and
+    // detectFromFrame.
+    // The referenced memory must stay valid until the call returns.
+    static FrameSource fileSource(const char* image_path);
+    static FrameSource memorySource(const uint8_t* data, size_t size);
+    static FrameSource bgraSource(const uint8_t* image_data, int width, int height, int stride);
+    static FrameSource yuvSource(
+        const uint8_t* y_data,
+        const uint8_t* u_data,
+        const uint8_t* v_data,
+        int width,
+        int height,
+        int y_row_stride,
+        int uv_row_stride,
+        int uv_pixel_stride,
+        int rotation
+    );
+    static FrameSource viewSource(const FrameView& view);
+
+    // Detection JSON for any frame source (what the detectFrom* calls wrap).
+    // stream: per-camera plan, metrics and log for callers serving several
+    // cameras from one detector (nullptr = the detector's own).
+    // status: optional, receives the outcome the JSON describes.
+    char* detectJson(
+        const FrameSource& source,
+        float conf_threshold = 0.25f,
+        float iou_threshold = 0.45f,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive,
+        StreamContext* stream = nullptr,
+        DetectStatus* status = nullptr
+    );
+
+    // Whether any detection of one of class_ids (empty = any class) reaches
+    // conf_threshold. Decoding stops at the first hit; no NMS, no JSON.
+    DetectStatus detectPresence(
+        const FrameSource& source,
+        const std::vector<int>& class_ids,
+        float conf_threshold,
+        bool& present,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive,
+        StreamContext* stream = nullptr
+    );
+
+    // Detections per class after NMS, restricted to class_ids (empty = all).
+    // counts is indexed by class id and sized to the model's class count.
+    DetectStatus detectCount(
+        const FrameSource& source,
+        const std::vector<int>& class_ids,
+        float conf_threshold,
+        float iou_threshold,
+        std::vector<int>& counts,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive,
+        StreamContext* stream = nullptr
+    );
+
+    // Final detections (no class name strings) for a binary result, plus
+    // embeddings (embeddingDim() floats per detection, in the same order)
+    // when with_embeddings is set. width / height: the frame size the boxes
+    // refer to.
+    DetectStatus detectBoxes(
+        const FrameSource& source,
+        float conf_threshold,
+        float iou_threshold,
+        bool with_embeddings,
+        std::vector<Detection>& detections,
+        std::vector<float>& embeddings,
+        int& width,
+        int& height,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive,
+        StreamContext* stream = nullptr
+    );
+
+    // Run the session on a caller-prepared input tensor [N, 3, H, W] (no
+    // preprocessing, no decoding). input is used in place and must stay valid
+    // until the call returns. PP-YOLOE's scale_factor input is fed as 1, so
+    // its boxes are in input tensor coordinates. run receives every detection
+    // output, then the embedding output if one is configured.
+    DetectStatus runTensor(
+        const float* input,
+        const int64_t* shape,
+        int rank,
+        TensorRun& run,
+        FrameTiming timing = FrameTiming(),
+        RequestPriority priority = RequestPriority::Interactive
+    );
+
+    // Model input size
+    int inputWidth() const { return m_input_width; }
+    int inputHeight() const { return m_input_height; }
+
+    // Stages of a detection pass, for callers running them separately (see
+    // FramePipeline): how frames are sampled into the input tensor, a new
+    // decoder for the model's outputs, and the step from decoded candidates
+    // to final detections.
+    bool letterboxInput() const { return m_letterbox; }
+    TensorFormat inputFormat() const { return m_input_format; }
+    std::unique_ptr<OutputDecoder> createDecoder() const;
+
+    // Detection outputs at the front of a runTensor result
+    size_t detectionOutputCount() const { return m_output_names_str.size(); }
+
+    // Mapping of runTensor output boxes back to a frame sampled with the
+    // given letterbox parameters
+    BoxMapping tensorMapping(int frame_width, int frame_height, float scale, int pad_x, int pad_y) const;
+
+    // Map candidates to the frame, clamp them, run NMS unless the model
+    // already did (or iou_threshold is negative) and, with class_names, set
+    // each detection's class name
+    std::vector<Detection> finishCandidates(
+        const std::vector<HeadBox>& candidates,
+        const BoxMapping& mapping,
+        int frame_width,
+        int frame_height,
+        float iou_threshold,
+        bool suppressed,
+        bool class_names
+    ) const;
+
     // Check if initialized
     bool isInitialized() const { return m_initialized; }
 
     // Set class names
     void setClassNames(const std::vector<std::string>& names);
+    const std::vector<std::string>& classNames() const { return m_class_names; }
 
     // Release resources
     void release();
 
+    // Queue wait / processing / frame age statistics as JSON
+    std::string metricsJson() const { return m_metrics.toJson(); }
+    const FrameMetrics& metrics() const { return m_metrics; }
+    void resetMetrics() { m_metrics.reset(); }
+
+    // Priority scheduling: queue limits, background preemption and statistics
+    void setSchedulerConfig(const SchedulerConfig& config) { m_scheduler.setConfig(config); }
+    SchedulerConfig schedulerConfig() const { return m_scheduler.config(); }
+    int cancelBackground() { return m_scheduler.cancelBackground(); }
+    uint64_t backgroundCancels() const { return m_scheduler.backgroundCancels(); }
+    SchedulerStats schedulerStats() const { return m_scheduler.stats(); }
+    std::string schedulerStatsJson() const { return m_scheduler.statsJson(); }
+
+    // Append every frame's detections to a binary log (nullptr to detach).
+    // The writer must outlive the attachment.
+    void setDetectionLog(DetectionLogWriter* log);
+
+    // Newest detection / box result for polling (frames of a stream go to the
+    // stream's own). setLatestResult points this detector at another one,
+    // e.g. so replicas publish into a single slot (nullptr = its own); it
+    // must outlive the attachment.
+    LatestResult& latestResult() { return *m_latest_target; }
+    void setLatestResult(LatestResult* latest) { m_latest_target = latest != nullptr ? latest : &m_latest; }
+
 private:
     bool m_initialized;
     int m_input_width;
@@ -83,59 +343,140 @@ private:
     ModelType m_model_type;
     std::vector<std::string> m_class_names;
 
-    // ONNX Runtime
-    std::unique_ptr<Ort::Env> m_env;
-    std::unique_ptr<Ort::Session> m_session;
-    std::unique_ptr<Ort::SessionOptions> m_session_options;
-    Ort::AllocatorWithDefaultOptions m_allocator;
+    // Inference backend (model session)
+    BackendType m_backend_type = BackendType::OnnxRuntime;
+    std::unique_ptr<InferenceBackend> m_backend;
+    int m_intra_op_threads = 0;
+    std::string m_intra_op_affinities;
 
     std::vector<std::string> m_input_names_str;
     std::vector<std::string> m_output_names_str;
 
-    // Run detection on cv::Mat
+    // Raw per-stride head outputs ([1, C, H, W] each) instead of one merged
+    // output
+    bool m_multi_head = false;
+    HeadLayout m_head_layout = HeadLayout::YOLOX;
+    int64_t m_head_channels = 0;
+
+    // Stages picked for the loaded model by configureStages(): input sampling
+    // and the output decoder (with its scratch buffers, reused across frames)
+    bool m_letterbox = true;
+    TensorFormat m_input_format;
+    std::unique_ptr<OutputDecoder> m_decoder;
+    std::vector<HeadBox> m_candidates;
+
+    // Neck feature output for appearance embeddings (empty name = none)
+    std::string m_embedding_output;
+    int m_embedding_pooled = 1;
+    int m_embedding_channels = 0;
+
+    // Input normalization folded into the first convolution (raw BGR input)
+    bool m_fold_input = false;
+    bool m_input_folded = false;
+
+    // Grants the detector by priority; time spent waiting here is the queue wait
+    RequestScheduler m_scheduler;
+    FrameMetrics m_metrics;
+
+    // Set when the scheduler aborted an inference to serve higher priority work
+    bool m_preempted = false;
+
+    // Optional binary log of every frame's detections
+    std::mutex m_log_mutex;
+    DetectionLogWriter* m_log = nullptr;
+
+    // Latest finished frame, read by UI polling
+    LatestResult m_latest;
+    LatestResult* m_latest_target = &m_latest;
+
+    // Sampling plan for the last frame geometry (rebuilt only when it changes)
+    SamplingPlan m_plan;
+
+    // Model input tensor, reused across frames
+    std::vector<float> m_input_tensor;
+
+    // Run detection on a source frame
     std::vector<Detection> detect(
-        const uint8_t* bgr_data,
-        int width,
-        int height,
+        const FrameView& frame,
         float conf_threshold,
-        float iou_threshold
+        float iou_threshold,
+        const DetectQuery& query
     );
 
-    // Preprocess image for model input (letterbox + normalize)
-    std::vector<float> preprocess(
-        const uint8_t* bgr_data,
-        int width,
-        int height,
+    // Reload the model with its input normalization folded into the first
+    // convolution; keeps the current model on failure
+    void foldInput(const std::string& model_path);
+
+    // Preprocess frame into m_input_tensor (convert + rotate + letterbox + normalize),
+    // with the stream's sampling plan if given
+    void preprocess(
+        const FrameView& frame,
+        StreamContext* stream,
         float& scale,
         int& pad_x,
         int& pad_y
     );
 
-    // Postprocess model output to detections
-    std::vector<Detection> postprocess(
-        const float* output,
-        const std::vector<int64_t>& output_shape,
-        size_t output_count,
-        int original_width,
-        int original_height,
-        float scale,
-        int pad_x,
-        int pad_y,
-        float conf_threshold,
-        float iou_threshold
+    // Classify m_head_channels against the current class names and set the
+    // layout, model type and class count accordingly
+    bool applyHeadLayout();
+
+    // Pick the input sampling and output decoder for the model type
+    void configureStages();
+
+    // Pool one embedding per detection from the feature output. Boxes are
+    // mapped into model input pixels by x * scale_x + pad_x (y likewise).
+    void poolEmbeddings(
+        const OutputTensor& features,
+        const std::vector<Detection>& detections,
+        float scale_x,
+        float scale_y,
+        float pad_x,
+        float pad_y,
+        std::vector<float>& embeddings
     );
 
     // Non-maximum suppression
-    std::vector<Detection> nms(
+    static std::vector<Detection> nms(
         std::vector<Detection>& detections,
         float iou_threshold
     );
 
     // Calculate IoU between two boxes
-    float iou(const Detection& a, const Detection& b);
+    static float iou(const Detection& a, const Detection& b);
+
+    // Shared body of every entry point: admit the request, produce the frame
+    // and run the query, then stamp the end time and record metrics.
+    // width / height are the frame size detections refer to.
+    DetectStatus runFrame(
+        const FrameSource& source,
+        const DetectQuery& query,
+        float conf_threshold,
+        float iou_threshold,
+        FrameTiming& timing,
+        RequestPriority priority,
+        std::vector<Detection>& detections,
+        int& width,
+        int& height
+    );
+
+    // Error result for a failed request
+    static char* statusError(DetectStatus status);
+
+    // Allowed-class mask for a query (empty = every class)
+    std::vector<bool> classMask(const std::vector<int>& class_ids) const;
+
+    // Publish the frame as the stream's latest result, else the detector's,
+    // and append it to the matching detection log, if any
+    void publishFrame(const std::vector<Detection>& detections, const FrameTiming& timing, int image_width,
+                      int image_height, StreamContext* stream);
+
+    // Publish and log the frame, then build the JSON result
+    char* finishFrame(const std::vector<Detection>& detections, FrameTiming& timing, int image_width, int image_height,
+                      StreamContext* stream);
 
     // Convert detections to JSON string
-    char* toJson(const std::vector<Detection>& detections, long long inference_time_ms, int image_width, int image_height);
+    char* toJson(const std::vector<Detection>& detections, const FrameTiming& timing, int image_width, int image_height);
 };
 
 #endif // YOLO_DETECTOR_HPP